@@ -26,7 +26,11 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackGlobals.h"
 #include "JackTime.h"
 #include "JackPortType.h"
+#include "graph.h"
+#include "startup.h"
+#include "budget.h"
 #include <math.h>
+#include <vector>
 #ifndef __STDC_FORMAT_MACROS // defined on MacOS
 #define __STDC_FORMAT_MACROS 1
 #endif
@@ -116,6 +120,10 @@ extern "C"
                                        JackXRunCallback xrun_callback, void *arg);
     LIB_EXPORT int jack_set_latency_callback(jack_client_t *client,
 			       JackLatencyCallback latency_callback, void *arg);
+    LIB_EXPORT int jack_set_budget_callback(jack_client_t *client,
+                                         JackBudgetCallback budget_callback, void *arg);
+    LIB_EXPORT int jack_get_budget_stats(jack_client_t *client,
+                                      jack_budget_stats_t *stats);
 
     LIB_EXPORT int jack_activate(jack_client_t *client);
     LIB_EXPORT int jack_deactivate(jack_client_t *client);
@@ -195,6 +203,8 @@ extern "C"
                                         jack_time_t    *current_usecs,
                                         jack_time_t    *next_usecs,
                                         float          *period_usecs);
+    LIB_EXPORT int jack_get_clock_estimate(const jack_client_t *client,
+                                           jack_clock_estimate_t *estimate);
     LIB_EXPORT float jack_cpu_load(jack_client_t *client);
     LIB_EXPORT jack_native_thread_t jack_client_thread_id(jack_client_t *);
     LIB_EXPORT void jack_set_error_function(print_function);
@@ -204,6 +214,26 @@ extern "C"
     LIB_EXPORT float jack_get_xrun_delayed_usecs(jack_client_t *client);
     LIB_EXPORT void jack_reset_max_delayed_usecs(jack_client_t *client);
 
+    LIB_EXPORT int jack_graph_get_version(jack_client_t *client, uint32_t *version);
+    LIB_EXPORT int jack_graph_get_port_peers(jack_client_t *client,
+                                          const jack_port_t *port,
+                                          jack_port_id_t *peers,
+                                          int count,
+                                          uint32_t *version);
+    LIB_EXPORT jack_graph_snapshot_t * jack_graph_snapshot_new(jack_client_t *client);
+    LIB_EXPORT int jack_graph_snapshot_update(jack_client_t *client, jack_graph_snapshot_t *snapshot);
+    LIB_EXPORT uint32_t jack_graph_snapshot_get_version(const jack_graph_snapshot_t *snapshot);
+    LIB_EXPORT uint32_t jack_graph_snapshot_get_port_count(const jack_graph_snapshot_t *snapshot);
+    LIB_EXPORT int jack_graph_snapshot_get_peers(const jack_graph_snapshot_t *snapshot,
+                                              jack_port_id_t port_id,
+                                              const jack_port_id_t **peers);
+    LIB_EXPORT void jack_graph_snapshot_free(jack_graph_snapshot_t *snapshot);
+
+    LIB_EXPORT int jack_activate_with_ports(jack_client_t *client,
+                                         const jack_port_spec_t *specs,
+                                         unsigned int count,
+                                         jack_port_t **ports);
+
     LIB_EXPORT int jack_release_timebase(jack_client_t *client);
     LIB_EXPORT int jack_set_sync_callback(jack_client_t *client,
                                        JackSyncCallback sync_callback,
@@ -218,6 +248,9 @@ extern "C"
                                       jack_nframes_t frame);
     LIB_EXPORT jack_transport_state_t jack_transport_query(const jack_client_t *client,
             jack_position_t *pos);
+    LIB_EXPORT jack_transport_state_t jack_transport_query_offset(const jack_client_t *client,
+            jack_nframes_t frame_offset,
+            jack_position_t *pos);
     LIB_EXPORT jack_nframes_t jack_get_current_transport_frame(const jack_client_t *client);
     LIB_EXPORT int jack_transport_reposition(jack_client_t *client,
                                           const jack_position_t *pos);
@@ -1045,6 +1078,42 @@ LIB_EXPORT int jack_set_latency_callback(jack_client_t* ext_client, JackLatencyC
     }
 }
 
+LIB_EXPORT int jack_set_budget_callback(jack_client_t* ext_client, JackBudgetCallback budget_callback, void *arg)
+{
+    JackGlobals::CheckContext("jack_set_budget_callback");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_set_budget_callback called with a NULL client");
+        return -1;
+    } else {
+        return client->SetBudgetCallback(budget_callback, arg);
+    }
+}
+
+LIB_EXPORT int jack_get_budget_stats(jack_client_t* ext_client, jack_budget_stats_t* stats)
+{
+    JackGlobals::CheckContext("jack_get_budget_stats");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_get_budget_stats called with a NULL client");
+        return -1;
+    }
+    if (stats == NULL) {
+        jack_error("jack_get_budget_stats called with NULL stats");
+        return -1;
+    }
+
+    JackClientControl* control = client->GetClientControl();
+    stats->violations = control->fBudgetViolations;
+    stats->bypass_count = control->fBypassCount;
+    stats->bypassed_cycles = control->fBypassedCycles;
+    stats->max_process_usecs = control->fMaxProcessUsecs;
+    stats->bypassed = control->fBypassed;
+    return 0;
+}
+
 LIB_EXPORT int jack_set_thread_init_callback(jack_client_t* ext_client, JackThreadInitCallback init_callback, void *arg)
 {
     JackGlobals::CheckContext("jack_set_thread_init_callback");
@@ -1434,6 +1503,23 @@ LIB_EXPORT int jack_get_cycle_times(const jack_client_t *client,
     }
 }
 
+LIB_EXPORT int jack_get_clock_estimate(const jack_client_t *client, jack_clock_estimate_t *estimate)
+{
+    JackGlobals::CheckContext("jack_get_clock_estimate");
+
+    JackEngineControl* control = GetEngineControl();
+    if (estimate == NULL) {
+        jack_error("jack_get_clock_estimate called with a NULL estimate");
+        return -1;
+    } else if (control) {
+        JackTimer timer;
+        control->ReadFrameTime(&timer);
+        return timer.GetClockEstimate(estimate, control->fBufferSize, control->fSampleRate);
+    } else {
+        return -1;
+    }
+}
+
 LIB_EXPORT float jack_cpu_load(jack_client_t* ext_client)
 {
     JackGlobals::CheckContext("jack_cpu_load");
@@ -1588,6 +1674,19 @@ LIB_EXPORT jack_transport_state_t jack_transport_query(const jack_client_t* ext_
     }
 }
 
+LIB_EXPORT jack_transport_state_t jack_transport_query_offset(const jack_client_t* ext_client, jack_nframes_t frame_offset, jack_position_t* pos)
+{
+    JackGlobals::CheckContext("jack_transport_query_offset");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_transport_query_offset called with a NULL client");
+        return JackTransportStopped;
+    } else {
+        return client->TransportQueryOffset(frame_offset, pos);
+    }
+}
+
 LIB_EXPORT jack_nframes_t jack_get_current_transport_frame(const jack_client_t* ext_client)
 {
     JackGlobals::CheckContext("jack_get_current_transport_frame");
@@ -1700,6 +1799,187 @@ LIB_EXPORT void jack_reset_max_delayed_usecs(jack_client_t* ext_client)
     }
 }
 
+// graph.h
+struct _jack_graph_snapshot
+{
+    uint32_t version;
+    uint32_t port_count;
+    jack_port_id_t* data;   // port_count + 1 offsets, then the peers
+    int data_size;          // grows with the port table
+};
+
+LIB_EXPORT int jack_graph_get_version(jack_client_t* ext_client, uint32_t* version)
+{
+    JackGlobals::CheckContext("jack_graph_get_version");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_graph_get_version called with a NULL client");
+        return -1;
+    } else {
+        JackGraphManager* manager = GetGraphManager();
+        if (!manager) {
+            return -1;
+        }
+        *version = manager->GetSnapshotVersion();
+        return 0;
+    }
+}
+
+LIB_EXPORT int jack_graph_get_port_peers(jack_client_t* ext_client, const jack_port_t* port, jack_port_id_t* peers, int count, uint32_t* version)
+{
+    JackGlobals::CheckContext("jack_graph_get_port_peers");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_graph_get_port_peers called with a NULL client");
+        return -1;
+    }
+
+    uintptr_t port_aux = (uintptr_t)port;
+    jack_port_id_t myport = (jack_port_id_t)port_aux;
+    if (!CheckPort(myport) || count < 0) {
+        jack_error("jack_graph_get_port_peers called with an incorrect port %ld", myport);
+        return -1;
+    } else {
+        JackGraphManager* manager = GetGraphManager();
+        UInt32 read_version;
+        int res = (manager ? manager->ReadSnapshotPeers(myport, peers, count, &read_version) : -1);
+        if (res >= 0 && version) {
+            *version = read_version;
+        }
+        return res;
+    }
+}
+
+LIB_EXPORT int jack_graph_snapshot_update(jack_client_t* ext_client, jack_graph_snapshot_t* snapshot)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_update");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL || snapshot == NULL) {
+        jack_error("jack_graph_snapshot_update called with a NULL client or snapshot");
+        return -1;
+    }
+
+    JackGraphManager* manager = GetGraphManager();
+    if (!manager) {
+        return -1;
+    } else if (snapshot->data && snapshot->version == manager->GetSnapshotVersion()) {
+        return 0;
+    }
+
+    UInt32 port_count, version;
+    int res = -1;
+
+    // Once more if the port table grows during the read
+    for (int retry = 0; retry < 2 && res < 0; retry++) {
+        int data_size = manager->GetSnapshotSize();
+        if (data_size > snapshot->data_size) {
+            jack_port_id_t* data = (jack_port_id_t*)realloc(snapshot->data, data_size * sizeof(jack_port_id_t));
+            if (!data) {
+                return -1;
+            }
+            snapshot->data = data;
+            snapshot->data_size = data_size;
+        }
+        res = manager->ReadSnapshot(snapshot->data, snapshot->data_size, &port_count, &version);
+    }
+
+    if (res < 0) {
+        jack_error("jack_graph_snapshot_update : cannot read the graph, or it does not fit in the snapshot");
+        return -1;
+    }
+    snapshot->version = version;
+    snapshot->port_count = port_count;
+    return 1;
+}
+
+LIB_EXPORT jack_graph_snapshot_t* jack_graph_snapshot_new(jack_client_t* ext_client)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_new");
+
+    jack_graph_snapshot_t* snapshot = (jack_graph_snapshot_t*)calloc(1, sizeof(jack_graph_snapshot_t));
+    if (snapshot && jack_graph_snapshot_update(ext_client, snapshot) < 0) {
+        jack_graph_snapshot_free(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+LIB_EXPORT uint32_t jack_graph_snapshot_get_version(const jack_graph_snapshot_t* snapshot)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_get_version");
+    return (snapshot) ? snapshot->version : 0;
+}
+
+LIB_EXPORT uint32_t jack_graph_snapshot_get_port_count(const jack_graph_snapshot_t* snapshot)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_get_port_count");
+    return (snapshot) ? snapshot->port_count : 0;
+}
+
+LIB_EXPORT int jack_graph_snapshot_get_peers(const jack_graph_snapshot_t* snapshot, jack_port_id_t port_id, const jack_port_id_t** peers)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_get_peers");
+
+    if (snapshot == NULL || port_id >= snapshot->port_count) {
+        jack_error("jack_graph_snapshot_get_peers called with a NULL snapshot or an incorrect port %ld", port_id);
+        return -1;
+    } else {
+        const jack_port_id_t* offsets = snapshot->data;
+        *peers = snapshot->data + snapshot->port_count + 1 + offsets[port_id];
+        return offsets[port_id + 1] - offsets[port_id];
+    }
+}
+
+LIB_EXPORT void jack_graph_snapshot_free(jack_graph_snapshot_t* snapshot)
+{
+    JackGlobals::CheckContext("jack_graph_snapshot_free");
+
+    if (snapshot) {
+        free(snapshot->data);
+        free(snapshot);
+    }
+}
+
+// startup.h
+LIB_EXPORT int jack_activate_with_ports(jack_client_t* ext_client, const jack_port_spec_t* specs, unsigned int count, jack_port_t** ports)
+{
+    JackGlobals::CheckContext("jack_activate_with_ports");
+
+    JackClient* client = (JackClient*)ext_client;
+    if (client == NULL) {
+        jack_error("jack_activate_with_ports called with a NULL client");
+        return -1;
+    }
+    if (count > 0 && (specs == NULL || ports == NULL)) {
+        jack_error("jack_activate_with_ports called with NULL port specs or ports");
+        return -1;
+    }
+
+    std::vector<const char*> names(count + 1);
+    std::vector<const char*> types(count + 1);
+    std::vector<unsigned long> flags(count + 1);
+    std::vector<jack_port_id_t> port_index(count + 1, 0);
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (specs[i].name == NULL || specs[i].type == NULL) {
+            jack_error("jack_activate_with_ports called with a NULL port name or a NULL port_type");
+            return -1;
+        }
+        names[i] = specs[i].name;
+        types[i] = specs[i].type;
+        flags[i] = specs[i].flags;
+    }
+
+    int res = client->ActivateWithPorts(&names[0], &types[0], &flags[0], count, &port_index[0]);
+    for (unsigned int i = 0; i < count; i++) {
+        ports[i] = (port_index[i] != NO_PORT) ? (jack_port_t *)((uintptr_t)port_index[i]) : NULL;
+    }
+    return res;
+}
+
 // thread.h
 LIB_EXPORT int jack_client_real_time_priority(jack_client_t* ext_client)
 {
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPlatformPlug.h"
 #include "JackTime.h"
 #include "JackTypes.h"
+#include <atomic>
 
 namespace Jack
 {
@@ -47,13 +48,32 @@ class JackActivationCount
         JackActivationCount(): fValue(0), fCount(0)
         {}
 
+        // Used when a whole connection state is copied
+        JackActivationCount& operator=(const JackActivationCount& obj)
+        {
+            fValue = obj.fValue.load();
+            fCount = obj.fCount;
+            return *this;
+        }
+
         bool Signal(JackSynchro* synchro, JackClientControl* control);
 
+        // Counts an input without waking the client, true when it was the last one
+        inline bool Pass()
+        {
+            return (fValue == 0) || (fValue-- == 1);
+        }
+
         inline void Reset()
         {
             fValue = fCount;
         }
 
+        inline void Reset(int val)
+        {
+            fValue = val;
+        }
+
         inline void SetValue(int val)
         {
             fCount = val;
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackTypes.h"
 #include <string.h> // for memcpy
 #include <atomic>
+#include <algorithm>
 
 namespace Jack
 {
@@ -98,6 +99,115 @@ public:
 } POST_PACKED_STRUCTURE;
 
 
+#define STATE_PAGE_SIZE 256
+#define STATE_PAGE_NUM  4096
+
+/*!
+\brief Pages of a state modified since it was last copied to the other state.
+
+ A state bigger than STATE_PAGE_NUM pages is entirely copied once something is marked beyond the last page.
+*/
+
+PRE_PACKED_STRUCTURE
+class JackStatePages
+{
+
+    private:
+
+        UInt32 fBits[STATE_PAGE_NUM / 32];
+        UInt32 fAll;
+
+    public:
+
+        JackStatePages()
+        {
+            SetAll();
+        }
+
+        void Clear()
+        {
+            memset(fBits, 0, sizeof(fBits));
+            fAll = 0;
+        }
+
+        void SetAll()
+        {
+            fAll = 1;
+        }
+
+        void Mark(size_t offset, size_t size)
+        {
+            size_t last = (offset + size - 1) / STATE_PAGE_SIZE;
+            if (last >= STATE_PAGE_NUM) {
+                fAll = 1;
+                return;
+            }
+            for (size_t page = offset / STATE_PAGE_SIZE; page <= last; page++) {
+                fBits[page / 32] |= 1 << (page % 32);
+            }
+        }
+
+        /*!
+        \brief Copy pages marked here or in other, from src to dst of the given size.
+        */
+        void Copy(char* dst, const char* src, size_t size, const JackStatePages& other) const
+        {
+            if (fAll || other.fAll) {
+                memcpy(dst, src, size);
+                return;
+            }
+            for (size_t i = 0; i < STATE_PAGE_NUM / 32; i++) {
+                UInt32 bits = fBits[i] | other.fBits[i];
+                for (size_t page = i * 32; bits; page++, bits >>= 1) {
+                    size_t offset = page * STATE_PAGE_SIZE;
+                    if ((bits & 1) && offset < size) {
+                        memcpy(dst + offset, src + offset, std::min(size_t(STATE_PAGE_SIZE), size - offset));
+                    }
+                }
+            }
+        }
+
+} POST_PACKED_STRUCTURE;
+
+/*!
+\brief Transient helper to mark the modified parts of a state object, given its address.
+*/
+
+class JackStateMarker
+{
+
+    private:
+
+        JackStatePages* fPages;
+        const char* fBase;
+
+    public:
+
+        JackStateMarker(JackStatePages* pages, const void* base):fPages(pages), fBase((const char*)base)
+        {}
+
+        void Mark(const void* addr, size_t size)
+        {
+            fPages->Mark((const char*)addr - fBase, size);
+        }
+
+        void MarkAll()
+        {
+            fPages->SetAll();
+        }
+
+};
+
+/*!
+\brief Copy the current state in the next one : states tracking their modifications provide a cheaper overload.
+*/
+
+template <class T>
+inline void CopyState(T* dst, T* src)
+{
+    memcpy(dst, src, sizeof(T));
+}
+
 /*!
 \brief A class to handle two states (switching from one to the other) in a lock-free manner
 */
@@ -125,13 +235,13 @@ class JackAtomicState
             do {
                 old_val = fCounter;
                 new_val = old_val;
-                cur_index = new_val.CurIndex();
+                cur_index = new_val.CurArrayIndex();
                 next_index = new_val.NextArrayIndex();
                 need_copy = new_val.CurIndex() == new_val.NextIndex();
                 new_val.SetNextIndex(new_val.CurIndex()); // Invalidate next index
             } while (!fCounter.CompareExchange(old_val,new_val));
             if (need_copy)
-                memcpy(&fState[next_index], &fState[cur_index], sizeof(T));
+                CopyState(&fState[next_index], &fState[cur_index]);
             return next_index;
         }
 
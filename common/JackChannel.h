@@ -49,6 +49,10 @@ class JackChannelTransactionInterface
         virtual int Read(void* data, int len) = 0;
         virtual int Write(void* data, int len) = 0;
 
+        // Descriptors passing, only on channels that support it
+        virtual int ReadFds(int* fds, int count) { return -1; }
+        virtual int WriteFds(int* fds, int count) { return -1; }
+
 };
 
 class JackRequestInterface
@@ -141,6 +145,8 @@ class JackClientChannelInterface
         {}
         virtual void PortUnRegister(int refnum, jack_port_id_t port_index, int* result)
         {}
+        virtual void PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port_index, int is_real_time, int* result)
+        {}
 
         virtual void PortConnect(int refnum, const char* src, const char* dst, int* result)
         {}
@@ -60,6 +60,7 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fSession = NULL;
     fLatency = NULL;
     fPropertyChange = NULL;
+    fBudget = NULL;
 
     fProcessArg = NULL;
     fGraphOrderArg = NULL;
@@ -79,8 +80,11 @@ JackClient::JackClient(JackSynchro* table):fThread(this)
     fSessionArg = NULL;
     fLatencyArg = NULL;
     fPropertyChangeArg = NULL;
+    fBudgetArg = NULL;
 
     fSessionReply = kPendingSessionReply;
+    fThreadCpu = -1;
+    fThreadCpuFixed = false;
 }
 
 JackClient::~JackClient()
@@ -182,6 +186,16 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
             jack_log("JackClient::kActivateClient name = %s ref = %ld ", name, refnum);
             InitAux();
             break;
+
+        case kAddPortChunk:
+            jack_log("JackClient::kAddPortChunk chunk = %ld", value1);
+            GetGraphManager()->AttachPortChunks();
+            break;
+
+        case kRealTimeCpu:
+            jack_log("JackClient::kRealTimeCpu cpu = %d", value1);
+            SetThreadCpu(value1);
+            break;
     }
 
     /*
@@ -332,6 +346,13 @@ int JackClient::ClientNotify(int refnum, const char* name, int notify, int sync,
                     fPropertyChange(subject, key, change, fPropertyChangeArg);
                 break;
             }
+
+            case kBudgetCallback:
+                jack_log("JackClient::kBudgetCallback client = %s bypassed = %ld", message, value1);
+                if (fBudget) {
+                    fBudget(message, value1, fBudgetArg);
+                }
+                break;
         }
     }
 
@@ -468,6 +489,78 @@ int JackClient::Activate()
     return result;
 }
 
+/*!
+\brief Register ports and activate the client. The last JACK_PORT_BATCH_MAX ports are registered by the activation request itself,
+so that the usual startup sequence only takes one round trip. Either all ports are registered and the client is activated, or nothing is done.
+*/
+int JackClient::ActivateWithPorts(const char* const* port_names, const char* const* port_types, const unsigned long* flags, int count, jack_port_id_t* ports)
+{
+    jack_log("JackClient::ActivateWithPorts count = %ld", count);
+    bool active = IsActive();
+    int batch = (active) ? 0 : std::min(count, JACK_PORT_BATCH_MAX);
+    int first = count - batch;
+    string full_names[JACK_PORT_BATCH_MAX];
+    const char* names[JACK_PORT_BATCH_MAX];
+    unsigned int batch_flags[JACK_PORT_BATCH_MAX];
+    bool registered = true;
+    int result = -1;
+    int i;
+
+    // Ports that do not fit in the request are registered first, one by one
+    for (i = 0; i < first && registered; i++) {
+        registered = ((ports[i] = PortRegister(port_names[i], port_types[i], flags[i], 0)) != 0);
+    }
+    for (int j = 0; j < batch && registered; j++) {
+        registered = PortFullName(port_names[first + j], full_names[j]);
+        names[j] = full_names[j].c_str();
+        batch_flags[j] = flags[first + j];
+    }
+
+    if (registered && batch == 0) {
+        result = Activate();
+    } else if (registered && (!IsRealTime() || StartThread() == 0)) {
+        // Same sequence as in Activate
+        GetClientControl()->fActive = true;
+        GetClientControl()->fTransportSync = true;
+        GetClientControl()->fTransportTimebase = true;
+        GetClientControl()->fCallback[kRealTimeCallback] = IsRealTime();
+        fChannel->PortRegisterActivate(GetClientControl()->fRefNum, batch, names, &port_types[first], batch_flags, &ports[first], IsRealTime(), &result);
+
+        for (int j = first; j < count; j++) {
+            if (result == 0) {
+                jack_log("JackClient::ActivateWithPorts ref = %ld name = %s port_index = %ld", GetClientControl()->fRefNum, names[j - first], ports[j]);
+                fPortList.push_back(ports[j]);
+            } else {
+                // Registered, but the activation or the transport failed
+                if (ports[j] != NO_PORT && ports[j] != 0) {
+                    int res;
+                    fChannel->PortUnRegister(GetClientControl()->fRefNum, ports[j], &res);
+                }
+                ports[j] = NO_PORT;
+            }
+        }
+    }
+
+    // On failure, the client is left as it was : inactive, and without the ports registered one by one
+    if (result < 0) {
+        if (!active && IsActive()) {
+            GetClientControl()->fActive = false;
+            GetClientControl()->fTransportSync = false;
+            GetClientControl()->fTransportTimebase = false;
+            if (IsRealTime()) {
+                fThread.Kill();
+            }
+        }
+        for (i = i - 1; i >= 0; i--) {
+            if (ports[i] != 0) {
+                PortUnRegister(ports[i]);
+                ports[i] = 0;
+            }
+        }
+    }
+    return result;
+}
+
 /*!
 \brief Need to stop thread after deactivating in the server.
 */
@@ -539,6 +632,7 @@ bool JackClient::Init()
         SetupRealTime();
     }
 
+    SetupAffinity();
     return true;
 }
 
@@ -557,6 +651,36 @@ void JackClient::SetupRealTime()
     }
 }
 
+/*!
+\brief The RT thread follows the CPU assigned by the server, unless the JACK_RT_CPU environment variable
+gives a CPU for all RT threads of the process, or -1 to leave them unpinned.
+*/
+void JackClient::SetupAffinity()
+{
+    const char* env = getenv("JACK_RT_CPU");
+    int cpu = (env) ? atoi(env) : GetEngineControl()->fClientCpu[GetClientControl()->fRefNum];
+    fThreadCpu = -1;
+    fThreadCpuFixed = (env != NULL);
+
+    if (cpu >= 0 && fThread.SetSelfAffinity(cpu) == 0) {
+        fThreadCpu = cpu;
+    }
+}
+
+/*!
+\brief Moves the RT thread to a new CPU assigned by the server, called from the notification thread.
+*/
+void JackClient::SetThreadCpu(int cpu)
+{
+    // Not started yet : SetupAffinity reads the assignment when it starts
+    if (fThreadCpuFixed || cpu < 0 || cpu == fThreadCpu || fThread.GetStatus() != JackThread::kRunning) {
+        return;
+    }
+    if (JackThread::SetAffinityImp(fThread.GetThreadID(), cpu) == 0) {
+        fThreadCpu = cpu;
+    }
+}
+
 int JackClient::StartThread()
 {
     if (fThread.StartSync() < 0) {
@@ -613,6 +737,7 @@ inline void JackClient::CycleSignalAux(int status)
         CallTimebaseCallbackAux();
     }
     SignalSync();
+
     if (status != 0) {
         End();     // Terminates the thread
     }
@@ -679,23 +804,33 @@ inline void JackClient::Error()
 // Port management
 //-----------------
 
-int JackClient::PortRegister(const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size)
+bool JackClient::PortFullName(const char* port_name, string& port_full_name_str)
 {
     // Check if port name is empty
     string port_short_name_str = string(port_name);
     if (port_short_name_str.size() == 0) {
         jack_error("port_name is empty");
-        return 0; // Means failure here...
+        return false;
     }
 
     // Check port name length
-    string port_full_name_str = string(GetClientControl()->fName) + string(":") + port_short_name_str;
+    port_full_name_str = string(GetClientControl()->fName) + string(":") + port_short_name_str;
     if (port_full_name_str.size() >= REAL_JACK_PORT_NAME_SIZE) {
         jack_error("\"%s:%s\" is too long to be used as a JACK port name.\n"
                    "Please use %lu characters or less",
                    GetClientControl()->fName,
                    port_name,
                    JACK_PORT_NAME_SIZE - 1);
+        return false;
+    }
+
+    return true;
+}
+
+int JackClient::PortRegister(const char* port_name, const char* port_type, unsigned long flags, unsigned long buffer_size)
+{
+    string port_full_name_str;
+    if (!PortFullName(port_name, port_full_name_str)) {
         return 0; // Means failure here...
     }
 
@@ -901,7 +1036,12 @@ int JackClient::TransportReposition(const jack_position_t* pos)
 
 jack_transport_state_t JackClient::TransportQuery(jack_position_t* pos)
 {
-    return GetEngineControl()->fTransport.Query(pos);
+    return GetEngineControl()->fTransport.Query(pos, GetGraphManager()->GetPipelineStage(GetClientControl()->fRefNum));
+}
+
+jack_transport_state_t JackClient::TransportQueryOffset(jack_nframes_t frame_offset, jack_position_t* pos)
+{
+    return GetEngineControl()->fTransport.QueryOffset(frame_offset, pos, GetGraphManager()->GetPipelineStage(GetClientControl()->fRefNum));
 }
 
 jack_nframes_t JackClient::GetCurrentTransportFrame()
@@ -1211,6 +1351,19 @@ int JackClient::SetPropertyChangeCallback(JackPropertyChangeCallback callback, v
     }
 }
 
+int JackClient::SetBudgetCallback(JackBudgetCallback callback, void *arg)
+{
+    if (IsActive()) {
+        jack_error("You cannot set callbacks on an active client");
+        return -1;
+    } else {
+        GetClientControl()->fCallback[kBudgetCallback] = (callback != NULL);
+        fBudgetArg = arg;
+        fBudget = callback;
+        return 0;
+    }
+}
+
 //------------------
 // Internal clients
 //------------------
@@ -29,6 +29,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackChannel.h"
 #include "JackRequest.h"
 #include "JackMetadata.h"
+#include "budget.h"
 #include "varargs.h"
 #include <list>
 
@@ -70,6 +71,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         JackSessionCallback fSession;
         JackLatencyCallback fLatency;
         JackPropertyChangeCallback fPropertyChange;
+        JackBudgetCallback fBudget;
 
         void* fProcessArg;
         void* fGraphOrderArg;
@@ -90,10 +92,13 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         void* fSessionArg;
         void* fLatencyArg;
         void* fPropertyChangeArg;
+        void* fBudgetArg;
 
         char fServerName[JACK_SERVER_NAME_SIZE+1];
 
         JackThread fThread;    /*! Thread to execute the Process function */
+        int fThreadCpu;        /*! CPU the RT thread is pinned to, -1 if none */
+        bool fThreadCpuFixed;  /*! Set when the CPU is chosen by the client instead of the server */
         detail::JackClientChannelInterface* fChannel;
         JackSynchro* fSynchroTable;
         std::list<jack_port_id_t> fPortList;
@@ -102,6 +107,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
 
         int StartThread();
         void SetupDriverSync(bool freewheel);
+        bool PortFullName(const char* port_name, std::string& port_full_name);
         bool IsActive();
 
         void CallSyncCallback();
@@ -123,6 +129,8 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         inline int ActivateAux();
         inline void InitAux();
         inline void SetupRealTime();
+        inline void SetupAffinity();
+        void SetThreadCpu(int cpu);
 
         int HandleLatencyCallback(int status);
 
@@ -143,6 +151,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
 
         virtual int Activate();
+        virtual int ActivateWithPorts(const char* const* port_names, const char* const* port_types, const unsigned long* flags, int count, jack_port_id_t* ports);
         virtual int Deactivate();
 
         // Context
@@ -170,6 +179,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int SetTimebaseCallback(int conditional, JackTimebaseCallback timebase_callback, void* arg);
         virtual void TransportLocate(jack_nframes_t frame);
         virtual jack_transport_state_t TransportQuery(jack_position_t* pos);
+        virtual jack_transport_state_t TransportQueryOffset(jack_nframes_t frame_offset, jack_position_t* pos);
         virtual jack_nframes_t GetCurrentTransportFrame();
         virtual int TransportReposition(const jack_position_t* pos);
         virtual void TransportStart();
@@ -192,6 +202,7 @@ class SERVER_EXPORT JackClient : public JackClientInterface, public JackRunnable
         virtual int SetSessionCallback(JackSessionCallback callback, void *arg);
         virtual int SetLatencyCallback(JackLatencyCallback callback, void *arg);
         virtual int SetPropertyChangeCallback(JackPropertyChangeCallback callback, void* arg);
+        virtual int SetBudgetCallback(JackBudgetCallback callback, void* arg);
 
         // Internal clients
         virtual char* GetInternalClientName(int ref);
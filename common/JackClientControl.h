@@ -46,6 +46,13 @@ struct JackClientControl : public JackShmMemAble
     int fPID;
     bool fActive;
 
+    // CPU budget statistics, updated by the server
+    UInt32 fBudgetViolations;   // Cycles over budget or not finished in time
+    UInt32 fBypassCount;        // Times the client has been bypassed
+    UInt32 fBypassedCycles;     // Cycles spent bypassed
+    jack_time_t fMaxProcessUsecs;
+    bool fBypassed;
+
     jack_uuid_t fSessionID;
     char fSessionCommand[JACK_SESSION_COMMAND_SIZE];
     jack_session_flags_t fSessionFlags;
@@ -76,6 +83,10 @@ struct JackClientControl : public JackShmMemAble
         fCallback[kRemoveClient] = true;
         fCallback[kActivateClient] = true;
         fCallback[kLatencyCallback] = true;
+        // So that new port chunks are mapped before the RT thread uses their ports
+        fCallback[kAddPortChunk] = true;
+        // So that the RT thread follows the CPU assigned by the server without any system call in the cycle
+        fCallback[kRealTimeCpu] = true;
         // So that driver synchro are correctly setup in "flush" or "normal" mode
         fCallback[kStartFreewheelCallback] = true;
         fCallback[kStopFreewheelCallback] = true;
@@ -85,6 +96,11 @@ struct JackClientControl : public JackShmMemAble
         fTransportSync = false;
         fTransportTimebase = false;
         fActive = false;
+        fBudgetViolations = 0;
+        fBypassCount = 0;
+        fBypassedCycles = 0;
+        fMaxProcessUsecs = 0;
+        fBypassed = false;
 
         fSessionID = uuid;
     }
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackGlobals.h"
 #include "JackError.h"
 #include <set>
+#include <algorithm>
 #include <iostream>
 #include <assert.h>
 
@@ -34,11 +35,11 @@ JackConnectionManager::JackConnectionManager()
     int i;
     jack_log("JackConnectionManager::InitConnections size = %ld ", sizeof(JackConnectionManager));
 
-    for (i = 0; i < PORT_NUM_MAX; i++) {
-        fConnection[i].Init();
-    }
-
+    fConnection.Init();
+    fInputPort.Init();
+    fOutputPort.Init();
     fLoopFeedback.Init();
+    fPipelineDepth = 0;
 
     jack_log("JackConnectionManager::InitClients");
     for (i = 0; i < CLIENT_NUM; i++) {
@@ -89,10 +90,14 @@ int JackConnectionManager::Connect(jack_port_id_t port_src, jack_port_id_t port_
 {
     jack_log("JackConnectionManager::Connect port_src = %ld port_dst = %ld", port_src, port_dst);
 
-    if (fConnection[port_src].AddItem(port_dst)) {
+    JackStateMarker marker = GetMarker();
+    if (fConnection.AddItem(port_src, port_dst, marker)) {
         return 0;
+    } else if (fConnection.GetItemCount(port_src) >= CONNECTION_NUM_FOR_PORT) {
+        jack_error("Connection table is full : a port can have at most %d connections", CONNECTION_NUM_FOR_PORT);
+        return -1;
     } else {
-        jack_error("Connection table is full !!");
+        jack_error("Connection table is full : the graph can have at most %d connections (see the --connections configure option)", CONNECTION_NUM);
         return -1;
     }
 }
@@ -104,7 +109,8 @@ int JackConnectionManager::Disconnect(jack_port_id_t port_src, jack_port_id_t po
 {
     jack_log("JackConnectionManager::Disconnect port_src = %ld port_dst = %ld", port_src, port_dst);
 
-    if (fConnection[port_src].RemoveItem(port_dst)) {
+    JackStateMarker marker = GetMarker();
+    if (fConnection.RemoveItem(port_src, port_dst, marker)) {
         return 0;
     } else {
         jack_error("Connection not found !!");
@@ -117,7 +123,7 @@ int JackConnectionManager::Disconnect(jack_port_id_t port_src, jack_port_id_t po
 */
 bool JackConnectionManager::IsConnected(jack_port_id_t port_src, jack_port_id_t port_dst) const
 {
-    return fConnection[port_src].CheckItem(port_dst);
+    return fConnection.CheckItem(port_src, port_dst);
 }
 
 /*!
@@ -125,7 +131,7 @@ bool JackConnectionManager::IsConnected(jack_port_id_t port_src, jack_port_id_t
 */
 const jack_int_t* JackConnectionManager::GetConnections(jack_port_id_t port_index) const
 {
-    return fConnection[port_index].GetItems();
+    return fConnection.GetItems(port_index);
 }
 
 //------------------------
@@ -137,7 +143,8 @@ const jack_int_t* JackConnectionManager::GetConnections(jack_port_id_t port_inde
 */
 int JackConnectionManager::AddInputPort(int refnum, jack_port_id_t port_index)
 {
-    if (fInputPort[refnum].AddItem(port_index)) {
+    JackStateMarker marker = GetMarker();
+    if (fInputPort.AddItem(refnum, port_index, marker)) {
         jack_log("JackConnectionManager::AddInputPort ref = %ld port = %ld", refnum, port_index);
         return 0;
     } else {
@@ -151,7 +158,8 @@ int JackConnectionManager::AddInputPort(int refnum, jack_port_id_t port_index)
 */
 int JackConnectionManager::AddOutputPort(int refnum, jack_port_id_t port_index)
 {
-    if (fOutputPort[refnum].AddItem(port_index)) {
+    JackStateMarker marker = GetMarker();
+    if (fOutputPort.AddItem(refnum, port_index, marker)) {
         jack_log("JackConnectionManager::AddOutputPort ref = %ld port = %ld", refnum, port_index);
         return 0;
     } else {
@@ -167,7 +175,8 @@ int JackConnectionManager::RemoveInputPort(int refnum, jack_port_id_t port_index
 {
     jack_log("JackConnectionManager::RemoveInputPort ref = %ld port_index = %ld ", refnum, port_index);
 
-    if (fInputPort[refnum].RemoveItem(port_index)) {
+    JackStateMarker marker = GetMarker();
+    if (fInputPort.RemoveItem(refnum, port_index, marker)) {
         return 0;
     } else {
         jack_error("Input port index = %ld not found for application ref = %ld", port_index, refnum);
@@ -182,7 +191,8 @@ int JackConnectionManager::RemoveOutputPort(int refnum, jack_port_id_t port_inde
 {
     jack_log("JackConnectionManager::RemoveOutputPort ref = %ld port_index = %ld ", refnum, port_index);
 
-    if (fOutputPort[refnum].RemoveItem(port_index)) {
+    JackStateMarker marker = GetMarker();
+    if (fOutputPort.RemoveItem(refnum, port_index, marker)) {
         return 0;
     } else {
         jack_error("Output port index = %ld not found for application ref = %ld", port_index, refnum);
@@ -195,7 +205,7 @@ int JackConnectionManager::RemoveOutputPort(int refnum, jack_port_id_t port_inde
 */
 const jack_int_t* JackConnectionManager::GetInputPorts(int refnum)
 {
-    return fInputPort[refnum].GetItems();
+    return fInputPort.GetItems(refnum);
 }
 
 /*!
@@ -203,7 +213,7 @@ const jack_int_t* JackConnectionManager::GetInputPorts(int refnum)
 */
 const jack_int_t* JackConnectionManager::GetOutputPorts(int refnum)
 {
-    return fOutputPort[refnum].GetItems();
+    return fOutputPort.GetItems(refnum);
 }
 
 /*!
@@ -211,10 +221,34 @@ const jack_int_t* JackConnectionManager::GetOutputPorts(int refnum)
 */
 void JackConnectionManager::InitRefNum(int refnum)
 {
-    fInputPort[refnum].Init();
-    fOutputPort[refnum].Init();
+    JackStateMarker marker = GetMarker();
+    fInputPort.Init(refnum, marker);
+    fOutputPort.Init(refnum, marker);
     fConnectionRef.Init(refnum);
     fInputCounter[refnum].SetValue(0);
+    fPipelineStage[refnum] = -1;
+    fPipelineCount[refnum] = 0;
+    Mark(&fConnectionRef, sizeof(fConnectionRef));
+    Mark(&fInputCounter[refnum], sizeof(fInputCounter[refnum]));
+    Mark(&fPipelineStage[refnum], sizeof(fPipelineStage[refnum]));
+    Mark(&fPipelineCount[refnum], sizeof(fPipelineCount[refnum]));
+    DeactivateRefNum(refnum);
+    UpdatePipeline();
+}
+
+void JackConnectionManager::ActivateRefNum(int refnum)
+{
+    if (!fActiveClient.CheckItem(refnum)) {
+        fActiveClient.AddItem(refnum);
+        Mark(&fActiveClient, sizeof(fActiveClient));
+    }
+}
+
+void JackConnectionManager::DeactivateRefNum(int refnum)
+{
+    if (fActiveClient.RemoveItem(refnum)) {
+        Mark(&fActiveClient, sizeof(fActiveClient));
+    }
 }
 
 /*!
@@ -223,9 +257,16 @@ void JackConnectionManager::InitRefNum(int refnum)
 void JackConnectionManager::ResetGraph(JackClientTiming* timing)
 {
     // Reset activation counter : must be done *before* starting to resume clients
-    for (int i = 0; i < CLIENT_NUM; i++) {
-        fInputCounter[i].Reset();
-        timing[i].fStatus = NotTriggered;
+    if (fPipelineDepth > 0) {
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            fInputCounter[i].Reset(fPipelineCount[i]);
+            timing[i].fStatus = NotTriggered;
+        }
+    } else {
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            fInputCounter[i].Reset();
+            timing[i].fStatus = NotTriggered;
+        }
     }
 }
 
@@ -247,25 +288,41 @@ int JackConnectionManager::SuspendRefNum(JackClientControl* control, JackSynchro
 */
 int JackConnectionManager::ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing)
 {
-    jack_time_t current_date = GetMicroSeconds();
-    const jack_int_t* output_ref = fConnectionRef.GetItems(control->fRefNum);
+    // A bypassed client finishing late must not activate its successors a second time
+    if (timing[control->fRefNum].fBypassed) {
+        return 0;
+    }
+
+    return ResumeOutputs(control->fRefNum, control, table, timing, GetMicroSeconds());
+}
+
+/*!
+\brief Signal clients connected to the given refnum, bypassed clients are not woken up : their own successors are signaled instead.
+*/
+int JackConnectionManager::ResumeOutputs(int refnum, JackClientControl* control, JackSynchro* table, JackClientTiming* timing, jack_time_t date)
+{
+    const jack_int_t* output_ref = fConnectionRef.GetItems(refnum);
     int res = 0;
 
     // Update state and timestamp of current client
-    timing[control->fRefNum].fStatus = Finished;
-    timing[control->fRefNum].fFinishedAt = current_date;
+    timing[refnum].fStatus = Finished;
+    timing[refnum].fFinishedAt = date;
 
     for (int i = 0; i < CLIENT_NUM; i++) {
 
-        // Signal connected clients or drivers
-        if (output_ref[i] > 0) {
+        // Signal connected clients or drivers, clients in a later pipeline stage will use this cycle data in the next one
+        if (output_ref[i] > 0 && !IsDelayedConnection(refnum, i)) {
 
             // Update state and timestamp of destination clients
             timing[i].fStatus = Triggered;
-            timing[i].fSignaledAt = current_date;
+            timing[i].fSignaledAt = date;
 
-            if (!fInputCounter[i].Signal(table + i, control)) {
-                jack_log("JackConnectionManager::ResumeRefNum error: ref = %ld output = %ld ", control->fRefNum, i);
+            if (timing[i].fBypassed) {
+                if (fInputCounter[i].Pass() && ResumeOutputs(i, control, table, timing, date) < 0) {
+                    res = -1;
+                }
+            } else if (!fInputCounter[i].Signal(table + i, control)) {
+                jack_log("JackConnectionManager::ResumeRefNum error: ref = %ld output = %ld ", refnum, i);
                 res = -1;
             }
         }
@@ -353,7 +410,10 @@ void JackConnectionManager::DirectConnect(int ref1, int ref2)
     if (fConnectionRef.IncItem(ref1, ref2) == 1) { // First connection between client ref1 and client ref2
         jack_log("JackConnectionManager::DirectConnect first: ref1 = %ld ref2 = %ld", ref1, ref2);
         fInputCounter[ref2].IncValue();
+        Mark(&fInputCounter[ref2], sizeof(fInputCounter[ref2]));
+        UpdatePipeline();
     }
+    Mark(&fConnectionRef.GetItems(ref1)[ref2], sizeof(jack_int_t));
 }
 
 /*!
@@ -366,7 +426,133 @@ void JackConnectionManager::DirectDisconnect(int ref1, int ref2)
     if (fConnectionRef.DecItem(ref1, ref2) == 0) { // Last connection between client ref1 and client ref2
         jack_log("JackConnectionManager::DirectDisconnect last: ref1 = %ld ref2 = %ld", ref1, ref2);
         fInputCounter[ref2].DecValue();
+        Mark(&fInputCounter[ref2], sizeof(fInputCounter[ref2]));
+        UpdatePipeline();
+    }
+    Mark(&fConnectionRef.GetItems(ref1)[ref2], sizeof(jack_int_t));
+}
+
+/*!
+\brief Set the number of pipeline stages - 1 (0 to run the graph normally).
+*/
+void JackConnectionManager::SetPipelineDepth(int depth)
+{
+    jack_log("JackConnectionManager::SetPipelineDepth depth = %ld", depth);
+    fPipelineDepth = depth;
+    Mark(&fPipelineDepth, sizeof(fPipelineDepth));
+    UpdatePipeline();
+}
+
+/*!
+\brief Compute pipeline stages and activation counts.
+
+Clients are ordered by their longest path from the drivers (following client to client connections only),
+then levels are evenly grouped in fPipelineDepth + 1 stages. Clients of a given stage are only activated by drivers
+and by clients of the same stage, so that each stage can run on cycle k + 1 while the next one is still on cycle k.
+A connection from stage s1 to stage s2 delays data by s2 - s1 cycles, so that all paths to a client are delayed alike.
+A client either gets all its inputs from its own stage, or all of them from earlier stages.
+*/
+void JackConnectionManager::UpdatePipeline()
+{
+    if (fPipelineDepth == 0) {
+        return;
     }
+
+    int driver_num = GetEngineControl()->fDriverNum;
+    int level[CLIENT_NUM];
+    jack_int_t pending[CLIENT_NUM];
+    jack_int_t ready[CLIENT_NUM];
+    int ready_count = 0;
+    int max_level = 0;
+
+    // Topological sort on client to client connections
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        level[i] = (i < driver_num) ? -1 : 0;
+        pending[i] = 0;
+        for (int j = driver_num; j < CLIENT_NUM && i >= driver_num; j++) {
+            if (j != i && fConnectionRef.GetItemCount(j, i) > 0) {
+                pending[i]++;
+            }
+        }
+        if (i >= driver_num && pending[i] == 0) {
+            ready[ready_count++] = i;
+        }
+    }
+
+    for (int k = 0; k < ready_count; k++) {
+        int ref1 = ready[k];
+        const jack_int_t* output_ref = fConnectionRef.GetItems(ref1);
+        for (int ref2 = driver_num; ref2 < CLIENT_NUM; ref2++) {
+            if (ref2 != ref1 && output_ref[ref2] > 0) {
+                level[ref2] = std::max(level[ref2], level[ref1] + 1);
+                max_level = std::max(max_level, level[ref2]);
+                if (--pending[ref2] == 0) {
+                    ready[ready_count++] = ref2;
+                }
+            }
+        }
+    }
+
+    // Group levels in stages
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        fPipelineStage[i] = (level[i] < 0) ? -1 : (level[i] * (fPipelineDepth + 1)) / (max_level + 1);
+    }
+
+    // A client fed by its own stage runs on the same cycle as it, and it cannot also mix data delayed from earlier stages :
+    // these earlier clients join its stage, and their outputs then move the following stages as needed
+    bool changed;
+    do {
+        changed = false;
+        for (int ref2 = driver_num; ref2 < CLIENT_NUM; ref2++) {
+            bool same = false;
+            bool earlier = false;
+            for (int ref1 = driver_num; ref1 < CLIENT_NUM; ref1++) {
+                if (ref1 != ref2 && fConnectionRef.GetItemCount(ref1, ref2) > 0) {
+                    same |= (fPipelineStage[ref1] == fPipelineStage[ref2]);
+                    earlier |= (fPipelineStage[ref1] < fPipelineStage[ref2]);
+                }
+            }
+            for (int ref1 = driver_num; ref1 < CLIENT_NUM && same && earlier; ref1++) {
+                if (ref1 != ref2 && fConnectionRef.GetItemCount(ref1, ref2) > 0 && fPipelineStage[ref1] < fPipelineStage[ref2]) {
+                    fPipelineStage[ref1] = fPipelineStage[ref2];
+                    changed = true;
+                }
+            }
+        }
+        for (int ref1 = driver_num; ref1 < CLIENT_NUM; ref1++) {
+            for (int ref2 = driver_num; ref2 < CLIENT_NUM; ref2++) {
+                if (ref1 != ref2 && fConnectionRef.GetItemCount(ref1, ref2) > 0 && fPipelineStage[ref2] < fPipelineStage[ref1]) {
+                    fPipelineStage[ref2] = fPipelineStage[ref1];
+                    changed = true;
+                }
+            }
+        }
+    } while (changed);
+
+    // Activation only comes from drivers and clients of the same stage
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        fPipelineCount[i] = 0;
+        for (int j = 0; j < CLIENT_NUM; j++) {
+            if (fConnectionRef.GetItemCount(j, i) > 0 && !IsDelayedConnection(j, i)) {
+                fPipelineCount[i]++;
+            }
+        }
+    }
+
+    Mark(&fPipelineStage, sizeof(fPipelineStage));
+    Mark(&fPipelineCount, sizeof(fPipelineCount));
+    jack_log("JackConnectionManager::UpdatePipeline levels = %ld stages = %ld", max_level + 1, std::min(max_level, fPipelineDepth) + 1);
+}
+
+/*!
+\brief Copy the state in dst, which was identical when it was last copied : only pages modified since then in either state are copied.
+*/
+void JackConnectionManager::CopyTo(JackConnectionManager* dst)
+{
+    size_t size = (const char*)&fModified - (const char*)this;
+    fModified.Copy((char*)dst, (const char*)this, size, dst->fModified);
+    fModified.Clear();
+    dst->fModified.Clear();
 }
 
 /*!
@@ -384,7 +570,7 @@ bool JackConnectionManager::IsDirectConnection(int ref1, int ref2) const
 int JackConnectionManager::GetInputRefNum(jack_port_id_t port_index) const
 {
     for (int i = 0; i < CLIENT_NUM; i++) {
-        if (fInputPort[i].CheckItem(port_index)) {
+        if (fInputPort.CheckItem(i, port_index)) {
             return i;
         }
     }
@@ -398,7 +584,7 @@ int JackConnectionManager::GetInputRefNum(jack_port_id_t port_index) const
 int JackConnectionManager::GetOutputRefNum(jack_port_id_t port_index) const
 {
     for (int i = 0; i < CLIENT_NUM; i++) {
-        if (fOutputPort[i].CheckItem(port_index)) {
+        if (fOutputPort.CheckItem(i, port_index)) {
             return i;
         }
     }
@@ -432,6 +618,7 @@ bool JackConnectionManager::IncFeedbackConnection(jack_port_id_t port_src, jack_
         DirectConnect(ref2, ref1);
     }
 
+    Mark(&fLoopFeedback, sizeof(fLoopFeedback));
     return fLoopFeedback.IncConnection(ref1, ref2); // Add the feedback connection
 }
 
@@ -448,6 +635,7 @@ bool JackConnectionManager::DecFeedbackConnection(jack_port_id_t port_src, jack_
         DirectDisconnect(ref2, ref1);
     }
 
+    Mark(&fLoopFeedback, sizeof(fLoopFeedback));
     return fLoopFeedback.DecConnection(ref1, ref2); // Remove the feedback connection
 }
 
@@ -22,10 +22,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackConstants.h"
 #include "JackActivationCount.h"
+#include "JackAtomicState.h"
 #include "JackError.h"
 #include "JackCompilerDeps.h"
 #include <vector>
 #include <assert.h>
+#include <string.h>
 
 namespace Jack
 {
@@ -43,7 +45,8 @@ class JackFixedArray
 
     private:
 
-        jack_int_t fTable[SIZE];
+        // GetItems gives a pointer to the table : keep it naturally aligned
+        MEM_ALIGN(jack_int_t fTable[SIZE], 2);
         uint32_t fCounter;
 
     public:
@@ -156,6 +159,193 @@ class JackFixedArray1 : public JackFixedArray<SIZE>
 
 } POST_PACKED_STRUCTURE;
 
+/*!
+\brief Set of variable size index arrays sharing a pool.
+
+Each array is a contiguous chunk of the pool terminated by EMPTY, so that it can be used like a JackFixedArray.
+Chunks are allocated at the top of the pool and grow by power of two, released chunks are only reused when the pool is compacted.
+Modifications are reported to the given marker, so that only modified parts are copied when the owning state is switched.
+*/
+
+PRE_PACKED_STRUCTURE
+template <int ARRAY_NUM, int POOL_SIZE, int ITEM_MAX>
+class JackArrayPool
+{
+
+    private:
+
+        uint32_t fOffset[ARRAY_NUM];
+        uint16_t fCapacity[ARRAY_NUM];      // Including the EMPTY terminator, 0 when no chunk is allocated
+        uint16_t fCounter[ARRAY_NUM];
+        uint32_t fTop;                      // Beginning of the free part of the pool
+        // Pointers to items are given to callers : previous fields keep them naturally aligned, and so does the packed owner
+        MEM_ALIGN(jack_int_t fEmpty, 2);
+        MEM_ALIGN(jack_int_t fPool[POOL_SIZE], 2);
+
+        static uint16_t GetCapacity(int count)
+        {
+            uint16_t capacity = 2;
+            while (capacity < count + 1) {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        void MarkArray(int array, JackStateMarker& marker)
+        {
+            marker.Mark(&fOffset[array], sizeof(fOffset[array]));
+            marker.Mark(&fCapacity[array], sizeof(fCapacity[array]));
+            marker.Mark(&fCounter[array], sizeof(fCounter[array]));
+            marker.Mark(&fTop, sizeof(fTop));
+        }
+
+        /*!
+        	\brief Move all chunks at the beginning of the pool, with the capacity they would get if allocated now.
+        */
+        void Compact(JackStateMarker& marker)
+        {
+            jack_int_t* items = new jack_int_t[fTop];
+            memcpy(items, fPool, fTop * sizeof(jack_int_t));
+            uint32_t top = 0;
+
+            for (int i = 0; i < ARRAY_NUM; i++) {
+                if (fCapacity[i] > 0) {
+                    uint16_t capacity = GetCapacity(fCounter[i]);
+                    memcpy(&fPool[top], &items[fOffset[i]], (fCounter[i] + 1) * sizeof(jack_int_t));
+                    fOffset[i] = top;
+                    fCapacity[i] = capacity;
+                    top += capacity;
+                }
+            }
+
+            jack_log("JackArrayPool::Compact used = %ld/%ld", top, POOL_SIZE);
+            fTop = top;
+            marker.Mark(this, sizeof(*this));
+            delete[] items;
+        }
+
+        bool Allocate(int array, uint16_t capacity, JackStateMarker& marker)
+        {
+            // Last chunk of the pool : grow it in place
+            if (fCapacity[array] > 0 && fOffset[array] + fCapacity[array] == fTop && fOffset[array] + capacity <= POOL_SIZE) {
+                fTop = fOffset[array] + capacity;
+                fCapacity[array] = capacity;
+                return true;
+            }
+
+            if (fTop + capacity > POOL_SIZE) {
+                Compact(marker);
+                if (fTop + capacity > POOL_SIZE) {
+                    return false;
+                }
+            }
+
+            if (fCapacity[array] > 0) {
+                memcpy(&fPool[fTop], &fPool[fOffset[array]], (fCounter[array] + 1) * sizeof(jack_int_t));
+            } else {
+                fPool[fTop] = EMPTY;
+            }
+
+            fOffset[array] = fTop;
+            fCapacity[array] = capacity;
+            fTop += capacity;
+            return true;
+        }
+
+    public:
+
+        JackArrayPool()
+        {
+            Init();
+        }
+
+        void Init()
+        {
+            for (int i = 0; i < ARRAY_NUM; i++) {
+                fOffset[i] = 0;
+                fCapacity[i] = 0;
+                fCounter[i] = 0;
+            }
+            fTop = 0;
+            fEmpty = EMPTY;
+        }
+
+        void Init(int array, JackStateMarker& marker)
+        {
+            // The chunk is lost until the next compaction, unless it is the last one
+            if (fCapacity[array] > 0 && fOffset[array] + fCapacity[array] == fTop) {
+                fTop = fOffset[array];
+            }
+            fCapacity[array] = 0;
+            fCounter[array] = 0;
+            MarkArray(array, marker);
+        }
+
+        bool AddItem(int array, jack_int_t index, JackStateMarker& marker)
+        {
+            if (fCounter[array] >= ITEM_MAX) {
+                return false;
+            }
+            if (fCounter[array] + 1 >= fCapacity[array] && !Allocate(array, GetCapacity(fCounter[array] + 1), marker)) {
+                return false;
+            }
+
+            jack_int_t* table = &fPool[fOffset[array]];
+            table[fCounter[array]++] = index;
+            table[fCounter[array]] = EMPTY;
+            marker.Mark(table, (fCounter[array] + 1) * sizeof(jack_int_t));
+            MarkArray(array, marker);
+            return true;
+        }
+
+        bool RemoveItem(int array, jack_int_t index, JackStateMarker& marker)
+        {
+            jack_int_t* table = &fPool[fOffset[array]];
+
+            for (int i = 0; i < fCounter[array]; i++) {
+                if (table[i] == index) {
+                    // Shift all indexes
+                    memmove(&table[i], &table[i + 1], (fCounter[array] - i) * sizeof(jack_int_t));
+                    marker.Mark(&table[i], (fCounter[array] - i) * sizeof(jack_int_t));
+                    if (--fCounter[array] == 0) {
+                        Init(array, marker);
+                    } else {
+                        MarkArray(array, marker);
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        jack_int_t GetItem(int array, jack_int_t index) const
+        {
+            return (index < fCounter[array]) ? fPool[fOffset[array] + index] : EMPTY;
+        }
+
+        const jack_int_t* GetItems(int array) const
+        {
+            return (fCapacity[array] > 0) ? &fPool[fOffset[array]] : &fEmpty;
+        }
+
+        bool CheckItem(int array, jack_int_t index) const
+        {
+            const jack_int_t* table = &fPool[fOffset[array]];
+
+            for (int i = 0; i < fCounter[array]; i++) {
+                if (table[i] == index)
+                    return true;
+            }
+            return false;
+        }
+
+        uint32_t GetItemCount(int array) const
+        {
+            return fCounter[array];
+        }
+
+} POST_PACKED_STRUCTURE;
+
 /*!
 \brief Utility class.
 */
@@ -377,6 +567,7 @@ struct JackClientTiming
     jack_time_t fAwakeAt;
     jack_time_t fFinishedAt;
     jack_client_state_t fStatus;
+    bool fBypassed;     // Set by the server, the client is skipped and its successors are resumed in its place
 
     JackClientTiming()
     {
@@ -391,6 +582,7 @@ struct JackClientTiming
         fAwakeAt = 0;
         fFinishedAt = 0;
         fStatus = NotTriggered;
+        fBypassed = false;
     }
 
 } POST_PACKED_STRUCTURE;
@@ -399,11 +591,14 @@ struct JackClientTiming
 \brief Connection manager.
 
 <UL>
-<LI>The <B>fConnection</B> array contains the list (array line) of connected ports for a given port.
-<LI>The <B>fInputPort</B> array contains the list (array line) of input connected  ports for a given client.
-<LI>The <B>fOutputPort</B> array contains the list (array line) of output connected  ports for a given client.
+<LI>The <B>fConnection</B> pool contains the list of connected ports for a given port.
+<LI>The <B>fInputPort</B> pool contains the list of input ports for a given client.
+<LI>The <B>fOutputPort</B> pool contains the list of output ports for a given client.
 <LI>The <B>fConnectionRef</B> array contains the number of ports connected between two clients.
 <LI>The <B>fInputCounter</B> array contains the number of input clients connected to a given for activation purpose.
+<LI>The <B>fPipelineStage</B> array contains the pipeline stage of each client when the graph is pipelined (freewheel mode).
+<LI>The <B>fActiveClient</B> array contains the refnums of the clients activated in the graph, for per cycle bookkeeping.
+<LI>The <B>fModified</B> pages are the ones written since the state was last copied, see CopyTo.
 </UL>
 */
 
@@ -413,14 +608,31 @@ class SERVER_EXPORT JackConnectionManager
 
     private:
 
-        JackFixedArray<CONNECTION_NUM_FOR_PORT> fConnection[PORT_NUM_MAX];  /*! Connection matrix: list of connected ports for a given port: needed to compute Mix buffer */
-        JackFixedArray1<PORT_NUM_FOR_CLIENT> fInputPort[CLIENT_NUM];	/*! Table of input port per refnum : to find a refnum for a given port */
-        JackFixedArray<PORT_NUM_FOR_CLIENT> fOutputPort[CLIENT_NUM];	/*! Table of output port per refnum : to find a refnum for a given port */
+        JackArrayPool<PORT_NUM_MAX, CONNECTION_POOL_SIZE, CONNECTION_NUM_FOR_PORT> fConnection;   /*! List of connected ports for a given port: needed to compute Mix buffer */
+        JackArrayPool<CLIENT_NUM, PORT_POOL_SIZE, PORT_NUM_FOR_CLIENT> fInputPort;               /*! Table of input port per refnum : to find a refnum for a given port */
+        JackArrayPool<CLIENT_NUM, PORT_POOL_SIZE, PORT_NUM_FOR_CLIENT> fOutputPort;              /*! Table of output port per refnum : to find a refnum for a given port */
         JackFixedMatrix<CLIENT_NUM> fConnectionRef;						/*! Table of port connections by (refnum , refnum) */
         JackActivationCount fInputCounter[CLIENT_NUM];					/*! Activation counter per refnum */
         JackLoopFeedback<CONNECTION_NUM_FOR_PORT> fLoopFeedback;		/*! Loop feedback connections */
+        int fPipelineDepth;                                             /*! Number of pipeline stages - 1, 0 when not pipelined */
+        int fPipelineStage[CLIENT_NUM];                                 /*! Pipeline stage per refnum, -1 for drivers */
+        jack_int_t fPipelineCount[CLIENT_NUM];                          /*! Activation count per refnum when pipelined */
+        JackFixedArray<CLIENT_NUM> fActiveClient;                       /*! Refnums of the clients activated in the graph */
+        JackStatePages fModified;                                       /*! Must stay the last field, not copied */
 
         bool IsLoopPathAux(int ref1, int ref2) const;
+        void UpdatePipeline();
+        int ResumeOutputs(int refnum, JackClientControl* control, JackSynchro* table, JackClientTiming* timing, jack_time_t date);
+
+        JackStateMarker GetMarker()
+        {
+            return JackStateMarker(&fModified, this);
+        }
+
+        void Mark(const void* addr, size_t size)
+        {
+            fModified.Mark((const char*)addr - (const char*)this, size);
+        }
 
     public:
 
@@ -437,13 +649,13 @@ class SERVER_EXPORT JackConnectionManager
         */
         jack_int_t Connections(jack_port_id_t port_index) const
         {
-            return fConnection[port_index].GetItemCount();
+            return fConnection.GetItemCount(port_index);
         }
 
         jack_port_id_t GetPort(jack_port_id_t port_index, int connection) const
         {
             assert(connection < CONNECTION_NUM_FOR_PORT);
-            return (jack_port_id_t)fConnection[port_index].GetItem(connection);
+            return (jack_port_id_t)fConnection.GetItem(port_index, connection);
         }
 
         const jack_int_t* GetConnections(jack_port_id_t port_index) const;
@@ -471,6 +683,16 @@ class SERVER_EXPORT JackConnectionManager
         int GetInputRefNum(jack_port_id_t port_index) const;
         int GetOutputRefNum(jack_port_id_t port_index) const;
 
+        // Active clients
+        void ActivateRefNum(int refnum);
+        void DeactivateRefNum(int refnum);
+
+        const jack_int_t* GetActiveRefNums(int* count) const
+        {
+            *count = fActiveClient.GetItemCount();
+            return fActiveClient.GetItems();
+        }
+
         // Connect/Disconnect 2 refnum "directly"
         bool IsDirectConnection(int ref1, int ref2) const;
         void DirectConnect(int ref1, int ref2);
@@ -481,14 +703,63 @@ class SERVER_EXPORT JackConnectionManager
             return fInputCounter[refnum].GetValue();
         }
 
+        // Pipelined graph
+        void SetPipelineDepth(int depth);
+        int GetPipelineDepth() const
+        {
+            return fPipelineDepth;
+        }
+
+        /*!
+          \brief Connections between clients of different pipeline stages do not activate the destination client, data is delayed.
+        */
+        bool IsDelayedConnection(int ref1, int ref2) const
+        {
+            return (fPipelineDepth > 0)
+                && (fPipelineStage[ref1] >= 0) && (fPipelineStage[ref2] >= 0)
+                && (fPipelineStage[ref1] != fPipelineStage[ref2]);
+        }
+
+        /*!
+          \brief Number of cycles data is delayed by between two clients, one per stage boundary.
+        */
+        int GetPipelineDelay(int ref1, int ref2) const
+        {
+            return IsDelayedConnection(ref1, ref2) ? fPipelineStage[ref2] - fPipelineStage[ref1] : 0;
+        }
+
+        /*!
+          \brief Pipeline stage of a client, 0 when not pipelined.
+        */
+        int GetPipelineStage(int refnum) const
+        {
+            return (fPipelineDepth > 0 && fPipelineStage[refnum] > 0) ? fPipelineStage[refnum] : 0;
+        }
+
         // Graph
         void ResetGraph(JackClientTiming* timing);
         int ResumeRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing);
         int SuspendRefNum(JackClientControl* control, JackSynchro* table, JackClientTiming* timing, long time_out_usec);
         void TopologicalSort(std::vector<jack_int_t>& sorted);
 
+        // State switch
+        void CopyTo(JackConnectionManager* dst);
+        void SetModified()
+        {
+            fModified.SetAll();
+        }
+
 } POST_PACKED_STRUCTURE;
 
+/*!
+\brief Used by JackAtomicState : only copy the pages modified in either state.
+*/
+
+inline void CopyState(JackConnectionManager* dst, JackConnectionManager* src)
+{
+    src->CopyTo(dst);
+}
+
 } // end of namespace
 
 #endif
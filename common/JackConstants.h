@@ -48,11 +48,27 @@
 #endif
 
 #ifndef PORT_NUM_MAX
-#define PORT_NUM_MAX 4096           // The "max" value for ports used in connection manager, although port number in graph manager is dynamic
+#define PORT_NUM_MAX 16384          // The "max" value for ports used in connection manager, the graph manager port table grows up to it
 #endif
 
+#ifndef PORT_CHUNK_SIZE
+#define PORT_CHUNK_SIZE 256         // Number of ports added each time the graph manager port table grows
+#endif
+
+#define PORT_CHUNK_NUM ((PORT_NUM_MAX + PORT_CHUNK_SIZE - 1) / PORT_CHUNK_SIZE)
+
 #define DRIVER_PORT_NUM 256
 
+#define RT_CPU_MAX 64               // CPUs that can be reserved for RT threads
+
+#define FREEWHEEL_PIPELINE_MAX 8    // Freewheel pipeline depth limit, transport positions of as many cycles are kept for later stages
+
+#define BUDGET_OVERRUN_MAX 3        // Consecutive cycles over budget before a client is bypassed
+
+#define JACK_PORT_BATCH_MAX 16     // Ports registered by a single PortRegisterActivate request
+
+#define NOTIFICATION_BATCH_MAX 32   // Notifications written to a client channel in a single write
+
 #ifndef PORT_NUM_FOR_CLIENT
 #define PORT_NUM_FOR_CLIENT 768
 #endif
@@ -61,6 +77,24 @@
 
 #define CONNECTION_NUM_FOR_PORT PORT_NUM_FOR_CLIENT
 
+#ifndef CONNECTION_NUM
+#define CONNECTION_NUM 8192         // Connections in the whole graph
+#endif
+
+// Shared by the connection lists of all ports : a connection is in the lists of both ports, and EMPTY terminated lists
+// grow by power of two, so that a compacted pool uses at most 4 entries per connection
+#define CONNECTION_POOL_SIZE (4 * CONNECTION_NUM)
+
+#define PORT_POOL_SIZE (2 * (PORT_NUM_MAX + CLIENT_NUM))    // Enough for all ports in the per client input or output lists
+
+#ifndef GRAPH_SNAPSHOT_PEER_NUM_FOR_PORT
+#define GRAPH_SNAPSHOT_PEER_NUM_FOR_PORT 8    // Average number of peers per port the published graph snapshot can hold
+#endif
+
+#define GRAPH_SNAPSHOT_READ_RETRY 1000        // A consistent snapshot is read in 1 or 2 tries, unless the server is gone
+
+// Client capacity, fixed when JACK is built (configure --clients) : it sizes the tables shared with clients
+// (connection matrix, activation counters, client timings). The client-max server parameter is only a lower limit.
 #ifndef CLIENT_NUM
 #define CLIENT_NUM 64
 #endif
@@ -72,7 +106,7 @@
 
 #define ALL_CLIENTS -1 // for notification
 
-#define JACK_PROTOCOL_VERSION 8
+#define JACK_PROTOCOL_VERSION 9
 
 #define SOCKET_TIME_OUT 2               // in sec
 #define DRIVER_OPEN_TIMEOUT 5           // in sec
@@ -58,6 +58,14 @@ static struct jack_constraint_enum_char_descriptor self_connect_mode_constraint_
     { 0 }
 };
 
+static struct jack_constraint_enum_char_descriptor clock_filter_constraint_descr_array[] =
+{
+    { 'd', "DLL with a fixed bandwidth" },
+    { 'a', "DLL with an adaptive bandwidth" },
+    { 'k', "Kalman filter" },
+    { 0 }
+};
+
 struct jackctl_server
 {
     JSList * drivers;
@@ -98,10 +106,38 @@ struct jackctl_server
     union jackctl_parameter_value port_max;
     union jackctl_parameter_value default_port_max;
 
+    /* uint32_t, maximum number of clients, drivers included */
+    union jackctl_parameter_value client_max;
+    union jackctl_parameter_value default_client_max;
+
     /* bool */
     union jackctl_parameter_value replace_registry;
     union jackctl_parameter_value default_replace_registry;
 
+    /* bool, back shared memory segments with huge pages */
+    union jackctl_parameter_value hugepages;
+    union jackctl_parameter_value default_hugepages;
+
+    /* bool, memfd shared memory segments passed to clients over their socket */
+    union jackctl_parameter_value memfd;
+    union jackctl_parameter_value default_memfd;
+
+    /* string, CPUs reserved for real-time threads */
+    union jackctl_parameter_value rt_cpus;
+    union jackctl_parameter_value default_rt_cpus;
+
+    /* string, CPU of some client real-time threads, chosen by client name */
+    union jackctl_parameter_value rt_client_cpus;
+    union jackctl_parameter_value default_rt_client_cpus;
+
+    /* uint32_t, percent of the period a client may use before being bypassed, 0 when not enforced */
+    union jackctl_parameter_value client_budget;
+    union jackctl_parameter_value default_client_budget;
+
+    /* char enum, filter of the driver wakeup dates */
+    union jackctl_parameter_value clock_filter;
+    union jackctl_parameter_value default_clock_filter;
+
     /* bool, synchronous or asynchronous engine mode */
     union jackctl_parameter_value sync;
     union jackctl_parameter_value default_sync;
@@ -109,6 +145,10 @@ struct jackctl_server
     /* char enum, self connect mode mode */
     union jackctl_parameter_value self_connect_mode;
     union jackctl_parameter_value default_self_connect_mode;
+
+    /* uint32_t, number of pipeline stages - 1 in freewheel mode */
+    union jackctl_parameter_value freewheel_pipeline;
+    union jackctl_parameter_value default_freewheel_pipeline;
 };
 
 struct jackctl_driver
@@ -874,7 +914,7 @@ SERVER_EXPORT jackctl_server_t * jackctl_server_create2(
           &server_ptr->parameters,
           "port-max",
           "Maximum number of ports.",
-          "",
+          "Number of ports allocated at startup. When they are all used, the port table grows by chunks, up to the value JACK was built with.",
           JackParamUInt,
           &server_ptr->port_max,
           &server_ptr->default_port_max,
@@ -883,6 +923,20 @@ SERVER_EXPORT jackctl_server_t * jackctl_server_create2(
         goto fail_free_parameters;
     }
 
+    value.ui = CLIENT_NUM;
+    if (jackctl_add_parameter(
+          &server_ptr->parameters,
+          "client-max",
+          "Client limit.",
+          "Limit on the number of clients, drivers included. It can only be lower than the client capacity JACK was built with, which also sizes the tables shared with clients.",
+          JackParamUInt,
+          &server_ptr->client_max,
+          &server_ptr->default_client_max,
+          value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
     value.b = false;
     if (jackctl_add_parameter(
             &server_ptr->parameters,
@@ -897,6 +951,93 @@ SERVER_EXPORT jackctl_server_t * jackctl_server_create2(
         goto fail_free_parameters;
     }
 
+    value.b = false;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "hugepages",
+            "Use huge pages for shared memory.",
+            "Back the shared memory segments of the server with huge pages from a writable hugetlbfs mount (or the one in JACK_HUGETLBFS), and fault them in when they are created. Segments use normal pages when no huge pages are available. Linux only.",
+            JackParamBool,
+            &server_ptr->hugepages,
+            &server_ptr->default_hugepages,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.b = false;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "memfd",
+            "Use memfd shared memory segments.",
+            "Create the shared memory segments of the server with memfd_create, and pass their descriptors to clients over their socket instead of having them open segments by name. Segments disappear with the server and its clients, even after a crash. Linux only.",
+            JackParamBool,
+            &server_ptr->memfd,
+            &server_ptr->default_memfd,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.str[0] = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "rt-cpus",
+            "CPUs reserved for real-time threads.",
+            "Comma separated list of CPUs or CPU ranges, like 2-5,8, reserved for real-time threads. The driver thread runs on the first one. Client real-time threads are spread over them following the graph order : clients that can run in parallel get different CPUs, a chain of clients stays on the same one. Other threads of the server, and threads started by clients afterwards, are kept off these CPUs. Linux only.",
+            JackParamString,
+            &server_ptr->rt_cpus,
+            &server_ptr->default_rt_cpus,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.str[0] = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "rt-client-cpus",
+            "CPU of client real-time threads, by client name.",
+            "Comma separated list of name:cpu entries, like synth:3,recorder:-1. The real-time thread of a client with that name runs on the given CPU instead of one chosen by the server, or is left unpinned with -1. The CPU does not need to be reserved with rt-cpus. A client can still choose its own CPU with the JACK_RT_CPU environment variable. Linux only.",
+            JackParamString,
+            &server_ptr->rt_client_cpus,
+            &server_ptr->default_rt_client_cpus,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.ui = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "client-budget",
+            "CPU budget of clients, in percent of the period.",
+            "Percent of the period a client process callback may take. A client exceeding it, or not finishing in time, for several cycles in a row is bypassed for about one second : its outputs are zeroed and the clients after it in the graph run without waiting for it. 0 disables the budget.",
+            JackParamUInt,
+            &server_ptr->client_budget,
+            &server_ptr->default_client_budget,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
+    value.c = 'd';
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "clock-filter",
+            "Filter of the driver wakeup dates.",
+            "Filter turning the driver wakeup dates into the frame time. The fixed DLL has a 1/8 Hz bandwidth. The adaptive DLL opens its bandwidth to lock and narrows it down to 1/32 Hz. The Kalman filter follows the measured jitter. Both use the hardware timestamps of the driver when it has them (ALSA).",
+            JackParamChar,
+            &server_ptr->clock_filter,
+            &server_ptr->default_clock_filter,
+            value,
+            jack_constraint_compose_enum_char(
+                JACK_CONSTRAINT_FLAG_STRICT | JACK_CONSTRAINT_FLAG_FAKE_VALUE,
+                clock_filter_constraint_descr_array)) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
     value.b = false;
     if (jackctl_add_parameter(
             &server_ptr->parameters,
@@ -928,6 +1069,20 @@ SERVER_EXPORT jackctl_server_t * jackctl_server_create2(
         goto fail_free_parameters;
     }
 
+    value.ui = 0;
+    if (jackctl_add_parameter(
+            &server_ptr->parameters,
+            "freewheel-pipeline",
+            "Freewheel pipeline depth.",
+            "Number of cycles a freewheel render may be pipelined over: clients are grouped in up to depth + 1 stages that process successive cycles concurrently, a connection adds one period of latency per stage boundary it crosses, and clients are given the transport position of the cycle their stage renders. 0 disables pipelining, 8 at most.",
+            JackParamUInt,
+            &server_ptr->freewheel_pipeline,
+            &server_ptr->default_freewheel_pipeline,
+            value) == NULL)
+    {
+        goto fail_free_parameters;
+    }
+
     JackServerGlobals::on_device_acquire = on_device_acquire;
     JackServerGlobals::on_device_release = on_device_release;
     JackServerGlobals::on_device_reservation_loop = on_device_reservation_loop;
@@ -1052,6 +1207,16 @@ jackctl_server_open(
             goto fail;
         }
 
+        /* check client max value before allocating server */
+        if (server_ptr->client_max.ui < 2 || server_ptr->client_max.ui > CLIENT_NUM) {
+            jack_error("Jack server started with %d clients (when client max has to be between 2 and %d, the limit JACK was configured with)", server_ptr->client_max.ui, CLIENT_NUM);
+            goto fail;
+        }
+
+        /* segments allocated from now on, graph manager and engine control included */
+        jack_set_shm_hugepages(server_ptr->hugepages.b);
+        jack_set_shm_memfd(server_ptr->memfd.b);
+
         /* get the engine/driver started */
         server_ptr->engine = new JackServer(
             server_ptr->sync.b,
@@ -1060,9 +1225,11 @@ jackctl_server_open(
             server_ptr->realtime.b,
             server_ptr->realtime_priority.i,
             server_ptr->port_max.ui,
+            server_ptr->client_max.ui,
             server_ptr->verbose.b,
             (jack_timer_type_t)server_ptr->clock_source.ui,
             server_ptr->self_connect_mode.c,
+            server_ptr->freewheel_pipeline.ui,
             server_ptr->name.str);
         if (server_ptr->engine == NULL)
         {
@@ -1070,6 +1237,11 @@ jackctl_server_open(
             goto fail_unregister;
         }
 
+        if (server_ptr->engine->SetRealTimeCpus(server_ptr->rt_cpus.str) < 0) goto fail_delete;
+        if (server_ptr->engine->SetClientCpus(server_ptr->rt_client_cpus.str) < 0) goto fail_delete;
+        if (server_ptr->engine->SetClientBudget(server_ptr->client_budget.ui) < 0) goto fail_delete;
+        if (server_ptr->engine->SetClockFilter(server_ptr->clock_filter.c) < 0) goto fail_delete;
+
         if (!jackctl_create_param_list(driver_ptr->parameters, &paramlist)) goto fail_delete;
         rc = server_ptr->engine->Open(driver_ptr->desc_ptr, paramlist);
         jackctl_destroy_param_list(paramlist);
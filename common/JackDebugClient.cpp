@@ -170,6 +170,34 @@ int JackDebugClient::Activate()
     return res;
 }
 
+int JackDebugClient::ActivateWithPorts(const char* const* port_names, const char* const* port_types, const unsigned long* flags, int count, jack_port_id_t* ports)
+{
+    CheckClient("ActivateWithPorts");
+    int res = fClient->ActivateWithPorts(port_names, port_types, flags, count, ports);
+    if (res == 0) {
+        for (int i = 0; i < count; i++) {
+            if (fTotalPortNumber < MAX_PORT_HISTORY) {
+                fPortList[fTotalPortNumber].idport = ports[i];
+                strcpy(fPortList[fTotalPortNumber].name, port_names[i]);
+                fPortList[fTotalPortNumber].IsConnected = 0;
+                fPortList[fTotalPortNumber].IsUnregistered = 0;
+            } else {
+                *fStream << "!!! WARNING !!! History is full : no more port history will be recorded." << endl;
+            }
+            fTotalPortNumber++;
+            fOpenPortNumber++;
+            *fStream << "Client '" << fClientName << "' port register with portname '" << port_names[i] << " port " << ports[i] << "' ." << endl;
+        }
+    }
+    fIsActivated++;
+    if (fIsDeactivated)
+        *fStream << "Client '" << fClientName << "' call activate a new time (it already call 'activate' previously)." << endl;
+    *fStream << "Client '" << fClientName << "' Activated with " << count << " ports" << endl;
+    if (res != 0)
+        *fStream << "Client '" << fClientName << "' try to activate with ports but server return " << res << " ." << endl;
+    return res;
+}
+
 int JackDebugClient::Deactivate()
 {
     CheckClient("Deactivate");
@@ -412,6 +440,12 @@ jack_transport_state_t JackDebugClient::TransportQuery(jack_position_t* pos)
     return fClient->TransportQuery(pos);
 }
 
+jack_transport_state_t JackDebugClient::TransportQueryOffset(jack_nframes_t frame_offset, jack_position_t* pos)
+{
+    CheckClient("TransportQueryOffset");
+    return fClient->TransportQueryOffset(frame_offset, pos);
+}
+
 jack_nframes_t JackDebugClient::GetCurrentTransportFrame()
 {
     CheckClient("GetCurrentTransportFrame");
@@ -489,6 +523,12 @@ int JackDebugClient::SetXRunCallback(JackXRunCallback callback, void *arg)
     return fClient->SetXRunCallback(callback, arg);
 }
 
+int JackDebugClient::SetBudgetCallback(JackBudgetCallback callback, void *arg)
+{
+    CheckClient("SetBudgetCallback");
+    return fClient->SetBudgetCallback(callback, arg);
+}
+
 int JackDebugClient::SetInitCallback(JackThreadInitCallback callback, void *arg)
 {
     CheckClient("SetInitCallback");
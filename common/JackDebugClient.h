@@ -78,6 +78,7 @@ class JackDebugClient : public JackClient
         int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
 
         int Activate();
+        int ActivateWithPorts(const char* const* port_names, const char* const* port_types, const unsigned long* flags, int count, jack_port_id_t* ports);
         int Deactivate();
 
         // Context
@@ -105,6 +106,7 @@ class JackDebugClient : public JackClient
         int SetTimebaseCallback(int conditional, JackTimebaseCallback timebase_callback, void* arg);
         void TransportLocate(jack_nframes_t frame);
         jack_transport_state_t TransportQuery(jack_position_t* pos);
+        jack_transport_state_t TransportQueryOffset(jack_nframes_t frame_offset, jack_position_t* pos);
         jack_nframes_t GetCurrentTransportFrame();
         int TransportReposition(const jack_position_t* pos);
         void TransportStart();
@@ -115,6 +117,7 @@ class JackDebugClient : public JackClient
         void OnInfoShutdown(JackInfoShutdownCallback callback, void *arg);
         int SetProcessCallback(JackProcessCallback callback, void* arg);
         int SetXRunCallback(JackXRunCallback callback, void* arg);
+        int SetBudgetCallback(JackBudgetCallback callback, void* arg);
         int SetInitCallback(JackThreadInitCallback callback, void* arg);
         int SetGraphOrderCallback(JackGraphOrderCallback callback, void* arg);
         int SetBufferSizeCallback(JackBufferSizeCallback callback, void* arg);
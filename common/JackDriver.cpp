@@ -49,6 +49,7 @@ JackDriver::JackDriver(const char* name, const char* alias, JackLockedEngine* en
     fEngine = engine;
     fGraphManager = NULL;
     fBeginDateUst = 0;
+    fHardwareDateUst = 0;
     fEndDateUst = 0;
     fDelayedUsecs = 0.f;
     fIsMaster = true;
@@ -189,7 +190,7 @@ bool JackDriver::IsRealTime() const
 
 void JackDriver::CycleIncTime()
 {
-    fEngineControl->CycleIncTime(fBeginDateUst);
+    fEngineControl->CycleIncTime(fBeginDateUst, fHardwareDateUst);
 }
 
 void JackDriver::CycleTakeBeginTime()
@@ -140,6 +140,7 @@ class SERVER_EXPORT JackDriver : public JackDriverClientInterface
         int fPlaybackChannels;
 
         jack_time_t fBeginDateUst;
+        jack_time_t fHardwareDateUst;   // Hardware date of the period, 0 if the driver has none
         jack_time_t fEndDateUst;
         float fDelayedUsecs;
 
@@ -23,6 +23,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackDriverInfo.h"
 #include "JackConstants.h"
 #include "JackError.h"
+#include "JackMessageBuffer.h"
 #include <getopt.h>
 #include <stdio.h>
 #include <errno.h>
@@ -808,6 +809,7 @@ JackDriverInfo::~JackDriverInfo()
 {
     delete fBackend;
     if (fHandle) {
+        Jack::JackMessageBuffer::Sync();
         UnloadDriverModule(fHandle);
     }
 }
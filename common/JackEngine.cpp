@@ -20,6 +20,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <iostream>
 #include <fstream>
 #include <set>
+#include <algorithm>
 #include <assert.h>
 #include <ctype.h>
 
@@ -52,9 +53,26 @@ JackEngine::JackEngine(JackGraphManager* manager,
     fSynchroTable = table;
     fEngineControl = control;
     fSelfConnectMode = self_connect_mode;
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    fClientTable = new JackClientInterface*[fEngineControl->fClientMax];
+    for (int i = 0; i < fEngineControl->fClientMax; i++) {
         fClientTable[i] = NULL;
     }
+    fClientList = new jack_int_t[fEngineControl->fClientMax];
+    fClientCount = 0;
+    fBudgetOverruns = new int[fEngineControl->fClientMax];
+    fBypassCycles = new int[fEngineControl->fClientMax];
+    for (int i = 0; i < fEngineControl->fClientMax; i++) {
+        fBudgetOverruns[i] = 0;
+        fBypassCycles[i] = 0;
+    }
+    fFreewheel = false;
+    fPendingNotifications = new std::vector<JackClientNotification>[fEngineControl->fClientMax];
+    fNotifyBatchDepth = 0;
+    fGraphSwitches = 0;
+    fGraphSwitchesNotified = 0;
+    fNotificationsSent = 0;
+    fNotificationsCoalesced = 0;
+    fGraphReordersCoalesced = 0;
     fLastSwitchUsecs = 0;
     fSessionPendingReplies = 0;
     fSessionTransaction = NULL;
@@ -62,7 +80,13 @@ JackEngine::JackEngine(JackGraphManager* manager,
 }
 
 JackEngine::~JackEngine()
-{}
+{
+    delete[] fClientTable;
+    delete[] fClientList;
+    delete[] fBudgetOverruns;
+    delete[] fBypassCycles;
+    delete[] fPendingNotifications;
+}
 
 int JackEngine::Open()
 {
@@ -80,19 +104,21 @@ int JackEngine::Open()
 int JackEngine::Close()
 {
     jack_log("JackEngine::Close");
+    jack_log("JackEngine::Close notifications sent = %lu coalesced = %lu graph reorders coalesced = %lu",
+             fNotificationsSent, fNotificationsCoalesced, fGraphReordersCoalesced);
     fChannel.Close();
 
     // Close remaining clients (RT is stopped)
-    for (int i = fEngineControl->fDriverNum; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(fEngineControl->fDriverNum - 1); i >= 0; i = NextClient(i)) {
         if (JackLoadableInternalClient* loadable_client = dynamic_cast<JackLoadableInternalClient*>(fClientTable[i])) {
             jack_log("JackEngine::Close loadable client = %s", loadable_client->GetClientControl()->fName);
             loadable_client->Close();
-            fClientTable[i] = NULL;
+            SetClient(i, NULL);
             delete loadable_client;
         } else if (JackExternalClient* external_client = dynamic_cast<JackExternalClient*>(fClientTable[i])) {
             jack_log("JackEngine::Close external client = %s", external_client->GetClientControl()->fName);
             external_client->Close();
-            fClientTable[i] = NULL;
+            SetClient(i, NULL);
             delete external_client;
         }
     }
@@ -112,27 +138,27 @@ void JackEngine::NotifyQuit()
 
 int JackEngine::AllocateRefnum()
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = 0; i < fEngineControl->fClientMax; i++) {
         if (!fClientTable[i]) {
             jack_log("JackEngine::AllocateRefNum ref = %ld", i);
             return i;
         }
     }
+    if (fEngineControl->fClientMax < CLIENT_NUM) {
+        jack_error("JackEngine::AllocateRefnum all %d clients are used, as limited by the client-max server parameter", fEngineControl->fClientMax);
+    } else {
+        jack_error("JackEngine::AllocateRefnum all %d clients are used, the capacity JACK was built with", fEngineControl->fClientMax);
+    }
     return -1;
 }
 
 void JackEngine::ReleaseRefnum(int refnum)
 {
-    fClientTable[refnum] = NULL;
+    SetClient(refnum, NULL);
+    fPendingNotifications[refnum].clear();
 
     if (fEngineControl->fTemporary) {
-        int i;
-        for (i = fEngineControl->fDriverNum; i < CLIENT_NUM; i++) {
-            if (fClientTable[i]) {
-                break;
-            }
-        }
-        if (i == CLIENT_NUM) {
+        if (NextClient(fEngineControl->fDriverNum - 1) < 0) {
             // Last client and temporary case: quit the server
             jack_log("JackEngine::ReleaseRefnum server quit");
             fEngineControl->fTemporary = false;
@@ -141,6 +167,53 @@ void JackEngine::ReleaseRefnum(int refnum)
     }
 }
 
+void JackEngine::SetClient(int refnum, JackClientInterface* client)
+{
+    int pos = 0;
+    while (pos < fClientCount && fClientList[pos] < refnum) {
+        pos++;
+    }
+    bool present = (pos < fClientCount && fClientList[pos] == refnum);
+
+    // Keep the list in refnum order, the order notifications have always been sent in
+    if (client && !present) {
+        memmove(&fClientList[pos + 1], &fClientList[pos], (fClientCount - pos) * sizeof(jack_int_t));
+        fClientList[pos] = refnum;
+        fClientCount++;
+    } else if (!client && present) {
+        memmove(&fClientList[pos], &fClientList[pos + 1], (fClientCount - pos - 1) * sizeof(jack_int_t));
+        fClientCount--;
+    }
+
+    fClientTable[refnum] = client;
+}
+
+bool JackEngine::CheckClient(int refnum)
+{
+    return (refnum >= 0 && refnum < fEngineControl->fClientMax && fClientTable[refnum] != NULL);
+}
+
+/*
+Loops on clients follow the refnum of the previous one, so that they stay correct
+when clients come or go meanwhile (notifications of internal clients unlock the engine).
+*/
+int JackEngine::NextClient(int refnum)
+{
+    int low = 0;
+    int high = fClientCount;
+
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (fClientList[mid] <= refnum) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return (low < fClientCount) ? fClientList[low] : -1;
+}
+
 //------------------
 // Graph management
 //------------------
@@ -149,6 +222,7 @@ void JackEngine::ProcessNext(jack_time_t cur_cycle_begin)
 {
     fLastSwitchUsecs = cur_cycle_begin;
     if (fGraphManager->RunNextGraph())  {   // True if the graph actually switched to a new state
+        fGraphSwitches++;
         fChannel.Notify(ALL_CLIENTS, kGraphOrderCallback, 0);
     }
     fSignal.Signal();                       // Signal for threads waiting for next cycle
@@ -169,6 +243,11 @@ bool JackEngine::Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end
     // Cycle  begin
     fEngineControl->CycleBegin(fClientTable, fGraphManager, cur_cycle_begin, prev_cycle_end);
 
+    // Before the graph is reset, timings of the previous cycle are still available
+    if (fEngineControl->fClientBudget > 0) {
+        CheckBudget();
+    }
+
     // Graph
     if (fGraphManager->IsFinishedGraph()) {
         ProcessNext(cur_cycle_begin);
@@ -187,7 +266,7 @@ bool JackEngine::Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end
     }
 
     // Cycle end
-    fEngineControl->CycleEnd(fClientTable);
+    fEngineControl->CycleEnd(fClientTable, fGraphManager);
     return res;
 }
 
@@ -214,9 +293,13 @@ static const char* State2String(jack_client_state_t state)
 
 void JackEngine::CheckXRun(jack_time_t callback_usecs)  // REVOIR les conditions de fin
 {
-    for (int i = fEngineControl->fDriverNum; i < CLIENT_NUM; i++) {
+    int count;
+    const jack_int_t* active = fGraphManager->GetActiveRefNums(&count);
+
+    for (int pos = 0; pos < count; pos++) {
+        int i = active[pos];
         JackClientInterface* client = fClientTable[i];
-        if (client && client->GetClientControl()->fActive) {
+        if (i >= fEngineControl->fDriverNum && client && client->GetClientControl()->fActive) {
             JackClientTiming* timing = fGraphManager->GetClientTiming(i);
             jack_client_state_t status = timing->fStatus;
             jack_time_t finished_date = timing->fFinishedAt;
@@ -234,6 +317,85 @@ void JackEngine::CheckXRun(jack_time_t callback_usecs)  // REVOIR les conditions
     }
 }
 
+/*!
+\brief Check the last cycle of each client against the budget, and bypass the clients that are repeatedly over it.
+
+A client is over budget when its process callback took longer than the budget, or when it had not finished at the beginning
+of the next cycle. After BUDGET_OVERRUN_MAX cycles over budget in a row, the client is bypassed for about one second :
+it is not woken up anymore, the clients connected after it are resumed in its place and its output buffers are cleared.
+*/
+void JackEngine::CheckBudget()
+{
+    jack_time_t budget = fEngineControl->fPeriodUsecs * fEngineControl->fClientBudget / 100;
+    int count;
+    const jack_int_t* active = fGraphManager->GetActiveRefNums(&count);
+
+    for (int pos = 0; pos < count; pos++) {
+        int i = active[pos];
+        JackClientInterface* client = fClientTable[i];
+        if (i < fEngineControl->fDriverNum || !client || !client->GetClientControl()->fActive) {
+            continue;
+        }
+
+        JackClientControl* control = client->GetClientControl();
+        JackClientTiming* timing = fGraphManager->GetClientTiming(i);
+
+        if (timing->fBypassed) {
+            control->fBypassedCycles++;
+            // Freewheel rendering does not drop clients
+            if (--fBypassCycles[i] > 0 && !fFreewheel) {
+                // Also cleared each cycle in case the client was still running when bypassed
+                fGraphManager->ClearOutputBuffers(i, fEngineControl->fBufferSize);
+            } else {
+                SetClientBypass(i, false);
+            }
+            continue;
+        }
+
+        if (fFreewheel || timing->fStatus == NotTriggered) {
+            continue;
+        }
+
+        bool overrun;
+        if (timing->fStatus == Finished) {
+            jack_time_t duration = timing->fFinishedAt - timing->fAwakeAt;
+            control->fMaxProcessUsecs = std::max(control->fMaxProcessUsecs, duration);
+            overrun = (duration > budget);
+        } else {
+            overrun = true;
+        }
+
+        if (!overrun) {
+            fBudgetOverruns[i] = 0;
+        } else {
+            control->fBudgetViolations++;
+            if (++fBudgetOverruns[i] >= BUDGET_OVERRUN_MAX) {
+                SetClientBypass(i, true);
+            }
+        }
+    }
+}
+
+// RT
+void JackEngine::SetClientBypass(int refnum, bool onoff)
+{
+    JackClientControl* control = fClientTable[refnum]->GetClientControl();
+    JackClientTiming* timing = fGraphManager->GetClientTiming(refnum);
+
+    fBudgetOverruns[refnum] = 0;
+    timing->fBypassed = onoff;
+    control->fBypassed = onoff;
+
+    if (onoff) {
+        fBypassCycles[refnum] = std::max(1, int(fEngineControl->fSampleRate / fEngineControl->fBufferSize));
+        fGraphManager->ClearOutputBuffers(refnum, fEngineControl->fBufferSize);
+        control->fBypassCount++;
+    }
+
+    // Use the audio thread => request thread communication channel
+    fChannel.Notify(refnum, kBudgetCallback, onoff);
+}
+
 int JackEngine::ComputeTotalLatencies()
 {
     std::vector<jack_int_t> sorted;
@@ -259,6 +421,74 @@ int JackEngine::ComputeTotalLatencies()
     return 0;
 }
 
+int JackEngine::SetClientCpu(const char* name, int cpu)
+{
+    jack_log("JackEngine::SetClientCpu name = %s cpu = %d", name, cpu);
+    fClientCpuMap[name] = cpu;
+    return 0;
+}
+
+/*!
+\brief Spread client RT threads over the CPUs reserved for RT threads, following the graph order.
+
+Clients are grouped by level : a client is one level after the deepest client it depends on. Clients of the same
+level can run in parallel and get different CPUs, while the first client of each level gets the first CPU,
+so that a chain of clients stays on the CPU of the driver thread, which waits for them in synchronous mode.
+Clients with a CPU chosen by name keep it and are not counted in the spreading.
+*/
+void JackEngine::AssignClientCpus()
+{
+    int cpu_count = fEngineControl->fRTCpuCount;
+    if (cpu_count == 0 && fClientCpuMap.empty()) {
+        return;
+    }
+
+    std::vector<jack_int_t> sorted;
+    std::vector<int> level(fEngineControl->fClientMax, 0);
+    std::vector<int> placed;
+    int cpu[CLIENT_NUM];
+
+    fGraphManager->TopologicalSort(sorted);
+
+    for (int i = 0; i < CLIENT_NUM; i++) {
+        cpu[i] = -1;
+    }
+
+    for (size_t i = 0; i < sorted.size(); i++) {
+        int refnum = sorted[i];
+        if (refnum < fEngineControl->fDriverNum) {
+            continue;
+        }
+        std::map<std::string,int>::const_iterator it = (fClientTable[refnum])
+            ? fClientCpuMap.find(fClientTable[refnum]->GetClientControl()->fName) : fClientCpuMap.end();
+        if (it != fClientCpuMap.end()) {
+            cpu[refnum] = it->second;
+            continue;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (fGraphManager->IsDirectConnection(sorted[j], refnum)) {
+                level[refnum] = std::max(level[refnum], level[sorted[j]] + 1);
+            }
+        }
+        if (cpu_count == 0) {
+            continue;
+        }
+        if ((int)placed.size() <= level[refnum]) {
+            placed.resize(level[refnum] + 1, 0);
+        }
+        cpu[refnum] = fEngineControl->fRTCpus[placed[level[refnum]]++ % cpu_count];
+    }
+
+    // Clients move their RT thread from their notification thread, the cycle does no system call
+    for (int i = fEngineControl->fDriverNum; i < fEngineControl->fClientMax; i++) {
+        if (fEngineControl->fClientCpu[i] != cpu[i]) {
+            jack_log("JackEngine::AssignClientCpus ref = %d cpu = %d", i, cpu[i]);
+            fEngineControl->fClientCpu[i] = cpu[i];
+            NotifyClient(i, kRealTimeCpu, false, "", cpu[i], 0);
+        }
+    }
+}
+
 //--------------
 // Metadata API
 //--------------
@@ -267,7 +497,7 @@ int JackEngine::PropertyChangeNotify(jack_uuid_t subject, const char* key, jack_
 {
     jack_log("JackEngine::PropertyChangeNotify: subject = %x key = %s change = %x", subject, key, change);
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client) {
             char buf[JACK_UUID_STRING_SIZE];
@@ -295,7 +525,14 @@ int JackEngine::ClientNotify(JackClientInterface* client, int refnum, const char
 
     // External client
     if (dynamic_cast<JackExternalClient*>(client)) {
-       res1 = client->ClientNotify(refnum, name, notify, sync, message, value1, value2);
+        int client_refnum = client->GetClientControl()->fRefNum;
+        if (!sync && fNotifyBatchDepth > 0) {
+            QueueNotification(client_refnum, refnum, name, notify, message, value1, value2);
+            return 0;
+        }
+        // Queued notifications first, to keep their order
+        FlushNotifications(client_refnum);
+        res1 = client->ClientNotify(refnum, name, notify, sync, message, value1, value2);
     // Important for internal client : unlock before calling the notification callbacks
     } else {
         bool res2 = Unlock();
@@ -305,12 +542,53 @@ int JackEngine::ClientNotify(JackClientInterface* client, int refnum, const char
         }
     }
 
+    fNotificationsSent++;
     if (res1 < 0) {
         jack_error("ClientNotify fails name = %s notification = %ld val1 = %ld val2 = %ld", name, notify, value1, value2);
     }
     return res1;
 }
 
+void JackEngine::QueueNotification(int client_refnum, int refnum, const char* name, int notify, const char* message, int value1, int value2)
+{
+    JackClientNotification event(name, refnum, notify, false, message, value1, value2);
+    if (JackClientNotificationBatch::Queue(fPendingNotifications[client_refnum], event)) {
+        fNotificationsCoalesced++;
+    }
+}
+
+void JackEngine::FlushNotifications(int client_refnum)
+{
+    std::vector<JackClientNotification>& pending = fPendingNotifications[client_refnum];
+    if (pending.empty()) {
+        return;
+    }
+
+    // Dropped if the client is already gone
+    JackExternalClient* client = dynamic_cast<JackExternalClient*>(fClientTable[client_refnum]);
+    if (client) {
+        if (client->ClientNotify(&pending[0], pending.size()) < 0) {
+            jack_error("FlushNotifications fails name = %s count = %ld", client->GetClientControl()->fName, pending.size());
+        }
+        fNotificationsSent += pending.size();
+    }
+    pending.clear();
+}
+
+void JackEngine::BeginNotifyBatch()
+{
+    fNotifyBatchDepth++;
+}
+
+void JackEngine::EndNotifyBatch()
+{
+    if (--fNotifyBatchDepth == 0) {
+        for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
+            FlushNotifications(i);
+        }
+    }
+}
+
 void JackEngine::NotifyClient(int refnum, int event, int sync, const char* message, int value1, int value2)
 {
     JackClientInterface* client = fClientTable[refnum];
@@ -321,7 +599,7 @@ void JackEngine::NotifyClient(int refnum, int event, int sync, const char* messa
 
 void JackEngine::NotifyClients(int event, int sync, const char* message, int value1, int value2)
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         NotifyClient(i, event, sync, message, value1, value2);
     }
 }
@@ -331,7 +609,7 @@ int JackEngine::NotifyAddClient(JackClientInterface* new_client, const char* new
     jack_log("JackEngine::NotifyAddClient: name = %s", new_name);
 
     // Notify existing clients of the new client and new client of existing clients.
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* old_client = fClientTable[i];
         if (old_client && old_client != new_client) {
             char* old_name = old_client->GetClientControl()->fName;
@@ -352,7 +630,7 @@ int JackEngine::NotifyAddClient(JackClientInterface* new_client, const char* new
 void JackEngine::NotifyRemoveClient(const char* name, int refnum)
 {
     // Notify existing clients (including the one being suppressed) of the removed client
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client) {
             ClientNotify(client, refnum, name, kRemoveClient, false, "", 0, 0);
@@ -376,9 +654,32 @@ void JackEngine::NotifyClientXRun(int refnum)
     }
 }
 
+void JackEngine::NotifyClientBudget(int refnum, int onoff)
+{
+    JackClientInterface* client = fClientTable[refnum];
+    if (client) {
+        const char* name = client->GetClientControl()->fName;
+        if (onoff) {
+            jack_error("JackEngine::NotifyClientBudget: client %s is repeatedly over its CPU budget, bypassed", name);
+        } else {
+            jack_info("JackEngine::NotifyClientBudget: client %s is not bypassed anymore", name);
+        }
+        NotifyClients(kBudgetCallback, false, name, onoff, 0);
+    }
+}
+
 void JackEngine::NotifyGraphReorder()
 {
+    // A previous reorder already saw the current graph when several switches were notified in a row
+    UInt32 switches = fGraphSwitches;
+    if (switches == fGraphSwitchesNotified) {
+        fGraphReordersCoalesced++;
+        return;
+    }
+    fGraphSwitchesNotified = switches;
+
     ComputeTotalLatencies();
+    AssignClientCpus();
     NotifyClients(kGraphOrderCallback, false, "", 0, 0);
 }
 
@@ -399,6 +700,7 @@ void JackEngine::NotifyFailure(int code, const char* reason)
 
 void JackEngine::NotifyFreewheel(bool onoff)
 {
+    fFreewheel = onoff;
     if (onoff) {
         // Save RT state
         fEngineControl->fSavedRealTime = fEngineControl->fRealTime;
@@ -448,7 +750,7 @@ int JackEngine::InternalClientHandle(const char* client_name, int* status, int*
     // Clear status
     *status = 0;
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && dynamic_cast<JackLoadableInternalClient*>(client) && (strcmp(client->GetClientControl()->fName, client_name) == 0)) {
             jack_log("InternalClientHandle found client name = %s ref = %ld",  client_name, i);
@@ -551,7 +853,7 @@ bool JackEngine::GenerateUniqueName(char* name)
 
 bool JackEngine::ClientCheckName(const char* name)
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && (strcmp(client->GetClientControl()->fName, name) == 0)) {
             return true;
@@ -572,7 +874,7 @@ void JackEngine::EnsureUUID(jack_uuid_t uuid)
     if (jack_uuid_empty(uuid))
         return;
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && jack_uuid_compare(client->GetClientControl()->fSessionID, uuid) == 0) {
             // FIXME? this code does nothing, but jack1 has it like this too..
@@ -584,7 +886,7 @@ void JackEngine::EnsureUUID(jack_uuid_t uuid)
 
 int JackEngine::GetClientPID(const char* name)
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && (strcmp(client->GetClientControl()->fName, name) == 0)) {
             return client->GetClientControl()->fPID;
@@ -596,7 +898,7 @@ int JackEngine::GetClientPID(const char* name)
 
 int JackEngine::GetClientRefNum(const char* name)
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && (strcmp(client->GetClientControl()->fName, name) == 0)) {
             return client->GetClientControl()->fRefNum;
@@ -651,7 +953,7 @@ int JackEngine::ClientExternalOpen(const char* name, int pid, jack_uuid_t uuid,
         goto error;
     }
 
-    fClientTable[refnum] = client;
+    SetClient(refnum, client);
 
     if (NotifyAddClient(client, real_name, refnum) < 0) {
         jack_error("Cannot notify add client");
@@ -668,7 +970,7 @@ int JackEngine::ClientExternalOpen(const char* name, int pid, jack_uuid_t uuid,
 error:
     // Cleanup...
     fSynchroTable[refnum].Destroy();
-    fClientTable[refnum] = 0;
+    SetClient(refnum, NULL);
     client->Close();
     delete client;
     return -1;
@@ -696,7 +998,7 @@ int JackEngine::ClientInternalOpen(const char* name, int* ref, JackEngineControl
         goto error;
     }
 
-    fClientTable[refnum] = client;
+    SetClient(refnum, client);
 
     if (NotifyAddClient(client, name, refnum) < 0) {
         jack_error("Cannot notify add client");
@@ -713,7 +1015,7 @@ int JackEngine::ClientInternalOpen(const char* name, int* ref, JackEngineControl
 error:
     // Cleanup...
     fSynchroTable[refnum].Destroy();
-    fClientTable[refnum] = 0;
+    SetClient(refnum, NULL);
     return -1;
 }
 
@@ -760,6 +1062,9 @@ int JackEngine::ClientCloseAux(int refnum, bool wait)
         PortUnRegister(refnum, ports[i]);
     }
 
+    // The client still gets what was queued for it, before its channel is closed
+    FlushNotifications(refnum);
+
     // Remove the client from the table
     ReleaseRefnum(refnum);
 
@@ -794,6 +1099,12 @@ int JackEngine::ClientActivate(int refnum, bool is_real_time)
     JackClientInterface* client = fClientTable[refnum];
     jack_log("JackEngine::ClientActivate ref = %ld name = %s", refnum, client->GetClientControl()->fName);
 
+    // A client bypassed before being deactivated starts again with a clean state
+    fGraphManager->GetClientTiming(refnum)->fBypassed = false;
+    client->GetClientControl()->fBypassed = false;
+    fBudgetOverruns[refnum] = 0;
+    fBypassCycles[refnum] = 0;
+
     if (is_real_time) {
         fGraphManager->Activate(refnum);
     }
@@ -877,20 +1188,31 @@ void JackEngine::ClientKill(int refnum)
 // Port management
 //-----------------
 
-int JackEngine::PortRegister(int refnum, const char* name, const char *type, unsigned int flags, unsigned int buffer_size, jack_port_id_t* port_index)
+int JackEngine::PortRegisterAux(int refnum, const char* name, const char *type, unsigned int flags, jack_port_id_t* port_index)
 {
-    jack_log("JackEngine::PortRegister ref = %ld name = %s type = %s flags = %d buffer_size = %d", refnum, name, type, flags, buffer_size);
-    JackClientInterface* client = fClientTable[refnum];
-
     // Check if port name already exists
     if (fGraphManager->GetPort(name) != NO_PORT) {
         jack_error("port_name \"%s\" already exists", name);
         return -1;
     }
 
-    // buffer_size is actually ignored...
+    unsigned int chunk_count = fGraphManager->GetPortChunkCount();
     *port_index = fGraphManager->AllocatePort(refnum, name, type, (JackPortFlags)flags, fEngineControl->fBufferSize);
-    if (*port_index != NO_PORT) {
+
+    // The port table grew : all clients, whatever their callbacks, map the new chunk before any of its ports is used
+    if (fGraphManager->GetPortChunkCount() != chunk_count) {
+        NotifyClients(kAddPortChunk, true, "", chunk_count, fGraphManager->GetPortChunkIndex(chunk_count));
+    }
+    return (*port_index != NO_PORT) ? 0 : -1;
+}
+
+int JackEngine::PortRegister(int refnum, const char* name, const char *type, unsigned int flags, unsigned int buffer_size, jack_port_id_t* port_index)
+{
+    jack_log("JackEngine::PortRegister ref = %ld name = %s type = %s flags = %d buffer_size = %d", refnum, name, type, flags, buffer_size);
+    JackClientInterface* client = fClientTable[refnum];
+
+    // buffer_size is actually ignored...
+    if (PortRegisterAux(refnum, name, type, flags, port_index) == 0) {
         if (client->GetClientControl()->fActive) {
             NotifyPortRegistation(*port_index, true);
         }
@@ -900,6 +1222,31 @@ int JackEngine::PortRegister(int refnum, const char* name, const char *type, uns
     }
 }
 
+int JackEngine::PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port_index, bool is_real_time)
+{
+    jack_log("JackEngine::PortRegisterActivate ref = %ld count = %ld", refnum, count);
+    int registered;
+
+    // All ports are added in a single graph state, their registration is notified by ClientActivate
+    fGraphManager->BeginUpdate();
+    for (registered = 0; registered < count; registered++) {
+        if (PortRegisterAux(refnum, names[registered], types[registered], flags[registered], &port_index[registered]) < 0) {
+            break;
+        }
+    }
+    if (registered < count) {
+        for (int i = 0; i < registered; i++) {
+            fGraphManager->ReleasePort(refnum, port_index[i]);
+        }
+        for (int i = 0; i < count; i++) {
+            port_index[i] = NO_PORT;
+        }
+    }
+    fGraphManager->EndUpdate();
+
+    return (registered < count) ? -1 : ClientActivate(refnum, is_real_time);
+}
+
 int JackEngine::PortUnRegister(int refnum, jack_port_id_t port_index)
 {
     jack_log("JackEngine::PortUnRegister ref = %ld port_index = %ld", refnum, port_index);
@@ -1119,7 +1466,7 @@ void JackEngine::SessionNotify(int refnum, const char *target, jack_session_even
         return;
     }
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && jack_uuid_empty(client->GetClientControl()->fSessionID)) {
             client->GetClientControl()->fSessionID = jack_client_uuid_generate();
@@ -1127,7 +1474,7 @@ void JackEngine::SessionNotify(int refnum, const char *target, jack_session_even
     }
     fSessionResult = new JackSessionNotifyResult();
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
         if (client && client->GetClientControl()->fCallback[kSessionCallback]) {
 
@@ -1199,7 +1546,7 @@ int JackEngine::SessionReply(int refnum)
 
 int JackEngine::GetUUIDForClientName(const char *client_name, char *uuid_res)
 {
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
 
         if (client && (strcmp(client_name, client->GetClientControl()->fName) == 0)) {
@@ -1217,7 +1564,7 @@ int JackEngine::GetClientNameForUUID(const char *uuid_buf, char *name_res)
     if (jack_uuid_parse(uuid_buf, &uuid) != 0)
         return -1;
 
-    for (int i = 0; i < CLIENT_NUM; i++) {
+    for (int i = NextClient(-1); i >= 0; i = NextClient(i)) {
         JackClientInterface* client = fClientTable[i];
 
         if (!client) {
@@ -1255,13 +1602,8 @@ int JackEngine::ReserveClientName(const char *name, const char *uuidstr)
 
 int JackEngine::ClientHasSessionCallback(const char *name)
 {
-    JackClientInterface* client = NULL;
-    for (int i = 0; i < CLIENT_NUM; i++) {
-        client = fClientTable[i];
-        if (client && (strcmp(client->GetClientControl()->fName, name) == 0)) {
-            break;
-        }
-    }
+    int refnum = GetClientRefNum(name);
+    JackClientInterface* client = (refnum >= 0) ? fClientTable[refnum] : NULL;
 
     if (client) {
         return client->GetClientControl()->fCallback[kSessionCallback];
@@ -28,7 +28,9 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackPlatformPlug.h"
 #include "JackRequest.h"
 #include "JackChannel.h"
+#include <atomic>
 #include <map>
+#include <vector>
 
 namespace Jack
 {
@@ -50,20 +52,36 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         JackGraphManager* fGraphManager;
         JackEngineControl* fEngineControl;
         char fSelfConnectMode;
-        JackClientInterface* fClientTable[CLIENT_NUM];
+        JackClientInterface** fClientTable;           /*! Indexed by refnum, fClientMax entries */
+        jack_int_t* fClientList;                       /*! Refnums of opened clients, in refnum order */
+        int fClientCount;
         JackSynchro* fSynchroTable;
         JackServerNotifyChannel fChannel;              /*! To communicate between the RT thread and server */
         JackProcessSync fSignal;
         jack_time_t fLastSwitchUsecs;
         JackMetadata fMetadata;
+        int* fBudgetOverruns;                          /*! Consecutive cycles over budget, indexed by refnum */
+        int* fBypassCycles;                            /*! Remaining bypassed cycles, indexed by refnum */
+        bool fFreewheel;
+
+        std::vector<JackClientNotification>* fPendingNotifications;  /*! Asynchronous notifications of external clients, indexed by refnum */
+        int fNotifyBatchDepth;                         /*! Pending notifications are sent when it goes back to 0 */
+        std::atomic<UInt32> fGraphSwitches;            /*! Incremented by the RT thread on each graph switch */
+        UInt32 fGraphSwitchesNotified;
+        unsigned long fNotificationsSent;
+        unsigned long fNotificationsCoalesced;
+        unsigned long fGraphReordersCoalesced;
 
         int fSessionPendingReplies;
         detail::JackChannelTransactionInterface* fSessionTransaction;
         JackSessionNotifyResult* fSessionResult;
         std::map<int,std::string> fReservationMap;
+        std::map<std::string,int> fClientCpuMap;   // CPU of client RT threads chosen by name, -1 to leave them unpinned
 
         int ClientCloseAux(int refnum, bool wait);
         void CheckXRun(jack_time_t callback_usecs);
+        void CheckBudget();
+        void SetClientBypass(int refnum, bool onoff);
 
         int NotifyAddClient(JackClientInterface* new_client, const char* new_name, int refnum);
         void NotifyRemoveClient(const char* name, int refnum);
@@ -76,8 +94,12 @@ class SERVER_EXPORT JackEngine : public JackLockAble
 
         int AllocateRefnum();
         void ReleaseRefnum(int refnum);
+        void SetClient(int refnum, JackClientInterface* client);
+        int NextClient(int refnum);
 
         int ClientNotify(JackClientInterface* client, int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
+        void QueueNotification(int client_refnum, int refnum, const char* name, int notify, const char* message, int value1, int value2);
+        void FlushNotifications(int client_refnum);
 
         void NotifyClient(int refnum, int event, int sync, const char*  message, int value1, int value2);
         void NotifyClients(int event, int sync, const char*  message,  int value1, int value2);
@@ -87,14 +109,14 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         void NotifyPortRename(jack_port_id_t src, const char* old_name);
         void NotifyActivate(int refnum);
 
+        void AssignClientCpus();
+
         void EnsureUUID(jack_uuid_t uuid);
 
-        bool CheckClient(int refnum)
-        {
-            return (refnum >= 0 && refnum < CLIENT_NUM && fClientTable[refnum] != NULL);
-        }
+        bool CheckClient(int refnum);
 
         int CheckPortsConnect(int refnum, jack_port_id_t src, jack_port_id_t dst);
+        int PortRegisterAux(int refnum, const char* name, const char *type, unsigned int flags, jack_port_id_t* port);
 
     public:
 
@@ -128,6 +150,7 @@ class SERVER_EXPORT JackEngine : public JackLockAble
 
         // Port management
         int PortRegister(int refnum, const char* name, const char *type, unsigned int flags, unsigned int buffer_size, jack_port_id_t* port);
+        int PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port, bool is_real_time);
         int PortUnRegister(int refnum, jack_port_id_t port);
 
         int PortConnect(int refnum, const char* src, const char* dst);
@@ -148,8 +171,12 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         bool Process(jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end);
 
         // Notifications
+        void BeginNotifyBatch();
+        void EndNotifyBatch();
+
         void NotifyDriverXRun();
         void NotifyClientXRun(int refnum);
+        void NotifyClientBudget(int refnum, int onoff);
         void NotifyFailure(int code, const char* reason);
         void NotifyGraphReorder();
         void NotifyBufferSize(jack_nframes_t buffer_size);
@@ -165,6 +192,34 @@ class SERVER_EXPORT JackEngine : public JackLockAble
         int GetClientNameForUUID(const char *uuid, char *name_res);
         int ReserveClientName(const char *name, const char *uuid);
         int ClientHasSessionCallback(const char *name);
+
+        // RT threads affinity
+        int SetClientCpu(const char* name, int cpu);
+};
+
+/*!
+\brief Engine lock : the asynchronous notifications queued while it is held are sent when it is released, in a single write per client.
+*/
+
+class JackEngineLock
+{
+    private:
+
+        JackEngine* fEngine;
+
+    public:
+
+        JackEngineLock(JackEngine* engine): fEngine(engine)
+        {
+            fEngine->Lock();
+            fEngine->BeginNotifyBatch();
+        }
+
+        ~JackEngineLock()
+        {
+            fEngine->EndNotifyBatch();
+            fEngine->Unlock();
+        }
 };
 
 
@@ -44,10 +44,13 @@ void JackEngineControl::CalcCPULoad(JackClientInterface** table,
 
     // In Asynchronous mode, last cycle end is the max of client end dates
     if (!fSyncMode) {
-        for (int i = fDriverNum; i < CLIENT_NUM; i++) {
+        int count;
+        const jack_int_t* active = manager->GetActiveRefNums(&count);
+        for (int pos = 0; pos < count; pos++) {
+            int i = active[pos];
             JackClientInterface* client = table[i];
             JackClientTiming* timing = manager->GetClientTiming(i);
-            if (client && client->GetClientControl()->fActive && timing->fStatus == Finished) {
+            if (i >= fDriverNum && client && client->GetClientControl()->fActive && timing->fStatus == Finished) {
                 last_cycle_end = JACK_MAX(last_cycle_end, timing->fFinishedAt);
             }
         }
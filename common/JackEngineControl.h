@@ -67,6 +67,7 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     JackTransportEngine fTransport;
     jack_timer_type_t fClockSource;
     int fDriverNum;
+    int fClientMax;         // Refnums are below this value
     bool fVerbose;
 
     // CPU Load
@@ -80,6 +81,14 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     int	fRollingInterval;
     float fCPULoad;
 
+    // RT threads affinity
+    int fRTCpuCount;
+    int fRTCpus[RT_CPU_MAX];        // CPUs reserved for RT threads, the driver thread uses the first one
+    int fClientCpu[CLIENT_NUM];     // CPU assigned to each client RT thread, -1 if none
+
+    // Clients CPU budget
+    int fClientBudget;              // Percent of the period a client may use, 0 if not enforced
+
     // For OSX thread
     UInt64 fPeriod;
     UInt64 fComputation;
@@ -92,7 +101,7 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     JackEngineProfiling fProfiler;
 #endif
 
-    JackEngineControl(bool sync, bool temporary, long timeout, bool rt, long priority, bool verbose, jack_timer_type_t clock, const char* server_name)
+    JackEngineControl(bool sync, bool temporary, long timeout, bool rt, long priority, bool verbose, jack_timer_type_t clock, int client_max, const char* server_name)
     {
         fBufferSize = 512;
         fSampleRate = 48000;
@@ -127,6 +136,12 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
         fXrunDelayedUsecs = 0.f;
         fClockSource = clock;
         fDriverNum = 0;
+        fClientMax = client_max;
+        fRTCpuCount = 0;
+        fClientBudget = 0;
+        for (int i = 0; i < CLIENT_NUM; i++) {
+            fClientCpu[i] = -1;
+        }
     }
 
     ~JackEngineControl()
@@ -141,10 +156,10 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
     }
 
     // Cycle
-    void CycleIncTime(jack_time_t callback_usecs)
+    void CycleIncTime(jack_time_t callback_usecs, jack_time_t hardware_usecs = 0)
     {
         // Timer
-        fFrameTimer.IncFrameTime(fBufferSize, callback_usecs, fPeriodUsecs);
+        fFrameTimer.IncFrameTime(fBufferSize, callback_usecs, fPeriodUsecs, hardware_usecs);
     }
 
     void CycleBegin(JackClientInterface** table, JackGraphManager* manager, jack_time_t cur_cycle_begin, jack_time_t prev_cycle_end)
@@ -156,9 +171,9 @@ struct SERVER_EXPORT JackEngineControl : public JackShmMem
 #endif
     }
 
-    void CycleEnd(JackClientInterface** table)
+    void CycleEnd(JackClientInterface** table, JackGraphManager* manager)
     {
-        fTransport.CycleEnd(table, fSampleRate, fBufferSize);
+        fTransport.CycleEnd(table, manager, fSampleRate, fBufferSize);
     }
 
     // Timer
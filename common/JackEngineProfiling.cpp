@@ -354,10 +354,13 @@ void JackEngineProfiling::Profile(JackClientInterface** table,
     fProfileTable[fAudioCycle].fPrevCycleEnd = prev_cycle_end;
     fProfileTable[fAudioCycle].fAudioCycle = fAudioCycle;
 
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    int count;
+    const jack_int_t* active = manager->GetActiveRefNums(&count);
+    for (int pos = 0; pos < count; pos++) {
+        int i = active[pos];
         JackClientInterface* client = table[i];
         JackClientTiming* timing = manager->GetClientTiming(i);
-        if (client && client->GetClientControl()->fActive && client->GetClientControl()->fCallback[kRealTimeCallback]) {
+        if (i >= GetEngineControl()->fDriverNum && client && client->GetClientControl()->fActive && client->GetClientControl()->fCallback[kRealTimeCallback]) {
 
             if (!CheckClient(client->GetClientControl()->fName, fAudioCycle)) {
                 // Keep new measured client
@@ -41,6 +41,14 @@ int JackExternalClient::ClientNotify(int refnum, const char* name, int notify, i
     return result;
 }
 
+int JackExternalClient::ClientNotify(JackClientNotification* events, int count)
+{
+    int result = -1;
+    jack_log("JackExternalClient::ClientNotify client = %s count = %ld", fClientControl->fName, count);
+    fChannel.ClientNotify(events, count, &result);
+    return result;
+}
+
 int JackExternalClient::Open(const char* name, int pid, int refnum, jack_uuid_t uuid, int* shared_client)
 {
     try {
@@ -28,6 +28,7 @@ namespace Jack
 {
 
 struct JackClientControl;
+struct JackClientNotification;
 
 /*!
 \brief Server side implementation of library clients.
@@ -50,6 +51,7 @@ class JackExternalClient : public JackClientInterface
         int Close();
 
         int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2);
+        int ClientNotify(JackClientNotification* events, int count);
 
         JackClientControl* GetClientControl() const;
 };
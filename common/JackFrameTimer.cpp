@@ -22,10 +22,26 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackError.h"
 #include <math.h>
 #include <stdio.h>
+#include <algorithm>
 
 namespace Jack
 {
 
+#define CLOCK_ERROR_WEIGHT      (1. / 64.)  // Weight of the last cycle in the error averages
+#define CLOCK_OUTLIER_RATIO     25.         // Squared error over its expected value beyond which a date is an outlier
+#define CLOCK_OUTLIER_MAX       3           // Consecutive outliers taken as a clock jump
+#define CLOCK_HARDWARE_MISSING  8           // Consecutive cycles without hardware date before using the wakeup dates
+
+#define ADAPTIVE_DLL_MIN_BW     (1. / 32.)  // Hz
+#define ADAPTIVE_DLL_MAX_BW     2.          // Hz
+#define ADAPTIVE_DLL_MAX_OMEGA  0.5         // Keeps the loop stable with long periods
+#define ADAPTIVE_DLL_NARROWING  1.          // Seconds for the bandwidth to narrow by a factor e
+
+#define KALMAN_PERIOD_DRIFT     1e-7        // Period random walk per cycle, relative to the period
+#define KALMAN_INITIAL_NOISE    100.        // usecs^2
+#define KALMAN_MIN_NOISE        0.25        // usecs^2, dates have a 1 usec resolution
+#define KALMAN_INITIAL_RATE     1e-3        // Initial uncertainty on the period, relative to the period
+
 #if defined(WIN32) && !defined(__MINGW32__)
 /* missing on Windows : see http://bugs.mysql.com/bug.php?id=15936 */
 inline double rint(double nr)
@@ -45,6 +61,9 @@ JackTimer::JackTimer()
     fNextWakeUp = 0;
     fPeriodUsecs = 0.0f;
     fFilterOmega = 0.0f; /* Initialised later */
+    fErrorUsecs = 0.0f;
+    fFilter = JackClockFilterDLL;
+    fHardwareTime = false;
 }
 
 jack_nframes_t JackTimer::Time2Frames(jack_time_t usecs, jack_nframes_t buffer_size)
@@ -102,6 +121,20 @@ int JackTimer::GetCycleTimes(jack_nframes_t* current_frames, jack_time_t* curren
     }
 }
 
+int JackTimer::GetClockEstimate(jack_clock_estimate_t* estimate, jack_nframes_t buffer_size, jack_nframes_t sample_rate)
+{
+    if (fInitialized && fPeriodUsecs > 0.0f && sample_rate > 0) {
+        estimate->period_usecs = fPeriodUsecs;
+        estimate->rate_ratio = ((double)buffer_size * 1000000.0 / (double)sample_rate) / (double)fPeriodUsecs;
+        estimate->error_usecs = fErrorUsecs;
+        estimate->filter = (jack_clock_filter_t)fFilter;
+        estimate->hardware_timestamps = fHardwareTime;
+        return 0;
+    } else {
+        return -1;
+    }
+}
+
 jack_nframes_t JackTimer::FramesSinceCycleStart(jack_time_t cur_time, jack_nframes_t frames_rate)
 {
     return (jack_nframes_t) floor((((float)frames_rate) / 1000000.0f) * (cur_time - fCurrentCallback));
@@ -112,14 +145,37 @@ void JackFrameTimer::InitFrameTime()
     fFirstWakeUp = true;
 }
 
-void JackFrameTimer::IncFrameTime(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs)
+void JackFrameTimer::SetFilter(jack_clock_filter_t filter)
 {
-    if (fFirstWakeUp) {
-        InitFrameTimeAux(callback_usecs, period_usecs);
+    fFilter = filter;
+    fFirstWakeUp = true;
+}
+
+void JackFrameTimer::IncFrameTime(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs, jack_time_t hardware_usecs)
+{
+    // The fixed DLL keeps filtering the wakeup dates
+    bool hardware_time = (fFilter != JackClockFilterDLL && hardware_usecs != 0);
+
+    // Hardware dates that stop coming are given up, the filter starts over on the wakeup dates
+    if (fHardwareTime && !hardware_time && !fFirstWakeUp) {
+        if (++fHardwareMissing >= CLOCK_HARDWARE_MISSING) {
+            jack_log("JackFrameTimer::IncFrameTime no hardware date for %d cycles, using wakeup dates", fHardwareMissing);
+            fFirstWakeUp = true;
+        }
+    } else {
+        fHardwareMissing = 0;
+    }
+
+    // Wakeup and hardware dates differ by the wakeup latency, so start over when the driver begins to give hardware dates
+    if (fFirstWakeUp || (hardware_time && !fHardwareTime)) {
+        fHardwareTime = hardware_time;
+        fHardwareMissing = 0;
+        InitFrameTimeAux(callback_usecs, (hardware_time) ? hardware_usecs : callback_usecs, period_usecs);
         fFirstWakeUp = false;
     }
     
-    IncFrameTimeAux(buffer_size, callback_usecs, period_usecs);
+    // Once on hardware dates, a few cycles without one (date 0) only run the prediction
+    IncFrameTimeAux(buffer_size, callback_usecs, (fHardwareTime) ? hardware_usecs : callback_usecs, period_usecs);
 }
 
 void JackFrameTimer::ResetFrameTime(jack_time_t callback_usecs)
@@ -151,7 +207,7 @@ void JackFrameTimer::ReadFrameTime(JackTimer* timer)
 
 // Internal
 
-void JackFrameTimer::InitFrameTimeAux(jack_time_t callback_usecs, jack_time_t period_usecs)
+void JackFrameTimer::InitFrameTimeAux(jack_time_t callback_usecs, jack_time_t date_usecs, jack_time_t period_usecs)
 {
     /* the first wakeup or post-freewheeling or post-xrun */
 
@@ -186,16 +242,35 @@ void JackFrameTimer::InitFrameTimeAux(jack_time_t callback_usecs, jack_time_t pe
        FA 13/02/2012
     */
     
+    /* The adaptive DLL starts with its widest bandwidth, and the Kalman
+       filter with a large uncertainty on the period, so that both lock
+       quickly and then narrow down.
+    */
+    
     JackTimer* timer = WriteNextStateStart();
     timer->fPeriodUsecs = (float)period_usecs;
     timer->fCurrentCallback = callback_usecs;
-    timer->fNextWakeUp = callback_usecs;
+    timer->fNextWakeUp = date_usecs;
     timer->fFilterOmega = period_usecs * 7.854e-7f;
+    timer->fErrorUsecs = 0.0f;
+    timer->fFilter = fFilter;
+    timer->fHardwareTime = fHardwareTime;
     WriteNextStateStop();
+    
+    double initial_rate = period_usecs * KALMAN_INITIAL_RATE;
+    fPhase = (double)date_usecs;
+    fPeriod = (double)period_usecs;
+    fOmega = std::min(6.2831853 * ADAPTIVE_DLL_MAX_BW * period_usecs * 1e-6, ADAPTIVE_DLL_MAX_OMEGA);
+    fErrorVariance = 0.;
+    fNoiseVariance = KALMAN_INITIAL_NOISE;
+    fPhaseVariance = KALMAN_INITIAL_NOISE;
+    fPhasePeriodCovariance = 0.;
+    fPeriodVariance = initial_rate * initial_rate;
+    fOutliers = 0;
     TrySwitchState(); // always succeed since there is only one writer
 }
 
-void JackFrameTimer::IncFrameTimeAux(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs)
+void JackFrameTimer::IncFrameTimeAux(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t date_usecs, jack_time_t period_usecs)
 {
     JackTimer* timer = WriteNextStateStart();
     
@@ -221,18 +296,124 @@ void JackFrameTimer::IncFrameTimeAux(jack_nframes_t buffer_size, jack_time_t cal
     FA 13/02/2012
     */
     
-    float delta = (float)((int64_t)callback_usecs - (int64_t)timer->fNextWakeUp);
-    delta *= timer->fFilterOmega;
     timer->fCurrentWakeup = timer->fNextWakeUp;
     timer->fCurrentCallback = callback_usecs;
     timer->fFrames += buffer_size;
-    timer->fPeriodUsecs += timer->fFilterOmega * delta;	
-    timer->fNextWakeUp += (int64_t)floorf(timer->fPeriodUsecs + 1.41f * delta + 0.5f);
+    
+    switch (fFilter) {
+    
+        case JackClockFilterAdaptiveDLL:
+            IncAdaptiveDLL(timer, date_usecs, period_usecs);
+            break;
+            
+        case JackClockFilterKalman:
+            IncKalman(timer, date_usecs, period_usecs);
+            break;
+            
+        default: {
+            float delta = (float)((int64_t)callback_usecs - (int64_t)timer->fNextWakeUp);
+            fErrorVariance += CLOCK_ERROR_WEIGHT * (delta * delta - fErrorVariance);
+            delta *= timer->fFilterOmega;
+            timer->fPeriodUsecs += timer->fFilterOmega * delta;	
+            timer->fNextWakeUp += (int64_t)floorf(timer->fPeriodUsecs + 1.41f * delta + 0.5f);
+            break;
+        }
+    }
+    
+    timer->fErrorUsecs = (float)sqrt(fErrorVariance);
     timer->fInitialized = true;
     
     WriteNextStateStop();
     TrySwitchState(); // always succeed since there is only one writer
 }
 
-} // end of namespace
+void JackFrameTimer::IncAdaptiveDLL(JackTimer* timer, jack_time_t date_usecs, jack_time_t period_usecs)
+{
+    /*
+    Same loop as the fixed DLL, with 'fOmega' following the error: it
+    opens up when several dates in a row are out of the expected range
+    (lock, clock jump or rate change), and otherwise narrows down to
+    ADAPTIVE_DLL_MIN_BW in a few seconds, filtering the timing noise of
+    interfaces with irregular interrupts much more than 1/8 Hz does.
+    */
+    
+    double period_secs = period_usecs * 1e-6;
+    double max_omega = std::min(6.2831853 * ADAPTIVE_DLL_MAX_BW * period_secs, ADAPTIVE_DLL_MAX_OMEGA);
+    double min_omega = std::min(6.2831853 * ADAPTIVE_DLL_MIN_BW * period_secs, max_omega);
+    double error = 0.;  // Without a date the loop just coasts
+    
+    if (date_usecs != 0) {
+        error = (double)date_usecs - fPhase;
+        if (error * error > CLOCK_OUTLIER_RATIO * std::max(fErrorVariance, KALMAN_MIN_NOISE)) {
+            if (++fOutliers >= CLOCK_OUTLIER_MAX) {
+                fOmega = max_omega;
+            }
+        } else {
+            fOutliers = 0;
+            fOmega = std::max(fOmega * (1. - std::min(period_secs / ADAPTIVE_DLL_NARROWING, 0.5)), min_omega);
+        }
+        fErrorVariance += CLOCK_ERROR_WEIGHT * (error * error - fErrorVariance);
+    }
+    
+    double delta = error * fOmega;
+    fPeriod += fOmega * delta;
+    fPhase += fPeriod + 1.4142136 * delta;
+    
+    timer->fPeriodUsecs = (float)fPeriod;
+    timer->fNextWakeUp = (jack_time_t)floor(fPhase + 0.5);
+}
 
+void JackFrameTimer::IncKalman(JackTimer* timer, jack_time_t date_usecs, jack_time_t period_usecs)
+{
+    /*
+    The state is the date of the next period and the period itself, the
+    period doing a random walk of KALMAN_PERIOD_DRIFT per cycle. The
+    measurement noise is estimated from the prediction error, so the
+    gains follow the actual jitter of the dates : hardware timestamps
+    give a wide bandwidth, noisy wakeups a narrow one. A date too far
+    from the prediction is skipped, unless several are in a row, which
+    is taken as a clock jump.
+    */
+    
+    double error = (double)date_usecs - fPhase;
+    double error2 = error * error;
+    
+    if (date_usecs == 0) {
+        // No date this cycle, only predict
+    } else if (error2 > CLOCK_OUTLIER_RATIO * (fPhaseVariance + fNoiseVariance) && ++fOutliers < CLOCK_OUTLIER_MAX) {
+        // Most likely a late wakeup, only predict
+        fErrorVariance += CLOCK_ERROR_WEIGHT * (error2 - fErrorVariance);
+    } else {
+        fErrorVariance += CLOCK_ERROR_WEIGHT * (error2 - fErrorVariance);
+        if (fOutliers >= CLOCK_OUTLIER_MAX) {
+            fPhaseVariance += error2;
+        }
+        fOutliers = 0;
+        
+        fNoiseVariance += CLOCK_ERROR_WEIGHT * (error2 - fPhaseVariance - fNoiseVariance);
+        fNoiseVariance = std::max(fNoiseVariance, KALMAN_MIN_NOISE);
+        
+        double innovation_variance = fPhaseVariance + fNoiseVariance;
+        double phase_gain = fPhaseVariance / innovation_variance;
+        double period_gain = fPhasePeriodCovariance / innovation_variance;
+        
+        fPhase += phase_gain * error;
+        fPeriod += period_gain * error;
+        fPeriodVariance -= period_gain * fPhasePeriodCovariance;
+        fPhasePeriodCovariance *= 1. - phase_gain;
+        fPhaseVariance *= 1. - phase_gain;
+    }
+    
+    // Prediction of the next period
+    double drift = period_usecs * KALMAN_PERIOD_DRIFT;
+    double drift2 = drift * drift;
+    fPhase += fPeriod;
+    fPhaseVariance += 2. * fPhasePeriodCovariance + fPeriodVariance + drift2 / 3.;
+    fPhasePeriodCovariance += fPeriodVariance + drift2 / 2.;
+    fPeriodVariance += drift2;
+    
+    timer->fPeriodUsecs = (float)fPeriod;
+    timer->fNextWakeUp = (jack_time_t)floor(fPhase + 0.5);
+}
+
+} // end of namespace
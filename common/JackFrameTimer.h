@@ -47,6 +47,9 @@ class SERVER_EXPORT JackTimer
         float fPeriodUsecs;
         float fFilterOmega; /* set once, never altered */
         bool fInitialized;
+        float fErrorUsecs;      // RMS of the prediction error
+        int fFilter;            // jack_clock_filter_t in use
+        bool fHardwareTime;     // Fed with the driver hardware timestamps
 
     public:
 
@@ -58,6 +61,7 @@ class SERVER_EXPORT JackTimer
         jack_time_t Frames2Time(jack_nframes_t frames, jack_nframes_t buffer_size);
         jack_nframes_t FramesSinceCycleStart(jack_time_t cur_time, jack_nframes_t frames_rate);
         int GetCycleTimes(jack_nframes_t* current_frames, jack_time_t* current_usecs, jack_time_t* next_usecs, float* period_usecs);
+        int GetClockEstimate(jack_clock_estimate_t* estimate, jack_nframes_t buffer_size, jack_nframes_t sample_rate);
 
         jack_nframes_t CurFrame()
         {
@@ -73,6 +77,10 @@ class SERVER_EXPORT JackTimer
 
 /*!
 \brief A class using the JackAtomicState to manage jack time.
+
+The wakeup dates are filtered with the fixed bandwidth DLL by default. The adaptive
+DLL and the Kalman filter keep their state in double precision here, on the writer
+side only, and are fed with the hardware date of the period when the driver has one.
 */
 
 PRE_PACKED_STRUCTURE
@@ -82,19 +90,39 @@ class SERVER_EXPORT JackFrameTimer : public JackAtomicState<JackTimer>
     private:
 
         bool fFirstWakeUp;
-        void IncFrameTimeAux(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs);
-        void InitFrameTimeAux(jack_time_t callback_usecs, jack_time_t period_usecs);
+        jack_clock_filter_t fFilter;
+        bool fHardwareTime;
+        int fHardwareMissing;       // Consecutive cycles without hardware date while using them
+
+        // Writer side filter state
+        double fPhase;              // Predicted date of the next period, in usecs
+        double fPeriod;             // Filtered period, in usecs
+        double fOmega;              // Adaptive DLL bandwidth, as 2 * pi * BW * Tperiod
+        double fErrorVariance;      // Mean square prediction error
+        double fNoiseVariance;      // Kalman measurement noise
+        double fPhaseVariance;      // Kalman covariance matrix
+        double fPhasePeriodCovariance;
+        double fPeriodVariance;
+        int fOutliers;              // Consecutive errors out of the expected range
+
+        void IncFrameTimeAux(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t date_usecs, jack_time_t period_usecs);
+        void InitFrameTimeAux(jack_time_t callback_usecs, jack_time_t date_usecs, jack_time_t period_usecs);
+        void IncAdaptiveDLL(JackTimer* timer, jack_time_t date_usecs, jack_time_t period_usecs);
+        void IncKalman(JackTimer* timer, jack_time_t date_usecs, jack_time_t period_usecs);
 
     public:
 
-        JackFrameTimer(): fFirstWakeUp(true)
+        JackFrameTimer(): fFirstWakeUp(true), fFilter(JackClockFilterDLL), fHardwareTime(false), fHardwareMissing(0),
+            fPhase(0.), fPeriod(0.), fOmega(0.), fErrorVariance(0.), fNoiseVariance(0.),
+            fPhaseVariance(0.), fPhasePeriodCovariance(0.), fPeriodVariance(0.), fOutliers(0)
         {}
         ~JackFrameTimer()
         {}
 
         void InitFrameTime();
         void ResetFrameTime(jack_time_t callback_usecs);
-        void IncFrameTime(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs);
+        void SetFilter(jack_clock_filter_t filter);
+        void IncFrameTime(jack_nframes_t buffer_size, jack_time_t callback_usecs, jack_time_t period_usecs, jack_time_t hardware_usecs = 0);
         void ReadFrameTime(JackTimer* timer);
 
 } POST_PACKED_STRUCTURE;
@@ -26,6 +26,13 @@
 namespace Jack
 {
 
+int JackFreewheelDriver::Start()
+{
+    // A new render : outputs of the previous one must not be delayed into it
+    fPipelineHistory.Reset();
+    return JackDriver::Start();
+}
+
 // When used in "master" mode
 
 int JackFreewheelDriver::Process()
@@ -35,6 +42,9 @@ int JackFreewheelDriver::Process()
 
    if (fEngine->Process(fBeginDateUst, fEndDateUst)) {
 
+        // Pipelined graph: hand previous cycles outputs to the next stages while no client is running
+        fGraphManager->LatchPipeline(fEngineControl->fBufferSize, &fPipelineHistory);
+
         // Resume connected clients in the graph
         if (ResumeRefNum() < 0) {
             jack_error("JackFreewheelDriver::Process: ResumeRefNum error");
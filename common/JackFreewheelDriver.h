@@ -22,6 +22,7 @@
 #define __JackFreewheelDriver__
 
 #include "JackDriver.h"
+#include "JackPipelineHistory.h"
 
 namespace Jack
 {
@@ -32,6 +33,10 @@ namespace Jack
 
 class JackFreewheelDriver : public JackDriver
 {
+    private:
+
+        JackPipelineHistory fPipelineHistory;
+
     protected:
 
         int SuspendRefNum();
@@ -48,6 +53,7 @@ class JackFreewheelDriver : public JackDriver
             return false;
         }
 
+        int Start();
         int Process();
 
         int ProcessReadSync();
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackClient.h"
 #include "JackGlobals.h"
 #include "JackError.h"
+#include "shm.h"
 
 namespace Jack
 {
@@ -114,6 +115,10 @@ void JackGenericClientChannel::ClientOpen(const char* name, int pid, jack_uuid_t
     *shared_engine = res.fSharedEngine;
     *shared_client = res.fSharedClient;
     *shared_graph = res.fSharedGraph;
+    // Kept until the segments are attached
+    for (int i = 0; i < res.fFdCount; i++) {
+        jack_shm_set_fd(res.fFdIndex[i], res.fFd[i]);
+    }
 }
 
 void JackGenericClientChannel::ClientClose(int refnum, int* result)
@@ -152,6 +157,16 @@ void JackGenericClientChannel::PortUnRegister(int refnum, jack_port_id_t port_in
     ServerSyncCall(&req, &res, result);
 }
 
+void JackGenericClientChannel::PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port_index, int is_real_time, int* result)
+{
+    JackPortRegisterActivateRequest req(refnum, count, names, types, flags, is_real_time);
+    JackPortRegisterActivateResult res;
+    ServerSyncCall(&req, &res, result);
+    for (int i = 0; i < count; i++) {
+        port_index[i] = (i < res.fCount) ? res.fPortIndex[i] : NO_PORT;
+    }
+}
+
 void JackGenericClientChannel::PortConnect(int refnum, const char* src, const char* dst, int* result)
 {
     JackPortConnectNameRequest req(refnum, src, dst);
@@ -64,6 +64,7 @@ class JackGenericClientChannel : public detail::JackClientChannelInterface
 
         void PortRegister(int refnum, const char* name, const char* type, unsigned int flags, unsigned int buffer_size, jack_port_id_t* port_index, int* result);
         void PortUnRegister(int refnum, jack_port_id_t port_index, int* result);
+        void PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port_index, int is_real_time, int* result);
 
         void PortConnect(int refnum, const char* src, const char* dst, int* result);
         void PortDisconnect(int refnum, const char* src, const char* dst, int* result);
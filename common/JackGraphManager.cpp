@@ -20,6 +20,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackGraphManager.h"
 #include "JackConstants.h"
+#include "JackEngineControl.h"
+#include "JackGlobals.h"
 #include "JackError.h"
 #include <assert.h>
 #include <stdlib.h>
@@ -41,6 +43,14 @@ static void AssertBufferSize(jack_nframes_t buffer_size)
     }
 }
 
+// Port chunks as mapped in this process
+static std::atomic<JackPort*> gPortChunks[PORT_CHUNK_NUM];
+static jack_shm_info_t gPortChunkInfo[PORT_CHUNK_NUM];
+static JackMutex gPortChunkMutex;
+
+// Used in place of the ports of a chunk that could not be mapped
+static JackPort gUnmappedPort;
+
 void JackGraphManager::AssertPort(jack_port_id_t port_index)
 {
     if (port_index >= fPortMax) {
@@ -51,13 +61,14 @@ void JackGraphManager::AssertPort(jack_port_id_t port_index)
 
 JackGraphManager* JackGraphManager::Allocate(int port_max)
 {
-    // Using "Placement" new
-    void* shared_ptr = JackShmMem::operator new(sizeof(JackGraphManager) + port_max * sizeof(JackPort));
+    // Using "Placement" new, snapshots are sized for the initial port table, chunks have their own ones
+    void* shared_ptr = JackShmMem::operator new(sizeof(JackGraphManager) + port_max * sizeof(JackPort) + 2 * JackGraphSnapshot::Size(port_max) + 8);
     return new(shared_ptr) JackGraphManager(port_max);
 }
 
 void JackGraphManager::Destroy(JackGraphManager* manager)
 {
+    manager->ReleasePortChunks();
     // "Placement" new was used
     manager->~JackGraphManager();
     JackShmMem::operator delete(manager);
@@ -72,17 +83,204 @@ JackGraphManager::JackGraphManager(int port_max)
     }
 
     fPortMax = port_max;
+    fPortArraySize = port_max;
+    fChunkCount = 0;
+    fSnapshotVersion = 0;
+    GetSnapshot(0, 0)->Init(port_max);
+    GetSnapshot(0, 1)->Init(port_max);
+    GetSnapshot(0, 0)->Build(ReadCurrentState(), port_max, 0);
 }
 
 JackPort* JackGraphManager::GetPort(jack_port_id_t port_index)
 {
     AssertPort(port_index);
-    return &fPortArray[port_index];
+    return (port_index < fPortArraySize) ? &fPortArray[port_index] : GetChunkPort(port_index);
 }
 
 jack_default_audio_sample_t* JackGraphManager::GetBuffer(jack_port_id_t port_index)
 {
-    return fPortArray[port_index].GetBuffer();
+    return GetPort(port_index)->GetBuffer();
+}
+
+JackPort* JackGraphManager::GetChunkPort(jack_port_id_t port_index)
+{
+    unsigned int chunk = (port_index - fPortArraySize) / PORT_CHUNK_SIZE;
+    JackPort* ports = gPortChunks[chunk].load(std::memory_order_acquire);
+    // Mapped by the notification thread before any port of the chunk is used, see AttachPortChunks : never attach here, this may be the RT thread
+    return (ports) ? &ports[(port_index - fPortArraySize) % PORT_CHUNK_SIZE] : &gUnmappedPort;
+}
+
+// Client
+JackPort* JackGraphManager::AttachPortChunk(unsigned int chunk)
+{
+    gPortChunkMutex.Lock();
+    JackPort* ports = gPortChunks[chunk];
+
+    if (!ports) {
+        jack_shm_info_t* info = &gPortChunkInfo[chunk];
+        info->index = fChunkIndex[chunk];
+        if (jack_attach_lib_shm(info)) {
+            gPortChunkMutex.Unlock();
+            jack_error("JackGraphManager::AttachPortChunk cannot attach chunk = %ld index = %ld", chunk, info->index);
+            return NULL;
+        }
+        ports = (JackPort*)jack_shm_addr(info);
+        LockMemoryImp(ports, PORT_CHUNK_SIZE * sizeof(JackPort));
+        jack_log("JackGraphManager::AttachPortChunk chunk = %ld index = %ld", chunk, info->index);
+        gPortChunks[chunk].store(ports, std::memory_order_release);
+    }
+
+    gPortChunkMutex.Unlock();
+    return ports;
+}
+
+// Client
+void JackGraphManager::AttachPortChunks()
+{
+    unsigned int count = __atomic_load_n(&fChunkCount, __ATOMIC_ACQUIRE);
+    for (unsigned int i = 0; i < count; i++) {
+        if (!gPortChunks[i].load(std::memory_order_acquire)) {
+            AttachPortChunk(i);
+        }
+        // A memfd descriptor received for a chunk another client of the process already mapped is not used
+        jack_shm_release_fd(fChunkIndex[i]);
+    }
+}
+
+// Client
+void JackGraphManager::DetachPortChunks()
+{
+    gPortChunkMutex.Lock();
+
+    for (int i = 0; i < PORT_CHUNK_NUM; i++) {
+        JackPort* ports = gPortChunks[i];
+        if (ports) {
+            UnlockMemoryImp(ports, PORT_CHUNK_SIZE * sizeof(JackPort));
+            jack_release_lib_shm(&gPortChunkInfo[i]);
+            gPortChunks[i] = NULL;
+        }
+    }
+
+    gPortChunkMutex.Unlock();
+}
+
+/*!
+\brief Add a chunk of ports at the end of the port table.
+
+Clients see the new ports once fPortMax is updated, after the chunk is complete. The published snapshot is copied in the chunk
+before it becomes the last one, so that readers always find it there.
+*/
+// Server
+bool JackGraphManager::AddPortChunk()
+{
+    unsigned int chunk = fChunkCount;
+    unsigned int port_max = fPortMax;
+    unsigned int port_limit = GetPortLimit(chunk + 1);
+    UInt32 version = fSnapshotVersion;
+    jack_shm_info_t info;
+
+    if (port_max >= PORT_NUM_MAX || chunk >= PORT_CHUNK_NUM) {
+        jack_error("JackGraphManager::AddPortChunk all %ld ports are used", port_max);
+        return false;
+    }
+
+    if (jack_shmalloc("/jack_ports", PORT_CHUNK_SIZE * sizeof(JackPort) + 2 * JackGraphSnapshot::Size(port_limit) + 8, &info)) {
+        jack_error("JackGraphManager::AddPortChunk cannot create shared memory segment err = %s", strerror(errno));
+        return false;
+    }
+
+    if (jack_attach_shm(&info)) {
+        jack_error("JackGraphManager::AddPortChunk cannot attach shared memory segment err = %s", strerror(errno));
+        jack_destroy_shm(&info);
+        return false;
+    }
+
+    JackPort* ports = (JackPort*)jack_shm_addr(&info);
+    InitLockMemoryImp(ports, PORT_CHUNK_SIZE * sizeof(JackPort));
+    for (int i = 0; i < PORT_CHUNK_SIZE; i++) {
+        new(&ports[i]) JackPort();
+        ports[i].Release();
+    }
+
+    gPortChunkInfo[chunk] = info;
+    gPortChunks[chunk].store(ports, std::memory_order_release);
+    fChunkIndex[chunk] = info.index;
+
+    GetSnapshot(chunk + 1, version)->CopyFrom(GetSnapshot(chunk, version), port_limit);
+    GetSnapshot(chunk + 1, version + 1)->Init(port_limit);
+
+    __atomic_store_n(&fChunkCount, chunk + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&fPortMax, port_limit, __ATOMIC_RELEASE);
+
+    jack_log("JackGraphManager::AddPortChunk chunk = %ld index = %ld port max = %ld", chunk, info.index, fPortMax);
+    return true;
+}
+
+// Server
+void JackGraphManager::ReleasePortChunks()
+{
+    gPortChunkMutex.Lock();
+
+    for (unsigned int i = 0; i < fChunkCount; i++) {
+        JackPort* ports = gPortChunks[i];
+        if (ports) {
+            UnlockMemoryImp(ports, PORT_CHUNK_SIZE * sizeof(JackPort));
+            jack_release_shm(&gPortChunkInfo[i]);
+            jack_destroy_shm(&gPortChunkInfo[i]);
+            gPortChunks[i] = NULL;
+        }
+    }
+
+    fPortMax = fPortArraySize;
+    fChunkCount = 0;
+    gPortChunkMutex.Unlock();
+}
+
+unsigned int JackGraphManager::GetPortLimit(unsigned int chunk_count)
+{
+    return std::min(fPortArraySize + chunk_count * PORT_CHUNK_SIZE, (unsigned int)PORT_NUM_MAX);
+}
+
+JackGraphSnapshot* JackGraphManager::GetSnapshot(unsigned int chunk_count, UInt32 version)
+{
+    // Snapshots follow the port array or the last chunk, shared memory segments are page aligned in all processes
+    JackPort* ports_end = (chunk_count == 0) ? &fPortArray[fPortArraySize] : &gPortChunks[chunk_count - 1].load(std::memory_order_acquire)[PORT_CHUNK_SIZE];
+    uintptr_t base = ((uintptr_t)ports_end + 7) & ~(uintptr_t)7;
+    return (JackGraphSnapshot*)(base + (version & 1) * JackGraphSnapshot::Size(GetPortLimit(chunk_count)));
+}
+
+// Client
+JackGraphSnapshot* JackGraphManager::GetPublishedSnapshot(UInt32 version)
+{
+    unsigned int chunk_count = GetPortChunkCount();
+    if (chunk_count > 0 && !gPortChunks[chunk_count - 1].load(std::memory_order_acquire) && !AttachPortChunk(chunk_count - 1)) {
+        return NULL;
+    }
+    return GetSnapshot(chunk_count, version);
+}
+
+/*!
+\brief Build the snapshot of the state being written in the unused slot, and publish it if the connections changed.
+*/
+// Server
+void JackGraphManager::PublishSnapshot(JackConnectionManager* manager)
+{
+    UInt32 version = fSnapshotVersion;
+    JackGraphSnapshot* next = GetSnapshot(fChunkCount, version + 1);
+    next->Build(manager, fPortMax, version + 1);
+    if (!next->IsSameGraph(GetSnapshot(fChunkCount, version))) {
+        __atomic_store_n(&fSnapshotVersion, version + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Server
+void JackGraphManager::WriteNextStateStop()
+{
+    if (fCallWriteCounter == 1) {
+        // Outermost write operation : the next state is complete
+        PublishSnapshot(&fState[fCounter.NextArrayIndex()]);
+    }
+    JackAtomicState<JackConnectionManager>::WriteNextStateStop();
 }
 
 // Server
@@ -93,6 +291,106 @@ void JackGraphManager::InitRefNum(int refnum)
     WriteNextStateStop();
 }
 
+// Server
+void JackGraphManager::SetPipelineDepth(int depth)
+{
+    JackConnectionManager* manager = WriteNextStateStart();
+    manager->SetPipelineDepth(depth);
+    WriteNextStateStop();
+}
+
+// RT, client
+int JackGraphManager::GetPipelineStage(int refnum)
+{
+    return ReadCurrentState()->GetPipelineStage(refnum);
+}
+
+// RT, client
+bool JackGraphManager::IsDelayedPort(JackConnectionManager* manager, jack_port_id_t port_index)
+{
+    const jack_int_t* connections = manager->GetConnections(port_index);
+    int dst_ref = GetPort(port_index)->GetRefNum();
+    jack_port_id_t src_index;
+
+    for (int i = 0; (i < CONNECTION_NUM_FOR_PORT) && ((src_index = connections[i]) != EMPTY); i++) {
+        if (manager->IsDelayedConnection(GetPort(src_index)->GetRefNum(), dst_ref)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+\brief Copy (or mix) outputs of previous cycles in input ports fed by previous pipeline stages.
+
+A connection spanning n stage boundaries gets the output of n cycles before, older outputs are kept in history.
+Must be called when no client is running, that is between the end of the graph and the next resume.
+*/
+// RT
+void JackGraphManager::LatchPipeline(jack_nframes_t buffer_size, JackPipelineHistory* history)
+{
+    JackConnectionManager* manager = ReadCurrentState();
+    int depth = manager->GetPipelineDepth();
+    if (depth == 0) {
+        return;
+    }
+
+    // Port buffers hold the outputs of the previous cycle, there are none before the first latch
+    size_t size = buffer_size * sizeof(jack_default_audio_sample_t);
+    uint64_t cycle = history->GetCycle();
+    history->SetDepth(depth);
+
+    for (unsigned int port_index = FIRST_AVAILABLE_PORT; port_index < fPortMax; port_index++) {
+        JackPort* port = GetPort(port_index);
+        if (!port->IsUsed() || !(port->fFlags & JackPortIsInput) || !IsDelayedPort(manager, port_index)) {
+            continue;
+        }
+
+        const jack_int_t* connections = manager->GetConnections(port_index);
+        void* buffers[CONNECTION_NUM_FOR_PORT];
+        jack_port_id_t src_index;
+        int count = 0;
+
+        for (int i = 0; (i < CONNECTION_NUM_FOR_PORT) && ((src_index = connections[i]) != EMPTY); i++) {
+            uint64_t delay = manager->GetPipelineDelay(GetPort(src_index)->GetRefNum(), port->GetRefNum());
+            void* buffer = NULL;
+            if (delay == 1 && cycle >= 1) {
+                buffer = GetBuffer(src_index, buffer_size);
+            } else if (delay > 1 && cycle >= delay) {
+                buffer = history->Read(src_index, cycle - delay, size);
+            }
+            if (buffer) {
+                buffers[count++] = buffer;
+            }
+        }
+
+        if (count > 0) {
+            port->MixBuffers(buffers, count, buffer_size);
+        } else {
+            port->ClearBuffer(buffer_size);
+        }
+    }
+
+    // Keep the outputs read later by connections spanning several stages
+    for (unsigned int port_index = FIRST_AVAILABLE_PORT; port_index < fPortMax && cycle >= 1 && depth > 1; port_index++) {
+        JackPort* port = GetPort(port_index);
+        if (!port->IsUsed() || !(port->fFlags & JackPortIsInput)) {
+            continue;
+        }
+
+        const jack_int_t* connections = manager->GetConnections(port_index);
+        jack_port_id_t src_index;
+
+        for (int i = 0; (i < CONNECTION_NUM_FOR_PORT) && ((src_index = connections[i]) != EMPTY); i++) {
+            if (manager->GetPipelineDelay(GetPort(src_index)->GetRefNum(), port->GetRefNum()) > 1) {
+                history->Write(src_index, cycle - 1, GetBuffer(src_index, buffer_size), size);
+            }
+        }
+    }
+
+    history->NextCycle();
+}
+
 // RT
 void JackGraphManager::RunCurrentGraph()
 {
@@ -130,6 +428,16 @@ int JackGraphManager::SuspendRefNum(JackClientControl* control, JackSynchro* tab
     return manager->SuspendRefNum(control, table, fClientTiming, usec);
 }
 
+// RT
+void JackGraphManager::ClearOutputBuffers(int refnum, jack_nframes_t buffer_size)
+{
+    JackConnectionManager* manager = ReadCurrentState();
+    const jack_int_t* output = manager->GetOutputPorts(refnum);
+    for (int i = 0; i < PORT_NUM_FOR_CLIENT && output[i] != EMPTY; i++) {
+        GetPort(output[i])->ClearBuffer(buffer_size);
+    }
+}
+
 void JackGraphManager::TopologicalSort(std::vector<jack_int_t>& sorted)
 {
     UInt16 cur_index;
@@ -190,6 +498,11 @@ void* JackGraphManager::GetBuffer(jack_port_id_t port_index, jack_nframes_t buff
         return (port->fTied != NO_PORT) ? GetBuffer(port->fTied, buffer_size) : GetBuffer(port_index);
     }
 
+    // Pipelined graph : previous cycle data has been latched in the port buffer
+    if (len > 0 && manager->GetPipelineDepth() > 0 && IsDelayedPort(manager, port_index)) {
+        return port->GetBuffer();
+    }
+
     // No connections : return a zero-filled buffer
     if (len == 0) {
         port->ClearBuffer(buffer_size);
@@ -314,7 +627,8 @@ int JackGraphManager::ComputeTotalLatencies()
 
 void JackGraphManager::RecalculateLatencyAux(jack_port_id_t port_index, jack_latency_callback_mode_t mode)
 {
-    const jack_int_t* connections = ReadCurrentState()->GetConnections(port_index);
+    JackConnectionManager* manager = ReadCurrentState();
+    const jack_int_t* connections = manager->GetConnections(port_index);
     JackPort* port = GetPort(port_index);
     jack_latency_range_t latency = { UINT32_MAX, 0 };
     jack_port_id_t dst_index;
@@ -326,6 +640,12 @@ void JackGraphManager::RecalculateLatencyAux(jack_port_id_t port_index, jack_lat
 
         dst_port->GetLatencyRange(mode, &other_latency);
 
+        // Pipelined graph : a connection adds one cycle per stage boundary
+        int delay = manager->GetPipelineDelay(port->GetRefNum(), dst_port->GetRefNum())
+            + manager->GetPipelineDelay(dst_port->GetRefNum(), port->GetRefNum());
+        other_latency.min += delay * GetEngineControl()->fBufferSize;
+        other_latency.max += delay * GetEngineControl()->fBufferSize;
+
         if (other_latency.max > latency.max) {
 			latency.max = other_latency.max;
         }
@@ -386,6 +706,14 @@ jack_port_id_t JackGraphManager::AllocatePortAux(int refnum, const char* port_na
         }
     }
 
+    // All ports are used : grow the table, the first port of the new chunk is free
+    if (port_index == fPortMax && AddPortChunk()) {
+        jack_log("JackGraphManager::AllocatePortAux port_index = %ld name = %s type = %s", port_index, port_name, port_type);
+        if (!GetPort(port_index)->Allocate(refnum, port_name, port_type, flags)) {
+            return NO_PORT;
+        }
+    }
+
     return (port_index < fPortMax) ? port_index : NO_PORT;
 }
 
@@ -559,8 +887,11 @@ void JackGraphManager::GetConnections(jack_port_id_t port_index, jack_int_t* res
 // Server
 void JackGraphManager::Activate(int refnum)
 {
+    JackConnectionManager* manager = WriteNextStateStart();
+    manager->ActivateRefNum(refnum);
     DirectConnect(FREEWHEEL_DRIVER_REFNUM, refnum);
     DirectConnect(refnum, FREEWHEEL_DRIVER_REFNUM);
+    WriteNextStateStop();
 }
 
 /*
@@ -571,6 +902,9 @@ void JackGraphManager::Activate(int refnum)
 // Server
 void JackGraphManager::Deactivate(int refnum)
 {
+    JackConnectionManager* manager = WriteNextStateStart();
+    manager->DeactivateRefNum(refnum);
+
     // Disconnect only when needed
     if (IsDirectConnection(refnum, FREEWHEEL_DRIVER_REFNUM)) {
         DirectDisconnect(refnum, FREEWHEEL_DRIVER_REFNUM);
@@ -584,6 +918,8 @@ void JackGraphManager::Deactivate(int refnum)
     } else {
         jack_log("JackServer::Deactivate client = %ld was not activated", refnum);
     }
+
+    WriteNextStateStop();
 }
 
 // Server
@@ -641,6 +977,7 @@ int JackGraphManager::Connect(jack_port_id_t port_src, jack_port_id_t port_dst)
     res = manager->Connect(port_dst, port_src);
     if (res < 0) {
         jack_error("JackGraphManager::Connect failed port_dst = %ld port_src = %ld", port_dst, port_src);
+        manager->Disconnect(port_src, port_dst);
         goto end;
     }
 
@@ -809,10 +1146,92 @@ const char** JackGraphManager::GetConnections(jack_port_id_t port_index)
 }
 
 // Client
-void JackGraphManager::GetPortsAux(const char** matching_ports, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags)
+int JackGraphManager::GetSnapshotSize()
+{
+    // Same for both slots of the last chunk, whatever the current size of the port table
+    return JackGraphSnapshot::DataSize(GetPortLimit(GetPortChunkCount()));
+}
+
+/*
+	Use the last published snapshot and check that the server did not rewrite it during the read operation.
+	The server only rewrites the slot of the previous version, so a retry is only needed if the graph changes twice during the copy.
+	When the port table grows, the slot of the last chunk may not hold the version read yet : it is also retried.
+*/
+
+// Client
+int JackGraphManager::ReadSnapshot(jack_port_id_t* data, int data_size, UInt32* port_count, UInt32* version)
+{
+    for (int retry = 0; retry < GRAPH_SNAPSHOT_READ_RETRY; retry++) {
+        UInt32 published = GetSnapshotVersion();
+        JackGraphSnapshot* snapshot = GetPublishedSnapshot(published);
+        if (!snapshot) {
+            return -1;
+        }
+        UInt32 seq = __atomic_load_n(&snapshot->fSeq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0 && snapshot->fVersion == published) {
+            // Values may be inconsistent if the slot is rewritten meanwhile, keep the copy in bounds anyway
+            UInt32 port_max = std::min(snapshot->fPortMax, (UInt32)std::max(data_size - 1, 0));
+            UInt32 edge_count = std::min(snapshot->fEdgeCount, std::min(snapshot->fDataSize, (UInt32)data_size) - port_max - 1);
+            bool overflow = snapshot->fOverflow;
+            *port_count = port_max;
+            *version = published;
+            memcpy(data, snapshot->fData, (port_max + 1 + edge_count) * sizeof(jack_port_id_t));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (__atomic_load_n(&snapshot->fSeq, __ATOMIC_RELAXED) == seq) {
+                // The port table grew since data was allocated
+                if (snapshot->fPortMax != port_max || snapshot->fEdgeCount != edge_count) {
+                    return -1;
+                }
+                return (overflow) ? -1 : edge_count;
+            }
+        }
+    }
+
+    // The server died while rewriting the snapshot, or the graph keeps changing faster than it can be read
+    jack_error("JackGraphManager::ReadSnapshot cannot get a consistent snapshot");
+    return -1;
+}
+
+// Client
+int JackGraphManager::ReadSnapshotPeers(jack_port_id_t port_index, jack_port_id_t* peers, int count, UInt32* version)
+{
+    if (port_index >= fPortMax) {
+        return -1;
+    }
+
+    for (int retry = 0; retry < GRAPH_SNAPSHOT_READ_RETRY; retry++) {
+        UInt32 published = GetSnapshotVersion();
+        JackGraphSnapshot* snapshot = GetPublishedSnapshot(published);
+        if (!snapshot) {
+            return -1;
+        }
+        UInt32 seq = __atomic_load_n(&snapshot->fSeq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0 && snapshot->fVersion == published) {
+            // A port added after the snapshot has no peers yet
+            UInt32 port_max = std::min(snapshot->fPortMax, snapshot->fDataSize - 1);
+            UInt32 edge_max = snapshot->fDataSize - port_max - 1;
+            UInt32 begin = (port_index < port_max) ? std::min(snapshot->GetOffsets()[port_index], edge_max) : 0;
+            UInt32 end = (port_index < port_max) ? std::min(snapshot->GetOffsets()[port_index + 1], edge_max) : 0;
+            int res = (end > begin) ? end - begin : 0;
+            bool overflow = snapshot->fOverflow;
+            *version = published;
+            memcpy(peers, snapshot->fData + port_max + 1 + begin, std::min(res, count) * sizeof(jack_port_id_t));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (__atomic_load_n(&snapshot->fSeq, __ATOMIC_RELAXED) == seq) {
+                return (overflow) ? -1 : res;
+            }
+        }
+    }
+
+    jack_error("JackGraphManager::ReadSnapshotPeers cannot get a consistent snapshot");
+    return -1;
+}
+
+// Client
+void JackGraphManager::GetPortsAux(const char** matching_ports, unsigned int port_max, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags)
 {
     // Cleanup port array
-    memset(matching_ports, 0, sizeof(char*) * fPortMax);
+    memset(matching_ports, 0, sizeof(char*) * port_max);
 
     int match_cnt = 0;
     regex_t port_regex, type_regex;
@@ -830,7 +1249,7 @@ void JackGraphManager::GetPortsAux(const char** matching_ports, const char* port
         }
     }
 
-    for (unsigned int i = 0; i < fPortMax; i++) {
+    for (unsigned int i = 0; i < port_max; i++) {
         bool matching = true;
         JackPort* port = GetPort(i);
 
@@ -877,7 +1296,9 @@ void JackGraphManager::GetPortsAux(const char** matching_ports, const char* port
 */
 const char** JackGraphManager::GetPorts(const char* port_name_pattern, const char* type_name_pattern, unsigned long flags)
 {
-    const char** res = (const char**)malloc(sizeof(char*) * fPortMax);
+    // The port table may grow meanwhile : only look at the ports the result can hold
+    unsigned int port_max = fPortMax;
+    const char** res = (const char**)malloc(sizeof(char*) * port_max);
     UInt16 cur_index, next_index;
 
     if (!res)
@@ -885,7 +1306,7 @@ const char** JackGraphManager::GetPorts(const char* port_name_pattern, const cha
 
     do {
         cur_index = GetCurrentIndex();
-        GetPortsAux(res, port_name_pattern, type_name_pattern, flags);
+        GetPortsAux(res, port_max, port_name_pattern, type_name_pattern, flags);
         next_index = GetCurrentIndex();
     } while (cur_index != next_index);  // Until a coherent state has been read
 
@@ -901,7 +1322,7 @@ const char** JackGraphManager::GetPorts(const char* port_name_pattern, const cha
 void JackGraphManager::Save(JackConnectionManager* dst)
 {
     JackConnectionManager* manager = WriteNextStateStart();
-    memcpy(dst, manager, sizeof(JackConnectionManager));
+    *dst = *manager;
     WriteNextStateStop();
 }
 
@@ -909,7 +1330,8 @@ void JackGraphManager::Save(JackConnectionManager* dst)
 void JackGraphManager::Restore(JackConnectionManager* src)
 {
     JackConnectionManager* manager = WriteNextStateStart();
-    memcpy(manager, src, sizeof(JackConnectionManager));
+    *manager = *src;
+    manager->SetModified();
     WriteNextStateStop();
 }
 
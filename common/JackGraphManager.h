@@ -25,6 +25,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPort.h"
 #include "JackConstants.h"
 #include "JackConnectionManager.h"
+#include "JackGraphSnapshot.h"
+#include "JackPipelineHistory.h"
 #include "JackAtomicState.h"
 #include "JackPlatformPlug.h"
 #include "JackSystemDeps.h"
@@ -34,6 +36,11 @@ namespace Jack
 
 /*!
 \brief Graph manager: contains the connection manager and the port array.
+
+The port array is followed by two graph snapshots : the last published one, and the one the server prepares.
+When all its ports are used, the port table grows by chunks of PORT_CHUNK_SIZE ports allocated in their own shared memory segments,
+so that ports already mapped by clients never move. Each chunk is followed by two snapshots sized for the ports up to it,
+the ones of the last chunk are used. Clients map each new chunk when notified, before its ports can be used by the RT thread.
 */
 
 PRE_PACKED_STRUCTURE
@@ -42,18 +49,35 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
 
     private:
 
-        unsigned int fPortMax;
+        // Counters updated by the server while clients read them are naturally aligned, and accessed with atomic builtins
+        MEM_ALIGN(unsigned int fPortMax, 4);                    // Current size of the port table
+        unsigned int fPortArraySize;                            // Ports in fPortArray, the following ones are in chunks
+        MEM_ALIGN(unsigned int fChunkCount, 4);
+        jack_shm_registry_index_t fChunkIndex[PORT_CHUNK_NUM];
         JackClientTiming fClientTiming[CLIENT_NUM];
+        MEM_ALIGN(UInt32 fSnapshotVersion, 4);
         JackPort fPortArray[0];    // The actual size depends of port_max, it will be dynamically computed and allocated using "placement" new
 
         void AssertPort(jack_port_id_t port_index);
+        JackPort* GetChunkPort(jack_port_id_t port_index);
+        JackPort* AttachPortChunk(unsigned int chunk);
+        bool AddPortChunk();
+        void ReleasePortChunks();
         jack_port_id_t AllocatePortAux(int refnum, const char* port_name, const char* port_type, JackPortFlags flags);
         void GetConnectionsAux(JackConnectionManager* manager, const char** res, jack_port_id_t port_index);
-        void GetPortsAux(const char** matching_ports, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags);
+        void GetPortsAux(const char** matching_ports, unsigned int port_max, const char* port_name_pattern, const char* type_name_pattern, unsigned long flags);
         jack_default_audio_sample_t* GetBuffer(jack_port_id_t port_index);
         void* GetBufferAux(JackConnectionManager* manager, jack_port_id_t port_index, jack_nframes_t frames);
         jack_nframes_t ComputeTotalLatencyAux(jack_port_id_t port_index, jack_port_id_t src_port_index, JackConnectionManager* manager, int hop_count);
         void RecalculateLatencyAux(jack_port_id_t port_index, jack_latency_callback_mode_t mode);
+        bool IsDelayedPort(JackConnectionManager* manager, jack_port_id_t port_index);
+        unsigned int GetPortLimit(unsigned int chunk_count);
+        JackGraphSnapshot* GetSnapshot(unsigned int chunk_count, UInt32 version);
+        JackGraphSnapshot* GetPublishedSnapshot(UInt32 version);
+        void PublishSnapshot(JackConnectionManager* manager);
+
+        // Hides JackAtomicState::WriteNextStateStop to publish the snapshot of each new state
+        void WriteNextStateStop();
 
     public:
 
@@ -73,6 +97,23 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
 
         JackPort* GetPort(jack_port_id_t index);
         jack_port_id_t GetPort(const char* name);
+        unsigned int GetPortMax()
+        {
+            return fPortMax;
+        }
+
+        unsigned int GetPortChunkCount()
+        {
+            return __atomic_load_n(&fChunkCount, __ATOMIC_ACQUIRE);
+        }
+        jack_shm_registry_index_t GetPortChunkIndex(unsigned int chunk)
+        {
+            return fChunkIndex[chunk];
+        }
+
+        // Client
+        void AttachPortChunks();
+        static void DetachPortChunks();
 
         int ComputeTotalLatency(jack_port_id_t port_index);
         int ComputeTotalLatencies();
@@ -96,6 +137,15 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
         void GetConnections(jack_port_id_t port_index, jack_int_t* connections);  // TODO
         const char** GetPorts(const char* port_name_pattern, const char* type_name_pattern, unsigned long flags);
 
+        // Graph snapshot, client
+        UInt32 GetSnapshotVersion()
+        {
+            return __atomic_load_n(&fSnapshotVersion, __ATOMIC_ACQUIRE);
+        }
+        int GetSnapshotSize();
+        int ReadSnapshot(jack_port_id_t* data, int data_size, UInt32* port_count, UInt32* version);
+        int ReadSnapshotPeers(jack_port_id_t port_index, jack_port_id_t* peers, int count, UInt32* version);
+
         int GetTwoPorts(const char* src, const char* dst, jack_port_id_t* src_index, jack_port_id_t* dst_index);
         int CheckPorts(jack_port_id_t port_src, jack_port_id_t port_dst);
 
@@ -110,20 +160,43 @@ class SERVER_EXPORT JackGraphManager : public JackShmMem, public JackAtomicState
         void Activate(int refnum);
         void Deactivate(int refnum);
 
+        // RT : clients activated in the graph being run
+        const jack_int_t* GetActiveRefNums(int* count)
+        {
+            return ReadCurrentState()->GetActiveRefNums(count);
+        }
+
         int GetInputRefNum(jack_port_id_t port_index);
         int GetOutputRefNum(jack_port_id_t port_index);
 
         // Buffer management
         void* GetBuffer(jack_port_id_t port_index, jack_nframes_t frames);
 
+        // Pipelined graph (freewheel)
+        void SetPipelineDepth(int depth);
+        void LatchPipeline(jack_nframes_t buffer_size, JackPipelineHistory* history);
+        int GetPipelineStage(int refnum);
+
         // Activation management
         void RunCurrentGraph();
         bool RunNextGraph();
         bool IsFinishedGraph();
 
         void InitRefNum(int refnum);
+
+        // Groups several graph changes in a single new state
+        void BeginUpdate()
+        {
+            WriteNextStateStart();
+        }
+        void EndUpdate()
+        {
+            WriteNextStateStop();
+        }
+
         int ResumeRefNum(JackClientControl* control, JackSynchro* table);
         int SuspendRefNum(JackClientControl* control, JackSynchro* table, long usecs);
+        void ClearOutputBuffers(int refnum, jack_nframes_t buffer_size);
         void TopologicalSort(std::vector<jack_int_t>& sorted);
 
         JackClientTiming* GetClientTiming(int refnum)
@@ -0,0 +1,98 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackGraphSnapshot.h"
+#include "JackConnectionManager.h"
+#include "JackError.h"
+#include <string.h>
+
+namespace Jack
+{
+
+void JackGraphSnapshot::Init(int port_limit)
+{
+    fSeq = 0;
+    fVersion = 0;
+    fPortMax = 0;
+    fDataSize = DataSize(port_limit);
+    fEdgeMax = fDataSize - 1;
+    fEdgeCount = 0;
+    fOverflow = 0;
+    fData[0] = 0;
+}
+
+// Server : the snapshot is not published yet
+void JackGraphSnapshot::CopyFrom(const JackGraphSnapshot* snapshot, int port_limit)
+{
+    Init(port_limit);
+    fVersion = snapshot->fVersion;
+    fPortMax = snapshot->fPortMax;
+    fEdgeMax = fDataSize - fPortMax - 1;
+    fEdgeCount = snapshot->fEdgeCount;
+    fOverflow = snapshot->fOverflow;
+    // Same offsets, room for peers only grows
+    memcpy(fData, snapshot->fData, (fPortMax + 1 + fEdgeCount) * sizeof(jack_port_id_t));
+}
+
+// Server
+void JackGraphSnapshot::Build(JackConnectionManager* manager, UInt32 port_max, UInt32 version)
+{
+    jack_port_id_t* offsets = fData;
+    jack_port_id_t* peers;
+    UInt32 count = 0;
+
+    __atomic_add_fetch(&fSeq, 1, __ATOMIC_ACQ_REL);  // Odd : readers will retry
+    fOverflow = 0;
+    fPortMax = port_max;
+    fEdgeMax = fDataSize - port_max - 1;
+    peers = fData + fPortMax + 1;
+
+    for (UInt32 port_index = 0; port_index < fPortMax; port_index++) {
+        offsets[port_index] = count;
+        int connections = manager->Connections(port_index);
+        if (count + connections > fEdgeMax) {
+            fOverflow = 1;
+            continue;
+        }
+        for (int i = 0; i < connections; i++) {
+            peers[count++] = manager->GetPort(port_index, i);
+        }
+    }
+
+    offsets[fPortMax] = count;
+    fEdgeCount = count;
+    fVersion = version;
+
+    if (fOverflow) {
+        jack_error("JackGraphSnapshot::Build connections do not fit in the snapshot, edge max = %ld", fEdgeMax);
+    }
+
+    __atomic_add_fetch(&fSeq, 1, __ATOMIC_RELEASE);
+}
+
+// Server
+bool JackGraphSnapshot::IsSameGraph(const JackGraphSnapshot* snapshot) const
+{
+    return (fPortMax == snapshot->fPortMax)
+        && (fEdgeCount == snapshot->fEdgeCount)
+        && (fOverflow == snapshot->fOverflow)
+        && (memcmp(fData, snapshot->fData, (fPortMax + 1 + fEdgeCount) * sizeof(jack_port_id_t)) == 0);
+}
+
+} // end of namespace
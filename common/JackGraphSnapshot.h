@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackGraphSnapshot__
+#define __JackGraphSnapshot__
+
+#include "JackTypes.h"
+#include "JackConstants.h"
+#include "JackCompilerDeps.h"
+#include "types.h"
+#include <stddef.h>
+
+namespace Jack
+{
+
+class JackConnectionManager;
+
+/*!
+\brief Compact (CSR) copy of the connection graph, published in shared memory for clients.
+
+<UL>
+<LI>The <B>fData</B> array starts with fPortMax + 1 offsets, followed by the peers : peers of port i are in [offset[i], offset[i + 1]).
+<LI>Each connection appears twice, in the peers of its source and of its destination port.
+<LI><B>fSeq</B> is odd while the server rewrites the snapshot : readers copy what they need and check it did not change meanwhile.
+It is a plain naturally aligned integer, only accessed with atomic builtins : a std::atomic field would make the compiler ignore the packing.
+<LI>The slot is sized for the ports up to the chunk it follows : as long as the port table did not grow that far, unused offsets leave more room for peers.
+</UL>
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackGraphSnapshot
+{
+
+    MEM_ALIGN(UInt32 fSeq, 4);
+    UInt32 fVersion;
+    UInt32 fPortMax;        // number of ports of the snapshot
+    UInt32 fDataSize;       // capacity of fData
+    UInt32 fEdgeMax;
+    UInt32 fEdgeCount;
+    UInt32 fOverflow;       // connections did not fit in fEdgeMax
+    jack_port_id_t fData[0];
+
+    static size_t DataSize(int port_limit)
+    {
+        // All peers come from the connection pool, which cannot hold more
+        int edge_max = port_limit * GRAPH_SNAPSHOT_PEER_NUM_FOR_PORT;
+        return port_limit + 1 + ((edge_max < CONNECTION_POOL_SIZE) ? edge_max : CONNECTION_POOL_SIZE);
+    }
+
+    static size_t Size(int port_limit)
+    {
+        // Keep the next snapshot aligned
+        size_t size = sizeof(JackGraphSnapshot) + DataSize(port_limit) * sizeof(jack_port_id_t);
+        return (size + 7) & ~7;
+    }
+
+    const jack_port_id_t* GetOffsets() const
+    {
+        return fData;
+    }
+
+    const jack_port_id_t* GetPeers() const
+    {
+        return fData + fPortMax + 1;
+    }
+
+    void Init(int port_limit);
+    void CopyFrom(const JackGraphSnapshot* snapshot, int port_limit);
+    void Build(JackConnectionManager* manager, UInt32 port_max, UInt32 version);
+    bool IsSameGraph(const JackGraphSnapshot* snapshot) const;
+
+} POST_PACKED_STRUCTURE;
+
+} // end of namespace
+
+#endif
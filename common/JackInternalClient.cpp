@@ -29,6 +29,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackClientControl.h"
 #include "JackInternalClientChannel.h"
 #include "JackTools.h"
+#include "JackMessageBuffer.h"
 #include <assert.h>
 
 namespace Jack
@@ -215,6 +216,7 @@ JackLoadableInternalClient::~JackLoadableInternalClient()
         fFinish(fProcessArg);
     }
     if (fHandle != NULL) {
+        JackMessageBuffer::Sync();
         UnloadJackModule(fHandle);
     }
 }
@@ -74,6 +74,10 @@ class JackInternalClientChannel : public detail::JackClientChannelInterface
         {
             *result = fEngine->PortUnRegister(refnum, port_index);
         }
+        void PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port_index, int is_real_time, int* result)
+        {
+            *result = fEngine->PortRegisterActivate(refnum, count, names, types, flags, port_index, is_real_time);
+        }
         void PortConnect(int refnum, const char* src, const char* dst, int* result)
         {
             *result = fEngine->PortConnect(refnum, src, dst);
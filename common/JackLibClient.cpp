@@ -136,11 +136,32 @@ int JackLibClient::Open(const char* server_name, const char* name, jack_uuid_t u
         JackGlobals::fVerbose = GetEngineControl()->fVerbose;
     } catch (...) {
         jack_error("Map shared memory segments exception");
+        jack_shm_release_fd(shared_engine);
+        jack_shm_release_fd(shared_graph);
+        jack_shm_release_fd(shared_client);
         goto error;
     }
 
+    // Chunks added later are notified
+    GetGraphManager()->AttachPortChunks();
+
+    // Segments already attached by another client of the process did not use their descriptor
+    jack_shm_release_fd(shared_engine);
+    jack_shm_release_fd(shared_graph);
+    jack_shm_release_fd(shared_client);
+
     SetupDriverSync(false);
 
+    // Threads started afterwards, except RT ones, stay off the CPUs reserved by the server
+    {
+        int rt_cpus[RT_CPU_MAX];
+        int rt_cpu_count = GetEngineControl()->fRTCpuCount;
+        for (int i = 0; i < rt_cpu_count; i++) {
+            rt_cpus[i] = GetEngineControl()->fRTCpus[i];
+        }
+        JackThread::SetRealTimeCpus(rt_cpus, rt_cpu_count);
+    }
+
     // Connect shared synchro : the synchro must be usable in I/O mode when several clients live in the same process
     assert(JackGlobals::fSynchroMutex);
     JackGlobals::fSynchroMutex->Lock();
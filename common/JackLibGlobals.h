@@ -89,6 +89,7 @@ struct JackLibGlobals
         for (int i = 0; i < CLIENT_NUM; i++) {
             fSynchroTable[i].Disconnect();
         }
+        JackGraphManager::DetachPortChunks();
         JackMessageBuffer::Destroy();
 
         delete fMetadata;
@@ -112,21 +112,21 @@ class SERVER_EXPORT JackLockedEngine
         int ClientCheck(const char* name, jack_uuid_t uuid, char* name_res, int protocol, int options, int* status)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ClientCheck(name, uuid, name_res, protocol, options, status);
             CATCH_EXCEPTION_RETURN
         }
         int ClientExternalOpen(const char* name, int pid, jack_uuid_t uuid, int* ref, int* shared_engine, int* shared_client, int* shared_graph_manager)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ClientExternalOpen(name, pid, uuid, ref, shared_engine, shared_client, shared_graph_manager);
             CATCH_EXCEPTION_RETURN
         }
         int ClientInternalOpen(const char* name, int* ref, JackEngineControl** shared_engine, JackGraphManager** shared_manager, JackClientInterface* client, bool wait)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ClientInternalOpen(name, ref, shared_engine, shared_manager, client, wait);
             CATCH_EXCEPTION_RETURN
         }
@@ -134,14 +134,14 @@ class SERVER_EXPORT JackLockedEngine
         int ClientExternalClose(int refnum)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.ClientExternalClose(refnum) : -1;
             CATCH_CLOSE_EXCEPTION_RETURN
         }
         int ClientInternalClose(int refnum, bool wait)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.ClientInternalClose(refnum, wait) : -1;
             CATCH_CLOSE_EXCEPTION_RETURN
         }
@@ -149,21 +149,21 @@ class SERVER_EXPORT JackLockedEngine
         int ClientActivate(int refnum, bool is_real_time)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.ClientActivate(refnum, is_real_time) : -1;
             CATCH_EXCEPTION_RETURN
         }
         int ClientDeactivate(int refnum)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.ClientDeactivate(refnum) : -1;
             CATCH_EXCEPTION_RETURN
         }
         void ClientKill(int refnum)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.ClientKill(refnum);
             CATCH_EXCEPTION
         }
@@ -172,21 +172,21 @@ class SERVER_EXPORT JackLockedEngine
         int GetInternalClientName(int int_ref, char* name_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.GetInternalClientName(int_ref, name_res);
             CATCH_EXCEPTION_RETURN
         }
         int InternalClientHandle(const char* client_name, int* status, int* int_ref)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.InternalClientHandle(client_name, status, int_ref);
             CATCH_EXCEPTION_RETURN
         }
         int InternalClientUnload(int refnum, int* status)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             // Client is tested in fEngine.InternalClientUnload
             return fEngine.InternalClientUnload(refnum, status);
             CATCH_EXCEPTION_RETURN
@@ -196,14 +196,21 @@ class SERVER_EXPORT JackLockedEngine
         int PortRegister(int refnum, const char* name, const char *type, unsigned int flags, unsigned int buffer_size, jack_port_id_t* port)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortRegister(refnum, name, type, flags, buffer_size, port) : -1;
             CATCH_EXCEPTION_RETURN
         }
+        int PortRegisterActivate(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, jack_port_id_t* port, bool is_real_time)
+        {
+            TRY_CALL
+            JackEngineLock lock(&fEngine);
+            return (fEngine.CheckClient(refnum)) ? fEngine.PortRegisterActivate(refnum, count, names, types, flags, port, is_real_time) : -1;
+            CATCH_EXCEPTION_RETURN
+        }
         int PortUnRegister(int refnum, jack_port_id_t port)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortUnRegister(refnum, port) : -1;
             CATCH_EXCEPTION_RETURN
         }
@@ -211,14 +218,14 @@ class SERVER_EXPORT JackLockedEngine
         int PortConnect(int refnum, const char* src, const char* dst)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortConnect(refnum, src, dst) : -1;
             CATCH_EXCEPTION_RETURN
         }
         int PortDisconnect(int refnum, const char* src, const char* dst)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortDisconnect(refnum, src, dst) : -1;
             CATCH_EXCEPTION_RETURN
         }
@@ -226,14 +233,14 @@ class SERVER_EXPORT JackLockedEngine
         int PortConnect(int refnum, jack_port_id_t src, jack_port_id_t dst)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortConnect(refnum, src, dst) : -1;
             CATCH_EXCEPTION_RETURN
         }
         int PortDisconnect(int refnum, jack_port_id_t src, jack_port_id_t dst)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortDisconnect(refnum, src, dst) : -1;
             CATCH_EXCEPTION_RETURN
         }
@@ -241,7 +248,7 @@ class SERVER_EXPORT JackLockedEngine
         int PortRename(int refnum, jack_port_id_t port, const char* name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortRename(refnum, port, name) : -1;
             CATCH_EXCEPTION_RETURN
         }
@@ -249,7 +256,7 @@ class SERVER_EXPORT JackLockedEngine
         int PortSetDefaultMetadata(int refnum, jack_port_id_t port, const char* pretty_name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return (fEngine.CheckClient(refnum)) ? fEngine.PortSetDefaultMetadata(port, pretty_name) : -1;
             CATCH_EXCEPTION_RETURN
         }
@@ -257,7 +264,7 @@ class SERVER_EXPORT JackLockedEngine
         int ComputeTotalLatencies()
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ComputeTotalLatencies();
             CATCH_EXCEPTION_RETURN
         }
@@ -279,15 +286,23 @@ class SERVER_EXPORT JackLockedEngine
         void NotifyClientXRun(int refnum)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifyClientXRun(refnum);
             CATCH_EXCEPTION
         }
 
+        void NotifyClientBudget(int refnum, int onoff)
+        {
+            TRY_CALL
+            JackEngineLock lock(&fEngine);
+            fEngine.NotifyClientBudget(refnum, onoff);
+            CATCH_EXCEPTION
+        }
+
         void NotifyGraphReorder()
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifyGraphReorder();
             CATCH_EXCEPTION
         }
@@ -295,21 +310,21 @@ class SERVER_EXPORT JackLockedEngine
         void NotifyBufferSize(jack_nframes_t buffer_size)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifyBufferSize(buffer_size);
             CATCH_EXCEPTION
         }
         void NotifySampleRate(jack_nframes_t sample_rate)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifySampleRate(sample_rate);
             CATCH_EXCEPTION
         }
         void NotifyFreewheel(bool onoff)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifyFreewheel(onoff);
             CATCH_EXCEPTION
         }
@@ -317,7 +332,7 @@ class SERVER_EXPORT JackLockedEngine
         void NotifyFailure(int code, const char* reason)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.NotifyFailure(code, reason);
             CATCH_EXCEPTION
         }
@@ -325,7 +340,7 @@ class SERVER_EXPORT JackLockedEngine
         int GetClientPID(const char* name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.GetClientPID(name);
             CATCH_EXCEPTION_RETURN
         }
@@ -333,7 +348,7 @@ class SERVER_EXPORT JackLockedEngine
         int GetClientRefNum(const char* name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.GetClientRefNum(name);
             CATCH_EXCEPTION_RETURN
         }
@@ -349,7 +364,7 @@ class SERVER_EXPORT JackLockedEngine
         void SessionNotify(int refnum, const char* target, jack_session_event_type_t type, const char *path, detail::JackChannelTransactionInterface *socket, JackSessionNotifyResult** result)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             fEngine.SessionNotify(refnum, target, type, path, socket, result);
             CATCH_EXCEPTION
         }
@@ -357,7 +372,7 @@ class SERVER_EXPORT JackLockedEngine
         int SessionReply(int refnum)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.SessionReply(refnum);
             CATCH_EXCEPTION_RETURN
         }
@@ -365,7 +380,7 @@ class SERVER_EXPORT JackLockedEngine
         int GetUUIDForClientName(const char *client_name, char *uuid_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.GetUUIDForClientName(client_name, uuid_res);
             CATCH_EXCEPTION_RETURN
         }
@@ -373,14 +388,14 @@ class SERVER_EXPORT JackLockedEngine
         int GetClientNameForUUID(const char *uuid, char *name_res)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.GetClientNameForUUID(uuid, name_res);
             CATCH_EXCEPTION_RETURN
         }
         int ReserveClientName(const char *name, const char *uuid)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ReserveClientName(name, uuid);
             CATCH_EXCEPTION_RETURN
         }
@@ -388,7 +403,7 @@ class SERVER_EXPORT JackLockedEngine
         int ClientHasSessionCallback(const char *name)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.ClientHasSessionCallback(name);
             CATCH_EXCEPTION_RETURN
         }
@@ -396,10 +411,18 @@ class SERVER_EXPORT JackLockedEngine
         int PropertyChangeNotify(jack_uuid_t subject, const char* key, jack_property_change_t change)
         {
             TRY_CALL
-            JackLock lock(&fEngine);
+            JackEngineLock lock(&fEngine);
             return fEngine.PropertyChangeNotify(subject, key, change);
             CATCH_EXCEPTION_RETURN
         }
+
+        int SetClientCpu(const char* name, int cpu)
+        {
+            TRY_CALL
+            JackEngineLock lock(&fEngine);
+            return fEngine.SetClientCpu(name, cpu);
+            CATCH_EXCEPTION_RETURN
+        }
 };
 
 } // end of namespace
@@ -23,12 +23,218 @@
 #include "JackGlobals.h"
 #include "JackError.h"
 #include "JackTime.h"
+#include <stdio.h>
+#include <stdint.h>
 
 namespace Jack
 {
 
 JackMessageBuffer* JackMessageBuffer::fInstance = NULL;
 
+// Static so that records stay readable whatever the order threads and message buffer go away
+JackLogRing JackMessageBuffer::fRings[MB_RINGS];
+
+// Gives the ring of a thread back when it exits
+struct JackLogRingOwner
+{
+    JackLogRing* fRing;
+
+    JackLogRingOwner():fRing(NULL)
+    {}
+    ~JackLogRingOwner()
+    {
+        if (fRing) {
+            fRing->Release();
+        }
+    }
+};
+
+static thread_local JackLogRingOwner gRingOwner;
+
+#define MB_SPEC_SIZE    32      /* conversion specification length limit */
+#define MB_SLOT(size)   (((size) + 7) & ~7)
+
+enum JackLogArg {
+    kLogArgNone,        // %%
+    kLogArgInt,
+    kLogArgLong,
+    kLogArgLongLong,
+    kLogArgSize,
+    kLogArgIntMax,
+    kLogArgPtrDiff,
+    kLogArgDouble,
+    kLogArgString,
+    kLogArgPointer,
+    kLogArgUnsupported
+};
+
+struct JackLogSpec
+{
+    const char* fStart;
+    int fLength;
+    int fStars;
+    JackLogArg fArg;
+};
+
+/*
+Finds the next conversion in fmt : literal text before it is [fmt, spec->fStart).
+Returns the format following the conversion, or NULL when there is none.
+*/
+static const char* ParseSpec(const char* fmt, JackLogSpec* spec)
+{
+    const char* p = strchr(fmt, '%');
+    int length = 0;     // 'l' = 1, 'll' = 2, 'z' = 3, 'j' = 4, 't' = 5, 'L' = 6
+
+    if (p == NULL) {
+        return NULL;
+    }
+
+    spec->fStart = p++;
+    spec->fStars = 0;
+    spec->fArg = kLogArgUnsupported;
+
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->fStars++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->fStars++;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            p += (p[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            length = (p[1] == 'l') ? 2 : 1;
+            p += length;
+            break;
+        case 'q':
+            length = 2;
+            p++;
+            break;
+        case 'z':
+            length = 3;
+            p++;
+            break;
+        case 'j':
+            length = 4;
+            p++;
+            break;
+        case 't':
+            length = 5;
+            p++;
+            break;
+        case 'L':
+            length = 6;
+            p++;
+            break;
+    }
+
+    switch (*p) {
+        case '%':
+            spec->fArg = (p == spec->fStart + 1) ? kLogArgNone : kLogArgUnsupported;
+            break;
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c': {
+            static const JackLogArg args[] = { kLogArgInt, kLogArgLong, kLogArgLongLong, kLogArgSize, kLogArgIntMax, kLogArgPtrDiff, kLogArgUnsupported };
+            spec->fArg = (*p == 'c' && length > 0) ? kLogArgUnsupported : args[length];
+            break;
+        }
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec->fArg = (length == 0 || length == 1) ? kLogArgDouble : kLogArgUnsupported;
+            break;
+        case 's':
+            spec->fArg = (length == 0) ? kLogArgString : kLogArgUnsupported;
+            break;
+        case 'p':
+            spec->fArg = (length == 0) ? kLogArgPointer : kLogArgUnsupported;
+            break;
+        case 0:
+            // Truncated conversion
+            spec->fLength = p - spec->fStart;
+            return p;
+    }
+
+    p++;
+    spec->fLength = p - spec->fStart;
+    if (spec->fLength >= MB_SPEC_SIZE) {
+        spec->fArg = kLogArgUnsupported;
+    }
+    return p;
+}
+
+template <typename T>
+static int FormatArg(char* dst, size_t size, const char* spec, int stars, const int* star, T value)
+{
+    switch (stars) {
+        case 0:
+            return snprintf(dst, size, spec, value);
+        case 1:
+            return snprintf(dst, size, spec, star[0], value);
+        default:
+            return snprintf(dst, size, spec, star[0], star[1], value);
+    }
+}
+
+bool JackLogRing::Write(const JackLogRecord* record)
+{
+    uint32_t write = fWrite.load(std::memory_order_relaxed);
+    uint32_t read = fRead.load(std::memory_order_acquire);
+    uint32_t pos = write & (MB_RING_SIZE - 1);
+    // Records are never split : skip the end of the ring if needed
+    uint32_t skip = (MB_RING_SIZE - pos < record->fSize) ? MB_RING_SIZE - pos : 0;
+
+    if (write - read + skip + record->fSize > MB_RING_SIZE) {
+        fDropped++;
+        return false;
+    }
+
+    char* buffer = (char*)fBuffer;
+    if (skip > 0) {
+        *(uint32_t*)&buffer[pos] = 0;
+        write += skip;
+        pos = 0;
+    }
+    memcpy(&buffer[pos], record, record->fSize);
+    fWrite.store(write + record->fSize, std::memory_order_release);
+    return true;
+}
+
+const JackLogRecord* JackLogRing::Read()
+{
+    uint32_t read = fRead.load(std::memory_order_relaxed);
+
+    while (read != fWrite.load(std::memory_order_acquire)) {
+        uint32_t pos = read & (MB_RING_SIZE - 1);
+        const JackLogRecord* record = (const JackLogRecord*)((char*)fBuffer + pos);
+        if (record->fSize > 0) {
+            return record;
+        }
+        read += MB_RING_SIZE - pos;
+        fRead.store(read, std::memory_order_release);
+    }
+
+    return NULL;
+}
+
+void JackLogRing::Next(const JackLogRecord* record)
+{
+    fRead.store(fRead.load(std::memory_order_relaxed) + record->fSize, std::memory_order_release);
+}
+
 JackMessageBuffer::JackMessageBuffer()
     :fInit(NULL),
     fInitArg(NULL),
@@ -62,6 +268,9 @@ bool JackMessageBuffer::Stop()
     } else {
         jack_log("no message buffer overruns");
     }
+    if (GetDropped() > 0) {
+        jack_error("WARNING: %u RT log records dropped!", GetDropped());
+    }
 
     if (fGuard.Lock()) {
         fRunning = false;
@@ -78,10 +287,140 @@ bool JackMessageBuffer::Stop()
 
 void JackMessageBuffer::Flush()
 {
+    // Also called by Sync() from other threads
+    fFlushMutex.Lock();
     while (fOutBuffer != fInBuffer) {
         jack_log_function(fBuffers[fOutBuffer].level, fBuffers[fOutBuffer].message);
         fOutBuffer = MB_NEXT(fOutBuffer);
     }
+    FlushRings();
+    fFlushMutex.Unlock();
+}
+
+void JackMessageBuffer::FlushRings()
+{
+    char message[MB_BUFFERSIZE];
+
+    // Oldest record first, whatever the thread
+    while (true) {
+        const JackLogRecord* oldest = NULL;
+        JackLogRing* ring = NULL;
+        for (int i = 0; i < MB_RINGS; i++) {
+            const JackLogRecord* record = fRings[i].Read();
+            if (record && (!oldest || record->fTime < oldest->fTime)) {
+                oldest = record;
+                ring = &fRings[i];
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        FormatRecord(oldest, message);
+        jack_log_function(oldest->fLevel, message);
+        ring->Next(oldest);
+    }
+}
+
+bool JackMessageBuffer::IsPending()
+{
+    for (int i = 0; i < MB_RINGS; i++) {
+        if (!fRings[i].IsEmpty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t JackMessageBuffer::GetDropped()
+{
+    uint32_t dropped = 0;
+    for (int i = 0; i < MB_RINGS; i++) {
+        dropped += fRings[i].GetDropped();
+    }
+    return dropped;
+}
+
+void JackMessageBuffer::FormatRecord(const JackLogRecord* record, char* message)
+{
+    const char* arg = (const char*)(record + 1);
+    const char* fmt = record->fFormat;
+    char spec_string[MB_SPEC_SIZE];
+    size_t len = 0;
+    JackLogSpec spec;
+    const char* next;
+
+    if (record->fPrefix) {
+        len = snprintf(message, MB_BUFFERSIZE, "%s", record->fPrefix);
+    }
+
+    while (len < MB_BUFFERSIZE - 1) {
+        next = ParseSpec(fmt, &spec);
+        size_t literal = (next) ? (size_t)(spec.fStart - fmt) : strlen(fmt);
+        if (literal > MB_BUFFERSIZE - 1 - len) {
+            literal = MB_BUFFERSIZE - 1 - len;
+        }
+        memcpy(message + len, fmt, literal);
+        len += literal;
+        if (next == NULL) {
+            break;
+        }
+
+        int star[2];
+        for (int i = 0; i < spec.fStars; i++) {
+            star[i] = (int)*(const int64_t*)arg;
+            arg += 8;
+        }
+
+        memcpy(spec_string, spec.fStart, spec.fLength);
+        spec_string[spec.fLength] = 0;
+        char* dst = message + len;
+        size_t size = MB_BUFFERSIZE - len;
+        int res = 0;
+
+        switch (spec.fArg) {
+            case kLogArgNone:
+                res = snprintf(dst, size, "%%");
+                break;
+            case kLogArgInt:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (int)*(const int64_t*)arg);
+                break;
+            case kLogArgLong:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (long)*(const int64_t*)arg);
+                break;
+            case kLogArgLongLong:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (long long)*(const int64_t*)arg);
+                break;
+            case kLogArgSize:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (size_t)*(const int64_t*)arg);
+                break;
+            case kLogArgIntMax:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (intmax_t)*(const int64_t*)arg);
+                break;
+            case kLogArgPtrDiff:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (ptrdiff_t)*(const int64_t*)arg);
+                break;
+            case kLogArgDouble:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, *(const double*)arg);
+                break;
+            case kLogArgPointer:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, (void*)(uintptr_t)*(const uint64_t*)arg);
+                break;
+            case kLogArgString:
+                res = FormatArg(dst, size, spec_string, spec.fStars, star, arg + 8);
+                arg += MB_SLOT(*(const uint32_t*)arg + 1);
+                break;
+            default:
+                break;
+        }
+        if (spec.fArg != kLogArgNone) {
+            arg += 8;
+        }
+
+        len += (res < 0) ? 0 : ((size_t)res < size) ? res : size - 1;
+        fmt = next;
+    }
+
+    message[len] = 0;
 }
 
 void JackMessageBuffer::AddMessage(int level, const char *message)
@@ -97,11 +436,116 @@ void JackMessageBuffer::AddMessage(int level, const char *message)
     }
 }
 
+/*
+Encodes the arguments of fmt without formatting them : this only takes a few copies in the RT thread.
+Returns false if the format cannot be encoded, for the caller to format it as usual.
+*/
+bool JackMessageBuffer::AddRecord(int level, const char* prefix, const char* fmt, va_list ap)
+{
+    uint64_t buffer[MB_RECORD_SIZE / sizeof(uint64_t)];
+    JackLogRecord* record = (JackLogRecord*)buffer;
+    char* end = (char*)buffer + sizeof(buffer);
+    char* arg = (char*)(record + 1);
+    const char* next = fmt;
+    JackLogSpec spec;
+    va_list args;
+
+    if (!gRingOwner.fRing) {
+        for (int i = 0; i < MB_RINGS && !gRingOwner.fRing; i++) {
+            if (fRings[i].Acquire()) {
+                gRingOwner.fRing = &fRings[i];
+            }
+        }
+        if (!gRingOwner.fRing) {
+            return false;
+        }
+    }
+
+    va_copy(args, ap);
+
+    while ((next = ParseSpec(next, &spec)) != NULL) {
+        if (spec.fArg == kLogArgUnsupported || arg + 8 * (spec.fStars + 1) > end) {
+            goto error;
+        }
+        for (int i = 0; i < spec.fStars; i++) {
+            *(int64_t*)arg = va_arg(args, int);
+            arg += 8;
+        }
+        switch (spec.fArg) {
+            case kLogArgNone:
+                continue;
+            case kLogArgInt:
+                *(int64_t*)arg = va_arg(args, int);
+                break;
+            case kLogArgLong:
+                *(int64_t*)arg = va_arg(args, long);
+                break;
+            case kLogArgLongLong:
+                *(int64_t*)arg = va_arg(args, long long);
+                break;
+            case kLogArgSize:
+                *(int64_t*)arg = va_arg(args, size_t);
+                break;
+            case kLogArgIntMax:
+                *(int64_t*)arg = va_arg(args, intmax_t);
+                break;
+            case kLogArgPtrDiff:
+                *(int64_t*)arg = va_arg(args, ptrdiff_t);
+                break;
+            case kLogArgDouble:
+                *(double*)arg = va_arg(args, double);
+                break;
+            case kLogArgPointer:
+                *(uint64_t*)arg = (uintptr_t)va_arg(args, void*);
+                break;
+            case kLogArgString: {
+                // Strings may not outlive the call : copy them, truncated to what is left in the record
+                const char* string = va_arg(args, const char*);
+                if (end - arg < 16) {
+                    goto error;
+                }
+                size_t available = end - arg - 8 - 1;
+                size_t length = strnlen((string) ? string : "(null)", available);
+                memcpy(arg + 8, (string) ? string : "(null)", length);
+                arg[8 + length] = 0;
+                *(uint32_t*)arg = length;
+                arg += MB_SLOT(length + 1);
+                break;
+            }
+            default:
+                goto error;
+        }
+        arg += 8;
+    }
+
+    va_end(args);
+
+    record->fSize = arg - (char*)buffer;
+    record->fLevel = level;
+    record->fTime = GetMicroSeconds();
+    record->fPrefix = prefix;
+    record->fFormat = fmt;
+
+    // A full ring is counted in the drops of the ring
+    if (gRingOwner.fRing->Write(record) && fGuard.Trylock()) {
+        fGuard.Signal();
+        fGuard.Unlock();
+    }
+    return true;
+
+error:
+    va_end(args);
+    return false;
+}
+
 bool JackMessageBuffer::Execute()
 {
     if (fGuard.Lock()) {
         while (fRunning) {
-            fGuard.Wait();
+            // Records written while the flusher had the lock did not signal it
+            if (!IsPending()) {
+                fGuard.Wait();
+            }
             /* the client asked for all threads to run a thread
             initialization callback, which includes us.
             */
@@ -152,6 +596,23 @@ bool JackMessageBuffer::Destroy()
     }
 }
 
+bool JackMessageBuffer::Sync()
+{
+    // Format pointers may point in a module which is going to be unloaded
+    if (fInstance != NULL) {
+        fInstance->Flush();
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool JackMessageBufferAddFormat(int level, const char* prefix, const char* fmt, va_list ap)
+{
+    return (Jack::JackMessageBuffer::fInstance != NULL)
+        && Jack::JackMessageBuffer::fInstance->AddRecord(level, prefix, fmt, ap);
+}
+
 void JackMessageBufferAdd(int level, const char *message)
 {
     if (Jack::JackMessageBuffer::fInstance == NULL) {
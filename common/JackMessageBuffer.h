@@ -32,6 +32,9 @@
 
 #include "JackPlatformPlug.h"
 #include "JackMutex.h"
+#include "types.h"
+#include <stdarg.h>
+#include <atomic>
 
 namespace Jack
 {
@@ -47,6 +50,74 @@ struct JackMessage
     char message[MB_BUFFERSIZE];
 };
 
+/* MB_RING_SIZE is a power of two */
+#define MB_RINGS        16      /* threads logging at the same time with deferred formatting */
+#define MB_RING_SIZE    16384   /* records of one thread */
+#define MB_RECORD_SIZE  256     /* record length limit */
+
+/*!
+\brief Log record with deferred formatting : the raw arguments of the format follow the header, in 8 bytes slots.
+*/
+
+struct JackLogRecord
+{
+    uint32_t fSize;         // whole record, 0 marks the end of the ring
+    int fLevel;
+    jack_time_t fTime;
+    const char* fPrefix;
+    const char* fFormat;
+};
+
+/*!
+\brief Lock-free ring of log records, written by one RT thread at a time and read by the message buffer thread.
+*/
+
+class JackLogRing
+{
+
+    private:
+
+        std::atomic<bool> fUsed;
+        std::atomic<uint32_t> fWrite;
+        std::atomic<uint32_t> fRead;
+        std::atomic<uint32_t> fDropped;
+        uint64_t fBuffer[MB_RING_SIZE / sizeof(uint64_t)];
+
+    public:
+
+        JackLogRing():fUsed(false), fWrite(0), fRead(0), fDropped(0)
+        {}
+
+        bool Acquire()
+        {
+            bool used = false;
+            return fUsed.compare_exchange_strong(used, true);
+        }
+
+        void Release()
+        {
+            fUsed = false;
+        }
+
+        uint32_t GetDropped()
+        {
+            return fDropped;
+        }
+
+        bool IsEmpty()
+        {
+            return fRead == fWrite;
+        }
+
+        // Writer
+        bool Write(const JackLogRecord* record);
+
+        // Reader
+        const JackLogRecord* Read();
+        void Next(const JackLogRecord* record);
+
+};
+
 /*!
 \brief Message buffer to be used from RT threads.
 */
@@ -65,8 +136,12 @@ class JackMessageBuffer : public JackRunnableInterface
         volatile unsigned int fOutBuffer;
         std::atomic<SInt32> fOverruns;
         bool fRunning;
+        JackMutex fFlushMutex;
 
         void Flush();
+        void FlushRings();
+        bool IsPending();
+        void FormatRecord(const JackLogRecord* record, char* message);
 
         bool Start();
         bool Stop();
@@ -83,9 +158,19 @@ class JackMessageBuffer : public JackRunnableInterface
 	    bool static Destroy();
 
         void AddMessage(int level, const char *message);
+        bool AddRecord(int level, const char* prefix, const char* fmt, va_list ap);
         int SetInitCallback(JackThreadInitCallback callback, void *arg);
 
+        SInt32 GetOverruns()
+        {
+            return fOverruns;
+        }
+        uint32_t GetDropped();
+
+        bool static Sync();
+
 	    static JackMessageBuffer* fInstance;
+	    static JackLogRing fRings[MB_RINGS];
 };
 
 #ifdef __cplusplus
@@ -94,6 +179,7 @@ extern "C"
 #endif
 
 void JackMessageBufferAdd(int level, const char *message);
+bool JackMessageBufferAddFormat(int level, const char* prefix, const char* fmt, va_list ap);
 
 #ifdef __cplusplus
 }
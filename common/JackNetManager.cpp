@@ -28,7 +28,7 @@ namespace Jack
 {
 //JackNetMaster******************************************************************************************************
 
-    JackNetMaster::JackNetMaster(JackNetSocket& socket, session_params_t& params, const char* multicast_ip)
+    JackNetMaster::JackNetMaster(JackNetSocket& socket, session_params_t& params, const char* multicast_ip, int jitter_latency)
             : JackNetMasterInterface(params, socket, multicast_ip)
     {
         jack_log("JackNetMaster::JackNetMaster");
@@ -39,6 +39,8 @@ namespace Jack
         fSendTransportData.fState = -1;
         fReturnTransportData.fState = -1;
         fLastTransportState = -1;
+        fJitterBuffer = NULL;
+        fJitterLatency = jitter_latency;
         int port_index;
 
         //jack audio ports
@@ -94,6 +96,14 @@ namespace Jack
 
         if (fClient) {
             jack_deactivate(fClient);
+        }
+        if (fJitterBuffer) {
+            jack_info("'%s' jitter buffer : %u late, %u lost, %u dropped cycle(s)", fParams.fName,
+                fJitterBuffer->GetLateCycles(), fJitterBuffer->GetLostCycles(), fJitterBuffer->GetDroppedCycles());
+            fJitterBuffer->Stop();
+            delete fJitterBuffer;
+        }
+        if (fClient) {
             FreePorts();
             jack_client_close(fClient);
         }
@@ -158,6 +168,16 @@ namespace Jack
         //process can now run
         fRunning = true;
 
+        //network I/O in its own thread, process callback only exchanges buffers with it
+        if (fJitterLatency > 0) {
+            fJitterBuffer = new JackNetJitterBuffer(this, &fParams, fJitterLatency);
+            if (!fJitterBuffer->Start(jack_client_real_time_priority(fClient) - 1)) {
+                jack_error("Can't start NetMaster network thread");
+                goto fail;
+            }
+            jack_info("'%s' uses a %d cycle(s) jitter buffer", fParams.fName, fJitterLatency);
+        }
+
         //finally activate jack client
         if (jack_activate(fClient) != 0) {
             jack_error("Can't activate JACK client");
@@ -171,6 +191,11 @@ namespace Jack
         return true;
 
     fail:
+        if (fJitterBuffer) {
+            fJitterBuffer->Stop();
+            delete fJitterBuffer;
+            fJitterBuffer = NULL;
+        }
         FreePorts();
         jack_client_close(fClient);
         fClient = NULL;
@@ -394,6 +419,7 @@ namespace Jack
     {
         JackNetMaster* obj = static_cast<JackNetMaster*>(arg);
         jack_nframes_t port_latency = jack_get_buffer_size(obj->fClient);
+        jack_nframes_t jitter_latency = obj->fJitterLatency * port_latency;
         jack_latency_range_t range;
         
         //audio
@@ -406,7 +432,7 @@ namespace Jack
         //audio
         for (int i = 0; i < obj->fParams.fReturnAudioChannels; i++) {
             //port latency
-            range.min = range.max = float(obj->fParams.fNetworkLatency * port_latency) / 2.f + ((obj->fParams.fSlaveSyncMode) ? 0 : port_latency);
+            range.min = range.max = float(obj->fParams.fNetworkLatency * port_latency) / 2.f + ((obj->fParams.fSlaveSyncMode) ? 0 : port_latency) + jitter_latency;
             jack_port_set_latency_range(obj->fAudioPlaybackPorts[i], JackCaptureLatency, &range);
         }
         
@@ -420,7 +446,7 @@ namespace Jack
         //midi
         for (int i = 0; i < obj->fParams.fReturnMidiChannels; i++) {
             //port latency
-            range.min = range.max = obj->fParams.fNetworkLatency * port_latency + ((obj->fParams.fSlaveSyncMode) ? 0 : port_latency);
+            range.min = range.max = obj->fParams.fNetworkLatency * port_latency + ((obj->fParams.fSlaveSyncMode) ? 0 : port_latency) + jitter_latency;
             jack_port_set_latency_range(obj->fMidiPlaybackPorts[i], JackCaptureLatency, &range);
         }
     }
@@ -454,10 +480,9 @@ namespace Jack
             return 0;
         }
 
-#ifdef JACK_MONITOR
-        jack_time_t begin_time = GetMicroSeconds();
-        fNetTimeMon->New();
-#endif
+        if (fJitterBuffer) {
+            return ProcessAsync();
+        }
 
         //buffers
         for (int midi_port_index = 0; midi_port_index < fParams.fSendMidiChannels; midi_port_index++) {
@@ -509,6 +534,120 @@ namespace Jack
         #endif
         }
 
+        int res = NetworkCycle();
+        if (res == DATA_PACKET_ERROR) {
+            // Well not a real XRun...
+            JackServerGlobals::fInstance->GetEngine()->NotifyClientXRun(ALL_CLIENTS);
+            return 0;
+        }
+        return res;
+    }
+
+    int JackNetMaster::ProcessAsync()
+    {
+        size_t midi_size = BUFFER_SIZE_MAX * sizeof(sample_t);
+
+        // hand this cycle's captured buffers to the network thread
+        net_jitter_slot_t* slot = fJitterBuffer->AcquireSlot();
+        if (slot) {
+            for (int midi_port_index = 0; midi_port_index < fParams.fSendMidiChannels; midi_port_index++) {
+                JackMidiBuffer* src = static_cast<JackMidiBuffer*>(jack_port_get_buffer(fMidiCapturePorts[midi_port_index], fParams.fPeriodSize));
+                JackMidiBuffer* dst = reinterpret_cast<JackMidiBuffer*>(slot->fSendMidi + midi_port_index * midi_size);
+                size_t event_size = sizeof(JackMidiBuffer) + src->event_count * sizeof(JackMidiEvent);
+                memcpy(dst, src, event_size);
+                memcpy(reinterpret_cast<char*>(dst) + src->buffer_size - src->write_pos,
+                        reinterpret_cast<char*>(src) + src->buffer_size - src->write_pos,
+                        src->write_pos);
+            }
+            for (int audio_port_index = 0; audio_port_index < fParams.fSendAudioChannels; audio_port_index++) {
+                // Port is connected on both sides...
+                bool active = fNetAudioCaptureBuffer->GetConnected(audio_port_index)
+                            && (jack_port_connected(fAudioCapturePorts[audio_port_index]) > 0);
+                slot->fSendActive[audio_port_index] = active;
+                if (active) {
+                    memcpy(slot->fSendAudio + audio_port_index * fParams.fPeriodSize,
+                            jack_port_get_buffer(fAudioCapturePorts[audio_port_index], fParams.fPeriodSize),
+                            sizeof(sample_t) * fParams.fPeriodSize);
+                }
+            }
+            for (int audio_port_index = 0; audio_port_index < fParams.fReturnAudioChannels; audio_port_index++) {
+                slot->fReturnActive[audio_port_index] = (jack_port_connected(fAudioPlaybackPorts[audio_port_index]) > 0);
+            }
+            fJitterBuffer->WriteSlot(slot);
+        }
+
+        // output the slot received 'latency' cycles ago, or silence if it is late or lost
+        slot = fJitterBuffer->ReadSlot();
+        bool valid = (slot && slot->fStatus == 0);
+
+        for (int midi_port_index = 0; midi_port_index < fParams.fReturnMidiChannels; midi_port_index++) {
+            JackMidiBuffer* dst = static_cast<JackMidiBuffer*>(jack_port_get_buffer(fMidiPlaybackPorts[midi_port_index], fParams.fPeriodSize));
+            JackMidiBuffer* src = reinterpret_cast<JackMidiBuffer*>(slot ? slot->fReturnMidi + midi_port_index * midi_size : NULL);
+            if (valid && src->IsValid() && src->buffer_size == dst->buffer_size && src->write_pos <= src->buffer_size) {
+                memcpy(dst, src, sizeof(JackMidiBuffer) + src->event_count * sizeof(JackMidiEvent));
+                memcpy(reinterpret_cast<char*>(dst) + src->buffer_size - src->write_pos,
+                        reinterpret_cast<char*>(src) + src->buffer_size - src->write_pos,
+                        src->write_pos);
+            } else {
+                dst->Reset(fParams.fPeriodSize);
+            }
+        }
+        for (int audio_port_index = 0; audio_port_index < fParams.fReturnAudioChannels; audio_port_index++) {
+            sample_t* out = static_cast<sample_t*>(jack_port_get_buffer(fAudioPlaybackPorts[audio_port_index], fParams.fPeriodSize));
+            if (valid && slot->fReturnActive[audio_port_index]) {
+                memcpy(out, slot->fReturnAudio + audio_port_index * fParams.fPeriodSize, sizeof(sample_t) * fParams.fPeriodSize);
+            } else {
+                memset(out, 0, sizeof(sample_t) * fParams.fPeriodSize);
+            }
+        }
+
+        if (slot) {
+            fJitterBuffer->ReleaseSlot(slot);
+        }
+        return 0;
+    }
+
+    void JackNetMaster::NetworkCycle(net_jitter_slot_t* slot)
+    {
+        size_t midi_size = BUFFER_SIZE_MAX * sizeof(sample_t);
+
+        //buffers, owned by the network thread until the slot is queued back
+        for (int midi_port_index = 0; midi_port_index < fParams.fSendMidiChannels; midi_port_index++) {
+            fNetMidiCaptureBuffer->SetBuffer(midi_port_index, reinterpret_cast<JackMidiBuffer*>(slot->fSendMidi + midi_port_index * midi_size));
+        }
+        for (int audio_port_index = 0; audio_port_index < fParams.fSendAudioChannels; audio_port_index++) {
+            fNetAudioCaptureBuffer->SetBuffer(audio_port_index,
+                                            (slot->fSendActive[audio_port_index])
+                                            ? slot->fSendAudio + audio_port_index * fParams.fPeriodSize
+                                            : NULL);
+        }
+        for (int midi_port_index = 0; midi_port_index < fParams.fReturnMidiChannels; midi_port_index++) {
+            JackMidiBuffer* midi_buffer = reinterpret_cast<JackMidiBuffer*>(slot->fReturnMidi + midi_port_index * midi_size);
+            midi_buffer->magic = JackMidiBuffer::MAGIC;
+            midi_buffer->buffer_size = midi_size;
+            midi_buffer->Reset(fParams.fPeriodSize);
+            fNetMidiPlaybackBuffer->SetBuffer(midi_port_index, midi_buffer);
+        }
+        for (int audio_port_index = 0; audio_port_index < fParams.fReturnAudioChannels; audio_port_index++) {
+            sample_t* out = (slot->fReturnActive[audio_port_index])
+                ? slot->fReturnAudio + audio_port_index * fParams.fPeriodSize
+                : NULL;
+            if (out) {
+                memset(out, 0, sizeof(sample_t) * fParams.fPeriodSize);
+            }
+            fNetAudioPlaybackBuffer->SetBuffer(audio_port_index, out);
+        }
+
+        slot->fStatus = NetworkCycle();
+    }
+
+    int JackNetMaster::NetworkCycle()
+    {
+#ifdef JACK_MONITOR
+        jack_time_t begin_time = GetMicroSeconds();
+        fNetTimeMon->New();
+#endif
+
         // encode the first packet
         EncodeSyncPacket();
 
@@ -558,12 +697,8 @@ namespace Jack
         
             case 0:
             case SOCKET_ERROR:
-                return res;
-                
             case DATA_PACKET_ERROR:
-                // Well not a real XRun...
-                JackServerGlobals::fInstance->GetEngine()->NotifyClientXRun(ALL_CLIENTS);
-                break;
+                return res;
         }
 
 #ifdef JACK_MONITOR
@@ -631,6 +766,198 @@ namespace Jack
     }
 
 
+//JackNetJitterBuffer************************************************************************************************
+
+    JackNetJitterBuffer::JackNetJitterBuffer(JackNetMaster* master, session_params_t* params, int latency)
+        : fMaster(master),
+        fThread(this),
+        fGuard(),
+        fLatency(latency),
+        fPrimed(false),
+        fRunning(false),
+        fLateCycles(0),
+        fLostCycles(0),
+        fDroppedCycles(0)
+    {
+        jack_log("JackNetJitterBuffer::JackNetJitterBuffer latency = %d", latency);
+
+        // 'latency' slots queued back to the process, one in the network thread, one being filled, one spare
+        fSlotCount = fLatency + 3;
+        fPeriodUsecs = (long)(1000000.f * ((float)params->fPeriodSize / (float)params->fSampleRate));
+
+        fSlots = new net_jitter_slot_t[fSlotCount];
+        fFreeSlots = new int[fSlotCount];
+        for (int i = 0; i < fSlotCount; i++) {
+            AllocSlot(&fSlots[i], params);
+            fFreeSlots[i] = i;
+        }
+        fFreeCount = fSlotCount;
+
+        // each queue must be able to hold every slot
+        fSendQueue = jack_ringbuffer_create((fSlotCount + 1) * sizeof(int));
+        fReturnQueue = jack_ringbuffer_create((fSlotCount + 1) * sizeof(int));
+        jack_ringbuffer_mlock(fSendQueue);
+        jack_ringbuffer_mlock(fReturnQueue);
+    }
+
+    JackNetJitterBuffer::~JackNetJitterBuffer()
+    {
+        jack_log("JackNetJitterBuffer::~JackNetJitterBuffer");
+        jack_ringbuffer_free(fSendQueue);
+        jack_ringbuffer_free(fReturnQueue);
+        for (int i = 0; i < fSlotCount; i++) {
+            FreeSlot(&fSlots[i]);
+        }
+        delete[] fSlots;
+        delete[] fFreeSlots;
+    }
+
+    void JackNetJitterBuffer::AllocSlot(net_jitter_slot_t* slot, session_params_t* params)
+    {
+        size_t midi_size = BUFFER_SIZE_MAX * sizeof(sample_t);
+
+        slot->fSendAudio = new sample_t[params->fSendAudioChannels * params->fPeriodSize];
+        slot->fReturnAudio = new sample_t[params->fReturnAudioChannels * params->fPeriodSize];
+        slot->fSendMidi = new char[params->fSendMidiChannels * midi_size];
+        slot->fReturnMidi = new char[params->fReturnMidiChannels * midi_size];
+        slot->fSendActive = new bool[params->fSendAudioChannels];
+        slot->fReturnActive = new bool[params->fReturnAudioChannels];
+        slot->fStatus = 0;
+
+        memset(slot->fSendAudio, 0, params->fSendAudioChannels * params->fPeriodSize * sizeof(sample_t));
+        memset(slot->fReturnAudio, 0, params->fReturnAudioChannels * params->fPeriodSize * sizeof(sample_t));
+        memset(slot->fSendMidi, 0, params->fSendMidiChannels * midi_size);
+        memset(slot->fReturnMidi, 0, params->fReturnMidiChannels * midi_size);
+        memset(slot->fSendActive, 0, params->fSendAudioChannels * sizeof(bool));
+        memset(slot->fReturnActive, 0, params->fReturnAudioChannels * sizeof(bool));
+    }
+
+    void JackNetJitterBuffer::FreeSlot(net_jitter_slot_t* slot)
+    {
+        delete[] slot->fSendAudio;
+        delete[] slot->fReturnAudio;
+        delete[] slot->fSendMidi;
+        delete[] slot->fReturnMidi;
+        delete[] slot->fSendActive;
+        delete[] slot->fReturnActive;
+    }
+
+    bool JackNetJitterBuffer::Start(int priority)
+    {
+        // Before StartSync()...
+        fRunning = true;
+        if (fThread.StartSync() < 0) {
+            fRunning = false;
+            return false;
+        }
+
+        // below the process callback so that network I/O never preempts the graph
+        if (priority > 0 && fThread.AcquireRealTime(priority) < 0) {
+            jack_error("Can't set NetMaster network thread realtime priority");
+        }
+        return true;
+    }
+
+    void JackNetJitterBuffer::Stop()
+    {
+        if (fGuard.Lock()) {
+            fRunning = false;
+            fGuard.Signal();
+            fGuard.Unlock();
+            fThread.Stop();
+        } else {
+            fRunning = false;
+            fThread.Kill();
+        }
+    }
+
+    bool JackNetJitterBuffer::Execute()
+    {
+        int index;
+
+        if (!fGuard.Lock()) {
+            jack_error("JackNetJitterBuffer::Execute lock cannot be taken");
+            return false;
+        }
+        // a signal may be lost on lock collision, so never wait longer than a cycle
+        while (fRunning && jack_ringbuffer_read_space(fSendQueue) < sizeof(int)) {
+            fGuard.TimedWait(fPeriodUsecs);
+        }
+        fGuard.Unlock();
+
+        if (!fRunning) {
+            return false;
+        }
+
+        jack_ringbuffer_read(fSendQueue, (char*)&index, sizeof(int));
+        net_jitter_slot_t* slot = &fSlots[index];
+
+        fMaster->NetworkCycle(slot);
+        if (slot->fStatus != 0) {
+            fLostCycles++;
+        }
+
+        jack_ringbuffer_write(fReturnQueue, (char*)&index, sizeof(int));
+        return true;
+    }
+
+    net_jitter_slot_t* JackNetJitterBuffer::AcquireSlot()
+    {
+        if (fFreeCount == 0) {
+            // network thread is stalled and holds every slot
+            fDroppedCycles++;
+            return NULL;
+        }
+        return &fSlots[fFreeSlots[--fFreeCount]];
+    }
+
+    void JackNetJitterBuffer::WriteSlot(net_jitter_slot_t* slot)
+    {
+        int index = slot - fSlots;
+        jack_ringbuffer_write(fSendQueue, (char*)&index, sizeof(int));
+
+        // never block the process thread, the network thread polls anyway
+        if (fGuard.Trylock()) {
+            fGuard.Signal();
+            fGuard.Unlock();
+        }
+    }
+
+    net_jitter_slot_t* JackNetJitterBuffer::ReadSlot()
+    {
+        int index;
+        size_t available = jack_ringbuffer_read_space(fReturnQueue) / sizeof(int);
+
+        // wait for the buffer to be filled up to the requested latency
+        if (!fPrimed) {
+            if (available < (size_t)fLatency) {
+                return NULL;
+            }
+            fPrimed = true;
+        }
+
+        if (available == 0) {
+            fLateCycles++;
+            return NULL;
+        }
+
+        // network thread caught up after a stall : skip the oldest cycles to keep latency constant
+        while (available > (size_t)fLatency) {
+            jack_ringbuffer_read(fReturnQueue, (char*)&index, sizeof(int));
+            ReleaseSlot(&fSlots[index]);
+            fLateCycles++;
+            available--;
+        }
+
+        jack_ringbuffer_read(fReturnQueue, (char*)&index, sizeof(int));
+        return &fSlots[index];
+    }
+
+    void JackNetJitterBuffer::ReleaseSlot(net_jitter_slot_t* slot)
+    {
+        fFreeSlots[fFreeCount++] = slot - fSlots;
+    }
+
 //JackNetMasterManager***********************************************************************************************
 
     JackNetMasterManager::JackNetMasterManager(jack_client_t* client, const JSList* params) : fSocket()
@@ -643,6 +970,7 @@ namespace Jack
         fRunning = true;
         fAutoConnect = false;
         fAutoSave = false;
+        fJitterLatency = 0;
 
         const JSList* node;
         const jack_driver_param_t* param;
@@ -683,6 +1011,14 @@ namespace Jack
                 case 's':
                     fAutoSave = true;
                     break;
+
+                case 'j':
+                    if (param->value.ui <= NETWORK_MAX_LATENCY) {
+                        fJitterLatency = param->value.ui;
+                    } else {
+                        jack_error("Jitter buffer latency must be <= %d, using synchronous network I/O", NETWORK_MAX_LATENCY);
+                    }
+                    break;
             }
         }
 
@@ -887,7 +1223,7 @@ namespace Jack
         }
 
         //create a new master and add it to the list
-        JackNetMaster* master = new JackNetMaster(fSocket, params, fMulticastIP);
+        JackNetMaster* master = new JackNetMaster(fSocket, params, fMulticastIP, fJitterLatency);
         if (master->Init(fAutoConnect)) {
             fMasterList.push_back(master);
             if (fAutoSave && fMasterConnectionList.find(params.fName) != fMasterConnectionList.end()) {
@@ -958,6 +1294,9 @@ extern "C"
         value.i = false;
         jack_driver_descriptor_add_parameter(desc, &filler, "auto-save", 's', JackDriverParamBool, &value, NULL, "Save/restore netmaster connection state when restarted", NULL);
 
+        value.ui = 0U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "jitter-buffer", 'j', JackDriverParamUInt, &value, NULL, "Network I/O in a separate thread with a jitter buffer of n cycles (0 = in process callback)", NULL);
+
         return desc;
     }
 
@@ -21,13 +21,94 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #define __JACKNETMANAGER_H__
 
 #include "JackNetInterface.h"
+#include "JackPlatformPlug.h"
 #include "jack.h"
+#include "ringbuffer.h"
+#include <atomic>
 #include <list>
 #include <map>
 
 namespace Jack
 {
     class JackNetMasterManager;
+    class JackNetMaster;
+
+    /**
+    \Brief One cycle of audio and MIDI exchanged between a NetMaster process callback and its network thread
+    */
+
+    struct net_jitter_slot_t
+    {
+        sample_t* fSendAudio;       // fSendAudioChannels * period
+        sample_t* fReturnAudio;     // fReturnAudioChannels * period
+        char* fSendMidi;            // fSendMidiChannels * MIDI port buffer size
+        char* fReturnMidi;          // fReturnMidiChannels * MIDI port buffer size
+        bool* fSendActive;          // send audio port is connected on both sides
+        bool* fReturnActive;        // return audio port is connected locally
+        int fStatus;                // result of the network cycle
+    };
+
+    /**
+    \Brief Jitter buffer decoupling the NetMaster process callback from network I/O.
+
+    The process callback fills a free slot with the captured buffers and queues it to a dedicated
+    network thread, which does the blocking send/receive cycle with the slave and queues the slot back.
+    Returned slots are consumed 'latency' cycles later, so a late or lost slave cycle only produces
+    silence on this slave's ports instead of stalling the whole master graph.
+    Both queues are lock-free single reader/single writer ringbuffers, the free list is only touched by the process thread.
+    */
+
+    class JackNetJitterBuffer : public JackRunnableInterface
+    {
+
+        private:
+
+            JackNetMaster* fMaster;
+            JackThread fThread;
+            JackProcessSync fGuard;
+
+            net_jitter_slot_t* fSlots;
+            int fSlotCount;
+            int fLatency;
+            long fPeriodUsecs;
+
+            jack_ringbuffer_t* fSendQueue;      // process -> network thread
+            jack_ringbuffer_t* fReturnQueue;    // network thread -> process
+            int* fFreeSlots;
+            int fFreeCount;
+            bool fPrimed;
+            volatile bool fRunning;
+
+            // statistics
+            std::atomic<uint32_t> fLateCycles;      // return slot not available in time
+            std::atomic<uint32_t> fLostCycles;      // network cycle failed (missing or erroneous packets)
+            std::atomic<uint32_t> fDroppedCycles;   // no free slot, capture not sent
+
+            void AllocSlot(net_jitter_slot_t* slot, session_params_t* params);
+            void FreeSlot(net_jitter_slot_t* slot);
+
+        public:
+
+            JackNetJitterBuffer(JackNetMaster* master, session_params_t* params, int latency);
+            ~JackNetJitterBuffer();
+
+            bool Start(int priority);
+            void Stop();
+
+            // JackRunnableInterface interface
+            bool Execute();
+
+            // to be used from the process thread only
+            net_jitter_slot_t* AcquireSlot();
+            void WriteSlot(net_jitter_slot_t* slot);
+            net_jitter_slot_t* ReadSlot();
+            void ReleaseSlot(net_jitter_slot_t* slot);
+
+            int GetLatency() { return fLatency; }
+            uint32_t GetLateCycles() { return fLateCycles; }
+            uint32_t GetLostCycles() { return fLostCycles; }
+            uint32_t GetDroppedCycles() { return fDroppedCycles; }
+    };
 
     /**
     \Brief This class describes a Net Master
@@ -38,6 +119,7 @@ namespace Jack
     class JackNetMaster : public JackNetMasterInterface
     {
             friend class JackNetMasterManager;
+            friend class JackNetJitterBuffer;
 
         private:
 
@@ -61,6 +143,10 @@ namespace Jack
             //sync and transport
             int fLastTransportState;
 
+            //asynchronous network I/O (NULL when the network cycle runs in the process callback)
+            JackNetJitterBuffer* fJitterBuffer;
+            int fJitterLatency;
+
             //monitoring
 #ifdef JACK_MONITOR
             jack_time_t fPeriodUsecs;
@@ -76,6 +162,9 @@ namespace Jack
             void DecodeTransportData();
 
             int Process();
+            int ProcessAsync();
+            int NetworkCycle();
+            void NetworkCycle(net_jitter_slot_t* slot);
             void TimebaseCallback(jack_position_t* pos);
             void ConnectPorts();
             void ConnectCallback(jack_port_id_t a, jack_port_id_t b, int connect);
@@ -85,7 +174,7 @@ namespace Jack
 
         public:
 
-            JackNetMaster(JackNetSocket& socket, session_params_t& params, const char* multicast_ip);
+            JackNetMaster(JackNetSocket& socket, session_params_t& params, const char* multicast_ip, int jitter_latency = 0);
             ~JackNetMaster();
 
             bool IsSlaveReadyToRoll();
@@ -120,6 +209,7 @@ namespace Jack
             bool fRunning;
             bool fAutoConnect;
             bool fAutoSave;
+            int fJitterLatency;
 
             void Run();
             JackNetMaster* InitMaster(session_params_t& params);
@@ -541,8 +541,6 @@ JackNetOneDriver::render_payload_to_jack_ports_float(void *packet_payload, jack_
         return;
 
     while (node != NULL) {
-        unsigned int i;
-        int_float_t val;
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
@@ -559,9 +557,7 @@ JackNetOneDriver::render_payload_to_jack_ports_float(void *packet_payload, jack_
             // audio port, resample if necessary
             if (net_period_down != nframes) {
                 SRC_STATE *src_state = (SRC_STATE *)src_node->data;
-                for (i = 0; i < net_period_down; i++) {
-                    packet_bufX[i] = ntohl (packet_bufX[i]);
-                }
+                netjack_net_to_float ((float *) packet_bufX, packet_bufX, net_period_down);
 
                 src.data_in = (float *) packet_bufX;
                 src.input_frames = net_period_down;
@@ -581,11 +577,7 @@ JackNetOneDriver::render_payload_to_jack_ports_float(void *packet_payload, jack_
                 if (dont_htonl_floats) {
                     memcpy(buf, packet_bufX, net_period_down * sizeof(jack_default_audio_sample_t));
                 } else {
-                    for (i = 0; i < net_period_down; i++) {
-                        val.i = packet_bufX[i];
-                        val.i = ntohl (val.i);
-                        buf[i] = val.f;
-                    }
+                    netjack_net_to_float (buf, packet_bufX, net_period_down);
                 }
             }
         } else if (strncmp (porttype, JACK_DEFAULT_MIDI_TYPE, jack_port_type_size()) == 0) {
@@ -616,8 +608,6 @@ JackNetOneDriver::render_jack_ports_to_payload_float (JSList *playback_ports, JS
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
-        unsigned int i;
-        int_float_t val;
         jack_port_id_t port_index = (jack_port_id_t)(intptr_t) node->data;
         JackPort *port = fGraphManager->GetPort(port_index);
 
@@ -644,9 +634,7 @@ JackNetOneDriver::render_jack_ports_to_payload_float (JSList *playback_ports, JS
                 src_set_ratio (src_state, src.src_ratio);
                 src_process (src_state, &src);
 
-                for (i = 0; i < net_period_up; i++) {
-                    packet_bufX[i] = htonl (packet_bufX[i]);
-                }
+                netjack_float_to_net (packet_bufX, (float *) packet_bufX, net_period_up);
                 src_node = jack_slist_next (src_node);
             } else
 #endif
@@ -654,11 +642,7 @@ JackNetOneDriver::render_jack_ports_to_payload_float (JSList *playback_ports, JS
                 if (dont_htonl_floats) {
                     memcpy(packet_bufX, buf, net_period_up * sizeof(jack_default_audio_sample_t));
                 } else {
-                    for (i = 0; i < net_period_up; i++) {
-                        val.f = buf[i];
-                        val.i = htonl (val.i);
-                        packet_bufX[i] = val.i;
-                    }
+                    netjack_float_to_net (packet_bufX, buf, net_period_up);
                 }
             }
         } else if (strncmp(porttype, JACK_DEFAULT_MIDI_TYPE, jack_port_type_size()) == 0) {
@@ -48,6 +48,9 @@ enum NotificationType {
     kSessionCallback = 17,
     kLatencyCallback = 18,
     kPropertyChangeCallback = 19,
+    kBudgetCallback = 20,
+    kAddPortChunk = 21,
+    kRealTimeCpu = 22,
     kMaxNotification = 64  // To keep some room in JackClientControl fCallback table
 };
 
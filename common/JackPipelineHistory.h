@@ -0,0 +1,115 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackPipelineHistory__
+#define __JackPipelineHistory__
+
+#include "JackTypes.h"
+#include "types.h"
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+namespace Jack
+{
+
+/*!
+\brief Outputs of previous cycles, for the connections that span several freewheel pipeline stages (server side).
+
+ Each port output is kept for depth - 1 cycles. Buffers are only allocated once a port feeds such a connection :
+ freewheel mode does not run in real-time, and the set of ports only changes with the graph.
+*/
+
+class JackPipelineHistory
+{
+
+    private:
+
+        struct Line
+        {
+            std::vector<char> fData;
+            std::vector<uint64_t> fCycle;   // cycle of the output kept in each slot
+        };
+
+        std::map<jack_port_id_t, Line> fLines;
+        int fSlots;
+        uint64_t fCycle;                    // latches done since Reset
+
+    public:
+
+        JackPipelineHistory(): fSlots(0), fCycle(0)
+        {}
+
+        void Reset()
+        {
+            fLines.clear();
+            fCycle = 0;
+        }
+
+        void SetDepth(int depth)
+        {
+            if (depth - 1 != fSlots) {
+                fSlots = depth - 1;
+                fLines.clear();
+            }
+        }
+
+        uint64_t GetCycle() const
+        {
+            return fCycle;
+        }
+
+        void NextCycle()
+        {
+            fCycle++;
+        }
+
+        // Output of the port for the given cycle, NULL if it has not been kept
+        void* Read(jack_port_id_t port_index, uint64_t cycle, size_t size)
+        {
+            std::map<jack_port_id_t, Line>::iterator it = fLines.find(port_index);
+            if (fSlots <= 0 || it == fLines.end() || (*it).second.fData.size() != fSlots * size) {
+                return NULL;
+            }
+            int slot = int(cycle % fSlots);
+            return ((*it).second.fCycle[slot] == cycle) ? &(*it).second.fData[slot * size] : NULL;
+        }
+
+        // Keeps the output of the port for the given cycle
+        void Write(jack_port_id_t port_index, uint64_t cycle, const void* buffer, size_t size)
+        {
+            if (fSlots <= 0) {
+                return;
+            }
+            Line& line = fLines[port_index];
+            if (line.fData.size() != fSlots * size) {
+                line.fData.assign(fSlots * size, 0);
+                line.fCycle.assign(fSlots, UINT64_MAX);
+            }
+            int slot = int(cycle % fSlots);
+            memcpy(&line.fData[slot * size], buffer, size);
+            line.fCycle[slot] = cycle;
+        }
+
+};
+
+} // end of namespace
+
+#endif
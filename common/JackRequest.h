@@ -26,11 +26,14 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackPlatformPlug.h"
 #include "JackChannel.h"
 #include "JackTime.h"
+#include "JackNotification.h"
 #include "types.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <list>
+#include <vector>
+#include <algorithm>
 
 namespace Jack
 {
@@ -90,7 +93,9 @@ struct JackRequest
         kGetUUIDByClient = 37,
         kClientHasSessionCallback = 38,
         kComputeTotalLatencies = 39,
-        kPropertyChangeNotify = 40
+        kPropertyChangeNotify = 40,
+        kShmRequestOpen = 41,
+        kPortRegisterActivate = 43
     };
 
     RequestType fType;
@@ -285,19 +290,42 @@ struct JackClientOpenRequest : public JackRequest
 \brief NewClient result.
 */
 
+#define JACK_SHM_FDS_MAX (3 + PORT_CHUNK_NUM)    // engine control, client control, graph manager and port chunks
+
+/*!
+\brief OpenClient result : with memfd segments, the descriptors of the segments the client attaches follow on the socket.
+*/
+
 struct JackClientOpenResult : public JackResult
 {
 
     int fSharedEngine;
     int fSharedClient;
     int fSharedGraph;
+    int fFdCount;
+    int fFdIndex[JACK_SHM_FDS_MAX];
+    int fFd[JACK_SHM_FDS_MAX];
 
     JackClientOpenResult()
-            : JackResult(), fSharedEngine(-1), fSharedClient(-1), fSharedGraph(-1)
-    {}
+            : JackResult(), fSharedEngine(-1), fSharedClient(-1), fSharedGraph(-1), fFdCount(0)
+    {
+        memset(fFdIndex, 0, sizeof(fFdIndex));
+        memset(fFd, -1, sizeof(fFd));
+    }
     JackClientOpenResult(int32_t result, int index1, int index2, int index3)
-            : JackResult(result), fSharedEngine(index1), fSharedClient(index2), fSharedGraph(index3)
-    {}
+            : JackResult(result), fSharedEngine(index1), fSharedClient(index2), fSharedGraph(index3), fFdCount(0)
+    {
+        memset(fFdIndex, 0, sizeof(fFdIndex));
+        memset(fFd, -1, sizeof(fFd));
+    }
+
+    void AddFd(int index, int fd)
+    {
+        if (fd >= 0 && fFdCount < JACK_SHM_FDS_MAX) {
+            fFdIndex[fFdCount] = index;
+            fFd[fFdCount++] = fd;
+        }
+    }
 
     int Read(detail::JackChannelTransactionInterface* trans)
     {
@@ -305,7 +333,10 @@ struct JackClientOpenResult : public JackResult
         CheckRes(trans->Read(&fSharedEngine, sizeof(int)));
         CheckRes(trans->Read(&fSharedClient, sizeof(int)));
         CheckRes(trans->Read(&fSharedGraph, sizeof(int)));
-        return 0;
+        CheckRes(trans->Read(&fFdCount, sizeof(int)));
+        CheckRes(trans->Read(&fFdIndex, sizeof(fFdIndex)));
+        fFdCount = std::max(0, std::min(fFdCount, JACK_SHM_FDS_MAX));
+        return (fFdCount > 0) ? trans->ReadFds(fFd, fFdCount) : 0;
     }
 
     int Write(detail::JackChannelTransactionInterface* trans)
@@ -314,7 +345,9 @@ struct JackClientOpenResult : public JackResult
         CheckRes(trans->Write(&fSharedEngine, sizeof(int)));
         CheckRes(trans->Write(&fSharedClient, sizeof(int)));
         CheckRes(trans->Write(&fSharedGraph, sizeof(int)));
-        return 0;
+        CheckRes(trans->Write(&fFdCount, sizeof(int)));
+        CheckRes(trans->Write(&fFdIndex, sizeof(fFdIndex)));
+        return (fFdCount > 0) ? trans->WriteFds(fFd, fFdCount) : 0;
     }
 
 };
@@ -1674,6 +1707,144 @@ struct JackPropertyChangeNotifyRequest : public JackRequest
     int Size() { return sizeof(fSubject) + sizeof(fKey) + sizeof(fChange); }
 };
 
+/*!
+\brief ShmRequestOpen request : switch client requests to a shared memory channel.
+
+ The segment descriptor is sent with the request, the name is only used in logs.
+*/
+
+struct JackShmRequestOpenRequest : public JackRequest
+{
+
+    char fName[SYNC_MAX_NAME_SIZE+1];
+    int fFd;
+
+    JackShmRequestOpenRequest(): fFd(-1)
+    {
+        memset(fName, 0, sizeof(fName));
+    }
+    JackShmRequestOpenRequest(const char* name, int fd)
+        : JackRequest(JackRequest::kShmRequestOpen), fFd(fd)
+    {
+        memset(fName, 0, sizeof(fName));
+        snprintf(fName, sizeof(fName), "%s", name);
+    }
+
+    int Read(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckSize();
+        CheckRes(trans->Read(&fName, sizeof(fName)));
+        return trans->ReadFds(&fFd, 1);
+    }
+
+    int Write(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckRes(JackRequest::Write(trans, Size()));
+        CheckRes(trans->Write(&fName, sizeof(fName)));
+        return trans->WriteFds(&fFd, 1);
+    }
+
+    int Size() { return sizeof(fName); }
+
+};
+
+
+/*!
+\brief PortRegisterActivate request : register a batch of ports, then activate the client.
+*/
+
+struct JackPortRegisterActivateRequest : public JackRequest
+{
+
+    int fRefNum;
+    int fIsRealTime;
+    int fCount;
+    char fName[JACK_PORT_BATCH_MAX][JACK_PORT_NAME_SIZE + 1];   // port full names
+    char fPortType[JACK_PORT_BATCH_MAX][JACK_PORT_TYPE_SIZE + 1];
+    unsigned int fFlags[JACK_PORT_BATCH_MAX];
+
+    JackPortRegisterActivateRequest() : fRefNum(0), fIsRealTime(0), fCount(0)
+    {
+        memset(fName, 0, sizeof(fName));
+        memset(fPortType, 0, sizeof(fPortType));
+        memset(fFlags, 0, sizeof(fFlags));
+    }
+    JackPortRegisterActivateRequest(int refnum, int count, const char* const* names, const char* const* types, const unsigned int* flags, int is_real_time)
+        : JackRequest(JackRequest::kPortRegisterActivate), fRefNum(refnum), fIsRealTime(is_real_time), fCount(std::max(0, std::min(count, JACK_PORT_BATCH_MAX)))
+    {
+        memset(fName, 0, sizeof(fName));
+        memset(fPortType, 0, sizeof(fPortType));
+        memset(fFlags, 0, sizeof(fFlags));
+        for (int i = 0; i < fCount; i++) {
+            strncpy(fName[i], names[i], sizeof(fName[i])-1);
+            strncpy(fPortType[i], types[i], sizeof(fPortType[i])-1);
+            fFlags[i] = flags[i];
+        }
+    }
+
+    int Read(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckSize();
+        CheckRes(trans->Read(&fRefNum, sizeof(int)));
+        CheckRes(trans->Read(&fIsRealTime, sizeof(int)));
+        CheckRes(trans->Read(&fCount, sizeof(int)));
+        CheckRes(trans->Read(&fName, sizeof(fName)));
+        CheckRes(trans->Read(&fPortType, sizeof(fPortType)));
+        CheckRes(trans->Read(&fFlags, sizeof(fFlags)));
+        fCount = std::max(0, std::min(fCount, JACK_PORT_BATCH_MAX));
+        return 0;
+    }
+
+    int Write(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckRes(JackRequest::Write(trans, Size()));
+        CheckRes(trans->Write(&fRefNum, sizeof(int)));
+        CheckRes(trans->Write(&fIsRealTime, sizeof(int)));
+        CheckRes(trans->Write(&fCount, sizeof(int)));
+        CheckRes(trans->Write(&fName, sizeof(fName)));
+        CheckRes(trans->Write(&fPortType, sizeof(fPortType)));
+        return trans->Write(&fFlags, sizeof(fFlags));
+    }
+
+    int Size() { return 3 * sizeof(int) + sizeof(fName) + sizeof(fPortType) + sizeof(fFlags); }
+
+};
+
+/*!
+\brief PortRegisterActivate result : the registered ports, none if one of them could not be registered.
+*/
+
+struct JackPortRegisterActivateResult : public JackResult
+{
+
+    int fCount;
+    jack_port_id_t fPortIndex[JACK_PORT_BATCH_MAX];
+
+    JackPortRegisterActivateResult(): JackResult(), fCount(0)
+    {
+        for (int i = 0; i < JACK_PORT_BATCH_MAX; i++) {
+            fPortIndex[i] = NO_PORT;
+        }
+    }
+
+    int Read(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckRes(JackResult::Read(trans));
+        CheckRes(trans->Read(&fCount, sizeof(int)));
+        CheckRes(trans->Read(&fPortIndex, sizeof(fPortIndex)));
+        fCount = std::max(0, std::min(fCount, JACK_PORT_BATCH_MAX));
+        return 0;
+    }
+
+    int Write(detail::JackChannelTransactionInterface* trans)
+    {
+        CheckRes(JackResult::Write(trans));
+        CheckRes(trans->Write(&fCount, sizeof(int)));
+        return trans->Write(&fPortIndex, sizeof(fPortIndex));
+    }
+
+};
+
 /*!
 \brief ClientNotification.
 */
@@ -1736,6 +1907,71 @@ struct JackClientNotification
 
 };
 
+/*!
+\brief Notifications of a client serialized in a buffer, to be written to its channel in a few writes.
+The client reads them one by one as if they were written separately.
+*/
+
+struct JackClientNotificationBatch : public detail::JackChannelTransactionInterface
+{
+    char fBuffer[NOTIFICATION_BATCH_MAX * (6 * sizeof(int) + JACK_CLIENT_NAME_SIZE + 1 + JACK_MESSAGE_SIZE + 1)];
+    int fSize;
+
+    JackClientNotificationBatch(): fSize(0)
+    {}
+
+    int Read(void* data, int len)
+    {
+        return -1;
+    }
+
+    int Write(void* data, int len)
+    {
+        if (fSize + len > int(sizeof(fBuffer))) {
+            return -1;
+        }
+        memcpy(fBuffer + fSize, data, len);
+        fSize += len;
+        return 0;
+    }
+
+    int Flush(detail::JackChannelTransactionInterface* trans)
+    {
+        int res = (fSize > 0) ? trans->Write(fBuffer, fSize) : 0;
+        fSize = 0;
+        return res;
+    }
+
+    // Only the last graph order change is of interest, and it has to come after the port notifications : returns true when an earlier one was dropped
+    static bool Queue(std::vector<JackClientNotification>& pending, const JackClientNotification& event)
+    {
+        bool coalesced = false;
+        if (event.fNotify == kGraphOrderCallback) {
+            for (std::vector<JackClientNotification>::iterator it = pending.begin(); it != pending.end(); it++) {
+                if (it->fNotify == kGraphOrderCallback) {
+                    pending.erase(it);
+                    coalesced = true;
+                    break;
+                }
+            }
+        }
+        pending.push_back(event);
+        return coalesced;
+    }
+
+    int Send(detail::JackChannelTransactionInterface* trans, JackClientNotification* events, int count)
+    {
+        for (int i = 0; i < count; i++) {
+            if (fSize + events[i].Size() > int(sizeof(fBuffer))) {
+                CheckRes(Flush(trans));
+            }
+            CheckRes(events[i].Write(this));
+        }
+        return Flush(trans);
+    }
+
+};
+
 } // end of namespace
 
 #endif
@@ -21,9 +21,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackServer.h"
 #include "JackLockedEngine.h"
 #include "JackChannel.h"
+#include "shm.h"
 
 #include <assert.h>
 #include <signal.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -42,6 +46,30 @@ JackRequestDecoder::JackRequestDecoder(JackServer* server, JackClientHandlerInte
 JackRequestDecoder::~JackRequestDecoder()
 {}
 
+// With memfd segments, the descriptors of all segments the client attaches at open are sent with the result
+void JackRequestDecoder::AddShmFds(JackClientOpenResult* res)
+{
+    JackGraphManager* manager = fServer->GetGraphManager();
+    unsigned int chunk_count = manager->GetPortChunkCount();
+
+    res->AddFd(res->fSharedEngine, jack_shm_dup_fd(res->fSharedEngine));
+    res->AddFd(res->fSharedClient, jack_shm_dup_fd(res->fSharedClient));
+    res->AddFd(res->fSharedGraph, jack_shm_dup_fd(res->fSharedGraph));
+    for (unsigned int i = 0; i < chunk_count; i++) {
+        res->AddFd(manager->GetPortChunkIndex(i), jack_shm_dup_fd(manager->GetPortChunkIndex(i)));
+    }
+}
+
+void JackRequestDecoder::CloseShmFds(JackClientOpenResult* res)
+{
+#ifdef __linux__
+    // Duplicated for the transfer
+    for (int i = 0; i < res->fFdCount; i++) {
+        close(res->fFd[i]);
+    }
+#endif
+}
+
 int JackRequestDecoder::HandleRequest(detail::JackChannelTransactionInterface* socket, int type_aux)
 {
     JackRequest::RequestType type = (JackRequest::RequestType)type_aux;
@@ -71,7 +99,11 @@ int JackRequestDecoder::HandleRequest(detail::JackChannelTransactionInterface* s
             JackClientOpenResult res;
             CheckRead(req, socket);
             fHandler->ClientAdd(socket, &req, &res);
+            if (res.fResult == 0) {
+                AddShmFds(&res);
+            }
             CheckWriteName("JackRequest::ClientOpen", socket);
+            CloseShmFds(&res);
             break;
         }
 
@@ -346,6 +378,33 @@ int JackRequestDecoder::HandleRequest(detail::JackChannelTransactionInterface* s
             break;
         }
 
+        case JackRequest::kShmRequestOpen: {
+            jack_log("JackRequest::ShmRequestOpen");
+            JackShmRequestOpenRequest req;
+            JackResult res;
+            CheckRead(req, socket);
+            res.fResult = fHandler->ShmRequestOpen(socket, req.fFd);
+            CheckWriteName("JackRequest::ShmRequestOpen", socket);
+            break;
+        }
+
+        case JackRequest::kPortRegisterActivate: {
+            jack_log("JackRequest::PortRegisterActivate");
+            JackPortRegisterActivateRequest req;
+            JackPortRegisterActivateResult res;
+            const char* names[JACK_PORT_BATCH_MAX];
+            const char* types[JACK_PORT_BATCH_MAX];
+            CheckRead(req, socket);
+            for (int i = 0; i < req.fCount; i++) {
+                names[i] = req.fName[i];
+                types[i] = req.fPortType[i];
+            }
+            res.fResult = fServer->GetEngine()->PortRegisterActivate(req.fRefNum, req.fCount, names, types, req.fFlags, res.fPortIndex, req.fIsRealTime);
+            res.fCount = req.fCount;
+            CheckWriteRefNum("JackRequest::PortRegisterActivate", socket);
+            break;
+        }
+
         default:
             jack_error("Unknown request %ld", type);
             return -1;
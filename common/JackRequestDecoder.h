@@ -22,6 +22,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackChannel.h"
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
 namespace Jack
 {
 
@@ -33,6 +37,16 @@ struct JackClientHandlerInterface {
 
     virtual void ClientAdd(detail::JackChannelTransactionInterface* socket, JackClientOpenRequest* req, JackClientOpenResult* res) = 0;
     virtual void ClientRemove(detail::JackChannelTransactionInterface* socket, int refnum) = 0;
+
+    // Optional shared memory request channel, stays on the client socket when not available.
+    // Takes ownership of fd, the segment received from the client.
+    virtual int ShmRequestOpen(detail::JackChannelTransactionInterface* socket, int fd)
+    {
+#ifndef WIN32
+        close(fd);
+#endif
+        return -1;
+    }
     
     virtual ~JackClientHandlerInterface()
     {}
@@ -50,6 +64,9 @@ class JackRequestDecoder
         JackServer* fServer;
         JackClientHandlerInterface* fHandler;
 
+        void AddShmFds(JackClientOpenResult* res);
+        void CloseShmFds(JackClientOpenResult* res);
+
     public:
 
         JackRequestDecoder(JackServer* server, JackClientHandlerInterface* handler);
@@ -34,6 +34,8 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include "JackError.h"
 #include "JackMessageBuffer.h"
 #include "JackInternalSessionLoader.h"
+#include "JackTools.h"
+#include <string>
 
 const char * jack_get_self_connect_mode_description(char mode);
 
@@ -43,7 +45,7 @@ namespace Jack
 //----------------
 // Server control 
 //----------------
-JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name)
+JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, int client_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, int freewheel_pipeline, const char* server_name)
 {
     if (rt) {
         jack_info("JACK server starting in realtime mode with priority %ld", priority);
@@ -54,7 +56,8 @@ JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int prio
     jack_info("self-connect-mode is \"%s\"", jack_get_self_connect_mode_description(self_connect_mode));
 
     fGraphManager = JackGraphManager::Allocate(port_max);
-    fEngineControl = new JackEngineControl(sync, temporary, timeout, rt, priority, verbose, clock, server_name);
+    fEngineControl = new JackEngineControl(sync, temporary, timeout, rt, priority, verbose, clock, client_max, server_name);
+    fSynchroTable = new JackSynchro[client_max];
     fEngine = new JackLockedEngine(fGraphManager, GetSynchroTable(), fEngineControl, self_connect_mode);
 
     // A distinction is made between the threaded freewheel driver and the
@@ -68,6 +71,11 @@ JackServer::JackServer(bool sync, bool temporary, int timeout, bool rt, int prio
     fDriverInfo = new JackDriverInfo();
     fAudioDriver = NULL;
     fFreewheel = false;
+    fFreewheelPipeline = freewheel_pipeline;
+    if (fFreewheelPipeline > FREEWHEEL_PIPELINE_MAX) {
+        jack_error("Freewheel pipeline depth %d is too large, using %d", fFreewheelPipeline, FREEWHEEL_PIPELINE_MAX);
+        fFreewheelPipeline = FREEWHEEL_PIPELINE_MAX;
+    }
     JackServerGlobals::fInstance = this;   // Unique instance
     JackServerGlobals::fUserCount = 1;     // One user
     JackGlobals::fVerbose = verbose;
@@ -80,6 +88,7 @@ JackServer::~JackServer()
     delete fThreadedFreewheelDriver;
     delete fEngine;
     delete fEngineControl;
+    delete[] fSynchroTable;
 }
 
 int JackServer::Open(jack_driver_desc_t* driver_desc, JSList* driver_params)
@@ -279,6 +288,7 @@ Freewheel mode is implemented by switching from the (audio [slaves] + freewheel)
     - all audio driver and slaves ports are deconnected, thus there is no more dependencies with the audio driver and slaves
     - the freewheel driver will be synchronized with the end of graph execution : all clients are connected to the freewheel driver
     - the freewheel driver becomes the "master"
+    - with a pipeline depth, clients are grouped in stages running concurrently on successive cycles (see JackConnectionManager::UpdatePipeline)
 
 Normal mode is restored with the connections state valid before freewheel mode was done. Thus one consider that
 no graph state change can be done during freewheel mode.
@@ -315,6 +325,11 @@ int JackServer::SetFreewheel(bool onoff)
             }
             // Disconnect master
             fGraphManager->DisconnectAllPorts(fAudioDriver->GetClientControl()->fRefNum);
+            // Pipelined rendering, will be reset when connection state is restored
+            if (fFreewheelPipeline > 0) {
+                jack_info("Freewheel with a %d stage(s) pipeline", fFreewheelPipeline + 1);
+                fGraphManager->SetPipelineDepth(fFreewheelPipeline);
+            }
             fEngine->NotifyFreewheel(onoff);
             fAudioDriver->SetMaster(false);
             fFreewheelDriver->SetMaster(true);
@@ -340,6 +355,10 @@ void JackServer::Notify(int refnum, int notify, int value)
         case kXRunCallback:
             fEngine->NotifyClientXRun(refnum);
             break;
+
+        case kBudgetCallback:
+            fEngine->NotifyClientBudget(refnum, value);
+            break;
     }
 }
 
@@ -454,6 +473,84 @@ JackSynchro* JackServer::GetSynchroTable()
     return fSynchroTable;
 }
 
+int JackServer::SetRealTimeCpus(const char* cpu_list)
+{
+    int cpus[RT_CPU_MAX];
+    int count = JackTools::ParseCpuList(cpu_list, cpus, RT_CPU_MAX);
+    if (count < 0) {
+        jack_error("Invalid RT CPU list \"%s\"", cpu_list);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        fEngineControl->fRTCpus[i] = cpus[i];
+    }
+    fEngineControl->fRTCpuCount = count;
+    // Server threads started afterwards, request and notification channels included, stay off these CPUs
+    JackThread::SetRealTimeCpus(cpus, count);
+    if (count > 0) {
+        jack_info("RT threads run on CPUs %s", cpu_list);
+    }
+    return 0;
+}
+
+int JackServer::SetClientCpus(const char* client_list)
+{
+    std::string list(client_list);
+    size_t pos = 0;
+
+    // name:cpu entries separated by commas, a client name cannot contain a colon
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        std::string entry = list.substr(pos, (end == std::string::npos) ? std::string::npos : end - pos);
+        size_t colon = entry.rfind(':');
+        char* last;
+        long cpu = (colon == std::string::npos) ? 0 : strtol(entry.c_str() + colon + 1, &last, 10);
+        if (colon == std::string::npos || colon == 0 || last == entry.c_str() + colon + 1 || *last != '\0' || cpu < -1) {
+            jack_error("Invalid client RT CPU \"%s\", must be name:cpu or name:-1", entry.c_str());
+            return -1;
+        }
+        fEngine->SetClientCpu(entry.substr(0, colon).c_str(), (int)cpu);
+        pos = (end == std::string::npos) ? list.size() : end + 1;
+    }
+    return 0;
+}
+
+int JackServer::SetClientBudget(unsigned int percent)
+{
+    if (percent > 100) {
+        jack_error("Invalid client budget %u%%, must be at most 100%%", percent);
+        return -1;
+    }
+
+    fEngineControl->fClientBudget = percent;
+    if (percent > 0) {
+        jack_info("Clients over %u%% of the period are bypassed", percent);
+    }
+    return 0;
+}
+
+int JackServer::SetClockFilter(char filter)
+{
+    switch (filter) {
+        case 'd':
+            fEngineControl->fFrameTimer.SetFilter(JackClockFilterDLL);
+            break;
+        case 'a':
+            fEngineControl->fFrameTimer.SetFilter(JackClockFilterAdaptiveDLL);
+            jack_info("Clock filtered with an adaptive DLL");
+            break;
+        case 'k':
+            fEngineControl->fFrameTimer.SetFilter(JackClockFilterKalman);
+            jack_info("Clock filtered with a Kalman filter");
+            break;
+        default:
+            jack_error("Invalid clock filter '%c', must be d, a or k", filter);
+            return -1;
+    }
+    return 0;
+}
+
 JackEngineControl* JackServer::GetEngineControl()
 {
     return fEngineControl;
@@ -57,14 +57,15 @@ class SERVER_EXPORT JackServer
         JackGraphManager* fGraphManager;
         JackServerChannel fRequestChannel;
         JackConnectionManager fConnectionState;
-        JackSynchro fSynchroTable[CLIENT_NUM];
+        JackSynchro* fSynchroTable;
         bool fFreewheel;
+        int fFreewheelPipeline;
 
         int InternalClientLoadAux(JackLoadableInternalClient* client, const char* so_name, const char* client_name, int options, int* int_ref, jack_uuid_t uuid, int* status);
 
     public:
 
-        JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, const char* server_name);
+        JackServer(bool sync, bool temporary, int timeout, bool rt, int priority, int port_max, int client_max, bool verbose, jack_timer_type_t clock, char self_connect_mode, int freewheel_pipeline, const char* server_name);
         ~JackServer();
 
         // Server control
@@ -82,6 +83,10 @@ class SERVER_EXPORT JackServer
         // From request thread : API
         int SetBufferSize(jack_nframes_t buffer_size);
         int SetFreewheel(bool onoff);
+        int SetRealTimeCpus(const char* cpu_list);
+        int SetClientCpus(const char* client_list);
+        int SetClientBudget(unsigned int percent);
+        int SetClockFilter(char filter);
 
         // Internals clients
         int InternalClientLoad1(const char* client_name, const char* so_name, const char* objet_data, int options, int* int_ref, jack_uuid_t uuid, int* status);
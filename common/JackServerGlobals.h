@@ -60,9 +60,11 @@ struct SERVER_EXPORT JackServerGlobals
                      int rt,
                      int priority,
                      int port_max,
+                     int client_max,
                      int verbose,
                      jack_timer_type_t clock,
-                     char self_connect_mode);
+                     char self_connect_mode,
+                     int freewheel_pipeline);
     static void Stop();
     static void Delete();
 };
@@ -0,0 +1,517 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#include "JackSyntheticDriver.h"
+#include "JackDriverLoader.h"
+#include "JackThreadedDriver.h"
+#include "JackEngineControl.h"
+#include "JackGraphManager.h"
+#include "JackLockedEngine.h"
+#include "JackPort.h"
+#include "JackError.h"
+#include "JackCompilerDeps.h"
+#include <algorithm>
+#include <new>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+namespace Jack
+{
+
+JackSyntheticDriver::JackSyntheticDriver(const char* name, const char* alias, JackLockedEngine* engine, JackSynchro* table,
+                                         Generator generator, const char* audio_file, bool free_run,
+                                         int midi_channels, const char* midi_file, jack_nframes_t midi_interval, jack_nframes_t midi_baud_rate)
+        : JackTimedDriver(name, alias, engine, table),
+        fGenerator(generator), fAudioFile(audio_file), fFrame(0), fFreeRun(free_run),
+        fMidiChannels(midi_channels), fMidiFile(midi_file), fMidiInterval(midi_interval),
+        fMidiBaudRate(midi_baud_rate), fMidiByteFrames(0)
+{
+    memset(fMidiPorts, 0, sizeof(fMidiPorts));
+    memset(fMidiCapturePortList, 0, sizeof(fMidiCapturePortList));
+    memset(fMidiPlaybackPortList, 0, sizeof(fMidiPlaybackPortList));
+
+    // Clamped here, so that the destructor stays in fMidiPorts even when Open fails early
+    if (fMidiChannels > DRIVER_PORT_NUM) {
+        jack_error("JackSyntheticDriver MIDI ports set to %d", DRIVER_PORT_NUM);
+        fMidiChannels = DRIVER_PORT_NUM;
+    } else if (fMidiChannels < 0) {
+        fMidiChannels = 0;
+    }
+}
+
+JackSyntheticDriver::~JackSyntheticDriver()
+{
+    for (int i = 0; i < fMidiChannels; i++) {
+        delete fMidiPorts[i];
+    }
+}
+
+int JackSyntheticDriver::LoadAudioFile(int channels)
+{
+    FILE* file = fopen(fAudioFile.c_str(), "rb");
+    if (!file) {
+        jack_error("JackSyntheticDriver::LoadAudioFile cannot open '%s' : %s", fAudioFile.c_str(), strerror(errno));
+        return -1;
+    }
+
+    // Raw interleaved float samples, one channel per capture port
+    jack_default_audio_sample_t samples[1024];
+    size_t count;
+    fAudioData.clear();
+    while ((count = fread(samples, sizeof(jack_default_audio_sample_t), 1024, file)) > 0) {
+        fAudioData.insert(fAudioData.end(), samples, samples + count);
+    }
+    fclose(file);
+
+    if (channels == 0 || fAudioData.size() < size_t(channels) || fAudioData.size() % channels != 0) {
+        jack_error("JackSyntheticDriver::LoadAudioFile '%s' does not contain whole frames of %d float samples", fAudioFile.c_str(), channels);
+        return -1;
+    }
+
+    jack_info("JackSyntheticDriver::LoadAudioFile %ld frames loaded from '%s'", fAudioData.size() / channels, fAudioFile.c_str());
+    return 0;
+}
+
+int JackSyntheticDriver::Open(jack_nframes_t buffer_size,
+                              jack_nframes_t samplerate,
+                              bool capturing,
+                              bool playing,
+                              int inchannels,
+                              int outchannels,
+                              bool monitor,
+                              const char* capture_driver_name,
+                              const char* playback_driver_name,
+                              jack_nframes_t capture_latency,
+                              jack_nframes_t playback_latency)
+{
+    if (fGenerator == kFile && LoadAudioFile(inchannels) < 0) {
+        return -1;
+    }
+
+    if (!fMidiFile.empty()) {
+        if (!fMidiScript.Load(fMidiFile.c_str())) {
+            return -1;
+        }
+    } else if (fMidiInterval > 0) {
+        fMidiScript.Generate(fMidiInterval);
+    }
+
+    try {
+        fLoopData.assign(outchannels * BUFFER_SIZE_MAX, 0.f);
+        for (int i = 0; i < fMidiChannels; i++) {
+            fMidiPorts[i] = new JackSyntheticMidiPort(&fMidiScript);
+        }
+    } catch (std::exception& e) {
+        jack_error("JackSyntheticDriver::Open cannot allocate the loopback buffers : %s", e.what());
+        return -1;
+    }
+
+    if (JackTimedDriver::Open(buffer_size, samplerate, capturing, playing, inchannels, outchannels, monitor,
+                              capture_driver_name, playback_driver_name, capture_latency, playback_latency) < 0) {
+        return -1;
+    }
+
+    SetMidiByteFrames(samplerate);
+    return 0;
+}
+
+int JackSyntheticDriver::Close()
+{
+    for (int i = 0; i < fMidiChannels; i++) {
+        delete fMidiPorts[i];
+        fMidiPorts[i] = NULL;
+    }
+    return JackTimedDriver::Close();
+}
+
+void JackSyntheticDriver::SetMidiByteFrames(jack_nframes_t sample_rate)
+{
+    // A MIDI byte is 10 bits on the cable
+    fMidiByteFrames = (fMidiBaudRate > 0) ? jack_nframes_t(ceil((double(sample_rate) * 10.) / fMidiBaudRate)) : 0;
+}
+
+int JackSyntheticDriver::SetSampleRate(jack_nframes_t sample_rate)
+{
+    SetMidiByteFrames(sample_rate);
+    return JackTimedDriver::SetSampleRate(sample_rate);
+}
+
+void JackSyntheticDriver::UpdateLatencies()
+{
+    jack_latency_range_t range;
+
+    JackTimedDriver::UpdateLatencies();
+
+    for (int i = 0; i < fMidiChannels; i++) {
+        if (fMidiCapturePortList[i]) {
+            range.min = range.max = fEngineControl->fBufferSize + fCaptureLatency;
+            fGraphManager->GetPort(fMidiCapturePortList[i])->SetLatencyRange(JackCaptureLatency, &range);
+        }
+        if (fMidiPlaybackPortList[i]) {
+            range.min = range.max = fEngineControl->fBufferSize + fPlaybackLatency;
+            fGraphManager->GetPort(fMidiPlaybackPortList[i])->SetLatencyRange(JackPlaybackLatency, &range);
+        }
+    }
+}
+
+int JackSyntheticDriver::Attach()
+{
+    jack_port_id_t port_index;
+    char name[REAL_JACK_PORT_NAME_SIZE+1];
+    char alias[REAL_JACK_PORT_NAME_SIZE+1];
+
+    if (JackTimedDriver::Attach() < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < fMidiChannels; i++) {
+        snprintf(alias, sizeof(alias), "%s:%s:midi_out%d", fAliasName, fCaptureDriverName, i + 1);
+        snprintf(name, sizeof(name), "%s:midi_capture_%d", fClientControl.fName, i + 1);
+        if (fEngine->PortRegister(fClientControl.fRefNum, name, JACK_DEFAULT_MIDI_TYPE, CaptureDriverFlags, fEngineControl->fBufferSize, &port_index) < 0) {
+            jack_error("driver: cannot register port for %s", name);
+            return -1;
+        }
+        fGraphManager->GetPort(port_index)->SetAlias(alias);
+        fMidiCapturePortList[i] = port_index;
+
+        snprintf(alias, sizeof(alias), "%s:%s:midi_in%d", fAliasName, fPlaybackDriverName, i + 1);
+        snprintf(name, sizeof(name), "%s:midi_playback_%d", fClientControl.fName, i + 1);
+        if (fEngine->PortRegister(fClientControl.fRefNum, name, JACK_DEFAULT_MIDI_TYPE, PlaybackDriverFlags, fEngineControl->fBufferSize, &port_index) < 0) {
+            jack_error("driver: cannot register port for %s", name);
+            return -1;
+        }
+        fGraphManager->GetPort(port_index)->SetAlias(alias);
+        fMidiPlaybackPortList[i] = port_index;
+    }
+
+    UpdateLatencies();
+    return 0;
+}
+
+int JackSyntheticDriver::Detach()
+{
+    for (int i = 0; i < fMidiChannels; i++) {
+        if (fMidiCapturePortList[i]) {
+            fEngine->PortUnRegister(fClientControl.fRefNum, fMidiCapturePortList[i]);
+            fMidiCapturePortList[i] = 0;
+        }
+        if (fMidiPlaybackPortList[i]) {
+            fEngine->PortUnRegister(fClientControl.fRefNum, fMidiPlaybackPortList[i]);
+            fMidiPlaybackPortList[i] = 0;
+        }
+    }
+    return JackTimedDriver::Detach();
+}
+
+int JackSyntheticDriver::Start()
+{
+    fFrame = 0;
+    std::fill(fLoopData.begin(), fLoopData.end(), 0.f);
+    return JackTimedDriver::Start();
+}
+
+int JackSyntheticDriver::Stop()
+{
+    unsigned long sent = 0;
+    unsigned long received = 0;
+    unsigned long lost = 0;
+
+    for (int i = 0; i < fMidiChannels; i++) {
+        sent += fMidiPorts[i]->GetSentMessages();
+        received += fMidiPorts[i]->GetReceivedMessages();
+        lost += fMidiPorts[i]->GetLostMessages();
+    }
+
+    jack_info("JackSyntheticDriver::Stop %u frames processed, MIDI messages sent = %lu received = %lu lost = %lu",
+              fFrame, sent, received, lost);
+    return JackTimedDriver::Stop();
+}
+
+void JackSyntheticDriver::GenerateAudio(int channel, jack_default_audio_sample_t* buffer, jack_nframes_t nframes)
+{
+    jack_nframes_t sample_rate = fEngineControl->fSampleRate;
+
+    switch (fGenerator) {
+
+        case kSine: {
+            // Channels are harmonics of 440 Hz, so the phase only depends on the frame modulo the sample rate
+            double step = (2. * M_PI * 440. * (channel + 1)) / sample_rate;
+            for (jack_nframes_t i = 0; i < nframes; i++) {
+                buffer[i] = 0.5f * float(sin(step * ((fFrame + i) % sample_rate)));
+            }
+            break;
+        }
+
+        case kNoise:
+            // White noise hashed from the frame and channel, instead of a generator state
+            for (jack_nframes_t i = 0; i < nframes; i++) {
+                uint32_t x = ((fFrame + i) * 0x9E3779B1U) ^ ((channel + 1) * 0x85EBCA77U);
+                x ^= x >> 15;
+                x *= 0x2C1B3C6DU;
+                x ^= x >> 12;
+                x *= 0x297A2D39U;
+                x ^= x >> 15;
+                buffer[i] = 0.5f * (float(int32_t(x)) / 2147483648.f);
+            }
+            break;
+
+        case kLoopback:
+            // Capture channels receive the playback channels of the previous cycle
+            if (fPlaybackChannels > 0) {
+                memcpy(buffer, &fLoopData[(channel % fPlaybackChannels) * BUFFER_SIZE_MAX], sizeof(jack_default_audio_sample_t) * nframes);
+            } else {
+                memset(buffer, 0, sizeof(jack_default_audio_sample_t) * nframes);
+            }
+            break;
+
+        case kFile: {
+            size_t file_frames = fAudioData.size() / fCaptureChannels;
+            for (jack_nframes_t i = 0; i < nframes; i++) {
+                buffer[i] = fAudioData[((fFrame + i) % file_frames) * fCaptureChannels + channel];
+            }
+            break;
+        }
+
+        default:
+            memset(buffer, 0, sizeof(jack_default_audio_sample_t) * nframes);
+            break;
+    }
+}
+
+int JackSyntheticDriver::Read()
+{
+    jack_nframes_t buffer_size = fEngineControl->fBufferSize;
+
+    for (int i = 0; i < fCaptureChannels; i++) {
+        if (fGraphManager->GetConnectionsNum(fCapturePortList[i]) > 0) {
+            GenerateAudio(i, GetInputBuffer(i), buffer_size);
+        }
+    }
+
+    // Always processed, so that looped back messages never accumulate
+    for (int i = 0; i < fMidiChannels; i++) {
+        fMidiPorts[i]->ProcessInput((JackMidiBuffer*)fGraphManager->GetBuffer(fMidiCapturePortList[i], buffer_size), buffer_size);
+    }
+
+    fFrame += buffer_size;
+    return 0;
+}
+
+int JackSyntheticDriver::Write()
+{
+    jack_nframes_t buffer_size = fEngineControl->fBufferSize;
+
+    JackTimedDriver::Write();
+
+    if (fGenerator == kLoopback) {
+        for (int i = 0; i < fPlaybackChannels; i++) {
+            jack_default_audio_sample_t* loop = &fLoopData[i * BUFFER_SIZE_MAX];
+            if (fGraphManager->GetConnectionsNum(fPlaybackPortList[i]) > 0) {
+                memcpy(loop, GetOutputBuffer(i), sizeof(jack_default_audio_sample_t) * buffer_size);
+            } else {
+                memset(loop, 0, sizeof(jack_default_audio_sample_t) * buffer_size);
+            }
+        }
+    }
+
+    for (int i = 0; i < fMidiChannels; i++) {
+        fMidiPorts[i]->ProcessOutput((JackMidiBuffer*)fGraphManager->GetBuffer(fMidiPlaybackPortList[i], buffer_size), buffer_size, fMidiByteFrames);
+    }
+
+    return 0;
+}
+
+int JackSyntheticDriver::Process()
+{
+    JackDriver::CycleTakeBeginTime();
+
+    if (JackAudioDriver::Process() < 0) {
+        return -1;
+    }
+
+    // In free run mode, cycles follow each other as fast as the graph allows
+    if (!fFreeRun) {
+        ProcessWait();
+    }
+    return 0;
+}
+
+} // end of namespace
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    SERVER_EXPORT jack_driver_desc_t * driver_get_descriptor () {
+        jack_driver_desc_t * desc;
+        jack_driver_desc_filler_t filler;
+        jack_driver_param_value_t value;
+
+        desc = jack_driver_descriptor_construct("synthetic", JackDriverMaster, "Synthetic streams backend for benchmarks", &filler);
+
+        value.ui = 2U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "capture", 'C', JackDriverParamUInt, &value, NULL, "Number of capture ports", NULL);
+        jack_driver_descriptor_add_parameter(desc, &filler, "playback", 'P', JackDriverParamUInt, &value, NULL, "Number of playback ports", NULL);
+
+        value.ui = 48000U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "rate", 'r', JackDriverParamUInt, &value, NULL, "Sample rate", NULL);
+
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "monitor", 'm', JackDriverParamBool, &value, NULL, "Provide monitor ports for the output", NULL);
+
+        value.ui = 1024U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "period", 'p', JackDriverParamUInt, &value, NULL, "Frames per period", NULL);
+
+        strcpy(value.str, "sine");
+        jack_driver_descriptor_add_parameter(desc, &filler, "generator", 'g', JackDriverParamString, &value, NULL, "Capture audio generator",
+            "Capture audio generator : 'silence', 'sine' (harmonics of 440 Hz), 'noise', or 'loopback' (the playback ports, one period later)");
+
+        strcpy(value.str, "");
+        jack_driver_descriptor_add_parameter(desc, &filler, "audio-file", 'f', JackDriverParamString, &value, NULL, "Raw float samples file, looped on the capture ports",
+            "Raw float samples file, interleaved with one channel per capture port and looped, instead of the generator");
+
+        value.i = 0;
+        jack_driver_descriptor_add_parameter(desc, &filler, "free-run", 'F', JackDriverParamBool, &value, NULL, "Run cycles back to back instead of in real time", NULL);
+
+        value.ui = 1U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "midi", 'M', JackDriverParamUInt, &value, NULL, "Number of MIDI capture/playback port pairs",
+            "Number of MIDI capture/playback port pairs, each playback port being looped back to its capture port one period later");
+
+        strcpy(value.str, "");
+        jack_driver_descriptor_add_parameter(desc, &filler, "midi-script", 's', JackDriverParamString, &value, NULL, "MIDI messages file, looped on the MIDI ports",
+            "MIDI messages file, looped on the MIDI ports : one message per line, with its frame followed by its bytes in hexadecimal");
+
+        value.ui = 0U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "midi-interval", 'i', JackDriverParamUInt, &value, NULL, "Frames between generated note on/off messages (0 for none)", NULL);
+
+        value.ui = 31250U;
+        jack_driver_descriptor_add_parameter(desc, &filler, "midi-baud", 'b', JackDriverParamUInt, &value, NULL, "MIDI cable baud rate (0 for unlimited)", NULL);
+
+        return desc;
+    }
+
+    SERVER_EXPORT Jack::JackDriverClientInterface* driver_initialize(Jack::JackLockedEngine* engine, Jack::JackSynchro* table, const JSList* params) {
+        jack_nframes_t sample_rate = 48000;
+        jack_nframes_t buffer_size = 1024;
+        unsigned int capture_ports = 2;
+        unsigned int playback_ports = 2;
+        unsigned int midi_ports = 1;
+        jack_nframes_t midi_interval = 0;
+        jack_nframes_t midi_baud_rate = 31250;
+        const char* generator_name = "sine";
+        const char* audio_file = "";
+        const char* midi_file = "";
+        bool free_run = false;
+        const JSList * node;
+        const jack_driver_param_t * param;
+        bool monitor = false;
+        Jack::JackSyntheticDriver::Generator generator;
+
+        for (node = params; node; node = jack_slist_next (node)) {
+            param = (const jack_driver_param_t *) node->data;
+
+            switch (param->character) {
+
+                case 'C':
+                    capture_ports = param->value.ui;
+                    break;
+
+                case 'P':
+                    playback_ports = param->value.ui;
+                    break;
+
+                case 'r':
+                    sample_rate = param->value.ui;
+                    break;
+
+                case 'p':
+                    buffer_size = param->value.ui;
+                    break;
+
+                case 'm':
+                    monitor = param->value.i;
+                    break;
+
+                case 'g':
+                    generator_name = param->value.str;
+                    break;
+
+                case 'f':
+                    audio_file = param->value.str;
+                    break;
+
+                case 'F':
+                    free_run = param->value.i;
+                    break;
+
+                case 'M':
+                    midi_ports = param->value.ui;
+                    break;
+
+                case 's':
+                    midi_file = param->value.str;
+                    break;
+
+                case 'i':
+                    midi_interval = param->value.ui;
+                    break;
+
+                case 'b':
+                    midi_baud_rate = param->value.ui;
+                    break;
+            }
+        }
+
+        if (audio_file[0]) {
+            generator = Jack::JackSyntheticDriver::kFile;
+        } else if (strcmp(generator_name, "silence") == 0) {
+            generator = Jack::JackSyntheticDriver::kSilence;
+        } else if (strcmp(generator_name, "sine") == 0) {
+            generator = Jack::JackSyntheticDriver::kSine;
+        } else if (strcmp(generator_name, "noise") == 0) {
+            generator = Jack::JackSyntheticDriver::kNoise;
+        } else if (strcmp(generator_name, "loopback") == 0) {
+            generator = Jack::JackSyntheticDriver::kLoopback;
+        } else {
+            jack_error("Unknown generator '%s'", generator_name);
+            return NULL;
+        }
+
+        if (buffer_size > BUFFER_SIZE_MAX) {
+            buffer_size = BUFFER_SIZE_MAX;
+            jack_error("Buffer size set to %d", BUFFER_SIZE_MAX);
+        }
+
+        Jack::JackDriverClientInterface* driver = new Jack::JackThreadedDriver(
+            new Jack::JackSyntheticDriver("system", "synthetic_pcm", engine, table, generator, audio_file, free_run,
+                                          midi_ports, midi_file, midi_interval, midi_baud_rate));
+        if (driver->Open(buffer_size, sample_rate, 1, 1, capture_ports, playback_ports, monitor, "synthetic", "synthetic", 0, 0) == 0) {
+            return driver;
+        } else {
+            delete driver;
+            return NULL;
+        }
+    }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+*/
+
+#ifndef __JackSyntheticDriver__
+#define __JackSyntheticDriver__
+
+#include <string>
+#include <vector>
+
+#include "JackTimedDriver.h"
+#include "JackSyntheticMidiPort.h"
+
+namespace Jack
+{
+
+/*!
+\brief The synthetic driver : a timer based backend for benchmarks.
+
+Capture ports carry generated audio, an audio file, or the playback ports looped back,
+and each MIDI playback port is looped back to a MIDI capture port through the raw MIDI queues.
+All streams only depend on the frame count, so runs are reproducible.
+*/
+
+class JackSyntheticDriver : public JackTimedDriver
+{
+
+    public:
+
+        enum Generator {
+            kSilence,
+            kSine,
+            kNoise,
+            kLoopback,
+            kFile
+        };
+
+    private:
+
+        Generator fGenerator;
+        std::string fAudioFile;
+        std::vector<jack_default_audio_sample_t> fAudioData;
+        std::vector<jack_default_audio_sample_t> fLoopData;
+        jack_nframes_t fFrame;
+        bool fFreeRun;
+
+        int fMidiChannels;
+        std::string fMidiFile;
+        jack_nframes_t fMidiInterval;
+        jack_nframes_t fMidiBaudRate;
+        jack_nframes_t fMidiByteFrames;
+        JackSyntheticMidiScript fMidiScript;
+        JackSyntheticMidiPort* fMidiPorts[DRIVER_PORT_NUM];
+        jack_port_id_t fMidiCapturePortList[DRIVER_PORT_NUM];
+        jack_port_id_t fMidiPlaybackPortList[DRIVER_PORT_NUM];
+
+        int LoadAudioFile(int channels);
+        void SetMidiByteFrames(jack_nframes_t sample_rate);
+        void GenerateAudio(int channel, jack_default_audio_sample_t* buffer, jack_nframes_t nframes);
+
+    protected:
+
+        void UpdateLatencies();
+
+    public:
+
+        JackSyntheticDriver(const char* name, const char* alias, JackLockedEngine* engine, JackSynchro* table,
+                            Generator generator, const char* audio_file, bool free_run,
+                            int midi_channels, const char* midi_file, jack_nframes_t midi_interval, jack_nframes_t midi_baud_rate);
+        virtual ~JackSyntheticDriver();
+
+        int Open(jack_nframes_t buffer_size,
+                 jack_nframes_t samplerate,
+                 bool capturing,
+                 bool playing,
+                 int inchannels,
+                 int outchannels,
+                 bool monitor,
+                 const char* capture_driver_name,
+                 const char* playback_driver_name,
+                 jack_nframes_t capture_latency,
+                 jack_nframes_t playback_latency);
+        int Close();
+
+        int Attach();
+        int Detach();
+
+        int Start();
+        int Stop();
+
+        int Read();
+        int Write();
+
+        int Process();
+
+        int SetSampleRate(jack_nframes_t sample_rate);
+
+};
+
+} // end of namespace
+
+#endif
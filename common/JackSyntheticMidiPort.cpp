@@ -0,0 +1,294 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "JackSyntheticMidiPort.h"
+#include "JackMidiUtil.h"
+#include "JackError.h"
+
+using Jack::JackSyntheticMidiPort;
+using Jack::JackSyntheticMidiScript;
+
+JackSyntheticMidiScript::JackSyntheticMidiScript()
+{
+    length = 0;
+}
+
+void
+JackSyntheticMidiScript::AddMessage(jack_nframes_t frame,
+                                    const jack_midi_data_t *buffer,
+                                    size_t size)
+{
+    Message message;
+    message.frame = frame;
+    message.offset = data.size();
+    message.size = size;
+    data.insert(data.end(), buffer, buffer + size);
+    messages.push_back(message);
+    if (frame >= length) {
+        length = frame + 1;
+    }
+}
+
+void
+JackSyntheticMidiScript::Generate(jack_nframes_t interval)
+{
+    static const jack_midi_data_t note_on[3] = { 0x90, 0x3c, 0x64 };
+    static const jack_midi_data_t note_off[3] = { 0x80, 0x3c, 0x00 };
+    AddMessage(0, note_on, 3);
+    AddMessage(interval, note_off, 3);
+    length = interval * 2;
+}
+
+bool
+JackSyntheticMidiScript::Load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (! file) {
+        jack_error("JackSyntheticMidiScript::Load - cannot open '%s': %s",
+                   path, strerror(errno));
+        return false;
+    }
+    char line[1024];
+    jack_midi_data_t buffer[sizeof(line) / 2];
+    jack_nframes_t last_frame = 0;
+    bool result = true;
+    for (int line_number = 1; fgets(line, sizeof(line), file);
+         line_number++) {
+        char *p = line;
+        while (isspace(*p)) {
+            p++;
+        }
+        if ((! *p) || (*p == '#')) {
+            continue;
+        }
+        char *end;
+        jack_nframes_t frame = strtoul(p, &end, 10);
+        size_t size = 0;
+        for (p = end;; p = end) {
+            unsigned long byte = strtoul(p, &end, 16);
+            if (end == p) {
+                break;
+            }
+            if (byte > 0xff) {
+                size = 0;
+                break;
+            }
+            buffer[size++] = (jack_midi_data_t) byte;
+        }
+        while (isspace(*end)) {
+            end++;
+        }
+        if ((! size) || *end || (frame < last_frame)) {
+            jack_error("JackSyntheticMidiScript::Load - '%s' line %d: "
+                       "expected a frame, in ascending order, followed by "
+                       "hexadecimal bytes", path, line_number);
+            result = false;
+            break;
+        }
+        AddMessage(frame, buffer, size);
+        last_frame = frame;
+    }
+    fclose(file);
+    return result;
+}
+
+JackSyntheticMidiPort::
+JackSyntheticMidiPort(const JackSyntheticMidiScript *script, size_t max_bytes,
+                      size_t max_messages)
+{
+    input_event = 0;
+    lost_messages = 0;
+    received_messages = 0;
+    script_index = 0;
+    script_start = 0;
+    script_started = false;
+    sent_messages = 0;
+    this->script = script;
+    loop_queue = new JackMidiAsyncQueue(max_bytes, max_bytes);
+    std::unique_ptr<JackMidiAsyncQueue> loop_queue_ptr(loop_queue);
+    read_queue = new JackMidiBufferReadQueue();
+    std::unique_ptr<JackMidiBufferReadQueue> read_queue_ptr(read_queue);
+    write_queue = new JackMidiBufferWriteQueue();
+    std::unique_ptr<JackMidiBufferWriteQueue> write_queue_ptr(write_queue);
+    send_queue = new JackSyntheticMidiSendQueue(loop_queue);
+    std::unique_ptr<JackSyntheticMidiSendQueue> send_queue_ptr(send_queue);
+    raw_output_queue = new JackMidiRawOutputWriteQueue(send_queue, max_bytes,
+                                                       max_messages,
+                                                       max_messages);
+    std::unique_ptr<JackMidiRawOutputWriteQueue>
+        raw_output_queue_ptr(raw_output_queue);
+    raw_input_queue = new JackMidiRawInputWriteQueue(write_queue, max_bytes,
+                                                     max_messages);
+    raw_output_queue_ptr.release();
+    send_queue_ptr.release();
+    write_queue_ptr.release();
+    read_queue_ptr.release();
+    loop_queue_ptr.release();
+}
+
+JackSyntheticMidiPort::~JackSyntheticMidiPort()
+{
+    delete raw_input_queue;
+    delete raw_output_queue;
+    delete send_queue;
+    delete write_queue;
+    delete read_queue;
+    delete loop_queue;
+}
+
+bool
+JackSyntheticMidiPort::EnqueueOutputEvent(jack_midi_event_t *event,
+                                          jack_nframes_t boundary_frame)
+{
+    switch (raw_output_queue->EnqueueEvent(event)) {
+    case JackMidiWriteQueue::BUFFER_FULL:
+
+        // Processing events early might free up some space in the raw
+        // output queue.
+
+        raw_output_queue->Process(boundary_frame);
+        if (raw_output_queue->EnqueueEvent(event) == JackMidiWriteQueue::OK) {
+            return true;
+        }
+        break;
+    case JackMidiWriteQueue::BUFFER_TOO_SMALL:
+        jack_error("JackSyntheticMidiPort::EnqueueOutputEvent - The write "
+                   "queue couldn't enqueue a %d-byte event.  Dropping event.",
+                   event->size);
+        break;
+    case JackMidiWriteQueue::OK:
+        return true;
+    default:
+        // This is here to stop compilers from warning us about not handling
+        // enumeration values.
+        ;
+    }
+    lost_messages++;
+    return false;
+}
+
+unsigned long
+JackSyntheticMidiPort::GetLostMessages()
+{
+    return lost_messages;
+}
+
+unsigned long
+JackSyntheticMidiPort::GetReceivedMessages()
+{
+    return received_messages;
+}
+
+jack_midi_event_t *
+JackSyntheticMidiPort::GetScriptEvent(jack_nframes_t boundary_frame)
+{
+    if (script->messages.empty()) {
+        return 0;
+    }
+    const JackSyntheticMidiScript::Message &message =
+        script->messages[script_index];
+    jack_nframes_t time = script_start + message.frame;
+    if (time >= boundary_frame) {
+        return 0;
+    }
+    script_event.buffer =
+        const_cast<jack_midi_data_t *>(&(script->data[message.offset]));
+    script_event.size = message.size;
+    script_event.time = time;
+    if (++script_index == script->messages.size()) {
+        script_index = 0;
+        script_start += script->length;
+    }
+    return &script_event;
+}
+
+unsigned long
+JackSyntheticMidiPort::GetSentMessages()
+{
+    return sent_messages;
+}
+
+void
+JackSyntheticMidiPort::ProcessInput(JackMidiBuffer *port_buffer,
+                                    jack_nframes_t frames)
+{
+    write_queue->ResetMidiBuffer(port_buffer, frames);
+    jack_nframes_t boundary_frame = GetLastFrame() + frames;
+    if (! input_event) {
+        input_event = loop_queue->DequeueEvent();
+    }
+    for (; input_event; input_event = loop_queue->DequeueEvent()) {
+        if (raw_input_queue->EnqueueEvent(input_event) !=
+            JackMidiWriteQueue::OK) {
+
+            // Processing events early might free up some space in the raw
+            // input queue.  The cable only carries single bytes, so the
+            // event can always be enqueued after that, or in a later period.
+
+            raw_input_queue->Process(boundary_frame);
+            if (raw_input_queue->EnqueueEvent(input_event) !=
+                JackMidiWriteQueue::OK) {
+                break;
+            }
+        }
+    }
+    raw_input_queue->Process(boundary_frame);
+    received_messages += port_buffer->event_count;
+}
+
+void
+JackSyntheticMidiPort::ProcessOutput(JackMidiBuffer *port_buffer,
+                                     jack_nframes_t frames,
+                                     jack_nframes_t byte_frames)
+{
+    read_queue->ResetMidiBuffer(port_buffer);
+    send_queue->ResetOutputBuffer(frames, frames, byte_frames);
+    jack_nframes_t boundary_frame = GetLastFrame() + frames;
+    if (! script_started) {
+        script_start = GetLastFrame();
+        script_started = true;
+    }
+
+    // Merge the port and script messages in time order, so the raw output
+    // queue sends them like a single source would.
+
+    jack_midi_event_t *event = read_queue->DequeueEvent();
+    jack_midi_event_t *scripted = GetScriptEvent(boundary_frame);
+    while (event || scripted) {
+        bool use_script = scripted && ((! event) ||
+                                       (scripted->time < event->time));
+        if (EnqueueOutputEvent(use_script ? scripted : event,
+                               boundary_frame)) {
+            sent_messages++;
+        }
+        if (use_script) {
+            scripted = GetScriptEvent(boundary_frame);
+        } else {
+            event = read_queue->DequeueEvent();
+        }
+    }
+    raw_output_queue->Process(boundary_frame);
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackSyntheticMidiPort__
+#define __JackSyntheticMidiPort__
+
+#include <vector>
+
+#include "JackMidiAsyncQueue.h"
+#include "JackMidiBufferReadQueue.h"
+#include "JackMidiBufferWriteQueue.h"
+#include "JackMidiRawInputWriteQueue.h"
+#include "JackMidiRawOutputWriteQueue.h"
+#include "JackSyntheticMidiSendQueue.h"
+
+namespace Jack {
+
+    /**
+     * A looping sequence of MIDI messages, with times relative to the start
+     * of the sequence.
+     */
+
+    class JackSyntheticMidiScript {
+
+    public:
+
+        struct Message {
+            jack_nframes_t frame;
+            size_t offset;
+            size_t size;
+        };
+
+        std::vector<jack_midi_data_t> data;
+        jack_nframes_t length;
+        std::vector<Message> messages;
+
+        JackSyntheticMidiScript();
+
+        void
+        AddMessage(jack_nframes_t frame, const jack_midi_data_t *buffer,
+                   size_t size);
+
+        /**
+         * Creates alternating note-on and note-off messages, 'interval'
+         * frames apart.
+         */
+
+        void
+        Generate(jack_nframes_t interval);
+
+        /**
+         * Reads a text file with one message per line: the frame of the
+         * message, followed by its bytes in hexadecimal.  Empty lines and
+         * lines starting with '#' are ignored.  The sequence loops one frame
+         * after its last message.
+         */
+
+        bool
+        Load(const char *path);
+
+    };
+
+    /**
+     * A pair of MIDI ports connected with a virtual cable.  Messages written
+     * to the playback port, merged with the script messages, go through the
+     * raw output queue and the cable, and come back on the capture port one
+     * period later through the raw input queue.
+     */
+
+    class JackSyntheticMidiPort {
+
+    private:
+
+        jack_midi_event_t *input_event;
+        unsigned long lost_messages;
+        JackMidiAsyncQueue *loop_queue;
+        JackMidiRawInputWriteQueue *raw_input_queue;
+        JackMidiRawOutputWriteQueue *raw_output_queue;
+        JackMidiBufferReadQueue *read_queue;
+        unsigned long received_messages;
+        const JackSyntheticMidiScript *script;
+        jack_midi_event_t script_event;
+        size_t script_index;
+        jack_nframes_t script_start;
+        bool script_started;
+        JackSyntheticMidiSendQueue *send_queue;
+        unsigned long sent_messages;
+        JackMidiBufferWriteQueue *write_queue;
+
+        bool
+        EnqueueOutputEvent(jack_midi_event_t *event,
+                           jack_nframes_t boundary_frame);
+
+        jack_midi_event_t *
+        GetScriptEvent(jack_nframes_t boundary_frame);
+
+    public:
+
+        JackSyntheticMidiPort(const JackSyntheticMidiScript *script,
+                              size_t max_bytes=4096,
+                              size_t max_messages=1024);
+        ~JackSyntheticMidiPort();
+
+        unsigned long
+        GetLostMessages();
+
+        unsigned long
+        GetReceivedMessages();
+
+        unsigned long
+        GetSentMessages();
+
+        void
+        ProcessInput(JackMidiBuffer *port_buffer, jack_nframes_t frames);
+
+        void
+        ProcessOutput(JackMidiBuffer *port_buffer, jack_nframes_t frames,
+                      jack_nframes_t byte_frames);
+
+    };
+
+}
+
+#endif
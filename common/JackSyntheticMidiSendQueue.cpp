@@ -0,0 +1,73 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include <cassert>
+
+#include "JackSyntheticMidiSendQueue.h"
+#include "JackMidiUtil.h"
+
+using Jack::JackSyntheticMidiSendQueue;
+
+JackSyntheticMidiSendQueue::
+JackSyntheticMidiSendQueue(JackMidiWriteQueue *loop_queue)
+{
+    this->loop_queue = loop_queue;
+    boundary_frame = 0;
+    byte_frames = 0;
+    delay = 0;
+    last_frame = 0;
+    next_frame = 0;
+}
+
+Jack::JackMidiWriteQueue::EnqueueResult
+JackSyntheticMidiSendQueue::EnqueueEvent(jack_nframes_t time, size_t size,
+                                         jack_midi_data_t *buffer)
+{
+    assert(size == 1);
+    jack_nframes_t send_time = GetNextScheduleFrame();
+    if (time > send_time) {
+        send_time = time;
+    }
+    if (send_time >= boundary_frame) {
+        return BUFFER_FULL;
+    }
+    EnqueueResult result = loop_queue->EnqueueEvent(send_time + delay, size,
+                                                    buffer);
+    if (result == OK) {
+        next_frame = send_time + byte_frames;
+    }
+    return result;
+}
+
+jack_nframes_t
+JackSyntheticMidiSendQueue::GetNextScheduleFrame()
+{
+    return (next_frame < last_frame) ? last_frame : next_frame;
+}
+
+void
+JackSyntheticMidiSendQueue::ResetOutputBuffer(jack_nframes_t frames,
+                                              jack_nframes_t delay,
+                                              jack_nframes_t byte_frames)
+{
+    last_frame = GetLastFrame();
+    boundary_frame = last_frame + frames;
+    this->byte_frames = byte_frames;
+    this->delay = delay;
+}
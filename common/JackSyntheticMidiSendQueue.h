@@ -0,0 +1,71 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackSyntheticMidiSendQueue__
+#define __JackSyntheticMidiSendQueue__
+
+#include "JackMidiSendQueue.h"
+
+namespace Jack {
+
+    /**
+     * A virtual MIDI cable.  Each byte sent occupies the cable for a fixed
+     * number of frames, and is passed to a loop queue with a fixed delay, so
+     * the bytes can be received again by an input port.
+     */
+
+    class JackSyntheticMidiSendQueue: public JackMidiSendQueue {
+
+    private:
+
+        jack_nframes_t boundary_frame;
+        jack_nframes_t byte_frames;
+        jack_nframes_t delay;
+        jack_nframes_t last_frame;
+        JackMidiWriteQueue *loop_queue;
+        jack_nframes_t next_frame;
+
+    public:
+
+        using JackMidiSendQueue::EnqueueEvent;
+
+        JackSyntheticMidiSendQueue(JackMidiWriteQueue *loop_queue);
+
+        EnqueueResult
+        EnqueueEvent(jack_nframes_t time, size_t size,
+                     jack_midi_data_t *buffer);
+
+        jack_nframes_t
+        GetNextScheduleFrame();
+
+        /**
+         * This method must be called each period.  Bytes can be sent until
+         * the end of the period, and are received 'delay' frames after they
+         * were sent.  Each byte occupies the cable for 'byte_frames' frames.
+         */
+
+        void
+        ResetOutputBuffer(jack_nframes_t frames, jack_nframes_t delay,
+                          jack_nframes_t byte_frames);
+
+    };
+
+}
+
+#endif
@@ -105,11 +105,15 @@ class SERVER_EXPORT JackThreadInterface
         int DropRealTime();                     // Used when called from another thread
         int DropSelfRealTime();                 // Used when called from thread itself
 
+        int SetSelfAffinity(int cpu);           // Used when called from thread itself
+
         jack_native_thread_t GetThreadID();
         bool IsThread();
 
         static int AcquireRealTimeImp(jack_native_thread_t thread, int priority);
         static int AcquireRealTimeImp(jack_native_thread_t thread, int priority, UInt64 period, UInt64 computation, UInt64 constraint);
+        static int SetAffinityImp(jack_native_thread_t thread, int cpu);
+        static void SetRealTimeCpus(const int* cpus, int count);
         static int DropRealTimeImp(jack_native_thread_t thread);
         static int StartImp(jack_native_thread_t* thread, int priority, int realtime, void*(*start_routine)(void*), void* arg);
         static int StopImp(jack_native_thread_t thread);
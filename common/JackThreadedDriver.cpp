@@ -270,6 +270,11 @@ void JackThreadedDriver::SetRealTime()
     } else {
         jack_log("JackThreadedDriver::Init non-realtime");
     }
+
+    // The driver thread runs on the first CPU reserved for RT threads
+    if (GetEngineControl()->fRTCpuCount > 0) {
+        fThread.SetSelfAffinity(GetEngineControl()->fRTCpus[0]);
+    }
 }
 
 
@@ -32,6 +32,9 @@ extern "C"
     SERVER_EXPORT void InitTime();
     SERVER_EXPORT void EndTime();
     SERVER_EXPORT jack_time_t GetMicroSeconds(void);
+#ifdef __linux__
+    SERVER_EXPORT int GetMicroSecondsClock(void);   // POSIX clock GetMicroSeconds() reads, -1 if it is not one
+#endif
     SERVER_EXPORT void JackSleep(long usec);
 
     void SetClockSource(jack_timer_type_t source);
@@ -236,6 +236,45 @@ namespace Jack {
         new_name[i] = '\0';
     }
 
+    /*!
+    \brief Parse a CPU list like "2-5,8" into at most max CPU numbers, returns their count or -1 if the list is invalid.
+    */
+    int JackTools::ParseCpuList(const char* list, int* cpus, int max)
+    {
+        int count = 0;
+        const char* pos = list;
+
+        while (*pos != '\0') {
+            char* end;
+            long first = strtol(pos, &end, 10);
+            long last = first;
+            if (end == pos || first < 0) {
+                return -1;
+            }
+            if (*end == '-') {
+                pos = end + 1;
+                last = strtol(pos, &end, 10);
+                if (end == pos || last < first) {
+                    return -1;
+                }
+            }
+            for (long cpu = first; cpu <= last; cpu++) {
+                if (count == max) {
+                    return -1;
+                }
+                cpus[count++] = (int)cpu;
+            }
+            if (*end == ',') {
+                end++;
+            } else if (*end != '\0') {
+                return -1;
+            }
+            pos = end;
+        }
+
+        return count;
+    }
+
 #ifdef WIN32
 
 void BuildClientPath(char* path_to_so, int path_len, const char* so_name)
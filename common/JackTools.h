@@ -66,6 +66,7 @@ namespace Jack
         static void CleanupFiles(const char* server_name);
         static int GetTmpdir();
         static void RewriteName(const char* name, char* new_name);
+        static int ParseCpuList(const char* list, int* cpus, int max);
         static void ThrowJackNetException();
 
         // For OSX only
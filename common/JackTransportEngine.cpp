@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackClientInterface.h"
 #include "JackClientControl.h"
 #include "JackEngineControl.h"
+#include "JackGraphManager.h"
 #include "JackGlobals.h"
 #include "JackError.h"
 #include "JackTime.h"
@@ -46,6 +47,9 @@ JackTransportEngine::JackTransportEngine(): JackAtomicArrayState<jack_position_t
     fConditionnal = false;
     fPendingPos = false;
     fNetworkSync = false;
+    fPublishCounter = 0;
+    fPublishIndex = 0;
+    memset(fPublished, 0, sizeof(fPublished));
 }
 
 // compute the number of cycle for timeout
@@ -90,11 +94,15 @@ int JackTransportEngine::SetTimebaseMaster(int refnum, bool conditionnal)
 }
 
 // RT
-bool JackTransportEngine::CheckAllRolling(JackClientInterface** table)
+bool JackTransportEngine::CheckAllRolling(JackClientInterface** table, JackGraphManager* manager)
 {
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    // Inactive clients are already made "rolling" by MakeAllStartingLocating, only the active ones are checked
+    int count;
+    const jack_int_t* active = manager->GetActiveRefNums(&count);
+    for (int pos = 0; pos < count; pos++) {
+        int i = active[pos];
         JackClientInterface* client = table[i];
-        if (client && client->GetClientControl()->fTransportState != JackTransportRolling) {
+        if (i >= GetEngineControl()->fDriverNum && client && client->GetClientControl()->fTransportState != JackTransportRolling) {
             jack_log("CheckAllRolling ref = %ld is not rolling", i);
             return false;
         }
@@ -106,7 +114,7 @@ bool JackTransportEngine::CheckAllRolling(JackClientInterface** table)
 // RT
 void JackTransportEngine::MakeAllStartingLocating(JackClientInterface** table)
 {
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    for (int i = GetEngineControl()->fDriverNum; i < GetEngineControl()->fClientMax; i++) {
         JackClientInterface* client = table[i];
         if (client) {
             JackClientControl* control = client->GetClientControl();
@@ -122,7 +130,7 @@ void JackTransportEngine::MakeAllStartingLocating(JackClientInterface** table)
 // RT
 void JackTransportEngine::MakeAllStopping(JackClientInterface** table)
 {
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    for (int i = GetEngineControl()->fDriverNum; i < GetEngineControl()->fClientMax; i++) {
         JackClientInterface* client = table[i];
         if (client) {
             JackClientControl* control = client->GetClientControl();
@@ -137,7 +145,7 @@ void JackTransportEngine::MakeAllStopping(JackClientInterface** table)
 // RT
 void JackTransportEngine::MakeAllLocating(JackClientInterface** table)
 {
-    for (int i = GetEngineControl()->fDriverNum; i < CLIENT_NUM; i++) {
+    for (int i = GetEngineControl()->fDriverNum; i < GetEngineControl()->fClientMax; i++) {
         JackClientInterface* client = table[i];
         if (client) {
             JackClientControl* control = client->GetClientControl();
@@ -159,7 +167,7 @@ void JackTransportEngine::CycleBegin(jack_nframes_t frame_rate, jack_time_t time
 }
 
 // RT
-void JackTransportEngine::CycleEnd(JackClientInterface** table, jack_nframes_t frame_rate, jack_nframes_t buffer_size)
+void JackTransportEngine::CycleEnd(JackClientInterface** table, JackGraphManager* manager, jack_nframes_t frame_rate, jack_nframes_t buffer_size)
 {
     TrySwitchState(1);	// Switch from "pending" to "current", it always works since there is always a pending state
 
@@ -198,7 +206,7 @@ void JackTransportEngine::CycleEnd(JackClientInterface** table, jack_nframes_t f
                 fTransportState = JackTransportStarting;
                 MakeAllStartingLocating(table);
                 SyncTimeout(frame_rate, buffer_size);
-            } else if (--fSyncTimeLeft == 0 || CheckAllRolling(table)) {  // Slow clients may still catch up
+            } else if (--fSyncTimeLeft == 0 || CheckAllRolling(table, manager)) {  // Slow clients may still catch up
                 if (fNetworkSync) {
                     jack_log("transport starting ==> netstarting frame = %d");
                     fTransportState = JackTransportNetStarting;
@@ -244,6 +252,31 @@ void JackTransportEngine::CycleEnd(JackClientInterface** table, jack_nframes_t f
         CopyPosition(request, pending);
         WriteNextStateStop(1);
     }
+
+    PublishPosition();
+}
+
+// RT
+void JackTransportEngine::PublishPosition()
+{
+    // Only the current state is copied, the RT thread is the only one to switch it
+    jack_position_t* current = ReadCurrentState();
+    UInt32 counter = __atomic_load_n(&fPublishCounter, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&fPublishCounter, counter + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    JackPublishedPosition* published = &fPublished[fPublishIndex % (FREEWHEEL_PIPELINE_MAX + 1)];
+    memcpy(&published->fPosition, current, sizeof(jack_position_t));
+    published->fState = fTransportState;
+    if (fTransportState == JackTransportRolling && (current->valid & JackPositionBBT) && current->frame_rate > 0) {
+        published->fTicksPerFrame = current->ticks_per_beat * current->beats_per_minute / (60.0 * current->frame_rate);
+    } else {
+        published->fTicksPerFrame = 0.;
+    }
+    fPublishIndex++;
+
+    __atomic_store_n(&fPublishCounter, counter + 2, __ATOMIC_RELEASE);
 }
 
 // Client
@@ -258,6 +291,22 @@ void JackTransportEngine::ReadCurrentPos(jack_position_t* pos)
     } while (cur_index != next_index); // Until a coherent state has been read
 }
 
+// Client : record published "cycles" cycles before the last one, or the oldest one kept
+void JackTransportEngine::ReadPublishedPosition(JackPublishedPosition* published, int cycles)
+{
+    UInt32 counter;
+    do {
+        counter = __atomic_load_n(&fPublishCounter, __ATOMIC_ACQUIRE);
+        uint64_t index = fPublishIndex;
+        uint64_t back = (cycles < FREEWHEEL_PIPELINE_MAX) ? cycles : FREEWHEEL_PIPELINE_MAX;
+        if (back + 1 > index) {
+            back = (index > 0) ? index - 1 : 0;
+        }
+        memcpy(published, &fPublished[((index > 0) ? index - 1 - back : 0) % (FREEWHEEL_PIPELINE_MAX + 1)], sizeof(JackPublishedPosition));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((counter & 1) || counter != __atomic_load_n(&fPublishCounter, __ATOMIC_RELAXED)); // Until a coherent record has been read
+}
+
 void JackTransportEngine::RequestNewPos(jack_position_t* pos)
 {
     jack_position_t* request = WriteNextStateStart(2);
@@ -267,13 +316,63 @@ void JackTransportEngine::RequestNewPos(jack_position_t* pos)
     WriteNextStateStop(2);
 }
 
-jack_transport_state_t JackTransportEngine::Query(jack_position_t* pos)
+// A client of pipeline stage s renders the cycle started s cycles ago
+jack_transport_state_t JackTransportEngine::Query(jack_position_t* pos, int stage)
 {
+    if (stage > 0) {
+        JackPublishedPosition published;
+        ReadPublishedPosition(&published, stage);
+        if (pos)
+            memcpy(pos, &published.fPosition, sizeof(jack_position_t));
+        return published.fState;
+    }
+
     if (pos)
         ReadCurrentPos(pos);
     return GetState();
 }
 
+jack_transport_state_t JackTransportEngine::QueryOffset(jack_nframes_t frame_offset, jack_position_t* pos, int stage)
+{
+    JackPublishedPosition published;
+    ReadPublishedPosition(&published, stage);
+
+    if (pos) {
+        memcpy(pos, &published.fPosition, sizeof(jack_position_t));
+        if (published.fState == JackTransportRolling) {
+            InterpolatePosition(pos, published.fTicksPerFrame, frame_offset);
+        }
+    }
+    return published.fState;
+}
+
+// Moves a rolling position "frames" later, at the tempo of the position
+void JackTransportEngine::InterpolatePosition(jack_position_t* pos, double ticks_per_frame, jack_nframes_t frames)
+{
+    pos->frame += frames;
+
+    if (!(pos->valid & JackPositionBBT) || ticks_per_frame <= 0. || pos->ticks_per_beat <= 0. || pos->beat < 1) {
+        return;
+    }
+
+    // BBT may refer to a frame before the cycle start, it now refers to pos->frame
+    if (pos->valid & JackBBTFrameOffset) {
+        frames += pos->bbt_offset;
+        pos->bbt_offset = 0;
+    }
+
+    double ticks = pos->tick + frames * ticks_per_frame;
+    double beats = floor(ticks / pos->ticks_per_beat);
+    int64_t beats_per_bar = (pos->beats_per_bar >= 1.f) ? (int64_t)pos->beats_per_bar : 1;
+    int64_t beat = (pos->beat - 1) + (int64_t)beats;
+    int64_t bars = beat / beats_per_bar;
+
+    pos->tick = (int32_t)(ticks - beats * pos->ticks_per_beat);
+    pos->beat = (int32_t)(beat - bars * beats_per_bar) + 1;
+    pos->bar += (int32_t)bars;
+    pos->bar_start_tick += bars * beats_per_bar * pos->ticks_per_beat;
+}
+
 jack_nframes_t JackTransportEngine::GetCurrentFrame()
 {
     jack_position_t pos;
@@ -23,6 +23,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "JackAtomicArrayState.h"
 #include "JackCompilerDeps.h"
+#include "JackConstants.h"
 #include "types.h"
 
 namespace Jack
@@ -49,6 +50,12 @@ We have:
 
 	We use a JackAtomicArrayState pattern that allows to manage several "next" states independently.
 
+	At the end of each cycle, the new current position and transport state are also copied in a record guarded
+	by a sequence counter (odd while it is written), with the tick rate at the current tempo. Clients read it
+	without retrying on the array state, and can get BBT values at any frame of the cycle (see QueryOffset).
+	The records of the last FREEWHEEL_PIPELINE_MAX + 1 cycles are kept : in a pipelined freewheel graph, a client
+	of stage s renders the cycle started s cycles ago, and is given the position of that cycle.
+
     In jack1 implementation, transport code (jack_transport_cycle_end) was not called if the graph could not be locked (see jack_run_one_cycle).
     Here transport cycle (CycleBegin, CycleEnd) has to run in the RT thread concurrently with code executed from the "command" thread.
 
@@ -88,6 +95,19 @@ We have:
 */
 
 class JackClientInterface;
+class JackGraphManager;
+
+/*!
+\brief The transport position as seen by clients, with the tick rate used to interpolate BBT inside a cycle.
+*/
+
+PRE_PACKED_STRUCTURE
+struct JackPublishedPosition
+{
+    jack_position_t fPosition;
+    jack_transport_state_t fState;
+    double fTicksPerFrame;  // 0 when not rolling or without valid BBT
+} POST_PACKED_STRUCTURE;
 
 PRE_PACKED_STRUCTURE
 class SERVER_EXPORT JackTransportEngine : public JackAtomicArrayState<jack_position_t>
@@ -105,13 +125,18 @@ class SERVER_EXPORT JackTransportEngine : public JackAtomicArrayState<jack_posit
         bool fNetworkSync;
         bool fConditionnal;
         std::atomic<SInt32> fWriteCounter {};
+        MEM_ALIGN(UInt32 fPublishCounter, 4);    // Odd while fPublished is written, naturally aligned in the packed shm struct
+        uint64_t fPublishIndex;                 // Cycles published so far, the last one is in fPublished[(fPublishIndex - 1) % (FREEWHEEL_PIPELINE_MAX + 1)]
+        JackPublishedPosition fPublished[FREEWHEEL_PIPELINE_MAX + 1];
 
-        bool CheckAllRolling(JackClientInterface** table);
+        bool CheckAllRolling(JackClientInterface** table, JackGraphManager* manager);
         void MakeAllStartingLocating(JackClientInterface** table);
         void MakeAllStopping(JackClientInterface** table);
         void MakeAllLocating(JackClientInterface** table);
 
         void SyncTimeout(jack_nframes_t frame_rate, jack_nframes_t buffer_size);
+        void PublishPosition();
+        void ReadPublishedPosition(JackPublishedPosition* published, int cycles);
 
     public:
 
@@ -159,7 +184,7 @@ class SERVER_EXPORT JackTransportEngine : public JackAtomicArrayState<jack_posit
         /*
         	\brief
         */
-        void CycleEnd(JackClientInterface** table, jack_nframes_t frame_rate, jack_nframes_t buffer_size);
+        void CycleEnd(JackClientInterface** table, JackGraphManager* manager, jack_nframes_t frame_rate, jack_nframes_t buffer_size);
 
         /*
         	\brief
@@ -178,7 +203,10 @@ class SERVER_EXPORT JackTransportEngine : public JackAtomicArrayState<jack_posit
 
         void RequestNewPos(jack_position_t* pos);
 
-        jack_transport_state_t Query(jack_position_t* pos);
+        jack_transport_state_t Query(jack_position_t* pos, int stage = 0);
+        jack_transport_state_t QueryOffset(jack_nframes_t frame_offset, jack_position_t* pos, int stage = 0);
+
+        static void InterpolatePosition(jack_position_t* pos, double ticks_per_frame, jack_nframes_t frames);
 
         jack_nframes_t GetCurrentFrame();
 
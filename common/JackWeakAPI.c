@@ -242,6 +242,7 @@ DECL_FUNCTION(jack_nframes_t, jack_time_to_frames, (const jack_client_t *client,
 DECL_FUNCTION(jack_time_t, jack_frames_to_time, (const jack_client_t *client, jack_nframes_t frames), (client, frames));
 DECL_FUNCTION(jack_nframes_t, jack_frame_time, (const jack_client_t *client), (client));
 DECL_FUNCTION(jack_nframes_t, jack_last_frame_time, (const jack_client_t *client), (client));
+DECL_FUNCTION(int, jack_get_clock_estimate, (const jack_client_t *client, jack_clock_estimate_t *estimate), (client, estimate));
 DECL_FUNCTION(float, jack_cpu_load, (jack_client_t *client), (client));
 DECL_FUNCTION_NULL(jack_native_thread_t, jack_client_thread_id, (jack_client_t *client), (client));
 DECL_VOID_FUNCTION(jack_set_error_function, (print_function fun), (fun));
@@ -260,6 +261,7 @@ DECL_FUNCTION(int, jack_set_timebase_callback, (jack_client_t *client,
                                                 void *arg), (client, conditional, timebase_callback, arg));
 DECL_FUNCTION(int, jack_transport_locate, (jack_client_t *client, jack_nframes_t frame), (client, frame));
 DECL_FUNCTION(jack_transport_state_t, jack_transport_query, (const jack_client_t *client, jack_position_t *pos), (client, pos));
+DECL_FUNCTION(jack_transport_state_t, jack_transport_query_offset, (const jack_client_t *client, jack_nframes_t frame_offset, jack_position_t *pos), (client, frame_offset, pos));
 DECL_FUNCTION(jack_nframes_t, jack_get_current_transport_frame, (const jack_client_t *client), (client));
 DECL_FUNCTION(int, jack_transport_reposition, (jack_client_t *client, const jack_position_t *pos), (client, pos));
 DECL_VOID_FUNCTION(jack_transport_start, (jack_client_t *client), (client));
@@ -205,12 +205,18 @@ static void usage(FILE* file, jackctl_server_t *server, bool full = true)
             "               [ --timeout OR -t client-timeout-in-msecs ]\n"
             "               [ --loopback OR -L loopback-port-number ]\n"
             "               [ --port-max OR -p maximum-number-of-ports]\n"
+            "               [ --client-max OR -K client-limit-below-build-capacity ]\n"
             "               [ --slave-backend OR -X slave-backend-name ]\n"
             "               [ --internal-client OR -I internal-client-name ]\n"
             "               [ --internal-session-file OR -C internal-session-file ]\n"
             "               [ --verbose OR -v ]\n"
+            "               [ --freewheel-pipeline OR -W depth ]\n"
+            "               [ --client-budget OR -B percent-of-period ]\n"
+            "               [ --clock-filter OR -k [ d(ll) | a(daptive dll) | k(alman) ] ]\n"
 #ifdef __linux__
             "               [ --clocksource OR -c [ h(pet) | s(ystem) ]\n"
+            "               [ --rt-cpus OR -A cpu-list ]\n"
+            "               [ --rt-client-cpus OR -Y name:cpu-list ]\n"
 #endif
             "               [ --autoconnect OR -a <modechar>]\n");
 
@@ -231,6 +237,10 @@ static void usage(FILE* file, jackctl_server_t *server, bool full = true)
 
     fprintf(file,
             "               [ --replace-registry ]\n"
+#ifdef __linux__
+            "               [ --hugepages ]\n"
+            "               [ --memfd ]\n"
+#endif
             "               [ --silent OR -s ]\n"
             "               [ --sync OR -S ]\n"
             "               [ --temporary OR -T ]\n"
@@ -263,6 +273,8 @@ int main(int argc, char** argv)
     jackctl_driver_t * master_driver_ctl;
     jackctl_driver_t * loopback_driver_ctl = NULL;
     int replace_registry = 0;
+    int hugepages = 0;
+    int memfd = 0;
 
     for(int a = 1; a < argc; ++a) {
         if( !strcmp(argv[a], "--version") || !strcmp(argv[a], "-V") ) {
@@ -270,16 +282,18 @@ int main(int argc, char** argv)
             return 0;
         }
     }
-    const char *options = "-d:X:I:P:uvshrRL:STFl:t:mn:p:C:"
+    const char *options = "-d:X:I:P:uvshrRL:STFl:t:mn:p:C:W:K:B:k:"
         "a:"
 #ifdef __linux__
-        "c:"
+        "c:A:Y:"
 #endif
         ;
 
     struct option long_options[] = {
 #ifdef __linux__
                                        { "clock-source", 1, 0, 'c' },
+                                       { "rt-cpus", 1, 0, 'A' },
+                                       { "rt-client-cpus", 1, 0, 'Y' },
 #endif
                                        { "internal-session-file", 1, 0, 'C' },
                                        { "loopback-driver", 1, 0, 'L' },
@@ -289,12 +303,15 @@ int main(int argc, char** argv)
                                        { "verbose", 0, 0, 'v' },
                                        { "help", 0, 0, 'h' },
                                        { "port-max", 1, 0, 'p' },
+                                       { "client-max", 1, 0, 'K' },
                                        { "no-mlock", 0, 0, 'm' },
                                        { "name", 1, 0, 'n' },
                                        { "unlock", 0, 0, 'u' },
                                        { "realtime", 0, 0, 'R' },
                                        { "no-realtime", 0, 0, 'r' },
                                        { "replace-registry", 0, &replace_registry, 0 },
+                                       { "hugepages", 0, &hugepages, 1 },
+                                       { "memfd", 0, &memfd, 1 },
                                        { "loopback", 0, 0, 'L' },
                                        { "realtime-priority", 1, 0, 'P' },
                                        { "timeout", 1, 0, 't' },
@@ -302,6 +319,9 @@ int main(int argc, char** argv)
                                        { "silent", 0, 0, 's' },
                                        { "sync", 0, 0, 'S' },
                                        { "autoconnect", 1, 0, 'a' },
+                                       { "freewheel-pipeline", 1, 0, 'W' },
+                                       { "client-budget", 1, 0, 'B' },
+                                       { "clock-filter", 1, 0, 'k' },
                                        { 0, 0, 0, 0 }
                                    };
 
@@ -369,6 +389,22 @@ int main(int argc, char** argv)
                     }
                 }
                 break;
+
+            case 'A':
+                param = jackctl_get_parameter(server_parameters, "rt-cpus");
+                if (param != NULL) {
+                    strncpy(value.str, optarg, JACK_PARAM_STRING_MAX);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'Y':
+                param = jackctl_get_parameter(server_parameters, "rt-client-cpus");
+                if (param != NULL) {
+                    strncpy(value.str, optarg, JACK_PARAM_STRING_MAX);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
         #endif
 
             case 'a':
@@ -415,6 +451,38 @@ int main(int argc, char** argv)
                 }
                 break;
 
+            case 'K':
+                param = jackctl_get_parameter(server_parameters, "client-max");
+                if (param != NULL) {
+                    value.ui = atoi(optarg);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'W':
+                param = jackctl_get_parameter(server_parameters, "freewheel-pipeline");
+                if (param != NULL) {
+                    value.ui = atoi(optarg);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'B':
+                param = jackctl_get_parameter(server_parameters, "client-budget");
+                if (param != NULL) {
+                    value.ui = atoi(optarg);
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
+            case 'k':
+                param = jackctl_get_parameter(server_parameters, "clock-filter");
+                if (param != NULL) {
+                    value.c = optarg[0];
+                    jackctl_parameter_set_value(param, &value);
+                }
+                break;
+
             case 'm':
                 break;
 
@@ -494,6 +562,10 @@ int main(int argc, char** argv)
                 }
                 break;
 
+            case 0:
+                // Long option only, its flag is set
+                break;
+
             case 'h':
                 usage(stdout, server_ctl);
                 return_value = 0;
@@ -513,6 +585,22 @@ int main(int argc, char** argv)
         jackctl_parameter_set_value(param, &value);
     }
 
+    if (hugepages) {
+        param = jackctl_get_parameter(server_parameters, "hugepages");
+        if (param != NULL) {
+            value.b = true;
+            jackctl_parameter_set_value(param, &value);
+        }
+    }
+
+    if (memfd) {
+        param = jackctl_get_parameter(server_parameters, "memfd");
+        if (param != NULL) {
+            value.b = true;
+            jackctl_parameter_set_value(param, &value);
+        }
+    }
+
     if (!master_driver_name) {
         usage(stderr, server_ctl, false);
         goto destroy_server;
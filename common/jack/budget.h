@@ -0,0 +1,89 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __jack_budget_h__
+#define __jack_budget_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <jack/types.h>
+
+/**
+ * @defgroup ClientBudget Client CPU budget
+ *
+ * When the server is started with a client budget (see the
+ * client-budget server parameter), the process callback of each client
+ * may take at most this percentage of the period. A client over budget,
+ * or not finished in time, for several cycles in a row is bypassed for
+ * about one second: its output buffers are zeroed and the clients after
+ * it in the graph run without waiting for it. It is then tried again.
+ *
+ * @{
+ */
+
+/**
+ * Prototype for the client supplied function that is called whenever
+ * a client is bypassed, or is not bypassed anymore.
+ *
+ * @param client_name name of the client.
+ * @param bypassed 1 when the client has been bypassed, 0 when it runs again.
+ * @param arg pointer to a client supplied structure.
+ */
+typedef void (*JackBudgetCallback)(const char *client_name, int bypassed, void *arg);
+
+/**
+ * CPU budget statistics of a client, counted since it was opened.
+ */
+typedef struct _jack_budget_stats {
+    uint32_t violations;            /**< cycles over budget or not finished in time */
+    uint32_t bypass_count;          /**< times the client has been bypassed */
+    uint32_t bypassed_cycles;       /**< cycles spent bypassed */
+    jack_time_t max_process_usecs;  /**< longest process callback measured */
+    int bypassed;                   /**< 1 when the client is currently bypassed */
+} jack_budget_stats_t;
+
+/**
+ * Tell the JACK server to call @a budget_callback whenever a client,
+ * this one included, is bypassed or is not bypassed anymore.
+ *
+ * @return 0 on success, otherwise a non-zero error code
+ */
+int jack_set_budget_callback (jack_client_t *client,
+                              JackBudgetCallback budget_callback,
+                              void *arg);
+
+/**
+ * Get the CPU budget statistics of @a client. They are only counted
+ * when the server enforces a client budget.
+ *
+ * @return 0 on success, otherwise a non-zero error code
+ */
+int jack_get_budget_stats (jack_client_t *client,
+                           jack_budget_stats_t *stats);
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __jack_budget_h__ */
@@ -0,0 +1,134 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __jack_graph_h__
+#define __jack_graph_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <jack/types.h>
+
+/**
+ * @defgroup GraphSnapshot Reading the connection graph without server requests
+ *
+ * The server publishes a compact copy of the connection graph in
+ * shared memory each time connections change. Reading it does not
+ * involve the server, and the version number allows monitoring tools
+ * to cheaply detect changes and diff two snapshots.
+ *
+ * Ports are identified by their jack_port_id_t, use jack_port_by_id()
+ * to get the corresponding jack_port_t. Each connection appears in the
+ * peers of both its source and its destination port.
+ *
+ * @{
+ */
+
+typedef struct _jack_graph_snapshot jack_graph_snapshot_t;
+
+/**
+ * Get the version of the last published graph. It changes each time
+ * a connection is made or broken, including when ports go away.
+ *
+ * @param client pointer to JACK client structure.
+ * @param version where to store the version.
+ *
+ * @return 0 on success, otherwise a non-zero error code
+ */
+int jack_graph_get_version (jack_client_t *client, uint32_t *version);
+
+/**
+ * Get the ports connected to @a port, as seen in the last published graph.
+ *
+ * @param client pointer to JACK client structure.
+ * @param port any port.
+ * @param peers array receiving at most @a count port ids.
+ * @param count size of the @a peers array.
+ * @param version if not NULL, where to store the version of the graph
+ * that was read.
+ *
+ * @return the number of connected ports (which may be greater than
+ * @a count), or -1 in case of error.
+ */
+int jack_graph_get_port_peers (jack_client_t *client,
+                               const jack_port_t *port,
+                               jack_port_id_t *peers,
+                               int count,
+                               uint32_t *version);
+
+/**
+ * Copy the whole last published graph.
+ *
+ * @param client pointer to JACK client structure.
+ *
+ * @return a new snapshot to be released with jack_graph_snapshot_free(),
+ * or NULL in case of error.
+ */
+jack_graph_snapshot_t * jack_graph_snapshot_new (jack_client_t *client);
+
+/**
+ * Copy the last published graph in @a snapshot, if its version changed.
+ *
+ * @param client pointer to JACK client structure.
+ * @param snapshot snapshot returned by jack_graph_snapshot_new().
+ *
+ * @return 1 if the snapshot was updated, 0 if the graph did not change,
+ * or -1 in case of error.
+ */
+int jack_graph_snapshot_update (jack_client_t *client, jack_graph_snapshot_t *snapshot);
+
+/**
+ * @return the version of the graph copied in @a snapshot.
+ */
+uint32_t jack_graph_snapshot_get_version (const jack_graph_snapshot_t *snapshot);
+
+/**
+ * @return the number of port ids in @a snapshot : valid ids are
+ * between 0 and this value (excluded).
+ */
+uint32_t jack_graph_snapshot_get_port_count (const jack_graph_snapshot_t *snapshot);
+
+/**
+ * Get the ports connected to a port in @a snapshot.
+ *
+ * @param snapshot snapshot returned by jack_graph_snapshot_new().
+ * @param port_id id of the port.
+ * @param peers where to store a pointer to the array of connected port
+ * ids, valid until the next update or free of the snapshot.
+ *
+ * @return the number of connected ports, or -1 in case of error.
+ */
+int jack_graph_snapshot_get_peers (const jack_graph_snapshot_t *snapshot,
+                                   jack_port_id_t port_id,
+                                   const jack_port_id_t **peers);
+
+/**
+ * Release a snapshot returned by jack_graph_snapshot_new().
+ */
+void jack_graph_snapshot_free (jack_graph_snapshot_t *snapshot);
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __jack_graph_h__ */
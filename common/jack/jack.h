@@ -1393,6 +1393,25 @@ int jack_get_cycle_times(const jack_client_t *client,
                         jack_time_t    *current_usecs,
                         jack_time_t    *next_usecs,
                         float          *period_usecs) JACK_OPTIONAL_WEAK_EXPORT;
+
+/**
+ * Fill @a estimate with the state of the filter the server uses to
+ * compute the cycle times (see jack_get_cycle_times()). Clients that
+ * resample, or sync the JACK clock to an external one, can use
+ * rate_ratio directly instead of deriving it from successive cycle
+ * times, and error_usecs to tell how far they can trust it.
+ *
+ * The filter is selected with the server "clock-filter" parameter.
+ * The adaptive DLL and Kalman filters use the hardware timestamps of
+ * the driver when it provides them (ALSA), which removes the wakeup
+ * latency jitter from the measurement.
+ *
+ * This function may be used from any thread.
+ *
+ * @return zero if OK, non-zero if the server clock is not running yet.
+ */
+int jack_get_clock_estimate(const jack_client_t *client,
+                            jack_clock_estimate_t *estimate) JACK_OPTIONAL_WEAK_EXPORT;
                   
 /**
  * @return the estimated time in microseconds of the specified frame time
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __jack_startup_h__
+#define __jack_startup_h__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <jack/types.h>
+
+/**
+ * @defgroup ClientStartup Registering ports and activating in one step
+ *
+ * Most clients register all their ports right after jack_client_open(),
+ * then call jack_activate(). Each of these calls is a server round trip
+ * and a graph change. jack_activate_with_ports() does the same in a
+ * single request, which makes loading sessions with many clients
+ * noticeably faster.
+ *
+ * @{
+ */
+
+/**
+ * Description of a port to register, see jack_port_register().
+ */
+typedef struct _jack_port_spec {
+    const char *name;       /**< short name of the port */
+    const char *type;       /**< port type, like JACK_DEFAULT_AUDIO_TYPE */
+    unsigned long flags;    /**< JackPortFlags mask */
+} jack_port_spec_t;
+
+/**
+ * Register @a count ports, then activate the client, like successive
+ * calls to jack_port_register() and jack_activate() would. Callbacks
+ * must be set before, as for jack_activate().
+ *
+ * Either all ports are registered and the client is activated, or no
+ * port is registered and the client is not activated, including when
+ * the activation itself fails. If the client is already active, the
+ * ports are registered as jack_port_register() does, and it stays
+ * active.
+ *
+ * @param client pointer to JACK client structure.
+ * @param specs array of @a count port descriptions.
+ * @param count number of ports to register, may be 0.
+ * @param ports array receiving the @a count registered ports, NULL for
+ * the ones that are not registered.
+ *
+ * @return 0 on success, otherwise a non-zero error code
+ */
+int jack_activate_with_ports (jack_client_t *client,
+                              const jack_port_spec_t *specs,
+                              unsigned int count,
+                              jack_port_t **ports);
+
+/*@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __jack_startup_h__ */
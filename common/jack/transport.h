@@ -162,6 +162,33 @@ int  jack_transport_locate (jack_client_t *client,
 jack_transport_state_t jack_transport_query (const jack_client_t *client,
 					     jack_position_t *pos) JACK_OPTIONAL_WEAK_EXPORT;
 
+/**
+ * Query the transport state, and the position at a frame of the
+ * current cycle.
+ *
+ * This function is realtime-safe, and can be called from any thread.
+ * It is meant for clients that need the position many times per
+ * cycle, like plugin hosts. The state and position are read together
+ * from the last cycle boundary, without waiting for the server.
+ *
+ * When the transport is rolling, @a pos->frame is advanced by @a
+ * frame_offset, and the BBT fields are advanced to that frame at the
+ * current tempo. If ::JackBBTFrameOffset is set, the BBT fields are
+ * moved to @a pos->frame too, and @a pos->bbt_offset is 0. Otherwise
+ * the position is the one jack_transport_query() returns.
+ *
+ * @param client the JACK client structure.
+ * @param frame_offset frame of the cycle, from 0 to the buffer size.
+ * @param pos pointer to structure for returning the transport position
+ * at @a frame_offset; @a pos->valid will show which fields contain
+ * valid data. If @a pos is NULL, do not return position information.
+ *
+ * @return Current transport state.
+ */
+jack_transport_state_t jack_transport_query_offset (const jack_client_t *client,
+						    jack_nframes_t frame_offset,
+						    jack_position_t *pos) JACK_OPTIONAL_WEAK_EXPORT;
+
 /**
  * Return an estimate of the current transport frame,
  * including any time elapsed since the last transport
@@ -276,6 +276,66 @@ struct _jack_latency_range
 
 typedef struct _jack_latency_range jack_latency_range_t;
 
+/**
+ * Filters the server may use to turn the driver wakeup times into the
+ * frame time / microseconds mapping.
+ */
+enum JackClockFilter {
+
+    /**
+     * Second order DLL with a fixed 1/8 Hz bandwidth
+     */
+    JackClockFilterDLL = 0,
+
+    /**
+     * Second order DLL opening its bandwidth while it locks or after a
+     * clock jump, and narrowing it down to 1/32 Hz as the error settles
+     */
+    JackClockFilterAdaptiveDLL = 1,
+
+    /**
+     * Two state (phase and period) Kalman filter, the measurement noise
+     * being estimated from the prediction error
+     */
+    JackClockFilterKalman = 2
+};
+
+typedef enum JackClockFilter jack_clock_filter_t;
+
+/**
+ * State of the server clock filter, see jack_get_clock_estimate().
+ */
+PRE_PACKED_STRUCTURE
+struct _jack_clock_estimate
+{
+    /**
+     * filtered period time in microseconds, as returned by
+     * jack_get_cycle_times()
+     */
+    float period_usecs;
+    /**
+     * actual sample rate of the driver divided by the nominal one,
+     * > 1.0 when the device runs fast
+     */
+    double rate_ratio;
+    /**
+     * RMS of the difference between the measured and predicted cycle
+     * start, in microseconds
+     */
+    float error_usecs;
+    /**
+     * filter in use
+     */
+    jack_clock_filter_t filter;
+    /**
+     * non-zero when the filter is fed with the driver hardware timestamps
+     * instead of its wakeup times
+     */
+    int hardware_timestamps;
+} POST_PACKED_STRUCTURE;
+
+typedef struct _jack_clock_estimate jack_clock_estimate_t;
+
 /**
  * Prototype for the client supplied function that is called
  * by the engine anytime there is work to be done.
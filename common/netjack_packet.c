@@ -35,7 +35,7 @@
 #define _DARWIN_C_SOURCE
 #endif
 
-#if HAVE_PPOLL
+#if HAVE_PPOLL || defined(__linux__)
 #define _GNU_SOURCE
 #endif
 
@@ -65,6 +65,13 @@
 #include <errno.h>
 #include <signal.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 #if HAVE_SAMPLERATE
 #include <samplerate.h>
 #endif
@@ -152,6 +159,11 @@ int jack_port_is_midi(const char *porttype)
 
 
 // fragment management functions.
+//
+// The cache is a ring indexed by framecnt : the packet of a framecnt is kept in
+// packets[framecnt % size]. The framecnts of the valid packets are all within
+// [oldest_framecnt, newest_framecnt], which is never wider than the ring, so
+// packets never share a slot and lookups do not scan the cache.
 
 packet_cache
 *packet_cache_new (int num_packets, int pkt_size, int mtu)
@@ -172,11 +184,15 @@ packet_cache
 
     pcache->size = num_packets;
     pcache->packets = malloc (sizeof (cache_packet) * num_packets);
+    pcache->rx_buf = malloc (mtu * PACKET_CACHE_RX_BATCH);
     pcache->master_address_valid = 0;
     pcache->last_framecnt_retreived = 0;
     pcache->last_framecnt_retreived_valid = 0;
+    pcache->oldest_framecnt = 0;
+    pcache->newest_framecnt = 0;
+    pcache->window_valid = 0;
 
-    if (pcache->packets == NULL) {
+    if ((pcache->packets == NULL) || (pcache->rx_buf == NULL)) {
         jack_error ("could not allocate packet cache (2)");
         return NULL;
     }
@@ -184,12 +200,13 @@ packet_cache
     for (i = 0; i < num_packets; i++) {
         pcache->packets[i].valid = 0;
         pcache->packets[i].num_fragments = fragment_number;
+        pcache->packets[i].received_fragments = 0;
         pcache->packets[i].packet_size = pkt_size;
         pcache->packets[i].mtu = mtu;
         pcache->packets[i].framecnt = 0;
-        pcache->packets[i].fragment_array = malloc (sizeof (char) * fragment_number);
+        pcache->packets[i].fragment_bitmap = calloc ((fragment_number + 31) / 32, sizeof (uint32_t));
         pcache->packets[i].packet_buf = malloc (pkt_size);
-        if ((pcache->packets[i].fragment_array == NULL) || (pcache->packets[i].packet_buf == NULL)) {
+        if ((pcache->packets[i].fragment_bitmap == NULL) || (pcache->packets[i].packet_buf == NULL)) {
             jack_error ("could not allocate packet cache (3)");
             return NULL;
         }
@@ -207,102 +224,74 @@ packet_cache_free (packet_cache *pcache)
         return;
 
     for (i = 0; i < pcache->size; i++) {
-        free (pcache->packets[i].fragment_array);
+        free (pcache->packets[i].fragment_bitmap);
         free (pcache->packets[i].packet_buf);
     }
 
     free (pcache->packets);
+    free (pcache->rx_buf);
     free (pcache);
 }
 
-cache_packet
-*packet_cache_get_packet (packet_cache *pcache, jack_nframes_t framecnt)
+static cache_packet
+*packet_cache_find_packet (packet_cache *pcache, jack_nframes_t framecnt)
 {
-    int i;
-    cache_packet *retval;
-
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid && (pcache->packets[i].framecnt == framecnt))
-            return &(pcache->packets[i]);
-    }
-
-    // The Packet is not in the packet cache.
-    // find a free packet.
-
-    retval = packet_cache_get_free_packet (pcache);
-    if (retval != NULL) {
-        cache_packet_set_framecnt (retval, framecnt);
-        return retval;
-    }
-
-    // No Free Packet available
-    // Get The Oldest packet and reset it.
+    cache_packet *cpack = &(pcache->packets[framecnt % pcache->size]);
 
-    retval = packet_cache_get_oldest_packet (pcache);
-    //printf( "Dropping %d from Cache :S\n", retval->framecnt );
-    cache_packet_reset (retval);
-    cache_packet_set_framecnt (retval, framecnt);
+    if (cpack->valid && (cpack->framecnt == framecnt))
+        return cpack;
 
-    return retval;
+    return NULL;
 }
 
-// TODO: fix wrapping case... need to pass
-//       current expected frame here.
-//
-//       or just save framecount into packet_cache.
-
-cache_packet
-*packet_cache_get_oldest_packet (packet_cache *pcache)
+static int
+packet_cache_is_available (packet_cache *pcache, jack_nframes_t framecnt)
 {
-    jack_nframes_t minimal_frame = JACK_MAX_FRAMES;
-    cache_packet *retval = &(pcache->packets[0]);
-    int i;
+    cache_packet *cpack = packet_cache_find_packet (pcache, framecnt);
 
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid && (pcache->packets[i].framecnt < minimal_frame)) {
-            minimal_frame = pcache->packets[i].framecnt;
-            retval = &(pcache->packets[i]);
-        }
-    }
-
-    return retval;
+    return (cpack != NULL) && cache_packet_is_complete (cpack);
 }
 
+// Returns NULL when the framecnt is older than what the cache holds.
 cache_packet
-*packet_cache_get_free_packet (packet_cache *pcache)
+*packet_cache_get_packet (packet_cache *pcache, jack_nframes_t framecnt)
 {
-    int i;
+    cache_packet *cpack;
 
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid == 0)
-            return &(pcache->packets[i]);
+    if (!pcache->window_valid) {
+        pcache->oldest_framecnt = framecnt;
+        pcache->newest_framecnt = framecnt;
+        pcache->window_valid = 1;
+    } else if (framecnt > pcache->newest_framecnt) {
+        // Slide the window, the packets too old to stay in the ring are dropped.
+        if ((framecnt - pcache->oldest_framecnt) >= (jack_nframes_t) pcache->size)
+            packet_cache_clear_old_packets (pcache, framecnt - pcache->size + 1);
+        pcache->newest_framecnt = framecnt;
+        pcache->window_valid = 1;
+    } else if (framecnt < pcache->oldest_framecnt) {
+        return NULL;
     }
 
-    return NULL;
+    cpack = &(pcache->packets[framecnt % pcache->size]);
+    if (!cpack->valid || (cpack->framecnt != framecnt))
+        cache_packet_set_framecnt (cpack, framecnt);
+
+    return cpack;
 }
 
 void
 cache_packet_reset (cache_packet *pack)
 {
-    int i;
     pack->valid = 0;
-
-    // XXX: i don't think this is necessary here...
-    //      fragment array is cleared in _set_framecnt()
-
-    for (i = 0; i < pack->num_fragments; i++)
-        pack->fragment_array[i] = 0;
 }
 
 void
 cache_packet_set_framecnt (cache_packet *pack, jack_nframes_t framecnt)
 {
-    int i;
-
     pack->framecnt = framecnt;
 
-    for (i = 0; i < pack->num_fragments; i++)
-        pack->fragment_array[i] = 0;
+    memset (pack->fragment_bitmap, 0, ((pack->num_fragments + 31) / 32) * sizeof (uint32_t));
+    pack->received_fragments = 0;
 
     pack->valid = 1;
 }
@@ -317,37 +306,36 @@ cache_packet_add_fragment (cache_packet *pack, char *packet_buf, int rcv_len)
 
     jack_nframes_t fragment_nr = ntohl (pkthdr->fragment_nr);
     jack_nframes_t framecnt    = ntohl (pkthdr->framecnt);
+    uint32_t fragment_bit      = 1U << (fragment_nr & 31);
 
     if (framecnt != pack->framecnt) {
         jack_error ("error. framecnts don't match");
         return;
     }
 
+    if (fragment_nr >= pack->num_fragments)
+        return;
+
     if (fragment_nr == 0) {
         memcpy (pack->packet_buf, packet_buf, rcv_len);
-        pack->fragment_array[0] = 1;
-
+    } else if ((fragment_nr * fragment_payload_size + rcv_len - sizeof (jacknet_packet_header)) <= (pack->packet_size - sizeof (jacknet_packet_header))) {
+        memcpy (packet_bufX + fragment_nr * fragment_payload_size, dataX, rcv_len - sizeof (jacknet_packet_header));
+    } else {
+        jack_error ("too long packet received...");
         return;
     }
 
-    if ((fragment_nr < pack->num_fragments) && (fragment_nr > 0)) {
-        if ((fragment_nr * fragment_payload_size + rcv_len - sizeof (jacknet_packet_header)) <= (pack->packet_size - sizeof (jacknet_packet_header))) {
-            memcpy (packet_bufX + fragment_nr * fragment_payload_size, dataX, rcv_len - sizeof (jacknet_packet_header));
-            pack->fragment_array[fragment_nr] = 1;
-        } else
-            jack_error ("too long packet received...");
+    // Duplicated fragments are only counted once.
+    if ((pack->fragment_bitmap[fragment_nr >> 5] & fragment_bit) == 0) {
+        pack->fragment_bitmap[fragment_nr >> 5] |= fragment_bit;
+        pack->received_fragments += 1;
     }
 }
 
 int
 cache_packet_is_complete (cache_packet *pack)
 {
-    int i;
-    for (i = 0; i < pack->num_fragments; i++)
-        if (pack->fragment_array[i] == 0)
-            return 0;
-
-    return 1;
+    return (pack->received_fragments == pack->num_fragments);
 }
 
 #ifndef WIN32
@@ -503,14 +491,83 @@ netjack_poll_deadline (int sockfd, jack_time_t deadline)
 // This now reads all a socket has into the cache.
 // replacing netjack_recv functions.
 
-void
-packet_cache_drain_socket( packet_cache *pcache, int sockfd )
+static void
+packet_cache_add_packet( packet_cache *pcache, char *rx_packet, int rcv_len, struct sockaddr_in *sender_address, int senderlen, jack_time_t timestamp )
 {
-    char *rx_packet = alloca (pcache->mtu);
     jacknet_packet_header *pkthdr = (jacknet_packet_header *) rx_packet;
-    int rcv_len;
     jack_nframes_t framecnt;
     cache_packet *cpack;
+
+    if (rcv_len < (int) sizeof (jacknet_packet_header))
+        return;
+
+    if (pcache->master_address_valid) {
+        // Verify its from our master.
+        if (memcmp (sender_address, &(pcache->master_address), senderlen) != 0)
+            return;
+    } else {
+        // Setup this one as master
+        //printf( "setup master...\n" );
+        memcpy ( &(pcache->master_address), sender_address, senderlen );
+        pcache->master_address_valid = 1;
+    }
+
+    framecnt = ntohl (pkthdr->framecnt);
+    if( pcache->last_framecnt_retreived_valid && (framecnt <= pcache->last_framecnt_retreived ))
+        return;
+
+    cpack = packet_cache_get_packet (pcache, framecnt);
+    if (cpack == NULL)
+        return;
+
+    cache_packet_add_fragment (cpack, rx_packet, rcv_len);
+    cpack->recv_timestamp = timestamp;
+}
+
+#ifdef __linux__
+
+// Fragments are read PACKET_CACHE_RX_BATCH at a time, with a single system call.
+void
+packet_cache_drain_socket( packet_cache *pcache, int sockfd )
+{
+    struct mmsghdr msgs[PACKET_CACHE_RX_BATCH];
+    struct iovec iovecs[PACKET_CACHE_RX_BATCH];
+    struct sockaddr_in sender_addresses[PACKET_CACHE_RX_BATCH];
+    jack_time_t timestamp;
+    int i, received;
+
+    while (1) {
+        for (i = 0; i < PACKET_CACHE_RX_BATCH; i++) {
+            iovecs[i].iov_base = pcache->rx_buf + i * pcache->mtu;
+            iovecs[i].iov_len = pcache->mtu;
+            memset (&msgs[i].msg_hdr, 0, sizeof (struct msghdr));
+            msgs[i].msg_hdr.msg_name = &sender_addresses[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in);
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        received = recvmmsg (sockfd, msgs, PACKET_CACHE_RX_BATCH, MSG_DONTWAIT, NULL);
+        if (received <= 0)
+            return;
+
+        timestamp = jack_get_time();
+        for (i = 0; i < received; i++)
+            packet_cache_add_packet (pcache, iovecs[i].iov_base, msgs[i].msg_len, &sender_addresses[i], msgs[i].msg_hdr.msg_namelen, timestamp);
+
+        // A short batch means the socket is empty.
+        if (received < PACKET_CACHE_RX_BATCH)
+            return;
+    }
+}
+
+#else
+
+void
+packet_cache_drain_socket( packet_cache *pcache, int sockfd )
+{
+    char *rx_packet = pcache->rx_buf;
+    int rcv_len;
     struct sockaddr_in sender_address;
 #ifdef WIN32
     int senderlen = sizeof( struct sockaddr_in );
@@ -530,60 +587,57 @@ packet_cache_drain_socket( packet_cache *pcache, int sockfd )
         if (rcv_len < 0)
             return;
 
-        if (pcache->master_address_valid) {
-            // Verify its from our master.
-            if (memcmp (&sender_address, &(pcache->master_address), senderlen) != 0)
-                continue;
-        } else {
-            // Setup this one as master
-            //printf( "setup master...\n" );
-            memcpy ( &(pcache->master_address), &sender_address, senderlen );
-            pcache->master_address_valid = 1;
-        }
-
-        framecnt = ntohl (pkthdr->framecnt);
-        if( pcache->last_framecnt_retreived_valid && (framecnt <= pcache->last_framecnt_retreived ))
-            continue;
-
-        cpack = packet_cache_get_packet (pcache, framecnt);
-        cache_packet_add_fragment (cpack, rx_packet, rcv_len);
-        cpack->recv_timestamp = jack_get_time();
+        packet_cache_add_packet (pcache, rx_packet, rcv_len, &sender_address, senderlen, jack_get_time());
     }
 }
 
+#endif
+
 void
 packet_cache_reset_master_address( packet_cache *pcache )
 {
+    int i;
+
     pcache->master_address_valid = 0;
     pcache->last_framecnt_retreived = 0;
     pcache->last_framecnt_retreived_valid = 0;
+
+    // The framecnts of a new master start over.
+    for (i = 0; i < pcache->size; i++)
+        cache_packet_reset (&(pcache->packets[i]));
+    pcache->window_valid = 0;
 }
 
+// Drops the packets older than framecnt.
 void
 packet_cache_clear_old_packets (packet_cache *pcache, jack_nframes_t framecnt )
 {
-    int i;
+    jack_nframes_t i;
+    cache_packet *cpack;
 
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid && (pcache->packets[i].framecnt < framecnt)) {
+    if (!pcache->window_valid || (framecnt <= pcache->oldest_framecnt))
+        return;
+
+    if ((framecnt - pcache->oldest_framecnt) >= (jack_nframes_t) pcache->size) {
+        for (i = 0; i < (jack_nframes_t) pcache->size; i++)
             cache_packet_reset (&(pcache->packets[i]));
+    } else {
+        for (i = pcache->oldest_framecnt; i != framecnt; i++) {
+            cpack = packet_cache_find_packet (pcache, i);
+            if (cpack)
+                cache_packet_reset (cpack);
         }
     }
+
+    pcache->oldest_framecnt = framecnt;
+    if (framecnt > pcache->newest_framecnt)
+        pcache->window_valid = 0;
 }
 
 int
 packet_cache_retreive_packet_pointer( packet_cache *pcache, jack_nframes_t framecnt, char **packet_buf, int pkt_size, jack_time_t *timestamp )
 {
-    int i;
-    cache_packet *cpack = NULL;
-
-
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid && (pcache->packets[i].framecnt == framecnt)) {
-            cpack = &(pcache->packets[i]);
-            break;
-        }
-    }
+    cache_packet *cpack = packet_cache_find_packet (pcache, framecnt);
 
     if( cpack == NULL ) {
         //printf( "retrieve packet: %d....not found\n", framecnt );
@@ -608,16 +662,7 @@ packet_cache_retreive_packet_pointer( packet_cache *pcache, jack_nframes_t frame
 int
 packet_cache_release_packet( packet_cache *pcache, jack_nframes_t framecnt )
 {
-    int i;
-    cache_packet *cpack = NULL;
-
-
-    for (i = 0; i < pcache->size; i++) {
-        if (pcache->packets[i].valid && (pcache->packets[i].framecnt == framecnt)) {
-            cpack = &(pcache->packets[i]);
-            break;
-        }
-    }
+    cache_packet *cpack = packet_cache_find_packet (pcache, framecnt);
 
     if( cpack == NULL ) {
         //printf( "retrieve packet: %d....not found\n", framecnt );
@@ -628,22 +673,26 @@ packet_cache_release_packet( packet_cache *pcache, jack_nframes_t framecnt )
         return -1;
     }
 
-    cache_packet_reset (cpack);
-    packet_cache_clear_old_packets( pcache, framecnt );
+    packet_cache_clear_old_packets( pcache, framecnt + 1 );
 
     return 0;
 }
+
 float
 packet_cache_get_fill( packet_cache *pcache, jack_nframes_t expected_framecnt )
 {
     int num_packets_before_us = 0;
-    int i;
+    jack_nframes_t first, i, count;
 
-    for (i = 0; i < pcache->size; i++) {
-        cache_packet *cpack = &(pcache->packets[i]);
-        if (cpack->valid && cache_packet_is_complete( cpack ))
-            if( cpack->framecnt >= expected_framecnt )
-                num_packets_before_us += 1;
+    if (!pcache->window_valid || (expected_framecnt > pcache->newest_framecnt))
+        return 0.0;
+
+    first = (expected_framecnt > pcache->oldest_framecnt) ? expected_framecnt : pcache->oldest_framecnt;
+    count = pcache->newest_framecnt - first + 1;
+
+    for (i = 0; i < count; i++) {
+        if (packet_cache_is_available (pcache, first + i))
+            num_packets_before_us += 1;
     }
 
     return 100.0 * (float)num_packets_before_us / (float)( pcache->size );
@@ -653,100 +702,80 @@ packet_cache_get_fill( packet_cache *pcache, jack_nframes_t expected_framecnt )
 int
 packet_cache_get_next_available_framecnt( packet_cache *pcache, jack_nframes_t expected_framecnt, jack_nframes_t *framecnt )
 {
-    int i;
-    jack_nframes_t best_offset = JACK_MAX_FRAMES / 2 - 1;
-    int retval = 0;
-
-    for (i = 0; i < pcache->size; i++) {
-        cache_packet *cpack = &(pcache->packets[i]);
-        //printf( "p%d: valid=%d, frame %d\n", i, cpack->valid, cpack->framecnt );
+    jack_nframes_t first, i, count;
 
-        if (!cpack->valid || !cache_packet_is_complete( cpack )) {
-            //printf( "invalid\n" );
-            continue;
-        }
-
-        if( cpack->framecnt < expected_framecnt )
-            continue;
+    if (!pcache->window_valid || (expected_framecnt > pcache->newest_framecnt))
+        return 0;
 
-        if( (cpack->framecnt - expected_framecnt) > best_offset ) {
-            continue;
+    first = (expected_framecnt > pcache->oldest_framecnt) ? expected_framecnt : pcache->oldest_framecnt;
+    count = pcache->newest_framecnt - first + 1;
+
+    // The lowest framecnt is the first one found.
+    for (i = 0; i < count; i++) {
+        if (packet_cache_is_available (pcache, first + i)) {
+            if ((first + i - expected_framecnt) > JACK_MAX_FRAMES / 2 - 1)
+                return 0;
+            if (framecnt)
+                *framecnt = first + i;
+            return 1;
         }
-
-        best_offset = cpack->framecnt - expected_framecnt;
-        retval = 1;
-
-        if (best_offset == 0)
-            break;
     }
-    if (retval && framecnt)
-        *framecnt = expected_framecnt + best_offset;
 
-    return retval;
+    return 0;
 }
 
 int
 packet_cache_get_highest_available_framecnt( packet_cache *pcache, jack_nframes_t *framecnt )
 {
-    int i;
-    jack_nframes_t best_value = 0;
-    int retval = 0;
+    jack_nframes_t i, count;
 
-    for (i = 0; i < pcache->size; i++) {
-        cache_packet *cpack = &(pcache->packets[i]);
-        //printf( "p%d: valid=%d, frame %d\n", i, cpack->valid, cpack->framecnt );
+    if (!pcache->window_valid)
+        return 0;
 
-        if (!cpack->valid || !cache_packet_is_complete( cpack )) {
-            //printf( "invalid\n" );
-            continue;
-        }
+    count = pcache->newest_framecnt - pcache->oldest_framecnt + 1;
 
-        if (cpack->framecnt < best_value) {
-            continue;
+    // The highest framecnt is the first one found.
+    for (i = 0; i < count; i++) {
+        if (packet_cache_is_available (pcache, pcache->newest_framecnt - i)) {
+            if (framecnt)
+                *framecnt = pcache->newest_framecnt - i;
+            return 1;
         }
-
-        best_value = cpack->framecnt;
-        retval = 1;
-
     }
-    if (retval && framecnt)
-        *framecnt = best_value;
 
-    return retval;
+    return 0;
 }
 
 // Returns 0 when no valid packet is inside the cache.
 int
 packet_cache_find_latency( packet_cache *pcache, jack_nframes_t expected_framecnt, jack_nframes_t *framecnt )
 {
-    int i;
-    jack_nframes_t best_offset = 0;
-    int retval = 0;
+    jack_nframes_t i, count, found;
 
-    for (i = 0; i < pcache->size; i++) {
-        cache_packet *cpack = &(pcache->packets[i]);
-        //printf( "p%d: valid=%d, frame %d\n", i, cpack->valid, cpack->framecnt );
-
-        if (!cpack->valid || !cache_packet_is_complete( cpack )) {
-            //printf( "invalid\n" );
-            continue;
-        }
+    if (!pcache->window_valid)
+        return 0;
 
-        if ((cpack->framecnt - expected_framecnt) < best_offset) {
-            continue;
+    // The biggest offset is the one of the oldest packet before expected_framecnt,
+    // or of the newest packet when there is none before.
+    count = pcache->newest_framecnt - pcache->oldest_framecnt + 1;
+    if (expected_framecnt > pcache->oldest_framecnt) {
+        for (i = 0; i < count && (pcache->oldest_framecnt + i) < expected_framecnt; i++) {
+            if (packet_cache_is_available (pcache, pcache->oldest_framecnt + i)) {
+                if (framecnt)
+                    *framecnt = JACK_MAX_FRAMES - (pcache->oldest_framecnt + i - expected_framecnt);
+                return 1;
+            }
         }
-
-        best_offset = cpack->framecnt - expected_framecnt;
-        retval = 1;
-
-        if( best_offset == 0 )
-            break;
     }
-    if (retval && framecnt)
-        *framecnt = JACK_MAX_FRAMES - best_offset;
 
-    return retval;
+    if (!packet_cache_get_highest_available_framecnt (pcache, &found) || (found < expected_framecnt))
+        return 0;
+
+    if (framecnt)
+        *framecnt = JACK_MAX_FRAMES - (found - expected_framecnt);
+    return 1;
 }
+
 // fragmented packet IO
 void
 netjack_sendto (int sockfd, char *packet_buf, int pkt_size, int flags, struct sockaddr *addr, int addr_size, int mtu)
@@ -860,6 +889,204 @@ encode_midi_buffer (uint32_t *buffer_uint32, unsigned int buffer_size_uint32, ja
     buffer_uint32[written] = 0;
 }
 
+// sample conversion kernels.
+//
+// The payload is big endian. 16bit samples are offset binary, 8bit samples
+// are signed. Encoding saturates to [-1.0, 1.0].
+
+#if defined(__SSE2__)
+#define NETJACK_SSE2 1
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define NETJACK_NEON 1
+#endif
+
+#define NETJACK_SCALE_16BIT (1.0f / 32768.0f)
+#define NETJACK_SCALE_8BIT  (1.0f / 127.0f)
+
+static inline float
+netjack_clip (float sample)
+{
+    // NaN is mapped to -1.0, like the vector min/max do.
+    return (sample > -1.0f) ? ((sample < 1.0f) ? sample : 1.0f) : -1.0f;
+}
+
+#if NETJACK_SSE2
+static inline __m128i
+netjack_swap_16x8 (__m128i v)
+{
+    return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+}
+
+static inline __m128i
+netjack_swap_32x4 (__m128i v)
+{
+    v = netjack_swap_16x8 (v);
+    v = _mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+    return _mm_shufflehi_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1));
+}
+#endif
+
+void
+netjack_float_to_net (uint32_t *dst, const float *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+    int_float_t val;
+
+#if NETJACK_SSE2
+    for (; i + 4 <= nsamples; i += 4)
+        _mm_storeu_si128 ((__m128i *) (dst + i), netjack_swap_32x4 (_mm_castps_si128 (_mm_loadu_ps (src + i))));
+#elif NETJACK_NEON
+    for (; i + 4 <= nsamples; i += 4)
+        vst1q_u8 ((uint8_t *) (dst + i), vrev32q_u8 (vld1q_u8 ((const uint8_t *) (src + i))));
+#endif
+    for (; i < nsamples; i++) {
+        val.f = src[i];
+        dst[i] = htonl (val.i);
+    }
+}
+
+void
+netjack_net_to_float (float *dst, const uint32_t *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+    int_float_t val;
+
+#if NETJACK_SSE2
+    for (; i + 4 <= nsamples; i += 4)
+        _mm_storeu_ps (dst + i, _mm_castsi128_ps (netjack_swap_32x4 (_mm_loadu_si128 ((const __m128i *) (src + i)))));
+#elif NETJACK_NEON
+    for (; i + 4 <= nsamples; i += 4)
+        vst1q_u8 ((uint8_t *) (dst + i), vrev32q_u8 (vld1q_u8 ((const uint8_t *) (src + i))));
+#endif
+    for (; i < nsamples; i++) {
+        val.i = ntohl (src[i]);
+        dst[i] = val.f;
+    }
+}
+
+void
+netjack_float_to_net_16bit (uint16_t *dst, const float *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+
+#if NETJACK_SSE2
+    const __m128 lower = _mm_set1_ps (-1.0f);
+    const __m128 upper = _mm_set1_ps (1.0f);
+    const __m128 scale = _mm_set1_ps (32767.0f);
+    const __m128i bias = _mm_set1_epi32 (32768);
+    const __m128i sign = _mm_set1_epi16 ((short) 0x8000);
+    for (; i + 8 <= nsamples; i += 8) {
+        __m128 a = _mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i), lower), upper);
+        __m128 b = _mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i + 4), lower), upper);
+        // [0, 65534] is packed with signed saturation around 32768, then biased back.
+        __m128i ia = _mm_sub_epi32 (_mm_cvttps_epi32 (_mm_mul_ps (_mm_add_ps (a, upper), scale)), bias);
+        __m128i ib = _mm_sub_epi32 (_mm_cvttps_epi32 (_mm_mul_ps (_mm_add_ps (b, upper), scale)), bias);
+        __m128i v = _mm_xor_si128 (_mm_packs_epi32 (ia, ib), sign);
+        _mm_storeu_si128 ((__m128i *) (dst + i), netjack_swap_16x8 (v));
+    }
+#elif NETJACK_NEON
+    const float32x4_t lower = vdupq_n_f32 (-1.0f);
+    const float32x4_t upper = vdupq_n_f32 (1.0f);
+    for (; i + 8 <= nsamples; i += 8) {
+        float32x4_t a = vminq_f32 (vmaxq_f32 (vld1q_f32 (src + i), lower), upper);
+        float32x4_t b = vminq_f32 (vmaxq_f32 (vld1q_f32 (src + i + 4), lower), upper);
+        uint32x4_t ia = vcvtq_u32_f32 (vmulq_n_f32 (vaddq_f32 (a, upper), 32767.0f));
+        uint32x4_t ib = vcvtq_u32_f32 (vmulq_n_f32 (vaddq_f32 (b, upper), 32767.0f));
+        uint16x8_t v = vcombine_u16 (vmovn_u32 (ia), vmovn_u32 (ib));
+        vst1q_u8 ((uint8_t *) (dst + i), vrev16q_u8 (vreinterpretq_u8_u16 (v)));
+    }
+#endif
+    for (; i < nsamples; i++)
+        dst[i] = htons ((uint16_t) ((netjack_clip (src[i]) + 1.0f) * 32767.0f));
+}
+
+void
+netjack_net_16bit_to_float (float *dst, const uint16_t *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+
+#if NETJACK_SSE2
+    const __m128i zero = _mm_setzero_si128 ();
+    const __m128 scale = _mm_set1_ps (NETJACK_SCALE_16BIT);
+    const __m128 one = _mm_set1_ps (1.0f);
+    for (; i + 8 <= nsamples; i += 8) {
+        __m128i v = netjack_swap_16x8 (_mm_loadu_si128 ((const __m128i *) (src + i)));
+        __m128 a = _mm_cvtepi32_ps (_mm_unpacklo_epi16 (v, zero));
+        __m128 b = _mm_cvtepi32_ps (_mm_unpackhi_epi16 (v, zero));
+        _mm_storeu_ps (dst + i, _mm_sub_ps (_mm_mul_ps (a, scale), one));
+        _mm_storeu_ps (dst + i + 4, _mm_sub_ps (_mm_mul_ps (b, scale), one));
+    }
+#elif NETJACK_NEON
+    const float32x4_t one = vdupq_n_f32 (1.0f);
+    for (; i + 8 <= nsamples; i += 8) {
+        uint16x8_t v = vreinterpretq_u16_u8 (vrev16q_u8 (vld1q_u8 ((const uint8_t *) (src + i))));
+        float32x4_t a = vcvtq_f32_u32 (vmovl_u16 (vget_low_u16 (v)));
+        float32x4_t b = vcvtq_f32_u32 (vmovl_u16 (vget_high_u16 (v)));
+        vst1q_f32 (dst + i, vsubq_f32 (vmulq_n_f32 (a, NETJACK_SCALE_16BIT), one));
+        vst1q_f32 (dst + i + 4, vsubq_f32 (vmulq_n_f32 (b, NETJACK_SCALE_16BIT), one));
+    }
+#endif
+    for (; i < nsamples; i++)
+        dst[i] = ((float) ntohs (src[i])) * NETJACK_SCALE_16BIT - 1.0f;
+}
+
+void
+netjack_float_to_net_8bit (int8_t *dst, const float *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+
+#if NETJACK_SSE2
+    const __m128 lower = _mm_set1_ps (-1.0f);
+    const __m128 upper = _mm_set1_ps (1.0f);
+    const __m128 scale = _mm_set1_ps (127.0f);
+    for (; i + 16 <= nsamples; i += 16) {
+        __m128i a = _mm_cvttps_epi32 (_mm_mul_ps (_mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i), lower), upper), scale));
+        __m128i b = _mm_cvttps_epi32 (_mm_mul_ps (_mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i + 4), lower), upper), scale));
+        __m128i c = _mm_cvttps_epi32 (_mm_mul_ps (_mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i + 8), lower), upper), scale));
+        __m128i d = _mm_cvttps_epi32 (_mm_mul_ps (_mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i + 12), lower), upper), scale));
+        _mm_storeu_si128 ((__m128i *) (dst + i), _mm_packs_epi16 (_mm_packs_epi32 (a, b), _mm_packs_epi32 (c, d)));
+    }
+#elif NETJACK_NEON
+    const float32x4_t lower = vdupq_n_f32 (-1.0f);
+    const float32x4_t upper = vdupq_n_f32 (1.0f);
+    for (; i + 8 <= nsamples; i += 8) {
+        int32x4_t a = vcvtq_s32_f32 (vmulq_n_f32 (vminq_f32 (vmaxq_f32 (vld1q_f32 (src + i), lower), upper), 127.0f));
+        int32x4_t b = vcvtq_s32_f32 (vmulq_n_f32 (vminq_f32 (vmaxq_f32 (vld1q_f32 (src + i + 4), lower), upper), 127.0f));
+        vst1_s8 (dst + i, vmovn_s16 (vcombine_s16 (vmovn_s32 (a), vmovn_s32 (b))));
+    }
+#endif
+    for (; i < nsamples; i++)
+        dst[i] = (int8_t) (netjack_clip (src[i]) * 127.0f);
+}
+
+void
+netjack_net_8bit_to_float (float *dst, const int8_t *src, unsigned int nsamples)
+{
+    unsigned int i = 0;
+
+#if NETJACK_SSE2
+    const __m128 scale = _mm_set1_ps (NETJACK_SCALE_8BIT);
+    for (; i + 16 <= nsamples; i += 16) {
+        __m128i v = _mm_loadu_si128 ((const __m128i *) (src + i));
+        // sign extension, by shifting right the bytes moved to the high part
+        __m128i lo = _mm_srai_epi16 (_mm_unpacklo_epi8 (v, v), 8);
+        __m128i hi = _mm_srai_epi16 (_mm_unpackhi_epi8 (v, v), 8);
+        _mm_storeu_ps (dst + i, _mm_mul_ps (_mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpacklo_epi16 (lo, lo), 16)), scale));
+        _mm_storeu_ps (dst + i + 4, _mm_mul_ps (_mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpackhi_epi16 (lo, lo), 16)), scale));
+        _mm_storeu_ps (dst + i + 8, _mm_mul_ps (_mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpacklo_epi16 (hi, hi), 16)), scale));
+        _mm_storeu_ps (dst + i + 12, _mm_mul_ps (_mm_cvtepi32_ps (_mm_srai_epi32 (_mm_unpackhi_epi16 (hi, hi), 16)), scale));
+    }
+#elif NETJACK_NEON
+    for (; i + 8 <= nsamples; i += 8) {
+        int16x8_t v = vmovl_s8 (vld1_s8 (src + i));
+        vst1q_f32 (dst + i, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (v))), NETJACK_SCALE_8BIT));
+        vst1q_f32 (dst + i + 4, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (v))), NETJACK_SCALE_8BIT));
+    }
+#endif
+    for (; i < nsamples; i++)
+        dst[i] = ((float) src[i]) * NETJACK_SCALE_8BIT;
+}
+
 // render functions for float
 void
 render_payload_to_jack_ports_float ( void *packet_payload, jack_nframes_t net_period_down, JSList *capture_ports, JSList *capture_srcs, jack_nframes_t nframes, int dont_htonl_floats)
@@ -876,8 +1103,6 @@ render_payload_to_jack_ports_float ( void *packet_payload, jack_nframes_t net_pe
         return;
 
     while (node != NULL) {
-        int i;
-        int_float_t val;
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
@@ -892,9 +1117,7 @@ render_payload_to_jack_ports_float ( void *packet_payload, jack_nframes_t net_pe
             // audio port, resample if necessary
             if (net_period_down != nframes) {
                 SRC_STATE *src_state = src_node->data;
-                for (i = 0; i < net_period_down; i++) {
-                    packet_bufX[i] = ntohl (packet_bufX[i]);
-                }
+                netjack_net_to_float ((float *) packet_bufX, packet_bufX, net_period_down);
 
                 src.data_in = (float *) packet_bufX;
                 src.input_frames = net_period_down;
@@ -914,11 +1137,7 @@ render_payload_to_jack_ports_float ( void *packet_payload, jack_nframes_t net_pe
                 if( dont_htonl_floats ) {
                     memcpy( buf, packet_bufX, net_period_down * sizeof(jack_default_audio_sample_t));
                 } else {
-                    for (i = 0; i < net_period_down; i++) {
-                        val.i = packet_bufX[i];
-                        val.i = ntohl (val.i);
-                        buf[i] = val.f;
-                    }
+                    netjack_net_to_float (buf, packet_bufX, net_period_down);
                 }
             }
         } else if (jack_port_is_midi (porttype)) {
@@ -949,8 +1168,6 @@ render_jack_ports_to_payload_float (JSList *playback_ports, JSList *playback_src
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
-        int i;
-        int_float_t val;
         jack_port_t *port = (jack_port_t *) node->data;
         jack_default_audio_sample_t* buf = jack_port_get_buffer (port, nframes);
 
@@ -974,9 +1191,7 @@ render_jack_ports_to_payload_float (JSList *playback_ports, JSList *playback_src
                 src_set_ratio (src_state, src.src_ratio);
                 src_process (src_state, &src);
 
-                for (i = 0; i < net_period_up; i++) {
-                    packet_bufX[i] = htonl (packet_bufX[i]);
-                }
+                netjack_float_to_net (packet_bufX, (float *) packet_bufX, net_period_up);
                 src_node = jack_slist_next (src_node);
             } else
 #endif
@@ -984,11 +1199,7 @@ render_jack_ports_to_payload_float (JSList *playback_ports, JSList *playback_src
                 if( dont_htonl_floats ) {
                     memcpy( packet_bufX, buf, net_period_up * sizeof(jack_default_audio_sample_t) );
                 } else {
-                    for (i = 0; i < net_period_up; i++) {
-                        val.f = buf[i];
-                        val.i = htonl (val.i);
-                        packet_bufX[i] = val.i;
-                    }
+                    netjack_float_to_net (packet_bufX, buf, net_period_up);
                 }
             }
         } else if (jack_port_is_midi (porttype)) {
@@ -1020,7 +1231,6 @@ render_payload_to_jack_ports_16bit (void *packet_payload, jack_nframes_t net_per
         return;
 
     while (node != NULL) {
-        int i;
         //uint32_t val;
 #if HAVE_SAMPLERATE
         SRC_DATA src;
@@ -1040,9 +1250,7 @@ render_payload_to_jack_ports_16bit (void *packet_payload, jack_nframes_t net_per
 #if HAVE_SAMPLERATE
             if (net_period_down != nframes) {
                 SRC_STATE *src_state = src_node->data;
-                for (i = 0; i < net_period_down; i++) {
-                    floatbuf[i] = ((float) ntohs(packet_bufX[i])) / 32767.0 - 1.0;
-                }
+                netjack_net_16bit_to_float (floatbuf, packet_bufX, net_period_down);
 
                 src.data_in = floatbuf;
                 src.input_frames = net_period_down;
@@ -1058,8 +1266,7 @@ render_payload_to_jack_ports_16bit (void *packet_payload, jack_nframes_t net_per
                 src_node = jack_slist_next (src_node);
             } else
 #endif
-                for (i = 0; i < net_period_down; i++)
-                    buf[i] = ((float) ntohs (packet_bufX[i])) / 32768.0 - 1.0;
+                netjack_net_16bit_to_float (buf, packet_bufX, net_period_down);
         } else if (jack_port_is_midi (porttype)) {
             // midi port, decode midi events
             // convert the data buffer to a standard format (uint32_t based)
@@ -1088,7 +1295,6 @@ render_jack_ports_to_payload_16bit (JSList *playback_ports, JSList *playback_src
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
-        int i;
         jack_port_t *port = (jack_port_t *) node->data;
         jack_default_audio_sample_t* buf = jack_port_get_buffer (port, nframes);
         const char *porttype = jack_port_type (port);
@@ -1114,14 +1320,11 @@ render_jack_ports_to_payload_16bit (JSList *playback_ports, JSList *playback_src
                 src_set_ratio (src_state, src.src_ratio);
                 src_process (src_state, &src);
 
-                for (i = 0; i < net_period_up; i++) {
-                    packet_bufX[i] = htons (((uint16_t)((floatbuf[i] + 1.0) * 32767.0)));
-                }
+                netjack_float_to_net_16bit (packet_bufX, floatbuf, net_period_up);
                 src_node = jack_slist_next (src_node);
             } else
 #endif
-                for (i = 0; i < net_period_up; i++)
-                    packet_bufX[i] = htons(((uint16_t)((buf[i] + 1.0) * 32767.0)));
+                netjack_float_to_net_16bit (packet_bufX, buf, net_period_up);
         } else if (jack_port_is_midi (porttype)) {
             // encode midi events from port to packet
             // convert the data buffer to a standard format (uint32_t based)
@@ -1152,7 +1355,6 @@ render_payload_to_jack_ports_8bit (void *packet_payload, jack_nframes_t net_peri
         return;
 
     while (node != NULL) {
-        int i;
         //uint32_t val;
 #if HAVE_SAMPLERATE
         SRC_DATA src;
@@ -1171,8 +1373,7 @@ render_payload_to_jack_ports_8bit (void *packet_payload, jack_nframes_t net_peri
             // audio port, resample if necessary
             if (net_period_down != nframes) {
                 SRC_STATE *src_state = src_node->data;
-                for (i = 0; i < net_period_down; i++)
-                    floatbuf[i] = ((float) packet_bufX[i]) / 127.0;
+                netjack_net_8bit_to_float (floatbuf, packet_bufX, net_period_down);
 
                 src.data_in = floatbuf;
                 src.input_frames = net_period_down;
@@ -1188,8 +1389,7 @@ render_payload_to_jack_ports_8bit (void *packet_payload, jack_nframes_t net_peri
                 src_node = jack_slist_next (src_node);
             } else
 #endif
-                for (i = 0; i < net_period_down; i++)
-                    buf[i] = ((float) packet_bufX[i]) / 127.0;
+                netjack_net_8bit_to_float (buf, packet_bufX, net_period_down);
         } else if (jack_port_is_midi (porttype)) {
             // midi port, decode midi events
             // convert the data buffer to a standard format (uint32_t based)
@@ -1218,7 +1418,6 @@ render_jack_ports_to_payload_8bit (JSList *playback_ports, JSList *playback_srcs
 #if HAVE_SAMPLERATE
         SRC_DATA src;
 #endif
-        int i;
         jack_port_t *port = (jack_port_t *) node->data;
 
         jack_default_audio_sample_t* buf = jack_port_get_buffer (port, nframes);
@@ -1245,13 +1444,11 @@ render_jack_ports_to_payload_8bit (JSList *playback_ports, JSList *playback_srcs
                 src_set_ratio (src_state, src.src_ratio);
                 src_process (src_state, &src);
 
-                for (i = 0; i < net_period_up; i++)
-                    packet_bufX[i] = floatbuf[i] * 127.0;
+                netjack_float_to_net_8bit (packet_bufX, floatbuf, net_period_up);
                 src_node = jack_slist_next (src_node);
             } else
 #endif
-                for (i = 0; i < net_period_up; i++)
-                    packet_bufX[i] = buf[i] * 127.0;
+                netjack_float_to_net_8bit (packet_bufX, buf, net_period_up);
         } else if (jack_port_is_midi (porttype)) {
             // encode midi events from port to packet
             // convert the data buffer to a standard format (uint32_t based)
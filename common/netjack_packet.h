@@ -81,24 +81,32 @@ extern "C"
     struct _cache_packet {
         int		    valid;
         int		    num_fragments;
+        int		    received_fragments;
         int		    packet_size;
         int		    mtu;
         jack_time_t	    recv_timestamp;
         jack_nframes_t  framecnt;
-        char *	    fragment_array;
+        uint32_t *	    fragment_bitmap;
         char *	    packet_buf;
     };
 
     typedef struct _packet_cache packet_cache;
 
+// Number of fragments read from the socket at once.
+#define PACKET_CACHE_RX_BATCH 16
+
     struct _packet_cache {
         int size;
-        cache_packet *packets;
+        cache_packet *packets;      // packets[framecnt % size]
         int mtu;
+        char *rx_buf;
         struct sockaddr_in master_address;
         int master_address_valid;
         jack_nframes_t last_framecnt_retreived;
         int last_framecnt_retreived_valid;
+        jack_nframes_t oldest_framecnt;
+        jack_nframes_t newest_framecnt;
+        int window_valid;
     };
 
     // fragment cache function prototypes
@@ -107,8 +115,7 @@ extern "C"
     void	      packet_cache_free(packet_cache *pkt_cache);
 
     cache_packet *packet_cache_get_packet(packet_cache *pkt_cache, jack_nframes_t framecnt);
-    cache_packet *packet_cache_get_oldest_packet(packet_cache *pkt_cache);
-    cache_packet *packet_cache_get_free_packet(packet_cache *pkt_cache);
+    void packet_cache_clear_old_packets(packet_cache *pkt_cache, jack_nframes_t framecnt);
 
     void	cache_packet_reset(cache_packet *pack);
     void	cache_packet_set_framecnt(cache_packet *pack, jack_nframes_t framecnt);
@@ -138,6 +145,14 @@ extern "C"
     //      This one waits forever. an is not using ppoll
     int netjack_poll(int sockfd, int timeout);
 
+    // sample conversion kernels, vectorized with SSE2 or NEON when available
+    void netjack_float_to_net (uint32_t *dst, const float *src, unsigned int nsamples);
+    void netjack_net_to_float (float *dst, const uint32_t *src, unsigned int nsamples);
+    void netjack_float_to_net_16bit (uint16_t *dst, const float *src, unsigned int nsamples);
+    void netjack_net_16bit_to_float (float *dst, const uint16_t *src, unsigned int nsamples);
+    void netjack_float_to_net_8bit (int8_t *dst, const float *src, unsigned int nsamples);
+    void netjack_net_8bit_to_float (float *dst, const int8_t *src, unsigned int nsamples);
+
     void decode_midi_buffer (uint32_t *buffer_uint32, unsigned int buffer_size_uint32, jack_default_audio_sample_t* buf);
     void encode_midi_buffer (uint32_t *buffer_uint32, unsigned int buffer_size_uint32, jack_default_audio_sample_t* buf);
 
@@ -53,6 +53,11 @@
 #include <sys/sem.h>
 #include <stdlib.h>
 #include "promiscuous.h"
+#ifdef __linux__
+#include <mntent.h>
+#include <sys/vfs.h>
+#include <sys/syscall.h>
+#endif
 
 #endif
 
@@ -128,6 +133,29 @@ static jack_shm_info_t registry_info = { /* SHM info for the registry */
 static jack_shm_header_t   *jack_shm_header = NULL;
 static jack_shm_registry_t *jack_shm_registry = NULL;
 
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+/* huge pages and memfd modes of the segments allocated by this process */
+static int jack_shm_hugepages = FALSE;
+static int jack_shm_memfd = FALSE;
+
+/* memfd segment descriptors known by this process, by registry index:
+ * the ones it allocated, and the ones received from their allocator
+ * that have not been attached yet.  Stored as fd + 1, 0 when none.
+ * Only accessed with the registry locked: request threads send the
+ * descriptors that jack_release_shm_entry closes.
+ */
+static int jack_shm_fds[MAX_SHM_ID];
+
+static void
+jack_shm_close_fd (jack_shm_registry_index_t index)
+{
+	/* the registry must be locked */
+	if (jack_shm_fds[index] > 0)
+		close (jack_shm_fds[index] - 1);
+	jack_shm_fds[index] = 0;
+}
+#endif
+
 /* jack_shm_lock_registry() serializes updates to the shared memory
  * segment JACK uses to keep track of the SHM segments allocated to
  * all its processes, including multiple servers.
@@ -464,6 +492,11 @@ static void
 jack_release_shm_entry (jack_shm_registry_index_t index)
 {
 	/* the registry must be locked */
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	/* a memfd segment disappears with the last descriptor and mapping */
+	if (jack_shm_registry[index].allocator == GetPID())
+		jack_shm_close_fd (index);
+#endif
 	jack_shm_registry[index].size = 0;
 	jack_shm_registry[index].allocator = 0;
 	memset (&jack_shm_registry[index].id, 0,
@@ -703,12 +736,334 @@ jack_attach_lib_shm_read (jack_shm_info_t* si)
     return res;
 }
 
+void
+jack_set_shm_hugepages (int onoff)
+{
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	jack_shm_hugepages = onoff;
+#else
+	if (onoff)
+		jack_error ("Huge pages shm segments are not supported on this platform");
+#endif
+}
+
+void
+jack_set_shm_memfd (int onoff)
+{
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	jack_shm_memfd = onoff;
+#else
+	if (onoff)
+		jack_error ("memfd shm segments are not supported on this platform");
+#endif
+}
+
+int
+jack_shm_dup_fd (jack_shm_registry_index_t index)
+{
+	int fd = -1;
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	if (index < 0 || index >= MAX_SHM_ID)
+		return -1;
+
+	if (jack_shm_lock_registry () < 0) {
+		jack_error ("jack_shm_lock_registry fails...");
+		return -1;
+	}
+
+	/* only the segments allocated by this process */
+	if (jack_shm_fds[index] > 0 && jack_shm_registry[index].allocator == GetPID())
+		fd = fcntl (jack_shm_fds[index] - 1, F_DUPFD_CLOEXEC, 0);
+
+	jack_shm_unlock_registry ();
+#endif
+	return fd;
+}
+
+void
+jack_shm_set_fd (jack_shm_registry_index_t index, int fd)
+{
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	if (index >= 0 && index < MAX_SHM_ID && jack_shm_lock_registry () == 0) {
+		/* several clients of the process may receive the same segment */
+		jack_shm_close_fd (index);
+		jack_shm_fds[index] = fd + 1;
+		jack_shm_unlock_registry ();
+		return;
+	}
+#endif
+	if (fd >= 0)
+		close (fd);
+}
+
+void
+jack_shm_release_fd (jack_shm_registry_index_t index)
+{
+#if defined(USE_POSIX_SHM) && defined(__linux__)
+	if (index >= 0 && index < MAX_SHM_ID && jack_shm_lock_registry () == 0) {
+		/* received, but the segment was already attached by this process */
+		if (jack_shm_registry[index].allocator != GetPID())
+			jack_shm_close_fd (index);
+		jack_shm_unlock_registry ();
+	}
+#endif
+}
+
 #ifdef USE_POSIX_SHM
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * POSIX interface-dependent functions
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#ifdef __linux__
+
+#ifndef HUGETLBFS_MAGIC
+#define HUGETLBFS_MAGIC 0x958458f6
+#endif
+
+/* Huge pages segments are files created in a hugetlbfs mount, and
+ * registered with their full path so that clients can open them
+ * whatever the mode of the server.  POSIX shm names never contain a
+ * '/' after the leading one.
+ */
+static int
+jack_is_hugetlbfs_id (const char *id)
+{
+	return (id[0] != '\0') && (strchr (id + 1, '/') != NULL);
+}
+
+/* find a hugetlbfs mount this process can create files in, either
+ * given by the JACK_HUGETLBFS environment variable or the first one
+ * listed in /proc/mounts
+ *
+ * returns: the huge page size of the mount, 0 if none is usable
+ */
+static long
+jack_get_hugetlbfs (char *path, size_t size)
+{
+	static char mount_path[PATH_MAX] = "";
+	static long page_size = -1;
+	const char *env;
+	struct statfs fs;
+
+	if (page_size < 0) {
+		page_size = 0;
+		if ((env = getenv ("JACK_HUGETLBFS")) != NULL) {
+			snprintf (mount_path, sizeof (mount_path), "%s", env);
+		} else {
+			FILE *mounts;
+			struct mntent *entry;
+			if ((mounts = setmntent ("/proc/mounts", "r")) != NULL) {
+				while ((entry = getmntent (mounts)) != NULL) {
+					if (strcmp (entry->mnt_type, "hugetlbfs") == 0
+					    && access (entry->mnt_dir, W_OK) == 0) {
+						snprintf (mount_path, sizeof (mount_path), "%s", entry->mnt_dir);
+						break;
+					}
+				}
+				endmntent (mounts);
+			}
+		}
+		if (mount_path[0] == '\0') {
+			jack_info ("No writable hugetlbfs mount, shm segments use normal pages");
+		} else if (statfs (mount_path, &fs) < 0 || fs.f_type != HUGETLBFS_MAGIC) {
+			jack_error ("%s is not a hugetlbfs mount, shm segments use normal pages", mount_path);
+		} else {
+			page_size = fs.f_bsize;
+			jack_log ("Huge pages shm segments in %s, page size = %ld", mount_path, page_size);
+		}
+	}
+
+	snprintf (path, size, "%s", mount_path);
+	return page_size;
+}
+
+/* the registry is world writable: a path is only used if it names a
+ * segment file directly in the hugetlbfs mount this process uses, so
+ * that a forged entry cannot make it open or unlink any other file
+ */
+static int
+jack_is_valid_hugetlbfs_id (const char *id)
+{
+	char path[PATH_MAX];
+	size_t len;
+
+	if (jack_get_hugetlbfs (path, sizeof (path)) <= 0)
+		return 0;
+
+	len = strlen (path);
+	return strncmp (id, path, len) == 0
+		&& strncmp (id + len, "/jack-", 6) == 0
+		&& strchr (id + len + 1, '/') == NULL;
+}
+
+/* create a huge pages segment for the POSIX shm name, rounding its size
+ * up to the huge page size
+ *
+ * returns: the segment file descriptor, with name and size updated, or
+ *          -1 if the segment cannot be backed by huge pages
+ */
+static int
+jack_hugetlbfs_shmalloc (char *name, size_t name_size, jack_shmsize_t *size)
+{
+	char path[PATH_MAX];
+	char file[PATH_MAX];
+	long page_size;
+	jack_shmsize_t huge_size;
+	void *addr;
+	int fd;
+
+	if ((page_size = jack_get_hugetlbfs (path, sizeof (path))) <= 0)
+		return -1;
+
+	if (snprintf (file, sizeof (file), "%s%s", path, name) >= (int)name_size) {
+		jack_error ("hugetlbfs segment name too long %s", file);
+		return -1;
+	}
+
+	huge_size = (*size + page_size - 1) / page_size * page_size;
+
+	if ((fd = open (file, O_RDWR|O_CREAT, 0666)) < 0) {
+		jack_error ("Cannot create hugetlbfs segment %s (%s)",
+			    file, strerror (errno));
+		return -1;
+	}
+
+	/* huge pages are reserved at mmap time, check now that the pool has
+	 * enough of them so that attaching later cannot fail
+	 */
+	if (ftruncate (fd, huge_size) < 0
+	    || (addr = mmap (0, huge_size, PROT_READ|PROT_WRITE,
+			     MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		jack_info ("Not enough huge pages for a %ld bytes segment (%s), using normal pages",
+			   (long)huge_size, strerror (errno));
+		close (fd);
+		unlink (file);
+		return -1;
+	}
+
+	munmap (addr, huge_size);
+	strcpy (name, file);
+	*size = huge_size;
+	return fd;
+}
+
+/* fault the pages of a segment in, so that the first RT cycles using it
+ * do not, and ask for transparent huge pages on normal shm segments
+ * (used when the shmem_enabled policy is "advise")
+ */
+static void
+jack_prefault_shm (void *addr, jack_shmsize_t size, int hugetlbfs)
+{
+	volatile char *ptr = (volatile char *)addr;
+	long page_size = sysconf (_SC_PAGESIZE);
+	jack_shmsize_t i;
+
+#ifdef MADV_HUGEPAGE
+	if (!hugetlbfs)
+		madvise (addr, size, MADV_HUGEPAGE);
+#endif
+
+	/* reading allocates the page cache pages of the segment as well,
+	 * and is safe whatever the segment already contains */
+	for (i = 0; i < size; i += page_size)
+		(void)ptr[i];
+}
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+/* memfd segments have no path: clients get the descriptor itself over
+ * their socket, the registry id only names the segment
+ */
+static int
+jack_is_memfd_id (const char *id)
+{
+	return strncmp (id, "memfd:", 6) == 0;
+}
+
+/* create a memfd segment, named after the POSIX shm name for debugging
+ *
+ * returns: the segment file descriptor, with name updated, or -1 if
+ *          memfd segments are not available
+ */
+static int
+jack_memfd_shmalloc (char *name, size_t name_size, jack_shmsize_t size)
+{
+#ifdef SYS_memfd_create
+	size_t len = strlen (name);
+	int fd;
+
+	if (len + 6 >= name_size)
+		return -1;
+
+	if ((fd = syscall (SYS_memfd_create, name + 1, MFD_CLOEXEC)) < 0) {
+		jack_info ("Cannot create memfd segment (%s), using POSIX shm", strerror (errno));
+		return -1;
+	}
+
+	if (ftruncate (fd, size) < 0) {
+		jack_error ("Cannot set size of memfd segment (%s)", strerror (errno));
+		close (fd);
+		return -1;
+	}
+
+	memmove (name + 6, name, len + 1);
+	memcpy (name, "memfd:", 6);
+	return fd;
+#else
+	return -1;
+#endif
+}
+
+#endif /* __linux__ */
+
+static int
+jack_shm_open (const char *id, int oflag)
+{
+#ifdef __linux__
+	if (jack_is_hugetlbfs_id (id)) {
+		if (!jack_is_valid_hugetlbfs_id (id)) {
+			errno = EINVAL;
+			return -1;
+		}
+		return open (id, oflag, 0666);
+	}
+#endif
+	return shm_open (id, oflag, 0666);
+}
+
+/* open the segment, or take the memfd descriptor this process got for
+ * it: the ones received from the allocator are used once
+ */
+static int
+jack_shm_open_index (jack_shm_registry_index_t index, int oflag)
+{
+#ifdef __linux__
+	if (jack_is_memfd_id (jack_shm_registry[index].id)) {
+		int fd;
+
+		if (jack_shm_lock_registry () < 0) {
+			jack_error ("jack_shm_lock_registry fails...");
+			return -1;
+		}
+		fd = jack_shm_fds[index] - 1;
+		if (fd >= 0 && jack_shm_registry[index].allocator == GetPID()) {
+			fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+		} else if (fd >= 0) {
+			jack_shm_fds[index] = 0;
+		} else {
+			jack_error ("No descriptor received for memfd segment %s", jack_shm_registry[index].id);
+			errno = EBADF;
+		}
+		jack_shm_unlock_registry ();
+		return fd;
+	}
+#endif
+	return jack_shm_open (jack_shm_registry[index].id, oflag);
+}
+
 /* gain addressability to existing SHM registry segment
  *
  * sets up global registry pointers, if successful
@@ -813,6 +1168,19 @@ static void
 jack_remove_shm (const jack_shm_id_t id)
 {
 	/* registry may or may not be locked */
+#ifdef __linux__
+	if (jack_is_memfd_id (id)) {
+		/* released with its descriptor, see jack_release_shm_entry */
+		return;
+	}
+	if (jack_is_hugetlbfs_id (id)) {
+		if (jack_is_valid_hugetlbfs_id (id))
+			unlink (id);
+		else
+			jack_error ("Not removing invalid shm segment %s", id);
+		return;
+	}
+#endif
 	shm_unlink (id);
 }
 
@@ -869,24 +1237,40 @@ jack_shmalloc (const char *shm_name, jack_shmsize_t size, jack_shm_info_t* si)
 		goto unlock;
 	}
 
-	if ((shm_fd = shm_open (name, O_RDWR|O_CREAT, 0666)) < 0) {
-		jack_error ("Cannot create shm segment %s (%s)",
-			    name, strerror (errno));
-		goto unlock;
-	}
+	shm_fd = -1;
+#ifdef __linux__
+	if (jack_shm_hugepages)
+		shm_fd = jack_hugetlbfs_shmalloc (name, sizeof (registry->id), &size);
+	if (shm_fd < 0 && jack_shm_memfd)
+		shm_fd = jack_memfd_shmalloc (name, sizeof (registry->id), size);
+#endif
 
-	if (ftruncate (shm_fd, size) < 0) {
-		jack_error ("Cannot set size of engine shm "
-			    "registry 0 (%s)",
-			    strerror (errno));
-		close (shm_fd);
-		goto unlock;
+	if (shm_fd < 0) {
+		if ((shm_fd = shm_open (name, O_RDWR|O_CREAT, 0666)) < 0) {
+			jack_error ("Cannot create shm segment %s (%s)",
+				    name, strerror (errno));
+			goto unlock;
+		}
+
+		if (ftruncate (shm_fd, size) < 0) {
+			jack_error ("Cannot set size of engine shm "
+				    "registry 0 (%s)",
+				    strerror (errno));
+			close (shm_fd);
+			goto unlock;
+		}
 	}
 
 	promiscuous = getenv("JACK_PROMISCUOUS_SERVER");
 	if ((promiscuous != NULL) && (jack_promiscuous_perms(shm_fd, name, jack_group2gid(promiscuous)) < 0))
 		goto unlock;
 
+#ifdef __linux__
+	if (jack_is_memfd_id (name)) {
+		/* kept open, it is the segment itself (the registry is locked) */
+		jack_shm_fds[registry->index] = shm_fd + 1;
+	} else
+#endif
 	close (shm_fd);
 	registry->size = size;
 	strncpy (registry->id, name, sizeof (registry->id));
@@ -906,8 +1290,7 @@ jack_attach_shm (jack_shm_info_t* si)
 	int shm_fd;
 	jack_shm_registry_t *registry = &jack_shm_registry[si->index];
 
-	if ((shm_fd = shm_open (registry->id,
-				O_RDWR, 0666)) < 0) {
+	if ((shm_fd = jack_shm_open_index (si->index, O_RDWR)) < 0) {
 		jack_error ("Cannot open shm segment %s (%s)", registry->id,
 			    strerror (errno));
 		return -1;
@@ -922,6 +1305,13 @@ jack_attach_shm (jack_shm_info_t* si)
 		return -1;
 	}
 
+#ifdef __linux__
+	/* the allocator (the server) attaches the segments it creates first */
+	if (jack_shm_hugepages && registry->allocator == GetPID())
+		jack_prefault_shm (si->ptr.attached_at, registry->size,
+				   jack_is_hugetlbfs_id (registry->id) && !jack_is_memfd_id (registry->id));
+#endif
+
 	close (shm_fd);
 	return 0;
 }
@@ -932,8 +1322,7 @@ jack_attach_shm_read (jack_shm_info_t* si)
 	int shm_fd;
 	jack_shm_registry_t *registry = &jack_shm_registry[si->index];
 
-	if ((shm_fd = shm_open (registry->id,
-				O_RDONLY, 0666)) < 0) {
+	if ((shm_fd = jack_shm_open_index (si->index, O_RDONLY)) < 0) {
 		jack_error ("Cannot open shm segment %s (%s)", registry->id,
 			    strerror (errno));
 		return -1;
@@ -210,6 +210,23 @@ extern "C"
     int jack_attach_lib_shm_read (jack_shm_info_t*);
     int jack_resize_shm (jack_shm_info_t*, jack_shmsize_t size);
 
+    /* Segments allocated afterwards by this process are backed by huge
+     * pages when possible, and pre-faulted when attached by the allocator
+     * (Linux only). */
+    void jack_set_shm_hugepages (int onoff);
+
+    /* Segments allocated afterwards by this process are memfd segments,
+     * that clients attach with descriptors passed over their socket
+     * (Linux only). */
+    void jack_set_shm_memfd (int onoff);
+    /* A new descriptor of a memfd segment allocated by this process, to
+     * be sent and closed by the caller, or -1 for other segments. */
+    int jack_shm_dup_fd (jack_shm_registry_index_t index);
+    /* Keep a received descriptor until the segment is attached. */
+    void jack_shm_set_fd (jack_shm_registry_index_t index, int fd);
+    /* Close the received descriptor if it was not used by an attach. */
+    void jack_shm_release_fd (jack_shm_registry_index_t index);
+
 #ifdef __cplusplus
 }
 #endif
@@ -789,6 +789,11 @@ jack_controller_run(
 {
     long ut;
 
+    if (controller_ptr->started && controller_ptr->patchbay_context != NULL)
+    {
+        jack_controller_patchbay_flush(controller_ptr);
+    }
+
     if (controller_ptr->pending_save == 0)
     {
         return;
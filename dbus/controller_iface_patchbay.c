@@ -42,12 +42,33 @@
 #define JACK_CLIENT_NAME_SIZE 64
 #define JACK_PORT_NAME_SIZE 256
 
+#define JACK_GRAPH_HASH_SIZE 1024          /* buckets of each index, must be a power of two */
+#define JACK_GRAPH_CHANGES_MAX 4096        /* changes kept for GetGraphChanges */
+
+/* change types, as reported by GetGraphChanges and the GraphChanges signal */
+#define JACK_GRAPH_CHANGE_CLIENT_APPEARED       1
+#define JACK_GRAPH_CHANGE_CLIENT_DISAPPEARED    2
+#define JACK_GRAPH_CHANGE_PORT_APPEARED         3
+#define JACK_GRAPH_CHANGE_PORT_DISAPPEARED      4
+#define JACK_GRAPH_CHANGE_PORTS_CONNECTED       5
+#define JACK_GRAPH_CHANGE_PORTS_DISCONNECTED    6
+#define JACK_GRAPH_CHANGE_PORT_RENAMED          7
+
+/* version, type, client1 id and name, port1 id and name, client2 id and name, port2 id and name, port flags and type, connection id */
+#define JACK_GRAPH_CHANGES_SIGNATURE "a(tutstststsuut)"
+
 struct jack_graph
 {
     uint64_t version;
     struct list_head clients;
     struct list_head ports;
     struct list_head connections;
+    struct hlist_head clients_by_name[JACK_GRAPH_HASH_SIZE];
+    struct hlist_head clients_by_id[JACK_GRAPH_HASH_SIZE];
+    struct hlist_head ports_by_name[JACK_GRAPH_HASH_SIZE]; /* hashed on the full name */
+    struct hlist_head ports_by_id[JACK_GRAPH_HASH_SIZE];
+    struct hlist_head connections_by_ports[JACK_GRAPH_HASH_SIZE];
+    struct hlist_head connections_by_id[JACK_GRAPH_HASH_SIZE];
 };
 
 struct jack_graph_client
@@ -57,6 +78,8 @@ struct jack_graph_client
     int pid;
     struct list_head siblings;
     struct list_head ports;
+    struct hlist_node siblings_name_hash;
+    struct hlist_node siblings_id_hash;
 };
 
 struct jack_graph_port
@@ -67,6 +90,8 @@ struct jack_graph_port
     uint32_t type;
     struct list_head siblings_graph;
     struct list_head siblings_client;
+    struct hlist_node siblings_name_hash;
+    struct hlist_node siblings_id_hash;
     struct jack_graph_client * client;
 };
 
@@ -76,6 +101,27 @@ struct jack_graph_connection
     struct jack_graph_port * port1;
     struct jack_graph_port * port2;
     struct list_head siblings;
+    struct hlist_node siblings_ports_hash;
+    struct hlist_node siblings_id_hash;
+};
+
+/* A graph change, names are stored after the structure */
+struct jack_graph_change
+{
+    uint64_t version;
+    uint32_t type;
+    uint64_t client1_id;
+    const char * client1_name;
+    uint64_t port1_id;
+    const char * port1_name;
+    uint64_t client2_id;
+    const char * client2_name;
+    uint64_t port2_id;
+    const char * port2_name;
+    uint32_t port_flags;
+    uint32_t port_type;
+    uint64_t connection_id;
+    struct list_head siblings;
 };
 
 struct jack_controller_patchbay
@@ -85,6 +131,11 @@ struct jack_controller_patchbay
     uint64_t next_client_id;
     uint64_t next_port_id;
     uint64_t next_connection_id;
+    struct list_head changes;           /* oldest first */
+    unsigned int changes_count;
+    uint64_t changes_base_version;      /* all changes after this version are in the list */
+    uint64_t signaled_version;          /* last version announced with GraphChanged */
+    bool flush_pending;                 /* the main loop has been woken up to signal the recorded changes */
 };
 
 void
@@ -310,6 +361,323 @@ jack_controller_patchbay_send_signal_port_renamed(
         DBUS_TYPE_INVALID);
 }
 
+/* FNV-1a */
+static
+uint32_t
+jack_controller_patchbay_hash_string(
+    uint32_t hash,
+    const char *str,            /* not '\0' terminated */
+    size_t len)                 /* without terminating '\0' */
+{
+    while (len-- > 0)
+    {
+        hash ^= (unsigned char)*str++;
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+#define JACK_GRAPH_HASH_INIT 2166136261u
+
+static
+uint32_t
+jack_controller_patchbay_hash_client_name(
+    const char *client_name,    /* not '\0' terminated */
+    size_t client_name_len)     /* without terminating '\0' */
+{
+    return jack_controller_patchbay_hash_string(JACK_GRAPH_HASH_INIT, client_name, client_name_len) & (JACK_GRAPH_HASH_SIZE - 1);
+}
+
+static
+uint32_t
+jack_controller_patchbay_hash_port_name(
+    const char *client_name,    /* not '\0' terminated */
+    size_t client_name_len,     /* without terminating '\0' */
+    const char *port_name)      /* '\0' terminated */
+{
+    uint32_t hash;
+
+    hash = jack_controller_patchbay_hash_string(JACK_GRAPH_HASH_INIT, client_name, client_name_len);
+    hash = jack_controller_patchbay_hash_string(hash, ":", 1);
+    hash = jack_controller_patchbay_hash_string(hash, port_name, strlen(port_name));
+    return hash & (JACK_GRAPH_HASH_SIZE - 1);
+}
+
+static
+uint32_t
+jack_controller_patchbay_hash_id(
+    uint64_t id)
+{
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & (JACK_GRAPH_HASH_SIZE - 1);
+}
+
+/* Connections are not oriented, both port orders give the same hash */
+static
+uint32_t
+jack_controller_patchbay_hash_connection(
+    struct jack_graph_port *port1_ptr,
+    struct jack_graph_port *port2_ptr)
+{
+    return jack_controller_patchbay_hash_id(port1_ptr->id ^ port2_ptr->id ^ ((port1_ptr->id & port2_ptr->id) << 32));
+}
+
+static
+void
+jack_controller_patchbay_hash_port(
+    struct jack_controller_patchbay *patchbay_ptr,
+    struct jack_graph_port *port_ptr)
+{
+    uint32_t bucket;
+
+    bucket = jack_controller_patchbay_hash_port_name(port_ptr->client->name, strlen(port_ptr->client->name), port_ptr->name);
+    hlist_add_head(&port_ptr->siblings_name_hash, &patchbay_ptr->graph.ports_by_name[bucket]);
+}
+
+/* Called with the lock held, after the graph version has been incremented */
+static
+void
+jack_controller_patchbay_record_change(
+    struct jack_controller_patchbay *patchbay_ptr,
+    uint32_t type,
+    uint64_t client1_id,
+    const char *client1_name,
+    uint64_t port1_id,
+    const char *port1_name,
+    uint64_t client2_id,
+    const char *client2_name,
+    uint64_t port2_id,
+    const char *port2_name,
+    uint32_t port_flags,
+    uint32_t port_type,
+    uint64_t connection_id)
+{
+    struct jack_graph_change *change_ptr;
+    size_t client1_name_size;
+    size_t port1_name_size;
+    size_t client2_name_size;
+    size_t port2_name_size;
+    char *names;
+
+    /* the first change of a batch wakes the main loop up, the changes recorded
+       until it runs are signaled with it */
+    if (!patchbay_ptr->flush_pending)
+    {
+        patchbay_ptr->flush_pending = true;
+        jack_dbus_wakeup_main_loop();
+    }
+
+    client1_name_size = strlen(client1_name) + 1;
+    port1_name_size = strlen(port1_name) + 1;
+    client2_name_size = strlen(client2_name) + 1;
+    port2_name_size = strlen(port2_name) + 1;
+
+    change_ptr = malloc(sizeof(struct jack_graph_change) + client1_name_size + port1_name_size + client2_name_size + port2_name_size);
+    if (change_ptr == NULL)
+    {
+        jack_error("Memory allocation of jack_graph_change structure failed.");
+        /* older versions cannot be brought up to date with the changes anymore */
+        patchbay_ptr->changes_base_version = patchbay_ptr->graph.version;
+        return;
+    }
+
+    names = (char *)(change_ptr + 1);
+    change_ptr->client1_name = memcpy(names, client1_name, client1_name_size);
+    names += client1_name_size;
+    change_ptr->port1_name = memcpy(names, port1_name, port1_name_size);
+    names += port1_name_size;
+    change_ptr->client2_name = memcpy(names, client2_name, client2_name_size);
+    names += client2_name_size;
+    change_ptr->port2_name = memcpy(names, port2_name, port2_name_size);
+
+    change_ptr->version = patchbay_ptr->graph.version;
+    change_ptr->type = type;
+    change_ptr->client1_id = client1_id;
+    change_ptr->port1_id = port1_id;
+    change_ptr->client2_id = client2_id;
+    change_ptr->port2_id = port2_id;
+    change_ptr->port_flags = port_flags;
+    change_ptr->port_type = port_type;
+    change_ptr->connection_id = connection_id;
+
+    list_add_tail(&change_ptr->siblings, &patchbay_ptr->changes);
+    patchbay_ptr->changes_count++;
+
+    if (patchbay_ptr->changes_count > JACK_GRAPH_CHANGES_MAX)
+    {
+        change_ptr = list_entry(patchbay_ptr->changes.next, struct jack_graph_change, siblings);
+        list_del(&change_ptr->siblings);
+        patchbay_ptr->changes_count--;
+        patchbay_ptr->changes_base_version = change_ptr->version;
+        free(change_ptr);
+    }
+}
+
+static
+bool
+jack_controller_patchbay_append_change(
+    DBusMessageIter *array_iter_ptr,
+    struct jack_graph_change *change_ptr)
+{
+    DBusMessageIter struct_iter;
+
+    if (!dbus_message_iter_open_container(array_iter_ptr, DBUS_TYPE_STRUCT, NULL, &struct_iter))
+    {
+        return false;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->version))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT32, &change_ptr->type))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->client1_id))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_STRING, &change_ptr->client1_name))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->port1_id))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_STRING, &change_ptr->port1_name))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->client2_id))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_STRING, &change_ptr->client2_name))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->port2_id))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_STRING, &change_ptr->port2_name))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT32, &change_ptr->port_flags))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT32, &change_ptr->port_type))
+    {
+        goto fail_close_struct;
+    }
+
+    if (!dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &change_ptr->connection_id))
+    {
+        goto fail_close_struct;
+    }
+
+    return dbus_message_iter_close_container(array_iter_ptr, &struct_iter);
+
+fail_close_struct:
+    dbus_message_iter_close_container(array_iter_ptr, &struct_iter);
+    return false;
+}
+
+/* Append the array of changes made after since_version, called with the lock held */
+static
+bool
+jack_controller_patchbay_append_changes(
+    struct jack_controller_patchbay *patchbay_ptr,
+    DBusMessageIter *iter_ptr,
+    uint64_t since_version)
+{
+    struct list_head *node_ptr;
+    DBusMessageIter array_iter;
+
+    if (!dbus_message_iter_open_container(iter_ptr, DBUS_TYPE_ARRAY, JACK_GRAPH_CHANGES_SIGNATURE + 1, &array_iter))
+    {
+        return false;
+    }
+
+    /* recent changes are at the end of the list */
+    node_ptr = &patchbay_ptr->changes;
+    while (node_ptr->prev != &patchbay_ptr->changes &&
+           list_entry(node_ptr->prev, struct jack_graph_change, siblings)->version > since_version)
+    {
+        node_ptr = node_ptr->prev;
+    }
+
+    for (; node_ptr != &patchbay_ptr->changes; node_ptr = node_ptr->next)
+    {
+        if (!jack_controller_patchbay_append_change(&array_iter, list_entry(node_ptr, struct jack_graph_change, siblings)))
+        {
+            dbus_message_iter_close_container(iter_ptr, &array_iter);
+            return false;
+        }
+    }
+
+    return dbus_message_iter_close_container(iter_ptr, &array_iter);
+}
+
+/* Signal the changes made after since_version, when some of them are not kept
+   anymore the signal only tells that the listeners have to use GetGraph */
+static
+void
+jack_controller_patchbay_send_signal_graph_changes(
+    struct jack_controller_patchbay *patchbay_ptr,
+    uint64_t since_version)
+{
+    DBusMessage *message_ptr;
+    DBusMessageIter iter;
+    dbus_bool_t complete;
+
+    message_ptr = dbus_message_new_signal(JACK_CONTROLLER_OBJECT_PATH, JACK_DBUS_IFACE_NAME, "GraphChanges");
+    if (message_ptr == NULL)
+    {
+        jack_error("dbus_message_new_signal() failed.");
+        return;
+    }
+
+    dbus_message_iter_init_append(message_ptr, &iter);
+
+    complete = since_version >= patchbay_ptr->changes_base_version;
+    if (!complete)
+    {
+        since_version = patchbay_ptr->graph.version;
+    }
+
+    if (!dbus_message_iter_append_basic(&iter, DBUS_TYPE_UINT64, &patchbay_ptr->graph.version) ||
+        !dbus_message_iter_append_basic(&iter, DBUS_TYPE_BOOLEAN, &complete) ||
+        !jack_controller_patchbay_append_changes(patchbay_ptr, &iter, since_version))
+    {
+        jack_error("Ran out of memory trying to construct GraphChanges signal");
+        goto unref;
+    }
+
+    if (!dbus_connection_send(g_connection, message_ptr, NULL))
+    {
+        jack_error("dbus_connection_send() failed.");
+    }
+
+unref:
+    dbus_message_unref(message_ptr);
+}
+
 static
 struct jack_graph_client *
 jack_controller_patchbay_find_client(
@@ -317,12 +685,14 @@ jack_controller_patchbay_find_client(
     const char *client_name,    /* not '\0' terminated */
     size_t client_name_len)     /* without terminating '\0' */
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_client *client_ptr;
+    uint32_t bucket;
 
-    list_for_each(node_ptr, &patchbay_ptr->graph.clients)
+    bucket = jack_controller_patchbay_hash_client_name(client_name, client_name_len);
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.clients_by_name[bucket])
     {
-        client_ptr = list_entry(node_ptr, struct jack_graph_client, siblings);
+        client_ptr = hlist_entry(node_ptr, struct jack_graph_client, siblings_name_hash);
         if (strlen(client_ptr->name) == client_name_len && strncmp(client_ptr->name, client_name, client_name_len) == 0)
         {
             return client_ptr;
@@ -338,12 +708,12 @@ jack_controller_patchbay_find_client_by_id(
     struct jack_controller_patchbay *patchbay_ptr,
     uint64_t id)
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_client *client_ptr;
 
-    list_for_each(node_ptr, &patchbay_ptr->graph.clients)
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.clients_by_id[jack_controller_patchbay_hash_id(id)])
     {
-        client_ptr = list_entry(node_ptr, struct jack_graph_client, siblings);
+        client_ptr = hlist_entry(node_ptr, struct jack_graph_client, siblings_id_hash);
         if (client_ptr->id == id)
         {
             return client_ptr;
@@ -388,9 +758,16 @@ jack_controller_patchbay_create_client(
 
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_add_tail(&client_ptr->siblings, &patchbay_ptr->graph.clients);
+    hlist_add_head(&client_ptr->siblings_name_hash, &patchbay_ptr->graph.clients_by_name[jack_controller_patchbay_hash_client_name(client_name, client_name_len)]);
+    hlist_add_head(&client_ptr->siblings_id_hash, &patchbay_ptr->graph.clients_by_id[jack_controller_patchbay_hash_id(client_ptr->id)]);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_client_appeared(patchbay_ptr->graph.version, client_ptr->id, client_ptr->name);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_CLIENT_APPEARED,
+        client_ptr->id, client_ptr->name, 0, "",
+        0, "", 0, "",
+        0, 0, 0);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 
     return client_ptr;
@@ -412,9 +789,16 @@ jack_controller_patchbay_destroy_client(
 
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_del(&client_ptr->siblings);
+    hlist_del(&client_ptr->siblings_name_hash);
+    hlist_del(&client_ptr->siblings_id_hash);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_client_disappeared(patchbay_ptr->graph.version, client_ptr->id, client_ptr->name);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_CLIENT_DISAPPEARED,
+        client_ptr->id, client_ptr->name, 0, "",
+        0, "", 0, "",
+        0, 0, 0);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 
     free(client_ptr->name);
@@ -499,6 +883,8 @@ jack_controller_patchbay_new_port(
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_add_tail(&port_ptr->siblings_client, &client_ptr->ports);
     list_add_tail(&port_ptr->siblings_graph, &patchbay_ptr->graph.ports);
+    jack_controller_patchbay_hash_port(patchbay_ptr, port_ptr);
+    hlist_add_head(&port_ptr->siblings_id_hash, &patchbay_ptr->graph.ports_by_id[jack_controller_patchbay_hash_id(port_ptr->id)]);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_port_appeared(
         patchbay_ptr->graph.version,
@@ -508,7 +894,12 @@ jack_controller_patchbay_new_port(
         port_ptr->name,
         port_ptr->flags,
         port_ptr->type);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_PORT_APPEARED,
+        client_ptr->id, client_ptr->name, port_ptr->id, port_ptr->name,
+        0, "", 0, "",
+        port_ptr->flags, port_ptr->type, 0);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 }
 
@@ -523,9 +914,16 @@ jack_controller_patchbay_remove_port(
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_del(&port_ptr->siblings_client);
     list_del(&port_ptr->siblings_graph);
+    hlist_del(&port_ptr->siblings_name_hash);
+    hlist_del(&port_ptr->siblings_id_hash);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_port_disappeared(patchbay_ptr->graph.version, port_ptr->client->id, port_ptr->client->name, port_ptr->id, port_ptr->name);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_PORT_DISAPPEARED,
+        port_ptr->client->id, port_ptr->client->name, port_ptr->id, port_ptr->name,
+        0, "", 0, "",
+        port_ptr->flags, port_ptr->type, 0);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 
     free(port_ptr->name);
@@ -538,12 +936,12 @@ jack_controller_patchbay_find_port_by_id(
     struct jack_controller_patchbay *patchbay_ptr,
     uint64_t port_id)
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_port *port_ptr;
 
-    list_for_each(node_ptr, &patchbay_ptr->graph.ports)
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.ports_by_id[jack_controller_patchbay_hash_id(port_id)])
     {
-        port_ptr = list_entry(node_ptr, struct jack_graph_port, siblings_graph);
+        port_ptr = hlist_entry(node_ptr, struct jack_graph_port, siblings_id_hash);
         if (port_ptr->id == port_id)
         {
             return port_ptr;
@@ -560,13 +958,15 @@ jack_controller_patchbay_find_client_port_by_name(
     struct jack_graph_client *client_ptr,
     const char *port_name)
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_port *port_ptr;
+    uint32_t bucket;
 
-    list_for_each(node_ptr, &client_ptr->ports)
+    bucket = jack_controller_patchbay_hash_port_name(client_ptr->name, strlen(client_ptr->name), port_name);
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.ports_by_name[bucket])
     {
-        port_ptr = list_entry(node_ptr, struct jack_graph_port, siblings_client);
-        if (strcmp(port_ptr->name, port_name) == 0)
+        port_ptr = hlist_entry(node_ptr, struct jack_graph_port, siblings_name_hash);
+        if (port_ptr->client == client_ptr && strcmp(port_ptr->name, port_name) == 0)
         {
             return port_ptr;
         }
@@ -649,6 +1049,8 @@ jack_controller_patchbay_create_connection(
 
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_add_tail(&connection_ptr->siblings, &patchbay_ptr->graph.connections);
+    hlist_add_head(&connection_ptr->siblings_ports_hash, &patchbay_ptr->graph.connections_by_ports[jack_controller_patchbay_hash_connection(port1_ptr, port2_ptr)]);
+    hlist_add_head(&connection_ptr->siblings_id_hash, &patchbay_ptr->graph.connections_by_id[jack_controller_patchbay_hash_id(connection_ptr->id)]);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_ports_connected(
         patchbay_ptr->graph.version,
@@ -661,7 +1063,12 @@ jack_controller_patchbay_create_connection(
         port2_ptr->id,
         port2_ptr->name,
         connection_ptr->id);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_PORTS_CONNECTED,
+        port1_ptr->client->id, port1_ptr->client->name, port1_ptr->id, port1_ptr->name,
+        port2_ptr->client->id, port2_ptr->client->name, port2_ptr->id, port2_ptr->name,
+        0, 0, connection_ptr->id);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 
     return connection_ptr;
@@ -675,6 +1082,8 @@ jack_controller_patchbay_destroy_connection(
 {
     pthread_mutex_lock(&patchbay_ptr->lock);
     list_del(&connection_ptr->siblings);
+    hlist_del(&connection_ptr->siblings_ports_hash);
+    hlist_del(&connection_ptr->siblings_id_hash);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_ports_disconnected(
         patchbay_ptr->graph.version,
@@ -687,7 +1096,12 @@ jack_controller_patchbay_destroy_connection(
         connection_ptr->port2->id,
         connection_ptr->port2->name,
         connection_ptr->id);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_PORTS_DISCONNECTED,
+        connection_ptr->port1->client->id, connection_ptr->port1->client->name, connection_ptr->port1->id, connection_ptr->port1->name,
+        connection_ptr->port2->client->id, connection_ptr->port2->client->name, connection_ptr->port2->id, connection_ptr->port2->name,
+        0, 0, connection_ptr->id);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 
     free(connection_ptr);
@@ -700,12 +1114,12 @@ jack_controller_patchbay_find_connection(
     struct jack_graph_port *port1_ptr,
     struct jack_graph_port *port2_ptr)
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_connection *connection_ptr;
 
-    list_for_each(node_ptr, &patchbay_ptr->graph.connections)
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.connections_by_ports[jack_controller_patchbay_hash_connection(port1_ptr, port2_ptr)])
     {
-        connection_ptr = list_entry(node_ptr, struct jack_graph_connection, siblings);
+        connection_ptr = hlist_entry(node_ptr, struct jack_graph_connection, siblings_ports_hash);
         if ((connection_ptr->port1 == port1_ptr &&
              connection_ptr->port2 == port2_ptr) ||
             (connection_ptr->port1 == port2_ptr &&
@@ -724,12 +1138,12 @@ jack_controller_patchbay_find_connection_by_id(
     struct jack_controller_patchbay *patchbay_ptr,
     uint64_t connection_id)
 {
-    struct list_head *node_ptr;
+    struct hlist_node *node_ptr;
     struct jack_graph_connection *connection_ptr;
 
-    list_for_each(node_ptr, &patchbay_ptr->graph.connections)
+    hlist_for_each(node_ptr, &patchbay_ptr->graph.connections_by_id[jack_controller_patchbay_hash_id(connection_id)])
     {
-        connection_ptr = list_entry(node_ptr, struct jack_graph_connection, siblings);
+        connection_ptr = hlist_entry(node_ptr, struct jack_graph_connection, siblings_id_hash);
         if (connection_ptr->id == connection_id)
         {
             return connection_ptr;
@@ -1123,6 +1537,78 @@ exit:
     return;
 }
 
+static
+void
+jack_controller_dbus_get_graph_changes(
+    struct jack_dbus_method_call * call)
+{
+    DBusMessageIter iter;
+    dbus_uint64_t version;
+    dbus_bool_t complete;
+
+    if (!controller_ptr->started)
+    {
+        jack_dbus_error(
+            call,
+            JACK_DBUS_ERROR_SERVER_NOT_RUNNING,
+            "Can't execute this method with stopped JACK server");
+        return;
+    }
+
+    if (!jack_dbus_get_method_args(call, DBUS_TYPE_UINT64, &version, DBUS_TYPE_INVALID))
+    {
+        /* The method call had invalid arguments meaning that
+         * jack_dbus_get_method_args() has constructed an error for us.
+         */
+        return;
+    }
+
+    pthread_mutex_lock(&patchbay_ptr->lock);
+
+    if (version > patchbay_ptr->graph.version)
+    {
+        jack_dbus_error(
+            call,
+            JACK_DBUS_ERROR_INVALID_ARGS,
+            "known graph version %" PRIu64 " is newer than actual version %" PRIu64,
+            version,
+            patchbay_ptr->graph.version);
+        pthread_mutex_unlock(&patchbay_ptr->lock);
+        return;
+    }
+
+    call->reply = dbus_message_new_method_return(call->message);
+    if (!call->reply)
+    {
+        pthread_mutex_unlock(&patchbay_ptr->lock);
+        jack_error("Ran out of memory trying to construct method return");
+        return;
+    }
+
+    dbus_message_iter_init_append(call->reply, &iter);
+
+    /* when the changes since the known version are not all kept anymore,
+       the caller has to use GetGraph */
+    complete = version >= patchbay_ptr->changes_base_version;
+    if (!complete)
+    {
+        version = patchbay_ptr->graph.version;
+    }
+
+    if (!dbus_message_iter_append_basic(&iter, DBUS_TYPE_UINT64, &patchbay_ptr->graph.version) ||
+        !dbus_message_iter_append_basic(&iter, DBUS_TYPE_BOOLEAN, &complete) ||
+        !jack_controller_patchbay_append_changes(patchbay_ptr, &iter, version))
+    {
+        pthread_mutex_unlock(&patchbay_ptr->lock);
+        dbus_message_unref(call->reply);
+        call->reply = NULL;
+        jack_error("Ran out of memory trying to construct method return");
+        return;
+    }
+
+    pthread_mutex_unlock(&patchbay_ptr->lock);
+}
+
 static
 void
 jack_controller_dbus_connect_ports_by_name(
@@ -1688,10 +2174,11 @@ void jack_controller_port_rename_callback(jack_port_id_t port, const char * old_
         return;
     }
 
+    pthread_mutex_lock(&patchbay_ptr->lock);
+    hlist_del(&port_ptr->siblings_name_hash);
     free(port_ptr->name);
     port_ptr->name = name_buffer;
-
-    pthread_mutex_lock(&patchbay_ptr->lock);
+    jack_controller_patchbay_hash_port(patchbay_ptr, port_ptr);
     patchbay_ptr->graph.version++;
     jack_controller_patchbay_send_signal_port_renamed(
         patchbay_ptr->graph.version,
@@ -1700,18 +2187,43 @@ void jack_controller_port_rename_callback(jack_port_id_t port, const char * old_
         port_ptr->id,
         port_old_short_name,
         port_ptr->name);
-    jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+    jack_controller_patchbay_record_change(
+        patchbay_ptr,
+        JACK_GRAPH_CHANGE_PORT_RENAMED,
+        port_ptr->client->id, port_ptr->client->name, port_ptr->id, port_old_short_name,
+        port_ptr->client->id, port_ptr->client->name, port_ptr->id, port_ptr->name,
+        port_ptr->flags, port_ptr->type, 0);
     pthread_mutex_unlock(&patchbay_ptr->lock);
 }
 
 #undef controller_ptr
 
+/* Send the graph changes made since the last call, called from the main loop */
+void
+jack_controller_patchbay_flush(
+    struct jack_controller * controller_ptr)
+{
+    pthread_mutex_lock(&patchbay_ptr->lock);
+
+    patchbay_ptr->flush_pending = false;
+
+    if (patchbay_ptr->signaled_version != patchbay_ptr->graph.version)
+    {
+        jack_controller_patchbay_send_signal_graph_changes(patchbay_ptr, patchbay_ptr->signaled_version);
+        jack_controller_patchbay_send_signal_graph_changed(patchbay_ptr->graph.version);
+        patchbay_ptr->signaled_version = patchbay_ptr->graph.version;
+    }
+
+    pthread_mutex_unlock(&patchbay_ptr->lock);
+}
+
 void
 jack_controller_patchbay_uninit(
     struct jack_controller * controller_ptr)
 {
     struct jack_graph_client *client_ptr;
     struct jack_graph_port *port_ptr;
+    struct jack_graph_change *change_ptr;
 
 /*     jack_info("jack_controller_patchbay_uninit() called"); */
 
@@ -1727,6 +2239,16 @@ jack_controller_patchbay_uninit(
         jack_controller_patchbay_destroy_client(patchbay_ptr, client_ptr);
     }
 
+    jack_controller_patchbay_flush(controller_ptr);
+
+    while (!list_empty(&patchbay_ptr->changes))
+    {
+        change_ptr = list_entry(patchbay_ptr->changes.next, struct jack_graph_change, siblings);
+        list_del(&change_ptr->siblings);
+        free(change_ptr);
+    }
+    patchbay_ptr->changes_count = 0;
+
     pthread_mutex_destroy(&patchbay_ptr->lock);
 }
 
@@ -1739,6 +2261,7 @@ jack_controller_patchbay_init(
     int ret;
     struct jack_controller_patchbay * patchbay_ptr;
     pthread_mutexattr_t attr;
+    int i;
 
 /*     jack_info("jack_controller_patchbay_init() called"); */
 
@@ -1765,10 +2288,24 @@ jack_controller_patchbay_init(
     INIT_LIST_HEAD(&patchbay_ptr->graph.clients);
     INIT_LIST_HEAD(&patchbay_ptr->graph.ports);
     INIT_LIST_HEAD(&patchbay_ptr->graph.connections);
+    for (i = 0; i < JACK_GRAPH_HASH_SIZE; i++)
+    {
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.clients_by_name[i]);
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.clients_by_id[i]);
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.ports_by_name[i]);
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.ports_by_id[i]);
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.connections_by_ports[i]);
+        INIT_HLIST_HEAD(&patchbay_ptr->graph.connections_by_id[i]);
+    }
     patchbay_ptr->graph.version = 1;
     patchbay_ptr->next_client_id = 1;
     patchbay_ptr->next_port_id = 1;
     patchbay_ptr->next_connection_id = 1;
+    INIT_LIST_HEAD(&patchbay_ptr->changes);
+    patchbay_ptr->changes_count = 0;
+    patchbay_ptr->changes_base_version = 1;
+    patchbay_ptr->signaled_version = 1;
+    patchbay_ptr->flush_pending = false;
 
     controller_ptr->patchbay_context = patchbay_ptr;
 
@@ -1827,6 +2364,13 @@ JACK_DBUS_METHOD_ARGUMENTS_BEGIN(GetGraph)
     JACK_DBUS_METHOD_ARGUMENT("connections", "a(tstststst)", true)
 JACK_DBUS_METHOD_ARGUMENTS_END
 
+JACK_DBUS_METHOD_ARGUMENTS_BEGIN(GetGraphChanges)
+    JACK_DBUS_METHOD_ARGUMENT("known_graph_version", DBUS_TYPE_UINT64_AS_STRING, false)
+    JACK_DBUS_METHOD_ARGUMENT("current_graph_version", DBUS_TYPE_UINT64_AS_STRING, true)
+    JACK_DBUS_METHOD_ARGUMENT("complete", DBUS_TYPE_BOOLEAN_AS_STRING, true)
+    JACK_DBUS_METHOD_ARGUMENT("changes", JACK_GRAPH_CHANGES_SIGNATURE, true)
+JACK_DBUS_METHOD_ARGUMENTS_END
+
 JACK_DBUS_METHOD_ARGUMENTS_BEGIN(ConnectPortsByName)
     JACK_DBUS_METHOD_ARGUMENT("client1_name", DBUS_TYPE_STRING_AS_STRING, false)
     JACK_DBUS_METHOD_ARGUMENT("port1_name", DBUS_TYPE_STRING_AS_STRING, false)
@@ -1863,6 +2407,7 @@ JACK_DBUS_METHOD_ARGUMENTS_END
 JACK_DBUS_METHODS_BEGIN
     JACK_DBUS_METHOD_DESCRIBE(GetAllPorts, jack_controller_dbus_get_all_ports)
     JACK_DBUS_METHOD_DESCRIBE(GetGraph, jack_controller_dbus_get_graph)
+    JACK_DBUS_METHOD_DESCRIBE(GetGraphChanges, jack_controller_dbus_get_graph_changes)
     JACK_DBUS_METHOD_DESCRIBE(ConnectPortsByName, jack_controller_dbus_connect_ports_by_name)
     JACK_DBUS_METHOD_DESCRIBE(ConnectPortsByID, jack_controller_dbus_connect_ports_by_id)
     JACK_DBUS_METHOD_DESCRIBE(DisconnectPortsByName, jack_controller_dbus_disconnect_ports_by_name)
@@ -1875,6 +2420,12 @@ JACK_DBUS_SIGNAL_ARGUMENTS_BEGIN(GraphChanged)
     JACK_DBUS_SIGNAL_ARGUMENT("new_graph_version", DBUS_TYPE_UINT64_AS_STRING)
 JACK_DBUS_SIGNAL_ARGUMENTS_END
 
+JACK_DBUS_SIGNAL_ARGUMENTS_BEGIN(GraphChanges)
+    JACK_DBUS_SIGNAL_ARGUMENT("new_graph_version", DBUS_TYPE_UINT64_AS_STRING)
+    JACK_DBUS_SIGNAL_ARGUMENT("complete", DBUS_TYPE_BOOLEAN_AS_STRING)
+    JACK_DBUS_SIGNAL_ARGUMENT("changes", JACK_GRAPH_CHANGES_SIGNATURE)
+JACK_DBUS_SIGNAL_ARGUMENTS_END
+
 JACK_DBUS_SIGNAL_ARGUMENTS_BEGIN(ClientAppeared)
     JACK_DBUS_SIGNAL_ARGUMENT("new_graph_version", DBUS_TYPE_UINT64_AS_STRING)
     JACK_DBUS_SIGNAL_ARGUMENT("client_id", DBUS_TYPE_UINT64_AS_STRING)
@@ -1942,6 +2493,7 @@ JACK_DBUS_SIGNAL_ARGUMENTS_END
 
 JACK_DBUS_SIGNALS_BEGIN
     JACK_DBUS_SIGNAL_DESCRIBE(GraphChanged)
+    JACK_DBUS_SIGNAL_DESCRIBE(GraphChanges)
     JACK_DBUS_SIGNAL_DESCRIBE(ClientAppeared)
     JACK_DBUS_SIGNAL_DESCRIBE(ClientDisappeared)
     JACK_DBUS_SIGNAL_DESCRIBE(PortAppeared)
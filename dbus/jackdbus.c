@@ -30,6 +30,8 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <dbus/dbus.h>
 #include <pthread.h>
 #include <unistd.h>
@@ -53,6 +55,7 @@ char *g_jackdbus_log_dir;
 size_t g_jackdbus_log_dir_len; /* without terminating '\0' char */
 int g_exit_command;
 DBusConnection *g_connection;
+static int g_wakeup_fds[2] = {-1, -1};
 
 void
 jack_dbus_send_signal(
@@ -94,6 +97,56 @@ exit:
     va_end(ap);
 }
 
+/*
+ * Make the main loop call jack_controller_run() without waiting for D-Bus
+ * traffic or for its timeout. Can be called from any thread.
+ */
+void
+jack_dbus_wakeup_main_loop()
+{
+    char byte = 0;
+
+    /* the pipe is non-blocking, when it is full the main loop is woken up anyway */
+    if (g_wakeup_fds[1] != -1 && write(g_wakeup_fds[1], &byte, 1) == -1 && errno != EAGAIN)
+    {
+        jack_error("Cannot wake up the main loop: %s", strerror(errno));
+    }
+}
+
+static
+bool
+jack_dbus_wakeup_init()
+{
+    if (pipe(g_wakeup_fds) != 0)
+    {
+        jack_error("Cannot create the main loop wakeup pipe: %s", strerror(errno));
+        return false;
+    }
+
+    if (fcntl(g_wakeup_fds[0], F_SETFL, O_NONBLOCK) != 0 ||
+        fcntl(g_wakeup_fds[1], F_SETFL, O_NONBLOCK) != 0 ||
+        fcntl(g_wakeup_fds[0], F_SETFD, FD_CLOEXEC) != 0 ||
+        fcntl(g_wakeup_fds[1], F_SETFD, FD_CLOEXEC) != 0)
+    {
+        jack_error("Cannot set up the main loop wakeup pipe: %s", strerror(errno));
+        close(g_wakeup_fds[0]);
+        close(g_wakeup_fds[1]);
+        g_wakeup_fds[0] = g_wakeup_fds[1] = -1;
+        return false;
+    }
+
+    return true;
+}
+
+static
+void
+jack_dbus_wakeup_uninit()
+{
+    close(g_wakeup_fds[0]);
+    close(g_wakeup_fds[1]);
+    g_wakeup_fds[0] = g_wakeup_fds[1] = -1;
+}
+
 /*
  * Send a method return.
  *
@@ -855,6 +908,9 @@ main (int argc, char **argv)
     void *controller_ptr;
     struct stat st;
     char timestamp_str[26];
+    int connection_fd;
+    struct pollfd poll_fds[2];
+    char wakeup_buffer[64];
 
     st.st_mtime = 0;
     stat(argv[0], &st);
@@ -937,19 +993,63 @@ main (int argc, char **argv)
         goto fail_unref_connection;
     }
 
+    if (!dbus_connection_get_unix_fd(g_connection, &connection_fd))
+    {
+        jack_error("Cannot get the D-Bus connection file descriptor");
+        ret = 1;
+        goto fail_unref_connection;
+    }
+
+    if (!jack_dbus_wakeup_init())
+    {
+        ret = 1;
+        goto fail_unref_connection;
+    }
+
     controller_ptr = jack_controller_create(g_connection);
 
     if (controller_ptr == NULL)
     {
         ret = 1;
-        goto fail_unref_connection;
+        goto fail_uninit_wakeup;
     }
 
     jack_info("Listening for D-Bus messages");
 
+    /* Besides D-Bus traffic, the loop is woken up through the wakeup pipe,
+       so that graph changes recorded by JACK threads are signaled right away */
     g_exit_command = FALSE;
-    while (!g_exit_command && dbus_connection_read_write_dispatch (g_connection, 200))
+    while (!g_exit_command)
     {
+        poll_fds[0].fd = connection_fd;
+        poll_fds[0].events = POLLIN;
+        if (dbus_connection_has_messages_to_send(g_connection))
+        {
+            poll_fds[0].events |= POLLOUT;
+        }
+        poll_fds[0].revents = 0;
+        poll_fds[1].fd = g_wakeup_fds[0];
+        poll_fds[1].events = POLLIN;
+        poll_fds[1].revents = 0;
+
+        if (poll(poll_fds, 2, dbus_connection_get_dispatch_status(g_connection) == DBUS_DISPATCH_DATA_REMAINS ? 0 : 200) == -1 &&
+            errno != EINTR)
+        {
+            jack_error("poll() failed: %s", strerror(errno));
+            break;
+        }
+
+        if (poll_fds[1].revents & POLLIN)
+        {
+            while (read(g_wakeup_fds[0], wakeup_buffer, sizeof(wakeup_buffer)) > 0);
+        }
+
+        /* does not block, the waiting has been done above */
+        if (!dbus_connection_read_write_dispatch(g_connection, 0))
+        {
+            break;
+        }
+
         jack_controller_run(controller_ptr);
     }
 
@@ -959,6 +1059,9 @@ main (int argc, char **argv)
 
     ret = 0;
 
+fail_uninit_wakeup:
+    jack_dbus_wakeup_uninit();
+
 fail_unref_connection:
     dbus_connection_unref(g_connection);
 
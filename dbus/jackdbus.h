@@ -317,6 +317,9 @@ jack_dbus_send_signal(
     int first_arg_type,
     ...);
 
+void
+jack_dbus_wakeup_main_loop();
+
 #define JACK_CONTROLLER_OBJECT_PATH "/org/jackaudio/Controller"
 
 extern struct jack_dbus_interface_descriptor * g_jackcontroller_interfaces[];
@@ -40,6 +40,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  * extreme jitter values, and for analyzing the amount of truth in the
  * technical specifications for your MIDI interface(s). :)
  *
+ * The output timing jitter plot shows how much later than scheduled each
+ * message arrived, with a 10 microsecond resolution.  A message is scheduled
+ * to arrive at the frame it was written at, plus the reported out-port and
+ * in-port latencies.  This is useful for checking how precisely a driver
+ * schedules its MIDI output within a period.
+ *
  * This program is loosely based on 'alsa-midi-latency-test' in the ALSA test
  * suite.
  *
@@ -108,6 +114,7 @@ jack_midi_data_t *message_2;
 int messages_received;
 int messages_sent;
 size_t message_size;
+jack_time_t *output_timing_values;
 jack_latency_range_t out_latency_range;
 jack_port_t *out_port;
 semaphore_t process_semaphore;
@@ -118,6 +125,7 @@ jack_port_t *remote_out_port;
 size_t samples;
 const char *target_in_port_name;
 const char *target_out_port_name;
+jack_nframes_t scheduled_frame;
 int timeout;
 jack_nframes_t total_latency;
 jack_time_t total_latency_time;
@@ -353,6 +361,9 @@ handle_process(jack_nframes_t frames, void *arg)
         }
         latency_time_values[messages_received] = time;
         latency_values[messages_received] = frame;
+        output_timing_values[messages_received] =
+            jack_frames_to_time(client, event_time) -
+            jack_frames_to_time(client, scheduled_frame);
         total_latency += frame;
         total_latency_time += time;
         messages_received++;
@@ -379,6 +390,8 @@ handle_process(jack_nframes_t frames, void *arg)
         memcpy(buffer, message, message_size * sizeof(jack_midi_data_t));
         last_activity = jack_last_frame_time(client) + frame;
         last_activity_time = jack_frames_to_time(client, last_activity);
+        scheduled_frame = last_activity + out_latency_range.max +
+            in_latency_range.max;
         messages_sent++;
 
     case 2:
@@ -614,6 +627,7 @@ main(int argc, char **argv)
 {
     int jitter_plot[101];
     int latency_plot[101];
+    int output_jitter_plot[202];
     int long_index = 0;
     struct option long_options[] = {
         {"help", 0, NULL, 'h'},
@@ -707,11 +721,17 @@ main(int argc, char **argv)
         error_source = "malloc";
         goto free_latency_values;
     }
+    output_timing_values = malloc(sizeof(jack_time_t) * samples);
+    if (output_timing_values == NULL) {
+        error_message = strerror(errno);
+        error_source = "malloc";
+        goto free_latency_time_values;
+    }
     message_1 = malloc(message_size * sizeof(jack_midi_data_t));
     if (message_1 == NULL) {
         error_message = strerror(errno);
         error_source = "malloc";
-        goto free_latency_time_values;
+        goto free_output_timing_values;
     }
     message_2 = malloc(message_size * sizeof(jack_midi_data_t));
     if (message_2 == NULL) {
@@ -862,12 +882,18 @@ main(int argc, char **argv)
             jitter_plot[i] = 0;
             latency_plot[i] = 0;
         }
+        for (i = 0; i < 202; i++) {
+            output_jitter_plot[i] = 0;
+        }
         for (i = 0; i < samples; i++) {
             double latency_time_value = (double) latency_time_values[i];
             double latency_plot_time =
                 (latency_time_value / 1000.0) - latency_plot_offset;
             double jitter_time = ABS(average_latency_time -
                                      latency_time_value);
+            /* Arrival time minus scheduled arrival time, can be negative */
+            double output_jitter_time =
+                (double) (int64_t) output_timing_values[i];
             if (latency_plot_time >= 10.0) {
                 (latency_plot[100])++;
             } else {
@@ -878,6 +904,15 @@ main(int argc, char **argv)
             } else {
                 (jitter_plot[(int) (jitter_time / 100.0)])++;
             }
+            if (output_jitter_time < -1000.0) {
+                (output_jitter_plot[0])++;
+            } else if (output_jitter_time >= 1000.0) {
+                (output_jitter_plot[201])++;
+            } else {
+                (output_jitter_plot[1 + (int)
+                                    floor((output_jitter_time + 1000.0) /
+                                          10.0)])++;
+            }
             total_jitter += ABS(average_latency -
                                 ((double) latency_values[i]));
             total_jitter_time += jitter_time;
@@ -912,6 +947,19 @@ main(int argc, char **argv)
         if (jitter_plot[100]) {
             printf("     > 10 ms: %d\n", jitter_plot[100]);
         }
+        printf("\nOutput Timing Jitter Plot:\n");
+        if (output_jitter_plot[0]) {
+            printf("    < -1000 us: %d\n", output_jitter_plot[0]);
+        }
+        for (i = 1; i <= 200; i++) {
+            if (output_jitter_plot[i]) {
+                printf("%5d - %5d us: %d\n", (((int) i) - 101) * 10,
+                       (((int) i) - 100) * 10, output_jitter_plot[i]);
+            }
+        }
+        if (output_jitter_plot[201]) {
+            printf("     > 1000 us: %d\n", output_jitter_plot[201]);
+        }
         printf("\nLatency Plot:\n");
         for (i = 0; i < 100; i++) {
             if (latency_plot[i]) {
@@ -952,6 +1000,8 @@ main(int argc, char **argv)
     free(message_2);
  free_message_1:
     free(message_1);
+ free_output_timing_values:
+    free(output_timing_values);
  free_latency_time_values:
     free(latency_time_values);
  free_latency_values:
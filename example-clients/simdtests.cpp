@@ -18,6 +18,13 @@
  *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
+/* Covers the sample moves, dither and interleave functions of memops.c,
+ * the audio port mixdown and (when built with SIMDTESTS_NETJACK) the netone
+ * payload codecs, for several buffer sizes and device buffer alignments.
+ * Results are compared in integer LSBs or float ULPs against per kernel
+ * tolerances, and the exit status is non zero when a check fails.
+ */
+
 /* We must include all headers memops.c includes to avoid trouble with
  * out namespace game below.
  */
@@ -44,14 +51,43 @@
 #include <arm_neon.h>
 #endif
 
+// same for JackAudioMixdown.h
+#if defined (__APPLE__)
+#include <Accelerate/Accelerate.h>
+#elif defined (__SSE__) && !defined (__sun__)
+#include <xmmintrin.h>
+#endif
+
 // our additional headers
 #include <time.h>
+#include <getopt.h>
+#ifdef SIMDTESTS_NETJACK
+#include <arpa/inet.h>
+#include "netjack_packet.h"
+#endif
+
+// what the accelerated functions were built for, before we undefine it below
+static const char *accelerated_isa =
+#if defined (__SSE4_1__) && !defined (__sun__)
+	"SSE4.1"
+#elif defined (__SSE2__) && !defined (__sun__)
+	"SSE2"
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+	"NEON"
+#else
+	"none"
+#endif
+#if defined (__APPLE__)
+	", mixdown with vDSP"
+#endif
+	;
 
 /* Dirty: include mempos.c twice the second time with SIMD disabled
  * so we can compare aceelerated non accelerated
  */
 namespace accelerated {
 #include "../common/memops.c"
+#include "../common/JackAudioMixdown.h"
 }
 
 namespace origerated {
@@ -68,6 +104,18 @@ namespace origerated {
 #endif
 
 #include "../common/memops.c"
+
+// the mixdown uses SSE, or vDSP on macOS
+#undef __JackAudioMixdown__
+#ifdef __SSE__
+#undef __SSE__
+#endif
+
+#ifdef __APPLE__
+#undef __APPLE__
+#endif
+
+#include "../common/JackAudioMixdown.h"
 }
 
 // define conversion function types
@@ -84,6 +132,13 @@ typedef void (*t_integer_to_jack)(
 	unsigned long nsamples,
 	unsigned long src_skip);
 
+typedef void (*t_interleave)(
+	char *dst,
+	char *src,
+	unsigned long src_bytes,
+	unsigned long dst_skip_bytes,
+	unsigned long src_skip_bytes);
+
 // define/setup test case data
 typedef struct test_case_data {
 	uint32_t frame_size;
@@ -93,7 +148,12 @@ typedef struct test_case_data {
 	t_jack_to_integer jack_to_integer_orig;
 	t_integer_to_jack integer_to_jack_accel;
 	t_integer_to_jack integer_to_jack_orig;
-	dither_state_t *ditherstate;
+	/* allowed deviation of the accelerated results, in LSBs and in ULPs:
+	 * SIMD code may truncate where lrintf rounds, and multiply by the
+	 * reciprocal where the plain code divides
+	 */
+	uint32_t integer_tolerance;
+	uint32_t float_tolerance;
 	const char *name;
 } test_case_data_t;
 
@@ -106,7 +166,8 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d32u24_sSs,
 		accelerated::sample_move_dS_s32u24s,
 		origerated::sample_move_dS_s32u24s,
-		NULL,
+		1,
+		1,
 		"32u24s" },
 	{
 		4,
@@ -116,7 +177,8 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d32u24_sS,
 		accelerated::sample_move_dS_s32u24,
 		origerated::sample_move_dS_s32u24,
-		NULL,
+		1,
+		1,
 		"32u24" },
 	{
 		3,
@@ -126,7 +188,8 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d24_sSs,
 		accelerated::sample_move_dS_s24s,
 		origerated::sample_move_dS_s24s,
-		NULL,
+		1,
+		1,
 		"24s" },
 	{
 		3,
@@ -136,7 +199,8 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d24_sS,
 		accelerated::sample_move_dS_s24,
 		origerated::sample_move_dS_s24,
-		NULL,
+		1,
+		1,
 		"24" },
 	{
 		2,
@@ -146,7 +210,8 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d16_sSs,
 		accelerated::sample_move_dS_s16s,
 		origerated::sample_move_dS_s16s,
-		NULL,
+		1,
+		1,
 		"16s" },
 	{
 		2,
@@ -156,22 +221,135 @@ test_case_data_t test_cases[] = {
 		origerated::sample_move_d16_sS,
 		accelerated::sample_move_dS_s16,
 		origerated::sample_move_dS_s16,
-		NULL,
+		1,
+		1,
 		"16" },
 };
 
+/* Dithered results are checked against the conversion without dither: dither
+ * may move a sample by the amplitude of its noise, but not further. Noise
+ * shaping feeds the clipping errors back, so shaped results are checked
+ * against the plain function instead, fed with the same noise.
+ */
+typedef struct dither_case_data {
+	uint32_t frame_size;
+	uint32_t sample_size;
+	bool reverse;
+	t_jack_to_integer jack_to_integer_accel;
+	t_jack_to_integer jack_to_integer_orig;
+	t_jack_to_integer undithered;
+	uint32_t dither_bound;
+	const char *name;
+} dither_case_data_t;
+
+dither_case_data_t dither_cases[] = {
+	{
+		2,
+		2,
+		true,
+		accelerated::sample_move_dither_rect_d16_sSs,
+		origerated::sample_move_dither_rect_d16_sSs,
+		origerated::sample_move_d16_sSs,
+		1,
+		"rect16s" },
+	{
+		2,
+		2,
+		false,
+		accelerated::sample_move_dither_rect_d16_sS,
+		origerated::sample_move_dither_rect_d16_sS,
+		origerated::sample_move_d16_sS,
+		1,
+		"rect16" },
+	{
+		2,
+		2,
+		true,
+		accelerated::sample_move_dither_tri_d16_sSs,
+		origerated::sample_move_dither_tri_d16_sSs,
+		origerated::sample_move_d16_sSs,
+		2,
+		"tri16s" },
+	{
+		2,
+		2,
+		false,
+		accelerated::sample_move_dither_tri_d16_sS,
+		origerated::sample_move_dither_tri_d16_sS,
+		origerated::sample_move_d16_sS,
+		2,
+		"tri16" },
+	{
+		2,
+		2,
+		true,
+		accelerated::sample_move_dither_shaped_d16_sSs,
+		origerated::sample_move_dither_shaped_d16_sSs,
+		NULL,
+		0,
+		"shape16s" },
+	{
+		2,
+		2,
+		false,
+		accelerated::sample_move_dither_shaped_d16_sS,
+		origerated::sample_move_dither_shaped_d16_sS,
+		NULL,
+		0,
+		"shape16" },
+};
+
+typedef struct interleave_case_data {
+	uint32_t sample_size;
+	t_interleave interleave_accel;
+	t_interleave interleave_orig;
+	const char *name;
+} interleave_case_data_t;
+
+interleave_case_data_t interleave_cases[] = {
+	{
+		2,
+		accelerated::memcpy_interleave_d16_s16,
+		origerated::memcpy_interleave_d16_s16,
+		"i16" },
+	{
+		3,
+		accelerated::memcpy_interleave_d24_s24,
+		origerated::memcpy_interleave_d24_s24,
+		"i24" },
+	{
+		4,
+		accelerated::memcpy_interleave_d32_s32,
+		origerated::memcpy_interleave_d32_s32,
+		"i32" },
+};
+
 // we need to repeat for better accuracy at time measurement
-const uint32_t retry_per_case = 1000;
+uint32_t iterations = 1000;
+uint32_t maxerr_displayed = 10;
+uint32_t failed_checks = 0;
 
 // setup test buffers
 #define TESTBUFF_SIZE 1024
+#define MAX_OFFSET 4
+#define MAX_MIX_SOURCES 8
+
+// odd sizes leave work for the scalar tails of the kernels
+uint32_t test_sizes[] = { 7, 61, 256, TESTBUFF_SIZE };
+// float buffers keep the alignment of port buffers, device buffers get shifted
+const uint32_t test_offsets[] = { 0, 1, 3 };
+const int mix_sources_counts[] = { 1, 2, 4, MAX_MIX_SOURCES };
+
 jack_default_audio_sample_t jackbuffer_source[TESTBUFF_SIZE];
 // integer buffers: max 4 bytes per value / * 2 for stereo
-char integerbuffer_accel[TESTBUFF_SIZE*4*2];
-char integerbuffer_orig[TESTBUFF_SIZE*4*2];
+char integerbuffer_accel[TESTBUFF_SIZE*4*2 + MAX_OFFSET];
+char integerbuffer_orig[TESTBUFF_SIZE*4*2 + MAX_OFFSET];
+char integerbuffer_ref[TESTBUFF_SIZE*4*2 + MAX_OFFSET];
+char integerbuffer_source[TESTBUFF_SIZE*4];
 // float buffers
 jack_default_audio_sample_t jackfloatbuffer_accel[TESTBUFF_SIZE];
 jack_default_audio_sample_t jackfloatbuffer_orig[TESTBUFF_SIZE];
+jack_default_audio_sample_t mix_sources[MAX_MIX_SOURCES][TESTBUFF_SIZE];
 
 // comparing unsigned makes life easier
 uint32_t extract_integer(
@@ -201,194 +379,466 @@ uint32_t extract_integer(
 	return retval;
 }
 
+// ... but deviations are measured on the signed values
+int32_t signed_integer(uint32_t value, uint32_t sample_size)
+{
+	uint32_t shift = 32 - sample_size*8;
+	return ((int32_t)(value << shift)) >> shift;
+}
+
+// distance in units in the last place, so the tolerance follows the magnitude
+uint32_t ulp_distance(float a, float b)
+{
+	int32_t int_a, int_b;
+	memcpy(&int_a, &a, sizeof(int_a));
+	memcpy(&int_b, &b, sizeof(int_b));
+	// map the sign/magnitude encoding to a monotonic integer scale
+	int64_t scaled_a = (int_a < 0) ? (int64_t)INT32_MIN - int_a : int_a;
+	int64_t scaled_b = (int_b < 0) ? (int64_t)INT32_MIN - int_b : int_b;
+	int64_t distance = (scaled_a > scaled_b) ? scaled_a - scaled_b : scaled_b - scaled_a;
+	return (distance > UINT32_MAX) ? UINT32_MAX : (uint32_t)distance;
+}
+
+// nsec per sample; every size converts the same number of samples
+template <typename T>
+double time_per_sample(T convert, uint32_t nsamples)
+{
+	uint32_t repetitions = iterations * TESTBUFF_SIZE / nsamples;
+	clock_t start = clock();
+	for(uint32_t repetition=0; repetition<repetitions; repetition++)
+	{
+		convert();
+	}
+	return ((double)(clock() - start)) / CLOCKS_PER_SEC * 1e9 / ((double)repetitions * nsamples);
+}
+
+void print_timing(const char *direction, const char *label, double orig, double accel)
+{
+	printf(
+		"%s @%s: Orig %7.3f nsec / Accel %7.3f nsec per sample -> Win: %7.2f %%\n",
+		direction,
+		label,
+		orig,
+		accel,
+		(accel > 0.0) ? (orig/accel-1)*100.0 : 0.0);
+}
+
+void print_result(const char *direction, const char *label, uint32_t error_count, uint32_t deviation_max, const char *unit)
+{
+	printf(
+		"%s @%s: Errors: %u Max deviation %u %s%s\n",
+		direction,
+		label,
+		error_count,
+		deviation_max,
+		unit,
+		error_count ? " -> FAILED" : "");
+	if(error_count)
+		failed_checks++;
+}
+
+// compare two device buffers, sample by sample
+void check_integers(
+	const char *direction,
+	const char *label,
+	char *buff_accel,
+	char *buff_orig,
+	uint32_t nsamples,
+	uint32_t skip,
+	uint32_t frame_size,
+	uint32_t sample_size,
+	bool reverse,
+	uint32_t tolerance)
+{
+#if __BYTE_ORDER == __BIG_ENDIAN
+	bool big_endian = !reverse;
+#else
+	bool big_endian = reverse;
+#endif
+	uint32_t deviation_max = 0;
+	uint32_t error_count = 0;
+	// output error (avoid spam -> limit error lines per test case)
+	for(uint32_t sample=0; sample<nsamples; sample++) {
+		uint32_t intval_accel = extract_integer(buff_accel, sample*skip, frame_size, sample_size, big_endian);
+		uint32_t intval_orig = extract_integer(buff_orig, sample*skip, frame_size, sample_size, big_endian);
+		int32_t difference = signed_integer(intval_accel, sample_size) - signed_integer(intval_orig, sample_size);
+		uint32_t deviation = (difference < 0) ? -difference : difference;
+		if(deviation > deviation_max)
+			deviation_max = deviation;
+		if(deviation > tolerance) {
+			if(error_count<maxerr_displayed) {
+				printf("Value error sample %u:", sample);
+				printf(" Orig 0x");
+				char formatstr[10];
+				sprintf(formatstr, "%%0%uX", sample_size*2);
+				printf(formatstr, intval_orig);
+				printf(" Accel 0x");
+				printf(formatstr, intval_accel);
+				printf("\n");
+			}
+			error_count++;
+		}
+	}
+	print_result(direction, label, error_count, deviation_max, "LSB");
+}
+
+void check_floats(
+	const char *direction,
+	const char *label,
+	jack_default_audio_sample_t *buff_accel,
+	jack_default_audio_sample_t *buff_orig,
+	uint32_t nsamples,
+	uint32_t tolerance)
+{
+	uint32_t deviation_max = 0;
+	uint32_t error_count = 0;
+	for(uint32_t sample=0; sample<nsamples; sample++) {
+		uint32_t deviation = ulp_distance(buff_accel[sample], buff_orig[sample]);
+		if(deviation > deviation_max)
+			deviation_max = deviation;
+		if(deviation > tolerance) {
+			if(error_count<maxerr_displayed) {
+				printf("Value error sample %u:", sample);
+				printf(" Orig %.9g Accel %.9g\n", buff_orig[sample], buff_accel[sample]);
+			}
+			error_count++;
+		}
+	}
+	print_result(direction, label, error_count, deviation_max, "ULP");
+}
+
+void test_sample_move(test_case_data_t *test_case, uint32_t channels, uint32_t nsamples, uint32_t offset)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%8.8s/%u n=%4u +%u", test_case->name, channels, nsamples, offset);
+	uint32_t skip = test_case->frame_size*channels;
+	char *buff_accel = integerbuffer_accel + offset;
+	char *buff_orig = integerbuffer_orig + offset;
+	dither_state_t state;
+	memset(&state, 0, sizeof(state));
+
+	//////////////////////////////////////////////////////////////////////////////
+	// jackfloat -> integer
+
+	// clean target buffers
+	memset(integerbuffer_accel, 0, sizeof(integerbuffer_accel));
+	memset(integerbuffer_orig, 0, sizeof(integerbuffer_orig));
+	double time_orig = time_per_sample([&] {
+		test_case->jack_to_integer_orig(buff_orig, jackbuffer_source, nsamples, skip, &state);
+	}, nsamples);
+	double time_accel = time_per_sample([&] {
+		test_case->jack_to_integer_accel(buff_accel, jackbuffer_source, nsamples, skip, &state);
+	}, nsamples);
+	print_timing("JackFloat->Integer", label, time_orig, time_accel);
+	check_integers(
+		"JackFloat->Integer",
+		label,
+		buff_accel,
+		buff_orig,
+		nsamples,
+		skip,
+		test_case->frame_size,
+		test_case->sample_size,
+		test_case->reverse,
+		test_case->integer_tolerance);
+
+	//////////////////////////////////////////////////////////////////////////////
+	// integer -> jackfloat
+
+	// clean target buffers
+	memset(jackfloatbuffer_accel, 0, sizeof(jackfloatbuffer_accel));
+	memset(jackfloatbuffer_orig, 0, sizeof(jackfloatbuffer_orig));
+	time_orig = time_per_sample([&] {
+		test_case->integer_to_jack_orig(jackfloatbuffer_orig, buff_orig, nsamples, skip);
+	}, nsamples);
+	time_accel = time_per_sample([&] {
+		test_case->integer_to_jack_accel(jackfloatbuffer_accel, buff_orig, nsamples, skip);
+	}, nsamples);
+	print_timing("Integer->JackFloat", label, time_orig, time_accel);
+	check_floats(
+		"Integer->JackFloat",
+		label,
+		jackfloatbuffer_accel,
+		jackfloatbuffer_orig,
+		nsamples,
+		test_case->float_tolerance);
+}
+
+void test_dither(dither_case_data_t *test_case, uint32_t channels, uint32_t nsamples, uint32_t offset)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%8.8s/%u n=%4u +%u", test_case->name, channels, nsamples, offset);
+	uint32_t skip = test_case->frame_size*channels;
+	char *buff_accel = integerbuffer_accel + offset;
+	char *buff_orig = integerbuffer_orig + offset;
+	char *buff_ref = integerbuffer_ref + offset;
+	dither_state_t state_accel;
+	dither_state_t state_orig;
+	memset(&state_accel, 0, sizeof(state_accel));
+	memset(&state_orig, 0, sizeof(state_orig));
+
+	double time_orig = time_per_sample([&] {
+		test_case->jack_to_integer_orig(buff_orig, jackbuffer_source, nsamples, skip, &state_orig);
+	}, nsamples);
+	double time_accel = time_per_sample([&] {
+		test_case->jack_to_integer_accel(buff_accel, jackbuffer_source, nsamples, skip, &state_accel);
+	}, nsamples);
+	print_timing("JackFloat->Dither ", label, time_orig, time_accel);
+
+	// a fresh noise generator and error filter for the checked run
+	memset(integerbuffer_accel, 0, sizeof(integerbuffer_accel));
+	memset(integerbuffer_ref, 0, sizeof(integerbuffer_ref));
+	memset(&state_accel, 0, sizeof(state_accel));
+	memset(&state_orig, 0, sizeof(state_orig));
+	accelerated::seed = 22222;
+	origerated::seed = 22222;
+	test_case->jack_to_integer_accel(buff_accel, jackbuffer_source, nsamples, skip, &state_accel);
+	if(test_case->undithered)
+		test_case->undithered(buff_ref, jackbuffer_source, nsamples, skip, &state_orig);
+	else
+		test_case->jack_to_integer_orig(buff_ref, jackbuffer_source, nsamples, skip, &state_orig);
+	check_integers(
+		"JackFloat->Dither ",
+		label,
+		buff_accel,
+		buff_ref,
+		nsamples,
+		skip,
+		test_case->frame_size,
+		test_case->sample_size,
+		test_case->reverse,
+		test_case->dither_bound);
+}
+
+void test_interleave(interleave_case_data_t *test_case, uint32_t channels, uint32_t nsamples, uint32_t offset)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%8.8s/%u n=%4u +%u", test_case->name, channels, nsamples, offset);
+	uint32_t skip = test_case->sample_size*channels;
+	uint32_t bytes = test_case->sample_size*nsamples;
+	char *buff_accel = integerbuffer_accel + offset;
+	char *buff_orig = integerbuffer_orig + offset;
+
+	memset(integerbuffer_accel, 0, sizeof(integerbuffer_accel));
+	memset(integerbuffer_orig, 0, sizeof(integerbuffer_orig));
+	double time_orig = time_per_sample([&] {
+		test_case->interleave_orig(buff_orig, integerbuffer_source, bytes, skip, test_case->sample_size);
+	}, nsamples);
+	double time_accel = time_per_sample([&] {
+		test_case->interleave_accel(buff_accel, integerbuffer_source, bytes, skip, test_case->sample_size);
+	}, nsamples);
+	print_timing("Integer->Interleave", label, time_orig, time_accel);
+	// copies must be exact, including the bytes between the samples
+	check_integers(
+		"Integer->Interleave",
+		label,
+		buff_accel,
+		buff_orig,
+		nsamples*channels,
+		test_case->sample_size,
+		test_case->sample_size,
+		test_case->sample_size,
+		false,
+		0);
+}
+
+void test_mixdown(int sources, uint32_t nsamples)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%6d src n=%4u +0", sources, nsamples);
+	void *buffers[MAX_MIX_SOURCES];
+	for(int source=0; source<sources; source++)
+		buffers[source] = mix_sources[source];
+
+	memset(jackfloatbuffer_accel, 0, sizeof(jackfloatbuffer_accel));
+	memset(jackfloatbuffer_orig, 0, sizeof(jackfloatbuffer_orig));
+	double time_orig = time_per_sample([&] {
+		origerated::Jack::AudioBufferMixdown(jackfloatbuffer_orig, buffers, sources, nsamples);
+	}, nsamples);
+	double time_accel = time_per_sample([&] {
+		accelerated::Jack::AudioBufferMixdown(jackfloatbuffer_accel, buffers, sources, nsamples);
+	}, nsamples);
+	print_timing("Mixdown           ", label, time_orig, time_accel);
+	// same additions in the same order: nothing may differ
+	check_floats("Mixdown           ", label, jackfloatbuffer_accel, jackfloatbuffer_orig, nsamples, 0);
+}
+
+#ifdef SIMDTESTS_NETJACK
+/* The payload kernels convert their remainder with scalar code, so the plain
+ * result is obtained by converting one sample per call. Only the kernels are
+ * timed, the per sample calls would measure the call overhead.
+ */
+int64_t payload_value(uint32_t value) { return value; }
+int64_t payload_value(uint16_t value) { return ntohs(value); }
+int64_t payload_value(int8_t value) { return value; }
+
+template <typename T>
+void test_netjack_codec(
+	const char *name,
+	void (*encode)(T *dst, const float *src, unsigned int nsamples),
+	void (*decode)(float *dst, const T *src, unsigned int nsamples),
+	uint32_t nsamples,
+	uint32_t tolerance)
+{
+	char label[64];
+	snprintf(label, sizeof(label), "%8.8s   n=%4u +0", name, nsamples);
+	T payload_accel[TESTBUFF_SIZE];
+	T payload_orig[TESTBUFF_SIZE];
+
+	double time_accel = time_per_sample([&] {
+		encode(payload_accel, jackbuffer_source, nsamples);
+	}, nsamples);
+	for(uint32_t sample=0; sample<nsamples; sample++)
+		encode(payload_orig + sample, jackbuffer_source + sample, 1);
+	printf("JackFloat->NetJack @%s: Accel %7.3f nsec per sample\n", label, time_accel);
+	uint32_t deviation_max = 0;
+	uint32_t error_count = 0;
+	for(uint32_t sample=0; sample<nsamples; sample++) {
+		int64_t difference = payload_value(payload_accel[sample]) - payload_value(payload_orig[sample]);
+		uint32_t deviation = (difference < 0) ? -difference : difference;
+		if(deviation > deviation_max)
+			deviation_max = deviation;
+		if(deviation > tolerance) {
+			if(error_count<maxerr_displayed) {
+				printf("Value error sample %u:", sample);
+				printf(" Orig %lld Accel %lld\n",
+					(long long)payload_value(payload_orig[sample]),
+					(long long)payload_value(payload_accel[sample]));
+			}
+			error_count++;
+		}
+	}
+	print_result("JackFloat->NetJack", label, error_count, deviation_max, "LSB");
+
+	memset(jackfloatbuffer_accel, 0, sizeof(jackfloatbuffer_accel));
+	memset(jackfloatbuffer_orig, 0, sizeof(jackfloatbuffer_orig));
+	time_accel = time_per_sample([&] {
+		decode(jackfloatbuffer_accel, payload_orig, nsamples);
+	}, nsamples);
+	for(uint32_t sample=0; sample<nsamples; sample++)
+		decode(jackfloatbuffer_orig + sample, payload_orig + sample, 1);
+	printf("NetJack->JackFloat @%s: Accel %7.3f nsec per sample\n", label, time_accel);
+	check_floats("NetJack->JackFloat", label, jackfloatbuffer_accel, jackfloatbuffer_orig, nsamples, 0);
+}
+
+void test_netjack(uint32_t nsamples)
+{
+	test_netjack_codec<uint32_t>("float", netjack_float_to_net, netjack_net_to_float, nsamples, 0);
+	// the vector and scalar products may truncate to different sides
+	test_netjack_codec<uint16_t>("16bit", netjack_float_to_net_16bit, netjack_net_16bit_to_float, nsamples, 1);
+	test_netjack_codec<int8_t>("8bit", netjack_float_to_net_8bit, netjack_net_8bit_to_float, nsamples, 1);
+}
+#endif
+
+void usage()
+{
+	fprintf(stderr, "\n"
+		"usage: jack_simdtests \n"
+		"              [ --iterations OR -i number_of_repetitions (default 1000) ]\n"
+		"              [ --size OR -s frames (default 7, 61, 256 and 1024) ]\n"
+		"              [ --errors OR -e value_errors_shown_per_test (default 10) ]\n"
+	);
+}
+
 int main(int argc, char *argv[])
 {
-//	parse_arguments(argc, argv);
-	uint32_t maxerr_displayed = 10;
+	const char *options = "i:s:e:h";
+	struct option long_options[] = {
+		{"iterations", 1, 0, 'i'},
+		{"size", 1, 0, 's'},
+		{"errors", 1, 0, 'e'},
+		{"help", 0, 0, 'h'},
+		{0, 0, 0, 0}
+	};
+	int option_index;
+	int opt;
+	uint32_t sizes_count = sizeof(test_sizes)/sizeof(test_sizes[0]);
+
+	while((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+		switch(opt) {
+			case 'i':
+				iterations = atoi(optarg);
+				break;
+			case 's':
+				test_sizes[0] = atoi(optarg);
+				sizes_count = 1;
+				break;
+			case 'e':
+				maxerr_displayed = atoi(optarg);
+				break;
+			case 'h':
+			default:
+				usage();
+				return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	if(iterations < 1 || test_sizes[0] < 1 || test_sizes[0] > TESTBUFF_SIZE) {
+		fprintf(stderr, "iterations must be at least 1, sizes between 1 and %d\n", TESTBUFF_SIZE);
+		return 1;
+	}
+
+	printf("Accelerated build: %s\n\n", accelerated_isa);
 
 	// fill jackbuffer
 	for(int i=0; i<TESTBUFF_SIZE; i++) {
-		// ramp
+		// ramp, stepped through so short buffers get the whole range too
 		jack_default_audio_sample_t value =
-			((jack_default_audio_sample_t)((i % TESTBUFF_SIZE) - TESTBUFF_SIZE/2)) / (TESTBUFF_SIZE/2);
+			((jack_default_audio_sample_t)(((i * 37) % TESTBUFF_SIZE) - TESTBUFF_SIZE/2)) / (TESTBUFF_SIZE/2);
 		// force clipping
 		value *= 1.02;
 		jackbuffer_source[i] = value;
 	}
+	for(int source=0; source<MAX_MIX_SOURCES; source++) {
+		for(int i=0; i<TESTBUFF_SIZE; i++) {
+			mix_sources[source][i] = sinf(i * 0.01f * (source + 1)) / (source + 1);
+		}
+	}
+	for(int i=0; i<TESTBUFF_SIZE*4; i++) {
+		integerbuffer_source[i] = (char)(i * 131);
+	}
 
-	for(uint32_t testcase=0; testcase<sizeof(test_cases)/sizeof(test_case_data_t); testcase++) {
-		// test mono/stereo
-		for(uint32_t channels=1; channels<=2; channels++) {
-			//////////////////////////////////////////////////////////////////////////////
-			// jackfloat -> integer
-
-			// clean target buffers
-			memset(integerbuffer_accel, 0, sizeof(integerbuffer_accel));
-			memset(integerbuffer_orig, 0, sizeof(integerbuffer_orig));
-			// accel
-			clock_t time_to_integer_accel = clock();
-			for(uint32_t repetition=0; repetition<retry_per_case; repetition++)
-			{
-				test_cases[testcase].jack_to_integer_accel(
-					integerbuffer_accel,
-					jackbuffer_source,
-					TESTBUFF_SIZE,
-					test_cases[testcase].frame_size*channels,
-					test_cases[testcase].ditherstate);
-			}
-			float timediff_to_integer_accel = ((float)(clock() - time_to_integer_accel)) / CLOCKS_PER_SEC;
-			// orig
-			clock_t time_to_integer_orig = clock();
-			for(uint32_t repetition=0; repetition<retry_per_case; repetition++)
-			{
-				test_cases[testcase].jack_to_integer_orig(
-					integerbuffer_orig,
-					jackbuffer_source,
-					TESTBUFF_SIZE,
-					test_cases[testcase].frame_size*channels,
-					test_cases[testcase].ditherstate);
-			}
-			float timediff_to_integer_orig = ((float)(clock() - time_to_integer_orig)) / CLOCKS_PER_SEC;
-			// output performance results
-			printf(
-				"JackFloat->Integer @%7.7s/%u: Orig %7.6f sec / Accel %7.6f sec -> Win: %5.2f %%\n",
-				test_cases[testcase].name,
-				channels,
-				timediff_to_integer_orig,
-				timediff_to_integer_accel,
-				(timediff_to_integer_orig/timediff_to_integer_accel-1)*100.0);
-			uint32_t int_deviation_max = 0;
-			uint32_t int_error_count = 0;
-			// output error (avoid spam -> limit error lines per test case)
-			for(uint32_t sample=0; sample<TESTBUFF_SIZE; sample++) {
-				uint32_t sample_offset = sample*test_cases[testcase].frame_size*channels;
-				// compare both results
-				uint32_t intval_accel=extract_integer(
-					integerbuffer_accel,
-					sample_offset,
-					test_cases[testcase].frame_size,
-					test_cases[testcase].sample_size,
-#if __BYTE_ORDER == __BIG_ENDIAN
-					!test_cases[testcase].reverse);
-#else
-					test_cases[testcase].reverse);
-#endif
-				uint32_t intval_orig=extract_integer(
-					integerbuffer_orig,
-					sample_offset,
-					test_cases[testcase].frame_size,
-					test_cases[testcase].sample_size,
-#if __BYTE_ORDER == __BIG_ENDIAN
-					!test_cases[testcase].reverse);
-#else
-					test_cases[testcase].reverse);
-#endif
-				if(intval_accel != intval_orig) {
-					if(int_error_count<maxerr_displayed) {
-						printf("Value error sample %u:", sample);
-						printf(" Orig 0x");
-						char formatstr[10];
-						sprintf(formatstr, "%%0%uX", test_cases[testcase].sample_size*2);
-						printf(formatstr, intval_orig);
-						printf(" Accel 0x");
-						printf(formatstr, intval_accel);
-						printf("\n");
-					}
-					int_error_count++;
-					uint32_t int_deviation;
-					if(intval_accel > intval_orig)
-						int_deviation = intval_accel-intval_orig;
-					else
-						int_deviation = intval_orig-intval_accel;
-					if(int_deviation > int_deviation_max)
-						int_deviation_max = int_deviation;
+	for(uint32_t size=0; size<sizes_count; size++) {
+		uint32_t nsamples = test_sizes[size];
+		for(uint32_t testcase=0; testcase<sizeof(test_cases)/sizeof(test_case_data_t); testcase++) {
+			// test mono/stereo
+			for(uint32_t channels=1; channels<=2; channels++) {
+				for(uint32_t offset=0; offset<sizeof(test_offsets)/sizeof(test_offsets[0]); offset++) {
+					test_sample_move(&test_cases[testcase], channels, nsamples, test_offsets[offset]);
 				}
 			}
-			printf(
-				"JackFloat->Integer @%7.7s/%u: Errors: %u Max deviation %u\n",
-				test_cases[testcase].name,
-				channels,
-				int_error_count,
-				int_deviation_max);
-
-			//////////////////////////////////////////////////////////////////////////////
-			// integer -> jackfloat
-
-			// clean target buffers
-			memset(jackfloatbuffer_accel, 0, sizeof(jackfloatbuffer_accel));
-			memset(jackfloatbuffer_orig, 0, sizeof(jackfloatbuffer_orig));
-			// accel
-			clock_t time_to_float_accel = clock();
-			for(uint32_t repetition=0; repetition<retry_per_case; repetition++)
-			{
-				test_cases[testcase].integer_to_jack_accel(
-					jackfloatbuffer_accel,
-					integerbuffer_orig,
-					TESTBUFF_SIZE,
-					test_cases[testcase].frame_size*channels);
-			}
-			float timediff_to_float_accel = ((float)(clock() - time_to_float_accel)) / CLOCKS_PER_SEC;
-			// orig
-			clock_t time_to_float_orig = clock();
-			for(uint32_t repetition=0; repetition<retry_per_case; repetition++)
-			{
-				test_cases[testcase].integer_to_jack_orig(
-					jackfloatbuffer_orig,
-					integerbuffer_orig,
-					TESTBUFF_SIZE,
-					test_cases[testcase].frame_size*channels);
-			}
-			float timediff_to_float_orig = ((float)(clock() - time_to_float_orig)) / CLOCKS_PER_SEC;
-			// output performance results
-			printf(
-				"Integer->JackFloat @%7.7s/%u: Orig %7.6f sec / Accel %7.6f sec -> Win: %5.2f %%\n",
-				test_cases[testcase].name,
-				channels,
-				timediff_to_float_orig,
-				timediff_to_float_accel,
-				(timediff_to_float_orig/timediff_to_float_accel-1)*100.0);
-			jack_default_audio_sample_t float_deviation_max = 0.0;
-			uint32_t float_error_count = 0;
-			// output error (avoid spam -> limit error lines per test case)
-			for(uint32_t sample=0; sample<TESTBUFF_SIZE; sample++) {
-				// For easier estimation/readability we scale floats back to integer
-				jack_default_audio_sample_t sample_scaling;
-				switch(test_cases[testcase].sample_size) {
-					case 2:
-						sample_scaling = SAMPLE_16BIT_SCALING;
-						break;
-					default:
-						sample_scaling = SAMPLE_24BIT_SCALING;
-						break;
+			printf("\n");
+		}
+		for(uint32_t testcase=0; testcase<sizeof(dither_cases)/sizeof(dither_case_data_t); testcase++) {
+			for(uint32_t channels=1; channels<=2; channels++) {
+				for(uint32_t offset=0; offset<sizeof(test_offsets)/sizeof(test_offsets[0]); offset++) {
+					test_dither(&dither_cases[testcase], channels, nsamples, test_offsets[offset]);
 				}
-				jack_default_audio_sample_t floatval_accel = jackfloatbuffer_accel[sample] * sample_scaling;
-				jack_default_audio_sample_t floatval_orig = jackfloatbuffer_orig[sample] * sample_scaling;
-				// compare both results
-				jack_default_audio_sample_t float_deviation;
-				if(floatval_accel > floatval_orig)
-					float_deviation = floatval_accel-floatval_orig;
-				else
-					float_deviation = floatval_orig-floatval_accel;
-				if(float_deviation > float_deviation_max)
-					float_deviation_max = float_deviation;
-				// deviation > half bit => error
-				if(float_deviation > 0.5) {
-					if(float_error_count<maxerr_displayed) {
-						printf("Value error sample %u:", sample);
-						printf(" Orig %8.1f Accel %8.1f\n", floatval_orig, floatval_accel);
-					}
-					float_error_count++;
+			}
+			printf("\n");
+		}
+		for(uint32_t testcase=0; testcase<sizeof(interleave_cases)/sizeof(interleave_case_data_t); testcase++) {
+			for(uint32_t channels=1; channels<=2; channels++) {
+				for(uint32_t offset=0; offset<sizeof(test_offsets)/sizeof(test_offsets[0]); offset++) {
+					test_interleave(&interleave_cases[testcase], channels, nsamples, test_offsets[offset]);
 				}
 			}
-			printf(
-				"Integer->JackFloat @%7.7s/%u: Errors: %u Max deviation %f\n",
-				test_cases[testcase].name,
-				channels,
-				float_error_count,
-				float_deviation_max);
-
 			printf("\n");
 		}
+		for(uint32_t sources=0; sources<sizeof(mix_sources_counts)/sizeof(mix_sources_counts[0]); sources++) {
+			test_mixdown(mix_sources_counts[sources], nsamples);
+		}
+		printf("\n");
+#ifdef SIMDTESTS_NETJACK
+		test_netjack(nsamples);
+		printf("\n");
+#endif
+	}
+
+	if(failed_checks) {
+		printf("%u checks FAILED\n", failed_checks);
+		return 1;
 	}
+	printf("All checks passed\n");
 	return 0;
 }
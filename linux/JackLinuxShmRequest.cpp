@@ -0,0 +1,322 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#include "JackLinuxShmRequest.h"
+#include "JackError.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <syscall.h>
+#include <linux/futex.h>
+
+#if !defined(SYS_futex) && defined(SYS_futex_time64)
+#define SYS_futex SYS_futex_time64
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC         0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING   0x0002U
+#endif
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS         1033
+#define F_GET_SEALS         1034
+#define F_SEAL_SEAL         0x0001
+#define F_SEAL_SHRINK       0x0002
+#define F_SEAL_GROW         0x0004
+#endif
+
+// The segment can never be resized : the server cannot get a SIGBUS from a truncated channel
+#define SHM_REQUEST_SEALS   (F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW)
+
+namespace Jack
+{
+
+JackShmRequestEnd::JackShmRequestEnd():fSharedMem(-1), fBlock(NULL)
+{
+    fName[0] = 0;
+    // Polling only makes sense if the other side can run meanwhile
+    fSpin = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? SHM_REQUEST_SPIN : 0;
+}
+
+JackShmRequestEnd::~JackShmRequestEnd()
+{
+    Unmap();
+}
+
+int JackShmRequestEnd::Map()
+{
+    fBlock = (JackShmRequestBlock*)mmap(NULL, sizeof(JackShmRequestBlock), PROT_READ|PROT_WRITE, MAP_SHARED, fSharedMem, 0);
+    if (fBlock == MAP_FAILED) {
+        jack_error("JackShmRequestEnd::Map can't map shared memory name = %s err = %s", fName, strerror(errno));
+        fBlock = NULL;
+        close(fSharedMem);
+        fSharedMem = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+void JackShmRequestEnd::Unmap()
+{
+    if (fBlock) {
+        munmap(fBlock, sizeof(JackShmRequestBlock));
+        fBlock = NULL;
+    }
+    if (fSharedMem >= 0) {
+        close(fSharedMem);
+        fSharedMem = -1;
+    }
+}
+
+void JackShmRequestEnd::Shutdown()
+{
+    if (fBlock) {
+        __atomic_store_n(&fBlock->fClosed, 1, __ATOMIC_SEQ_CST);
+        SignalRing(&fBlock->fRequest);
+        SignalRing(&fBlock->fResult);
+    }
+}
+
+void JackShmRequestEnd::SignalRing(JackShmRequestRing* ring)
+{
+    __atomic_add_fetch(&ring->fSeq, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->fWaiters, __ATOMIC_SEQ_CST) > 0) {
+        ::syscall(SYS_futex, &ring->fSeq, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+bool JackShmRequestEnd::WaitRing(JackShmRequestRing* ring, uint32_t seq)
+{
+    // The other side usually answers within a few microseconds : avoid the futex round trip in this case
+    for (int i = 0; i < fSpin; i++) {
+        if ((uint32_t)__atomic_load_n(&ring->fSeq, __ATOMIC_ACQUIRE) != seq) {
+            return !__atomic_load_n(&fBlock->fClosed, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    const timespec timeout = { SHM_REQUEST_TIME_OUT / 1000, (SHM_REQUEST_TIME_OUT % 1000) * 1000000 };
+
+    while ((uint32_t)__atomic_load_n(&ring->fSeq, __ATOMIC_SEQ_CST) == seq) {
+        if (__atomic_load_n(&fBlock->fClosed, __ATOMIC_SEQ_CST)) {
+            return false;
+        }
+        __atomic_add_fetch(&ring->fWaiters, 1, __ATOMIC_SEQ_CST);
+        int res = ::syscall(SYS_futex, &ring->fSeq, FUTEX_WAIT, (int)seq, &timeout, NULL, 0);
+        __atomic_sub_fetch(&ring->fWaiters, 1, __ATOMIC_SEQ_CST);
+        if (res != 0 && errno == ETIMEDOUT && !IsPeerAlive()) {
+            jack_error("JackShmRequestEnd::WaitRing name = %s peer is gone", fName);
+            return false;
+        }
+    }
+
+    return !__atomic_load_n(&fBlock->fClosed, __ATOMIC_SEQ_CST);
+}
+
+int JackShmRequestEnd::ReadRing(JackShmRequestRing* ring, void* data, int len)
+{
+    char* dst = (char*)data;
+
+    while (len > 0) {
+        uint32_t seq = __atomic_load_n(&ring->fSeq, __ATOMIC_SEQ_CST);
+        uint32_t read = ring->fRead;
+        uint32_t avail = __atomic_load_n(&ring->fWrite, __ATOMIC_SEQ_CST) - read;
+
+        if (avail == 0) {
+            if (!WaitRing(ring, seq)) {
+                return -1;
+            }
+            continue;
+        }
+
+        uint32_t count = (avail < (uint32_t)len) ? avail : len;
+        uint32_t pos = read & (SHM_REQUEST_RING_SIZE - 1);
+        uint32_t first = (count < SHM_REQUEST_RING_SIZE - pos) ? count : SHM_REQUEST_RING_SIZE - pos;
+        memcpy(dst, &ring->fBuffer[pos], first);
+        memcpy(dst + first, &ring->fBuffer[0], count - first);
+
+        __atomic_store_n(&ring->fRead, read + count, __ATOMIC_SEQ_CST);
+        SignalRing(ring);
+        dst += count;
+        len -= count;
+    }
+
+    return 0;
+}
+
+int JackShmRequestEnd::WriteRing(JackShmRequestRing* ring, void* data, int len)
+{
+    const char* src = (const char*)data;
+
+    if (__atomic_load_n(&fBlock->fClosed, __ATOMIC_SEQ_CST)) {
+        return -1;
+    }
+
+    while (len > 0) {
+        uint32_t seq = __atomic_load_n(&ring->fSeq, __ATOMIC_SEQ_CST);
+        uint32_t write = ring->fWrite;
+        uint32_t space = SHM_REQUEST_RING_SIZE - (write - __atomic_load_n(&ring->fRead, __ATOMIC_SEQ_CST));
+
+        if (space == 0) {
+            if (!WaitRing(ring, seq)) {
+                return -1;
+            }
+            continue;
+        }
+
+        uint32_t count = (space < (uint32_t)len) ? space : len;
+        uint32_t pos = write & (SHM_REQUEST_RING_SIZE - 1);
+        uint32_t first = (count < SHM_REQUEST_RING_SIZE - pos) ? count : SHM_REQUEST_RING_SIZE - pos;
+        memcpy(&ring->fBuffer[pos], src, first);
+        memcpy(&ring->fBuffer[0], src + first, count - first);
+
+        __atomic_store_n(&ring->fWrite, write + count, __ATOMIC_SEQ_CST);
+        SignalRing(ring);
+        src += count;
+        len -= count;
+    }
+
+    return 0;
+}
+
+// Client side
+
+JackShmClientRequest::JackShmClientRequest():JackShmRequestEnd(), fServerFd(-1)
+{}
+
+JackShmClientRequest::~JackShmClientRequest()
+{
+    Close();
+}
+
+int JackShmClientRequest::Allocate(int shared_client, int server_fd)
+{
+    // The segment has no path : the server only gets its descriptor, sent on the client socket
+    snprintf(fName, sizeof(fName), "jack_req.%d", shared_client);
+    jack_log("JackShmClientRequest::Allocate name = %s", fName);
+
+#ifdef SYS_memfd_create
+    if ((fSharedMem = ::syscall(SYS_memfd_create, fName, MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0) {
+        jack_log("JackShmClientRequest::Allocate can't create memfd name = %s err = %s", fName, strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(fSharedMem, sizeof(JackShmRequestBlock)) != 0
+        || fcntl(fSharedMem, F_ADD_SEALS, SHM_REQUEST_SEALS) != 0) {
+        jack_error("JackShmClientRequest::Allocate can't set shared memory size name = %s err = %s", fName, strerror(errno));
+        close(fSharedMem);
+        fSharedMem = -1;
+        return -1;
+    }
+
+    if (Map() < 0) {
+        return -1;
+    }
+
+    memset(fBlock, 0, sizeof(JackShmRequestBlock));
+    fServerFd = server_fd;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+int JackShmClientRequest::Close()
+{
+    if (fBlock) {
+        jack_log("JackShmClientRequest::Close name = %s", fName);
+        Shutdown();
+        Unmap();
+    }
+    return 0;
+}
+
+bool JackShmClientRequest::IsPeerAlive()
+{
+    // Nothing is expected on the request socket while a request is pending in shared memory : any event means it has been closed
+    struct pollfd pfd = { fServerFd, POLLIN, 0 };
+    return (fServerFd < 0) || (poll(&pfd, 1, 0) == 0);
+}
+
+int JackShmClientRequest::Read(void* data, int len)
+{
+    return (fBlock) ? ReadRing(&fBlock->fResult, data, len) : -1;
+}
+
+int JackShmClientRequest::Write(void* data, int len)
+{
+    return (fBlock) ? WriteRing(&fBlock->fRequest, data, len) : -1;
+}
+
+// Server side
+
+JackShmServerRequest::JackShmServerRequest():JackShmRequestEnd()
+{}
+
+JackShmServerRequest::~JackShmServerRequest()
+{
+    Close();
+}
+
+int JackShmServerRequest::Connect(int fd)
+{
+    struct stat info;
+    snprintf(fName, sizeof(fName), "jack_req.fd%d", fd);
+    jack_log("JackShmServerRequest::Connect name = %s", fName);
+
+    // The client may still write in the segment, but it must not be able to resize it
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(JackShmRequestBlock)
+        || (fcntl(fd, F_GET_SEALS) & SHM_REQUEST_SEALS) != SHM_REQUEST_SEALS) {
+        jack_error("JackShmServerRequest::Connect name = %s is not a sealed request segment", fName);
+        close(fd);
+        return -1;
+    }
+
+    fSharedMem = fd;
+    return Map();
+}
+
+int JackShmServerRequest::Close()
+{
+    if (fBlock) {
+        jack_log("JackShmServerRequest::Close name = %s", fName);
+        Shutdown();
+        Unmap();
+    }
+    return 0;
+}
+
+int JackShmServerRequest::Read(void* data, int len)
+{
+    return (fBlock) ? ReadRing(&fBlock->fRequest, data, len) : -1;
+}
+
+int JackShmServerRequest::Write(void* data, int len)
+{
+    return (fBlock) ? WriteRing(&fBlock->fResult, data, len) : -1;
+}
+
+} // end of namespace
+
@@ -0,0 +1,151 @@
+/*
+Copyright (C) 2026 JACK developers
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation; either version 2.1 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+*/
+
+#ifndef __JackLinuxShmRequest__
+#define __JackLinuxShmRequest__
+
+#include "JackChannel.h"
+#include "JackConstants.h"
+#include "JackCompilerDeps.h"
+#include <stdint.h>
+
+namespace Jack
+{
+
+#define SHM_REQUEST_RING_SIZE   16384   // must be a power of two
+#define SHM_REQUEST_SPIN        2000    // polling loops before sleeping on the futex, on SMP only
+#define SHM_REQUEST_TIME_OUT    1000    // in ms, to check peer state while waiting
+
+/*!
+\brief Byte stream between two processes in shared memory.
+
+ A single producer/single consumer ring : the futex word is bumped each time one side makes progress,
+ and only woken when the other side actually sleeps on it.
+*/
+
+struct JackShmRequestRing
+{
+    uint32_t fWrite;        // total written bytes
+    uint32_t fRead;         // total read bytes
+    int fSeq;               // futex word
+    int fWaiters;
+    char fBuffer[SHM_REQUEST_RING_SIZE];
+};
+
+/*!
+\brief Request/result channel shared between a client and the server.
+*/
+
+struct JackShmRequestBlock
+{
+    int fClosed;
+    JackShmRequestRing fRequest;   // client to server
+    JackShmRequestRing fResult;    // server to client
+};
+
+/*!
+\brief Common part of both channel ends.
+*/
+
+class SERVER_EXPORT JackShmRequestEnd
+{
+
+    protected:
+
+        char fName[SYNC_MAX_NAME_SIZE + 1];
+        int fSharedMem;
+        int fSpin;
+        JackShmRequestBlock* fBlock;
+
+        int ReadRing(JackShmRequestRing* ring, void* data, int len);
+        int WriteRing(JackShmRequestRing* ring, void* data, int len);
+
+        bool WaitRing(JackShmRequestRing* ring, uint32_t seq);
+        void SignalRing(JackShmRequestRing* ring);
+
+        // Called when the peer did not make progress during SHM_REQUEST_TIME_OUT
+        virtual bool IsPeerAlive() { return true; }
+
+        // Maps fSharedMem, closes it on failure
+        int Map();
+        void Unmap();
+
+    public:
+
+        JackShmRequestEnd();
+        virtual ~JackShmRequestEnd();
+
+        const char* GetName() { return fName; }
+        int GetFd() { return fSharedMem; }
+
+        // Wakes up both sides, pending and next Read/Write will fail
+        void Shutdown();
+};
+
+/*!
+\brief Client side : allocates the channel and sends requests in it.
+*/
+
+class SERVER_EXPORT JackShmClientRequest : public detail::JackClientRequestInterface, public JackShmRequestEnd
+{
+
+    private:
+
+        int fServerFd;  // request socket, used to detect a dead server
+
+        bool IsPeerAlive();
+
+    public:
+
+        JackShmClientRequest();
+        virtual ~JackShmClientRequest();
+
+        int Allocate(int shared_client, int server_fd);
+        int Close();
+
+        int Read(void* data, int len);
+        int Write(void* data, int len);
+
+};
+
+/*!
+\brief Server side : receives requests from the channel allocated by the client.
+*/
+
+class SERVER_EXPORT JackShmServerRequest : public detail::JackChannelTransactionInterface, public JackShmRequestEnd
+{
+
+    public:
+
+        JackShmServerRequest();
+        virtual ~JackShmServerRequest();
+
+        // Takes ownership of fd, a segment received from the client
+        int Connect(int fd);
+        int Close();
+
+        int Read(void* data, int len);
+        int Write(void* data, int len);
+
+};
+
+} // end of namespace
+
+#endif
+
@@ -138,16 +138,14 @@ static jack_time_t jack_get_microseconds_from_system (void)
 
 #else
 
+/* CLOCK_MONOTONIC rather than CLOCK_MONOTONIC_RAW : timers (timerfd, clock_nanosleep)
+   can then be armed at absolute JACK times */
 static jack_time_t jack_get_microseconds_from_system (void)
 {
 	jack_time_t jackTime;
 	struct timespec time;
 
-#ifdef CLOCK_MONOTONIC_RAW
-	clock_gettime(CLOCK_MONOTONIC_RAW, &time);
-#else
 	clock_gettime(CLOCK_MONOTONIC, &time);
-#endif
 	jackTime = (jack_time_t) time.tv_sec * 1e6 +
 		(jack_time_t) time.tv_nsec / 1e3;
 	return jackTime;
@@ -212,6 +210,15 @@ SERVER_EXPORT jack_time_t GetMicroSeconds()
 	return _jack_get_microseconds();
 }
 
+SERVER_EXPORT int GetMicroSecondsClock()
+{
+#ifdef HAVE_CLOCK_GETTIME
+	return (_jack_get_microseconds == jack_get_microseconds_from_system) ? CLOCK_MONOTONIC : -1;
+#else
+	return -1;
+#endif
+}
+
 SERVER_EXPORT jack_time_t jack_get_microseconds()
 {
 	return _jack_get_microseconds();
@@ -495,6 +495,11 @@ void JackAlsaDriver::SetTimetAux(jack_time_t time)
     fBeginDateUst = time;
 }
 
+void JackAlsaDriver::SetHardwareTimeAux(jack_time_t time)
+{
+    fHardwareDateUst = time;
+}
+
 int JackAlsaDriver::PortSetDefaultMetadata(jack_port_id_t port_id, const char* pretty_name)
 {
     return fEngine->PortSetDefaultMetadata(fClientControl.fRefNum, port_id, pretty_name);
@@ -949,6 +954,11 @@ void SetTime(jack_time_t time)
     g_alsa_driver->SetTimetAux(time);
 }
 
+void SetHardwareTime(jack_time_t time)
+{
+    g_alsa_driver->SetHardwareTimeAux(time);
+}
+
 int Restart()
 {
     int res;
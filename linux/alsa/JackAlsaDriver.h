@@ -93,6 +93,7 @@ class JackAlsaDriver : public JackAudioDriver
         void ClearOutputAux();
         void WriteOutputAux(jack_nframes_t orig_nframes, snd_pcm_sframes_t contiguous, snd_pcm_sframes_t nwritten);
         void SetTimetAux(jack_time_t time);
+        void SetHardwareTimeAux(jack_time_t time);
 
         int PortSetDefaultMetadata(jack_port_id_t port_id, const char* pretty_name);
 
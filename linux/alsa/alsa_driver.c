@@ -32,6 +32,7 @@
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <time.h>
 #include <string.h>
 
 #include "alsa_driver.h"
@@ -363,6 +364,7 @@ alsa_driver_configure_stream (alsa_driver_t *driver, char *device_name,
 			      unsigned long sample_width)
 {
 	int err, format;
+	int tstamp_clock;
 	unsigned int frame_rate;
 	snd_pcm_uframes_t stop_th;
 	static struct {
@@ -591,10 +593,12 @@ alsa_driver_configure_stream (alsa_driver_t *driver, char *device_name,
 		return -1;
 	}
 
+	tstamp_clock = CLOCK_REALTIME;
 	err = snd_pcm_sw_params_set_tstamp_mode(handle, sw_params, SND_PCM_TSTAMP_ENABLE);
 	if (err < 0) {
 		jack_info("Could not enable ALSA time stamp mode for %s (err %d)",
 			  stream_name, err);
+		tstamp_clock = -1;
 	}
 
 #if SND_LIB_MAJOR >= 1 && SND_LIB_MINOR >= 1
@@ -602,9 +606,16 @@ alsa_driver_configure_stream (alsa_driver_t *driver, char *device_name,
 	if (err < 0) {
 		jack_info("Could not use monotonic ALSA time stamps for %s (err %d)",
 			  stream_name, err);
+	} else if (tstamp_clock >= 0) {
+		tstamp_clock = CLOCK_MONOTONIC;
 	}
 #endif
 
+	/* the period date is taken from the capture stream when there is one */
+	if (handle == driver->capture_handle || driver->capture_handle == NULL) {
+		driver->tstamp_clock = tstamp_clock;
+	}
+
 	if ((err = snd_pcm_sw_params (handle, sw_params)) < 0) {
 		jack_error ("ALSA: cannot set software parameters for %s\n",
 			    stream_name);
@@ -1280,6 +1291,47 @@ alsa_driver_set_clock_sync_status (alsa_driver_t *driver, channel_t chn,
 
 static int under_gdb = FALSE;
 
+/* Date of the end of the period in jack_get_microseconds() time, computed
+ * from the ALSA timestamp of the last hardware pointer update, so without
+ * the wakeup latency of the driver thread. 0 when there is no usable
+ * timestamp.
+ */
+static jack_time_t
+alsa_driver_period_date (alsa_driver_t *driver)
+{
+	snd_pcm_t *handle = driver->capture_handle ? driver->capture_handle : driver->playback_handle;
+	snd_pcm_uframes_t avail;
+	snd_htimestamp_t tstamp;
+	struct timespec now;
+	jack_time_t now_usecs;
+	int64_t age;
+
+	if (driver->tstamp_clock < 0
+	    || snd_pcm_htimestamp (handle, &avail, &tstamp) < 0
+	    || (tstamp.tv_sec == 0 && tstamp.tv_nsec == 0)
+	    || avail < driver->frames_per_cycle) {
+		return 0;
+	}
+
+	/* only time differences are taken in the ALSA clock, which may not
+	 * be the one of jack_get_microseconds() */
+	now_usecs = jack_get_microseconds ();
+	if (clock_gettime (driver->tstamp_clock, &now) < 0) {
+		return 0;
+	}
+
+	/* age of the timestamp, plus the time the frames past the period took */
+	age = (int64_t) (now.tv_sec - tstamp.tv_sec) * 1000000
+		+ (now.tv_nsec - tstamp.tv_nsec) / 1000
+		+ (int64_t) (avail - driver->frames_per_cycle) * 1000000 / driver->frame_rate;
+
+	if (age < 0 || age > 4 * (int64_t) driver->period_usecs) {
+		return 0;
+	}
+
+	return now_usecs - age;
+}
+
 jack_nframes_t
 alsa_driver_wait (alsa_driver_t *driver, int extra_fd, int *status, float
 		  *delayed_usecs)
@@ -1407,6 +1459,7 @@ alsa_driver_wait (alsa_driver_t *driver, int extra_fd, int *status, float
 
         // JACK2
         SetTime(poll_ret);
+        SetHardwareTime(alsa_driver_period_date(driver));
 
 		if (extra_fd < 0) {
 			if (driver->poll_next && poll_ret > driver->poll_next) {
@@ -2075,6 +2128,7 @@ alsa_driver_new (char *name, char *playback_alsa_device,
 	driver->clock_sync_listeners = 0;
 
 	driver->poll_late = 0;
+	driver->tstamp_clock = -1;
 	driver->xrun_count = 0;
 	driver->process_count = 0;
 
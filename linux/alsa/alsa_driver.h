@@ -61,6 +61,7 @@ typedef struct _alsa_driver {
     int                           poll_timeout;
     jack_time_t                   poll_last;
     jack_time_t                   poll_next;
+    int                           tstamp_clock; /* clock of the hardware timestamps, -1 if none */
     char                        **playback_addr;
     char                        **capture_addr;
     const snd_pcm_channel_area_t *capture_areas;
@@ -277,6 +278,7 @@ void MonitorInput();
 void ClearOutput();
 void WriteOutput(jack_nframes_t orig_nframes, snd_pcm_sframes_t contiguous, snd_pcm_sframes_t nwritten);
 void SetTime(jack_time_t time);
+void SetHardwareTime(jack_time_t time);
 int Restart();
 
 #ifdef __cplusplus
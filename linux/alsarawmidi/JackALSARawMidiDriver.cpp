@@ -22,6 +22,7 @@ Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 #include <stdexcept>
 
 #include <alsa/asoundlib.h>
+#include <sys/timerfd.h>
 
 #include "JackALSARawMidiDriver.h"
 #include "JackALSARawMidiUtil.h"
@@ -45,6 +46,8 @@ JackALSARawMidiDriver::JackALSARawMidiDriver(const char *name,
     output_ports = 0;
     output_port_timeouts = 0;
     poll_fds = 0;
+    timer_armed = false;
+    timer_fd = -1;
 }
 
 JackALSARawMidiDriver::~JackALSARawMidiDriver()
@@ -150,37 +153,40 @@ JackALSARawMidiDriver::Execute()
         struct timespec *timeout_ptr;
         if (! timeout_frame) {
             timeout_ptr = 0;
+            if (timer_armed) {
+                SetTimer(0);
+            }
         } else {
 
-            // The timeout value is relative to the time that
-            // 'GetMicroSeconds()' is called, not the time that 'poll()' is
-            // called.  This means that the amount of time that passes between
-            // 'GetMicroSeconds()' and 'ppoll()' is time that will be lost
-            // while waiting for 'poll() to timeout.
-            //
-            // I tried to replace the timeout with a 'timerfd' with absolute
-            // times, but, strangely, it actually slowed things down, and made
-            // the code a lot more complicated.
+            // A relative 'ppoll()' timeout is relative to the time that
+            // 'GetMicroSeconds()' is called, not the time that 'ppoll()' is
+            // called, so the time that passes in between is lost while
+            // waiting.  When the timer descriptor is available, it's armed
+            // at the JACK time of the event's frame, as an absolute time of
+            // the clock that JACK time is read from, and 'ppoll()' waits
+            // without a timeout until the timer expires.
             //
-            // I wonder about using the 'epoll' interface instead of 'ppoll()'.
-            // The problem with the 'epoll' interface is that the timeout
-            // resolution of 'epoll_wait()' is set in milliseconds.  We need
-            // microsecond resolution.  Without microsecond resolution, we
-            // impose the same jitter as USB MIDI.
+            // 'epoll_wait()' isn't used, as its timeout resolution is set in
+            // milliseconds.  We need microsecond resolution.  Without
+            // microsecond resolution, we impose the same jitter as USB MIDI.
             //
-            // Another problem is that 'ppoll()' returns later than the wait
+            // 'ppoll()' and the timer may still return later than the wait
             // time.  The problem can be minimized with high precision timers.
 
             timeout_ptr = &timeout;
             jack_time_t next_time = GetTimeFromFrames(timeout_frame);
-            jack_time_t now = GetMicroSeconds();
-            if (next_time <= now) {
-                timeout.tv_sec = 0;
-                timeout.tv_nsec = 0;
+            if ((timer_fd != -1) && SetTimer(next_time)) {
+                timeout_ptr = 0;
             } else {
-                jack_time_t wait_time = next_time - now;
-                timeout.tv_sec = wait_time / 1000000;
-                timeout.tv_nsec = (wait_time % 1000000) * 1000;
+                jack_time_t now = GetMicroSeconds();
+                if (next_time <= now) {
+                    timeout.tv_sec = 0;
+                    timeout.tv_nsec = 0;
+                } else {
+                    jack_time_t wait_time = next_time - now;
+                    timeout.tv_sec = wait_time / 1000000;
+                    timeout.tv_nsec = (wait_time % 1000000) * 1000;
+                }
             }
         }
         int poll_result = ppoll(poll_fds, poll_fd_count, timeout_ptr, 0);
@@ -198,6 +204,21 @@ JackALSARawMidiDriver::Execute()
                        strerror(errno));
             break;
         }
+
+        // An expired timer isn't an I/O event.  It's consumed here, so that
+        // a timer expiration alone is handled like a 'ppoll()' timeout.
+
+        if ((timer_fd != -1) && poll_fds[1].revents) {
+            uint64_t expirations;
+            if (read(timer_fd, &expirations, sizeof(expirations)) == -1) {
+                if (errno != EAGAIN) {
+                    jack_error("JackALSARawMidiDriver::Execute - timer read "
+                               "error: %s", strerror(errno));
+                }
+            }
+            timer_armed = false;
+            poll_result--;
+        }
         jack_nframes_t port_timeout;
         timeout_frame = 0;
         if (! poll_result) {
@@ -276,6 +297,37 @@ JackALSARawMidiDriver::Execute()
     return false;
 }
 
+bool
+JackALSARawMidiDriver::SetTimer(jack_time_t deadline)
+{
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = 0;
+    spec.it_interval.tv_nsec = 0;
+    if (! deadline) {
+
+        // Disarm the timer.
+
+        spec.it_value.tv_sec = 0;
+        spec.it_value.tv_nsec = 0;
+        timer_armed = false;
+        return ! timerfd_settime(timer_fd, 0, &spec, 0);
+    }
+
+    // The timer is created on the clock that JACK time is read from, so
+    // the deadline is the JACK time itself.  A deadline that has already
+    // passed expires immediately.
+
+    spec.it_value.tv_sec = deadline / 1000000;
+    spec.it_value.tv_nsec = (deadline % 1000000) * 1000;
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, 0)) {
+        jack_error("JackALSARawMidiDriver::SetTimer - timerfd_settime: %s",
+                   strerror(errno));
+        return false;
+    }
+    timer_armed = true;
+    return true;
+}
+
 void
 JackALSARawMidiDriver::
 FreeDeviceInfo(std::vector<snd_rawmidi_info_t *> *in_info_list,
@@ -500,7 +552,25 @@ JackALSARawMidiDriver::Start()
     jack_info("JackALSARawMidiDriver::Start - Starting 'alsarawmidi' driver.");
 
     JackMidiDriver::Start();
-    poll_fd_count = 1;
+
+    // Output events are scheduled with an absolute timer when possible.  If
+    // JACK time isn't read from a clock that timers can use (HPET), or the
+    // timer can't be created, 'ppoll()' timeouts are used instead.
+
+    int clock = GetMicroSecondsClock();
+    if (clock == -1) {
+        timer_fd = -1;
+        jack_info("JackALSARawMidiDriver::Start - JACK time isn't read from "
+                  "a POSIX clock.  Using poll timeouts for output "
+                  "scheduling.");
+    } else if ((timer_fd = timerfd_create(clock, TFD_CLOEXEC | TFD_NONBLOCK))
+               == -1) {
+        jack_info("JackALSARawMidiDriver::Start - timerfd_create: %s.  "
+                  "Using poll timeouts for output scheduling.",
+                  strerror(errno));
+    }
+    timer_armed = false;
+    poll_fd_count = (timer_fd == -1) ? 1 : 2;
     for (int i = 0; i < fCaptureChannels; i++) {
         poll_fd_count += input_ports[i]->GetPollDescriptorCount();
     }
@@ -512,7 +582,7 @@ JackALSARawMidiDriver::Start()
     } catch (std::exception& e) {
         jack_error("JackALSARawMidiDriver::Start - creating poll descriptor "
                    "structures failed: %s", e.what());
-        return -1;
+        goto close_timer;
     }
     if (fPlaybackChannels) {
         try {
@@ -534,6 +604,11 @@ JackALSARawMidiDriver::Start()
     poll_fds[0].events = POLLERR | POLLIN | POLLNVAL;
     poll_fds[0].fd = fds[0];
     poll_fd_iter = poll_fds + 1;
+    if (timer_fd != -1) {
+        poll_fd_iter->events = POLLERR | POLLIN | POLLNVAL;
+        poll_fd_iter->fd = timer_fd;
+        poll_fd_iter++;
+    }
     for (int i = 0; i < fCaptureChannels; i++) {
         JackALSARawMidiInputPort *input_port = input_ports[i];
         input_port->PopulatePollDescriptors(poll_fd_iter);
@@ -566,6 +641,11 @@ JackALSARawMidiDriver::Start()
  free_poll_descriptors:
     delete[] poll_fds;
     poll_fds = 0;
+ close_timer:
+    if (timer_fd != -1) {
+        close(timer_fd);
+        timer_fd = -1;
+    }
     return -1;
 }
 
@@ -607,6 +687,10 @@ JackALSARawMidiDriver::Stop()
         delete[] poll_fds;
         poll_fds = 0;
     }
+    if (timer_fd != -1) {
+        close(timer_fd);
+        timer_fd = -1;
+    }
     if (result) {
         jack_error("JackALSARawMidiDriver::Stop - could not %s MIDI "
                    "processing thread.", verb);
@@ -44,6 +44,8 @@ namespace Jack {
         nfds_t poll_fd_count;
         struct pollfd *poll_fds;
         JackThread *thread;
+        bool timer_armed;
+        int timer_fd;
 
         void
         FreeDeviceInfo(std::vector<snd_rawmidi_info_t *> *in_info_list,
@@ -57,6 +59,9 @@ namespace Jack {
         HandleALSAError(const char *driver_func, const char *alsa_func,
                         int code);
 
+        bool
+        SetTimer(jack_time_t deadline);
+
     public:
 
         JackALSARawMidiDriver(const char *name, const char *alias,
@@ -32,7 +32,7 @@ namespace Jack
 \brief A synchronization primitive built using a condition variable.
 */
 
-class JackPosixProcessSync : public JackBasePosixMutex
+class SERVER_EXPORT JackPosixProcessSync : public JackBasePosixMutex
 {
 
     private:
@@ -24,6 +24,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackGlobals.h"
 #include <string.h> // for memset
 #include <unistd.h> // for _POSIX_PRIORITY_SCHEDULING check
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 //#define JACK_SCHED_POLICY SCHED_RR
 #define JACK_SCHED_POLICY SCHED_FIFO
@@ -35,6 +38,12 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 namespace Jack
 {
 
+#ifdef __linux__
+// CPUs left to non RT threads when some are reserved for RT threads
+static cpu_set_t gNonRealTimeCpus;
+static bool gNonRealTimeCpusSet = false;
+#endif
+
 void* JackPosixThread::ThreadHandler(void* arg)
 {
     JackPosixThread* obj = (JackPosixThread*)arg;
@@ -141,6 +150,11 @@ int JackPosixThread::StartImp(jack_native_thread_t* thread, int priority, int re
         if ((res = pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED))) {
             jack_log("Cannot request explicit scheduling for non RT thread res = %d", res);
         }
+#ifdef __linux__
+        if (gNonRealTimeCpusSet && (res = pthread_attr_setaffinity_np(&attributes, sizeof(cpu_set_t), &gNonRealTimeCpus))) {
+            jack_log("Cannot keep non RT thread off RT CPUs res = %d", res);
+        }
+#endif
     }
 
     if ((res = pthread_attr_setstacksize(&attributes, THREAD_STACK))) {
@@ -280,6 +294,54 @@ int JackPosixThread::DropRealTimeImp(jack_native_thread_t thread)
     return 0;
 }
 
+int JackPosixThread::SetSelfAffinity(int cpu)
+{
+    return SetAffinityImp(pthread_self(), cpu);
+}
+
+int JackPosixThread::SetAffinityImp(jack_native_thread_t thread, int cpu)
+{
+#ifdef __linux__
+    cpu_set_t cpus;
+    int res;
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return -1;
+    }
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    jack_log("JackPosixThread::SetAffinityImp cpu = %d", cpu);
+
+    if ((res = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpus)) != 0) {
+        jack_error("Cannot set thread affinity to CPU %d (%s)", cpu, strerror(res));
+        return -1;
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+void JackPosixThread::SetRealTimeCpus(const int* cpus, int count)
+{
+#ifdef __linux__
+    // Non RT threads started afterwards run on the CPUs of the process that are not reserved
+    if (count == 0 || sched_getaffinity(0, sizeof(cpu_set_t), &gNonRealTimeCpus) != 0) {
+        gNonRealTimeCpusSet = false;
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] < CPU_SETSIZE) {
+            CPU_CLR(cpus[i], &gNonRealTimeCpus);
+        }
+    }
+    gNonRealTimeCpusSet = (CPU_COUNT(&gNonRealTimeCpus) > 0);
+    if (!gNonRealTimeCpusSet) {
+        jack_info("All CPUs are reserved for RT threads, non RT threads are not restricted");
+    }
+#endif
+}
+
 jack_native_thread_t JackPosixThread::GetThreadID()
 {
     return fThread;
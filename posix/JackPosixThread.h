@@ -67,6 +67,8 @@ class SERVER_EXPORT JackPosixThread : public detail::JackThreadInterface
         int DropRealTime();                     // Used when called from another thread
         int DropSelfRealTime();                 // Used when called from thread itself
 
+        int SetSelfAffinity(int cpu);           // Used when called from thread itself
+
         jack_native_thread_t GetThreadID();
         bool IsThread();
 
@@ -76,6 +78,8 @@ class SERVER_EXPORT JackPosixThread : public detail::JackThreadInterface
             return JackPosixThread::AcquireRealTimeImp(thread, priority);
         }
         static int DropRealTimeImp(jack_native_thread_t thread);
+        static int SetAffinityImp(jack_native_thread_t thread, int cpu);
+        static void SetRealTimeCpus(const int* cpus, int count);
         static int StartImp(jack_native_thread_t* thread, int priority, int realtime, void*(*start_routine)(void*), void* arg);
         static int StopImp(jack_native_thread_t thread);
         static int KillImp(jack_native_thread_t thread);
@@ -27,6 +27,13 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include <pthread.h>
 #include <fcntl.h>
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
 namespace Jack
 {
 
@@ -256,6 +263,85 @@ int JackClientSocket::Write(void* data, int len)
     }
 }
 
+// Descriptors are sent as SCM_RIGHTS ancillary data of a one byte message
+int JackClientSocket::ReadFds(int* fds, int count)
+{
+    char byte;
+    struct iovec iov = { &byte, 1 };
+    union {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int) * JACK_SOCKET_FDS_MAX)];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    if (count <= 0 || count > JACK_SOCKET_FDS_MAX) {
+        return -1;
+    }
+
+    int res;
+    do {
+        res = recvmsg(fSocket, &msg, MSG_CMSG_CLOEXEC);
+    } while (res < 0 && errno == EINTR);
+
+    if (res != 1) {
+        jack_error("Cannot read descriptors on socket fd = %d err = %s", fSocket, strerror(errno));
+        return -1;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS
+        || cmsg->cmsg_len != CMSG_LEN(sizeof(int) * count) || (msg.msg_flags & MSG_CTRUNC)) {
+        jack_error("Cannot read %d descriptors on socket fd = %d", count, fSocket);
+        return -1;
+    }
+
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * count);
+    return 0;
+}
+
+int JackClientSocket::WriteFds(int* fds, int count)
+{
+    char byte = 0;
+    struct iovec iov = { &byte, 1 };
+    union {
+        struct cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int) * JACK_SOCKET_FDS_MAX)];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    memset(&control, 0, sizeof(control));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    if (count <= 0 || count > JACK_SOCKET_FDS_MAX) {
+        return -1;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+
+    int res;
+    do {
+        res = sendmsg(fSocket, &msg, MSG_NOSIGNAL);
+    } while (res < 0 && errno == EINTR);
+
+    if (res != 1) {
+        jack_error("Cannot write descriptors on socket fd = %d err = %s", fSocket, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
 JackServerSocket::JackServerSocket(): fSocket( -1)
 {
     const char* promiscuous = getenv("JACK_PROMISCUOUS_SERVER");
@@ -34,6 +34,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 namespace Jack
 {
 
+#define JACK_SOCKET_FDS_MAX 253     // SCM_MAX_FD, the most descriptors the kernel passes in one message
+
 /*!
 \brief Client socket.
 */
@@ -57,6 +59,8 @@ class JackClientSocket : public detail::JackClientRequestInterface
         int Close();
         int Read(void* data, int len);
         int Write(void* data, int len);
+        int ReadFds(int* fds, int count);
+        int WriteFds(int* fds, int count);
         int GetFd()
         {
             return fSocket;
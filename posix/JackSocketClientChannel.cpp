@@ -22,6 +22,8 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackClient.h"
 #include "JackGlobals.h"
 #include "JackError.h"
+#include "JackNotification.h"
+#include "shm.h"
 
 namespace Jack
 {
@@ -29,13 +31,21 @@ namespace Jack
 JackSocketClientChannel::JackSocketClientChannel()
     :JackGenericClientChannel(), fThread(this)
 {
-    fRequest = new JackClientSocket();
+    fRequestSocket = new JackClientSocket();
+    fRequest = fRequestSocket;
     fNotificationSocket = NULL;
+#ifdef __linux__
+    fShmRequest = NULL;
+    fServerName[0] = 0;
+#endif
 }
 
 JackSocketClientChannel::~JackSocketClientChannel()
 {
-    delete fRequest;
+#ifdef __linux__
+    delete fShmRequest;
+#endif
+    delete fRequestSocket;
     delete fNotificationSocket;
 }
 
@@ -54,6 +64,9 @@ int JackSocketClientChannel::Open(const char* server_name, const char* name, jac
     
     // OK so server is there...
     JackGlobals::fServerRunning = true;
+#ifdef __linux__
+    snprintf(fServerName, sizeof(fServerName), "%s", server_name);
+#endif
 
     // Check name in server
     ClientCheck(name, uuid, name_res, JACK_PROTOCOL_VERSION, (int)options, (int*)status, &result, true);
@@ -82,6 +95,14 @@ error:
 
 void JackSocketClientChannel::Close()
 {
+#ifdef __linux__
+    if (fShmRequest) {
+        fShmRequest->Close();
+        delete fShmRequest;
+        fShmRequest = NULL;
+    }
+#endif
+    fRequest = fRequestSocket;
     fRequest->Close();
     fNotificationListenSocket.Close();
     if (fNotificationSocket) {
@@ -89,6 +110,46 @@ void JackSocketClientChannel::Close()
     }
 }
 
+void JackSocketClientChannel::ClientOpen(const char* name, int pid, jack_uuid_t uuid, int* shared_engine, int* shared_client, int* shared_graph, int* result)
+{
+    JackGenericClientChannel::ClientOpen(name, pid, uuid, shared_engine, shared_client, shared_graph, result);
+#ifdef __linux__
+    if (*result == 0 && !getenv("JACK_NO_SHM_REQUEST")) {
+        ShmRequestOpen(*shared_client);
+    }
+#endif
+}
+
+void JackSocketClientChannel::ClientClose(int refnum, int* result)
+{
+    // Done on the socket, so that the server releases both channels together
+    fRequest = fRequestSocket;
+    JackGenericClientChannel::ClientClose(refnum, result);
+}
+
+#ifdef __linux__
+void JackSocketClientChannel::ShmRequestOpen(int shared_client)
+{
+    fShmRequest = new JackShmClientRequest();
+
+    if (fShmRequest->Allocate(shared_client, fRequestSocket->GetFd()) == 0) {
+        JackShmRequestOpenRequest req(fShmRequest->GetName(), fShmRequest->GetFd());
+        JackResult res;
+        int result;
+        ServerSyncCall(&req, &res, &result);
+        if (result == 0) {
+            jack_log("JackSocketClientChannel::ShmRequestOpen name = %s", fShmRequest->GetName());
+            fRequest = fShmRequest;
+            return;
+        }
+    }
+
+    jack_log("JackSocketClientChannel::ShmRequestOpen : requests will use the socket");
+    delete fShmRequest;
+    fShmRequest = NULL;
+}
+#endif
+
 int JackSocketClientChannel::Start()
 {
     jack_log("JackSocketClientChannel::Start");
@@ -140,6 +201,18 @@ bool JackSocketClientChannel::Execute()
         goto error;
     }
 
+#ifdef __linux__
+    // Descriptor of a new memfd port chunk, kept until the chunk is attached
+    if (event.fNotify == kAddPortChunk && event.fValue2 >= 0) {
+        int fd;
+        if (fNotificationSocket->ReadFds(&fd, 1) < 0) {
+            jack_error("JackSocketClientChannel read descriptor fail");
+            goto error;
+        }
+        jack_shm_set_fd(event.fValue2, fd);
+    }
+#endif
+
     res.fResult = fClient->ClientNotify(event.fRefNum, event.fName, event.fNotify, event.fSync, event.fMessage, event.fValue1, event.fValue2);
 
     if (event.fSync) {
@@ -24,6 +24,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackSocket.h"
 #include "JackPlatformPlug.h"
 #include "JackThread.h"
+#ifdef __linux__
+#include "JackLinuxShmRequest.h"
+#endif
 
 namespace Jack
 {
@@ -43,6 +46,13 @@ class JackSocketClientChannel : public JackGenericClientChannel, public JackRunn
         JackClientSocket* fNotificationSocket;      // Socket for server notification
         JackThread fThread;                         // Thread to execute the event loop
         JackClient* fClient;
+        JackClientSocket* fRequestSocket;           // Socket for requests
+#ifdef __linux__
+        JackShmClientRequest* fShmRequest;          // Shared memory for requests, when accepted by the server
+        char fServerName[JACK_SERVER_NAME_SIZE+1];
+
+        void ShmRequestOpen(int shared_client);
+#endif
 
     public:
 
@@ -55,6 +65,9 @@ class JackSocketClientChannel : public JackGenericClientChannel, public JackRunn
         int Start();
         void Stop();
 
+        void ClientOpen(const char* name, int pid, jack_uuid_t uuid, int* shared_engine, int* shared_client, int* shared_graph, int* result);
+        void ClientClose(int refnum, int* result);
+
         // JackRunnableInterface interface
         bool Init();
         bool Execute();
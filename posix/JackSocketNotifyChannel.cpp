@@ -21,6 +21,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackSocketNotifyChannel.h"
 #include "JackError.h"
 #include "JackConstants.h"
+#include "JackNotification.h"
+#include "shm.h"
+#include <unistd.h>
 
 namespace Jack
 {
@@ -49,15 +52,28 @@ void JackSocketNotifyChannel::Close()
 
 void JackSocketNotifyChannel::ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2, int* result)
 {
-    JackClientNotification event(name, refnum, notify, sync, message, value1, value2);
     JackResult res;
+    int fd = -1;
+
+    // With a memfd segment, the descriptor of the new port chunk follows the notification
+    if (notify == kAddPortChunk && (fd = jack_shm_dup_fd(value2)) < 0) {
+        value2 = -1;
+    }
+
+    JackClientNotification event(name, refnum, notify, sync, message, value1, value2);
 
     // Send notification
-    if (event.Write(&fNotifySocket) < 0) {
+    if (event.Write(&fNotifySocket) < 0 || (fd >= 0 && fNotifySocket.WriteFds(&fd, 1) < 0)) {
         jack_error("Could not write notification");
+        if (fd >= 0) {
+            close(fd);
+        }
         *result = -1;
         return;
     }
+    if (fd >= 0) {
+        close(fd);
+    }
 
     // Read the result in "synchronous" mode only
     if (sync) {
@@ -73,6 +89,19 @@ void JackSocketNotifyChannel::ClientNotify(int refnum, const char* name, int not
     }
 }
 
+void JackSocketNotifyChannel::ClientNotify(JackClientNotification* events, int count, int* result)
+{
+    JackClientNotificationBatch batch;
+
+    // Asynchronous notifications only, no result to read
+    if (batch.Send(&fNotifySocket, events, count) < 0) {
+        jack_error("Could not write notifications");
+        *result = -1;
+    } else {
+        *result = 0;
+    }
+}
+
 } // end of namespace
 
 
@@ -35,6 +35,84 @@ using namespace std;
 namespace Jack
 {
 
+#ifdef __linux__
+
+JackShmRequestHandler::JackShmRequestHandler(JackRequestDecoder* decoder, JackMutex* mutex)
+    :fThread(this), fDecoder(decoder), fMutex(mutex)
+{}
+
+JackShmRequestHandler::~JackShmRequestHandler()
+{}
+
+int JackShmRequestHandler::Open(int fd)
+{
+    if (fRequest.Connect(fd) < 0) {
+        return -1;
+    }
+
+    if (fThread.Start() != 0) {
+        jack_error("Cannot start shared memory request thread");
+        fRequest.Close();
+        return -1;
+    }
+
+    return 0;
+}
+
+void JackShmRequestHandler::Shutdown()
+{
+    fRequest.Shutdown();
+}
+
+void JackShmRequestHandler::Close()
+{
+    fRequest.Shutdown();
+    fThread.Stop();
+    fRequest.Close();
+}
+
+bool JackShmRequestHandler::Init()
+{
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &set, 0);
+    return true;
+}
+
+bool JackShmRequestHandler::Execute()
+{
+    // Decode header, waiting for the client
+    JackRequest header;
+    if (header.Read(&fRequest) < 0) {
+        jack_log("JackShmRequestHandler::Execute : channel %s is closed", fRequest.GetName());
+        return false;
+    }
+
+    // The client socket identifies the client : opening and closing it can only be done there
+    if (header.fType == JackRequest::kClientCheck
+        || header.fType == JackRequest::kClientOpen
+        || header.fType == JackRequest::kClientClose) {
+        jack_error("JackShmRequestHandler::Execute : request %d is only accepted on the client socket, closing channel %s", header.fType, fRequest.GetName());
+        fRequest.Shutdown();
+        return false;
+    }
+
+    fMutex->Lock();
+    try {
+        // Result is not needed here
+        fDecoder->HandleRequest(&fRequest, header.fType);
+    } catch (JackQuitException& e) {
+        jack_log("JackShmRequestHandler::Execute : JackQuitException");
+        fMutex->Unlock();
+        return false;
+    }
+    fMutex->Unlock();
+    return true;
+}
+
+#endif
+
 JackSocketServerChannel::JackSocketServerChannel():
     fThread(this), fDecoder(NULL)
 {
@@ -69,6 +147,17 @@ void JackSocketServerChannel::Close()
 {
    fRequestListenSocket.Close();
 
+#ifdef __linux__
+    // Close remaining shared memory channels
+    std::map<int, JackShmRequestHandler*>::iterator it_shm;
+
+    for (it_shm = fShmTable.begin(); it_shm != fShmTable.end(); it_shm++) {
+        fShmClosed.push_back((*it_shm).second);
+    }
+    fShmTable.clear();
+    ShmRequestRelease();
+#endif
+
     // Close remaining client sockets
     std::map<int, std::pair<int, JackClientSocket*> >::iterator it;
 
@@ -156,6 +245,9 @@ void JackSocketServerChannel::ClientRemove(detail::JackChannelTransactionInterfa
     assert(fd >= 0);
 
     jack_log("JackSocketServerChannel::ClientRemove ref = %d fd = %d", refnum, fd);
+#ifdef __linux__
+    ShmRequestClose(fd);
+#endif
     fSocketTable.erase(fd);
     socket->Close();
     delete socket;
@@ -170,10 +262,15 @@ void JackSocketServerChannel::ClientKill(int fd)
     assert(socket);
     
     jack_log("JackSocketServerChannel::ClientKill ref = %d fd = %d", refnum, fd);
+#ifdef __linux__
+    ShmRequestClose(fd);
+#endif
     if (refnum == -1) {  // Should never happen... correspond to a client that started the socket but never opened...
         jack_log("Client was not opened : probably correspond to server_check");
     } else {
+        fDecoderMutex.Lock();
         fServer->GetEngine()->ClientKill(refnum);
+        fDecoderMutex.Unlock();
     }
    
     fSocketTable.erase(fd);
@@ -182,6 +279,61 @@ void JackSocketServerChannel::ClientKill(int fd)
     fRebuild = true;
 }
 
+#ifdef __linux__
+
+int JackSocketServerChannel::ShmRequestOpen(detail::JackChannelTransactionInterface* socket_aux, int shm_fd)
+{
+    JackClientSocket* socket = dynamic_cast<JackClientSocket*>(socket_aux);
+    if (!socket) {
+        jack_error("JackSocketServerChannel::ShmRequestOpen : request is only accepted on the client socket");
+        close(shm_fd);
+        return -1;
+    }
+    int fd = GetFd(socket);
+    assert(fd >= 0);
+
+    if (fShmTable.find(fd) != fShmTable.end()) {
+        jack_error("JackSocketServerChannel::ShmRequestOpen : shared memory channel already opened fd = %d", fd);
+        close(shm_fd);
+        return -1;
+    }
+
+    JackShmRequestHandler* handler = new JackShmRequestHandler(fDecoder, &fDecoderMutex);
+    if (handler->Open(shm_fd) < 0) {
+        delete handler;
+        return -1;
+    }
+
+    jack_log("JackSocketServerChannel::ShmRequestOpen fd = %d", fd);
+    fShmTable[fd] = handler;
+    return 0;
+}
+
+void JackSocketServerChannel::ShmRequestClose(int fd)
+{
+    std::map<int, JackShmRequestHandler*>::iterator it = fShmTable.find(fd);
+
+    if (it != fShmTable.end()) {
+        jack_log("JackSocketServerChannel::ShmRequestClose fd = %d", fd);
+        // May be called while decoding a request : the handler thread is only joined in ShmRequestRelease
+        (*it).second->Shutdown();
+        fShmClosed.push_back((*it).second);
+        fShmTable.erase(it);
+    }
+}
+
+void JackSocketServerChannel::ShmRequestRelease()
+{
+    while (!fShmClosed.empty()) {
+        JackShmRequestHandler* handler = fShmClosed.front();
+        fShmClosed.pop_front();
+        handler->Close();
+        delete handler;
+    }
+}
+
+#endif
+
 void JackSocketServerChannel::BuildPoolTable()
 {
     if (fRebuild) {
@@ -242,7 +394,14 @@ bool JackSocketServerChannel::Execute()
                     // Decode request
                     } else {
                         // Result is not needed here
-                        fDecoder->HandleRequest(socket, header.fType);
+                        fDecoderMutex.Lock();
+                        try {
+                            fDecoder->HandleRequest(socket, header.fType);
+                        } catch (JackQuitException& e) {
+                            fDecoderMutex.Unlock();
+                            throw;
+                        }
+                        fDecoderMutex.Unlock();
                     }
                 }
             }
@@ -257,6 +416,9 @@ bool JackSocketServerChannel::Execute()
             }
         }
 
+#ifdef __linux__
+        ShmRequestRelease();
+#endif
         BuildPoolTable();
         return true;
 
@@ -23,15 +23,53 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "JackSocket.h"
 #include "JackPlatformPlug.h"
 #include "JackRequestDecoder.h"
+#ifdef __linux__
+#include "JackLinuxShmRequest.h"
+#endif
 
 #include <poll.h>
 #include <map>
+#include <list>
 
 namespace Jack
 {
 
 class JackServer;
 
+#ifdef __linux__
+
+/*!
+\brief Serves the requests of a client using a shared memory channel.
+*/
+
+class JackShmRequestHandler : public JackRunnableInterface
+{
+
+    private:
+
+        JackShmServerRequest fRequest;
+        JackThread fThread;
+        JackRequestDecoder* fDecoder;
+        JackMutex* fMutex;              // Requests are decoded one at a time, like on the sockets
+
+    public:
+
+        JackShmRequestHandler(JackRequestDecoder* decoder, JackMutex* mutex);
+        ~JackShmRequestHandler();
+
+        int Open(int fd);
+        void Close();
+
+        // Wakes up the handler thread, to be closed later without holding fMutex
+        void Shutdown();
+
+        // JackRunnableInterface interface
+        bool Init();
+        bool Execute();
+};
+
+#endif
+
 /*!
 \brief JackServerChannel using sockets.
 */
@@ -49,6 +87,14 @@ class JackSocketServerChannel : public JackRunnableInterface, public JackClientH
         pollfd* fPollTable;
         bool fRebuild;
         std::map<int, std::pair<int, JackClientSocket*> > fSocketTable;
+        JackMutex fDecoderMutex;
+#ifdef __linux__
+        std::map<int, JackShmRequestHandler*> fShmTable;    // Shared memory request channels, by socket fd
+        std::list<JackShmRequestHandler*> fShmClosed;
+
+        void ShmRequestClose(int fd);
+        void ShmRequestRelease();
+#endif
 
         void BuildPoolTable();
 
@@ -57,6 +103,7 @@ class JackSocketServerChannel : public JackRunnableInterface, public JackClientH
   
         void ClientAdd(detail::JackChannelTransactionInterface* socket, JackClientOpenRequest* req, JackClientOpenResult *res);
         void ClientRemove(detail::JackChannelTransactionInterface* socket, int refnum);
+        int ShmRequestOpen(detail::JackChannelTransactionInterface* socket, int fd);
 
         int GetFd(JackClientSocket* socket);
 
@@ -0,0 +1,212 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file activeclients.cpp
+ *
+ * @brief Measures the per cycle client bookkeeping of the engine : scanning the whole client table, or the active client index of the graph state.
+ *
+ * No server is needed : the loops of CalcCPULoad, CheckXRun and CheckAllRolling are run on a client table and a connection state built here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <getopt.h>
+#include <algorithm>
+#include <vector>
+#include "JackConnectionManager.h"
+#include "JackClientInterface.h"
+#include "JackClientControl.h"
+
+using namespace Jack;
+
+#define DRIVER_NUM  2
+
+class TestClient : public JackClientInterface
+{
+
+    private:
+
+        JackClientControl* fControl;
+
+    public:
+
+        TestClient(int refnum)
+        {
+            char name[JACK_CLIENT_NAME_SIZE + 1];
+            snprintf(name, sizeof(name), "client%d", refnum);
+            fControl = new JackClientControl(name, 0, refnum, JACK_UUID_EMPTY_INITIALIZER);
+            fControl->fActive = true;
+            fControl->fCallback[kRealTimeCallback] = true;
+            fControl->fTransportState = JackTransportRolling;
+        }
+        virtual ~TestClient()
+        {
+            delete fControl;
+        }
+
+        int Close()
+        {
+            return 0;
+        }
+
+        int ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2)
+        {
+            return 0;
+        }
+
+        JackClientControl* GetClientControl() const
+        {
+            return fControl;
+        }
+};
+
+static JackClientInterface* table[CLIENT_NUM];
+static JackClientTiming timing[CLIENT_NUM];
+static int iterations = 100000;
+
+static double now_nsec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_active_clients \n"
+            "              [ --iterations OR -i number_of_cycles (default 100000) ]\n"
+    );
+}
+
+// Same tests as the engine for a client at each cycle
+static inline int check_client(int i, jack_time_t date)
+{
+    JackClientInterface* client = table[i];
+    if (i >= DRIVER_NUM && client && client->GetClientControl()->fActive) {
+        int res = (timing[i].fStatus == Finished && timing[i].fFinishedAt > date);
+        res += (client->GetClientControl()->fTransportState != JackTransportRolling);
+        return res;
+    }
+    return 0;
+}
+
+static int table_cycle(jack_time_t date)
+{
+    int res = 0;
+    // CalcCPULoad, CheckXRun then CheckAllRolling
+    for (int loop = 0; loop < 3; loop++) {
+        for (int i = DRIVER_NUM; i < CLIENT_NUM; i++) {
+            res += check_client(i, date);
+        }
+    }
+    return res;
+}
+
+static int index_cycle(JackConnectionManager* manager, jack_time_t date)
+{
+    int res = 0;
+    for (int loop = 0; loop < 3; loop++) {
+        int count;
+        const jack_int_t* active = manager->GetActiveRefNums(&count);
+        for (int pos = 0; pos < count; pos++) {
+            res += check_client(active[pos], date);
+        }
+    }
+    return res;
+}
+
+static void measure(int clients)
+{
+    JackConnectionManager* manager = new JackConnectionManager();
+    std::vector<int> refnums;
+
+    // Clients are spread in the table, the way refnums get reused when clients come and go
+    for (int i = DRIVER_NUM; i < CLIENT_NUM; i++) {
+        refnums.push_back(i);
+    }
+    std::random_shuffle(refnums.begin(), refnums.end());
+    refnums.resize(std::min(clients, CLIENT_NUM - DRIVER_NUM));
+
+    for (size_t i = 0; i < refnums.size(); i++) {
+        int refnum = refnums[i];
+        table[refnum] = new TestClient(refnum);
+        timing[refnum].fStatus = Finished;
+        timing[refnum].fFinishedAt = refnum;
+        manager->ActivateRefNum(refnum);
+    }
+
+    int res = 0;
+    double start = now_nsec();
+    for (int i = 0; i < iterations; i++) {
+        res += table_cycle(i);
+    }
+    double table_time = (now_nsec() - start) / iterations;
+
+    start = now_nsec();
+    for (int i = 0; i < iterations; i++) {
+        res -= index_cycle(manager, i);
+    }
+    double index_time = (now_nsec() - start) / iterations;
+
+    printf("%3d clients : client table %8.1f nsec per cycle, active index %8.1f nsec per cycle%s\n",
+           (int)refnums.size(), table_time, index_time, (res != 0) ? " (results differ !)" : "");
+
+    for (size_t i = 0; i < refnums.size(); i++) {
+        delete table[refnums[i]];
+        table[refnums[i]] = NULL;
+        timing[refnums[i]].Init();
+    }
+    delete manager;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "i:h";
+    struct option long_options[] = {
+        {"iterations", 1, 0, 'i'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (iterations < 1) {
+        fprintf(stderr, "iterations must be at least 1\n");
+        return 1;
+    }
+
+    printf("client table size = %d, 3 loops per cycle\n", CLIENT_NUM);
+    measure(2);
+    measure(16);
+    measure(64);
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file clockfilter.cpp
+ *
+ * @brief Simulates a sound card clock and checks the rate error and lock time of the frame timer filters.
+ *
+ * No server is needed : the frame timer is fed the way the driver does, with wakeup dates that have a scheduling
+ * latency and, for the hardware date cases, the date of the period with a small timestamp jitter.
+ * The card runs off its nominal rate, and the dates jump once in the middle of the run, like after a long xrun.
+ * In the last case the driver stops giving hardware dates before the jump : the filter has to go back to wakeup dates.
+ * The noise is pseudo random with a fixed seed, so every run gives the same results.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "JackFrameTimer.h"
+
+using namespace Jack;
+
+#define SAMPLE_RATE     48000
+#define BUFFER_SIZE     256
+#define RATE_OFFSET     1e-4        // The card runs 100 ppm fast
+#define CYCLES          (60 * SAMPLE_RATE / BUFFER_SIZE)    // One minute
+#define JUMP_CYCLE      (CYCLES / 2)
+#define JUMP_USECS      5000.
+#define LOCK_PPM        20.         // Rate error under which the filter is locked
+#define MAX_PHASE_USECS 500.        // Error allowed on the date of the last period, wakeup dates are up to 120 usecs late
+
+struct Scenario {
+    const char* name;
+    jack_clock_filter_t filter;
+    bool hardware;                  // The driver gives the hardware date of the period
+    int hardware_cycles;            // Cycles after which the driver stops giving hardware dates, never when negative
+    double max_rate_ppm;            // Rate error allowed once locked, RMS over the last 10 seconds
+    double max_lock_secs;           // Time allowed to lock, at start and after the jump, not checked when negative
+};
+
+// Limits have about a factor 2 of margin on the results of the filters at the time this test was written.
+// The fixed 1/8 Hz DLL is the reference : with these wakeup outliers its rate error stays around LOCK_PPM.
+static const Scenario scenarios[] = {
+    { "dll, wakeup dates",              JackClockFilterDLL,         false,  -1,             30.,  -1. },
+    { "adaptive dll, wakeup dates",     JackClockFilterAdaptiveDLL, false,  -1,             1.,   6. },
+    { "kalman, wakeup dates",           JackClockFilterKalman,      false,  -1,             2.,   2. },
+    { "adaptive dll, hardware dates",   JackClockFilterAdaptiveDLL, true,   -1,             0.5,  3. },
+    { "kalman, hardware dates",         JackClockFilterKalman,      true,   -1,             1.,   1. },
+    { "kalman, hardware dates stop",    JackClockFilterKalman,      true,   JUMP_CYCLE / 2, 2.,   2. },
+};
+
+static unsigned int seed;
+
+static double uniform()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 16777216.;
+}
+
+static double gaussian()
+{
+    double u1 = uniform() + 1e-12;
+    double u2 = uniform();
+    return sqrt(-2. * log(u1)) * cos(6.2831853 * u2);
+}
+
+// Wakeups come 20 to 120 usecs after the period, and 1% of them are 1 to 3 msecs late
+static double wakeup_latency()
+{
+    double latency = 20. + 100. * uniform();
+    if (uniform() < 0.01) {
+        latency += 1000. + 2000. * uniform();
+    }
+    return latency;
+}
+
+// Returns the cycle from which the rate error stays under LOCK_PPM, in [first, last)
+static int lock_cycle(const double* rate_ppm, int first, int last)
+{
+    int cycle = last;
+    for (int i = last - 1; i >= first && fabs(rate_ppm[i]) < LOCK_PPM; i--) {
+        cycle = i;
+    }
+    return cycle;
+}
+
+static int run(const Scenario& scenario)
+{
+    JackFrameTimer* timer = new JackFrameTimer();
+    double* rate_ppm = new double[CYCLES];
+    double nominal_usecs = BUFFER_SIZE * 1e6 / SAMPLE_RATE;
+    double period_usecs = nominal_usecs / (1. + RATE_OFFSET);
+    double date = 1e6;
+    double phase_usecs = 0.;
+    jack_clock_estimate_t estimate;
+
+    seed = 1;
+    timer->SetFilter(scenario.filter);
+
+    for (int cycle = 0; cycle < CYCLES; cycle++) {
+        if (cycle == JUMP_CYCLE) {
+            date += JUMP_USECS;
+        }
+        jack_time_t callback_usecs = (jack_time_t)(date + wakeup_latency());
+        bool hardware = scenario.hardware && (scenario.hardware_cycles < 0 || cycle < scenario.hardware_cycles);
+        jack_time_t hardware_usecs = (hardware) ? (jack_time_t)(date + 2. * gaussian() + 0.5) : 0;
+        timer->IncFrameTime(BUFFER_SIZE, callback_usecs, (jack_time_t)nominal_usecs, hardware_usecs);
+
+        JackTimer state;
+        jack_nframes_t frames;
+        jack_time_t current_usecs, next_usecs;
+        float filtered_usecs;
+        timer->ReadFrameTime(&state);
+        state.GetCycleTimes(&frames, &current_usecs, &next_usecs, &filtered_usecs);
+        rate_ppm[cycle] = (filtered_usecs / period_usecs - 1.) * 1e6;
+        phase_usecs = double(current_usecs) - date;
+        state.GetClockEstimate(&estimate, BUFFER_SIZE, SAMPLE_RATE);
+        date += period_usecs;
+    }
+
+    double cycle_secs = nominal_usecs * 1e-6;
+    // When hardware dates stop, the filter starts over from there
+    int start_cycle = (scenario.hardware && scenario.hardware_cycles >= 0) ? scenario.hardware_cycles : 0;
+    double lock_secs = (lock_cycle(rate_ppm, start_cycle, JUMP_CYCLE) - start_cycle) * cycle_secs;
+    double relock_secs = (lock_cycle(rate_ppm, JUMP_CYCLE, CYCLES) - JUMP_CYCLE) * cycle_secs;
+
+    double sum = 0.;
+    int last_cycles = int(10. / cycle_secs);
+    for (int i = CYCLES - last_cycles; i < CYCLES; i++) {
+        sum += rate_ppm[i] * rate_ppm[i];
+    }
+    double rms_ppm = sqrt(sum / last_cycles);
+
+    int res = 0;
+    printf("%-30s rate error = %6.3f ppm, lock = %5.2f sec, relock after the jump = %5.2f sec, last period date error = %4.0f usecs\n",
+           scenario.name, rms_ppm, lock_secs, relock_secs, phase_usecs);
+    if (rms_ppm > scenario.max_rate_ppm) {
+        printf("rate error is over %.2f ppm !\n", scenario.max_rate_ppm);
+        res = 1;
+    }
+    if (scenario.max_lock_secs >= 0 && (lock_secs > scenario.max_lock_secs || relock_secs > scenario.max_lock_secs)) {
+        printf("lock takes more than %.2f sec !\n", scenario.max_lock_secs);
+        res = 1;
+    }
+    if (fabs(phase_usecs) > MAX_PHASE_USECS) {
+        printf("period date error is over %.0f usecs !\n", MAX_PHASE_USECS);
+        res = 1;
+    }
+    if (estimate.hardware_timestamps != (scenario.hardware && scenario.hardware_cycles < 0)) {
+        printf("hardware dates should%s be in use at the end !\n", (estimate.hardware_timestamps) ? " not" : "");
+        res = 1;
+    }
+
+    delete [] rate_ppm;
+    delete timer;
+    return res;
+}
+
+int main(int argc, char* argv[])
+{
+    int res = 0;
+
+    printf("%d frames at %d Hz, card %.0f ppm fast, dates jump by %.0f usecs after %d sec\n",
+           BUFFER_SIZE, SAMPLE_RATE, RATE_OFFSET * 1e6, JUMP_USECS, JUMP_CYCLE * BUFFER_SIZE / SAMPLE_RATE);
+
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        res |= run(scenarios[i]);
+    }
+
+    printf("%s\n", res ? "FAILED" : "OK");
+    return res;
+}
@@ -0,0 +1,645 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file graphbench.cpp
+ *
+ * @brief Measures the cycle overhead of client graphs, on a server started with the dummy driver for each period size.
+ *
+ * Clients are connected in a chain, or fan out of a source client, or fan in to a sink client.
+ * Internal 'inprocess' clients can be interleaved with the external ones.
+ * For each period size, the program reports:
+ *    - wake : time from the cycle start to the start of the first client
+ *    - graph : time from the cycle start to the end of the last client
+ *    - overhead : graph time minus the time spent in the external clients
+ *    - hop : time from the end of a client to the start of the client it feeds
+ *    - the highest number of chained clients that runs without xruns
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <jack/jack.h>
+#include <jack/intclient.h>
+
+enum topology_t { kChain, kFanOut, kFanIn };
+
+static const char* topology_names[] = { "chain", "fanout", "fanin" };
+
+static topology_t topology = kChain;
+static int clients = 8;
+static bool internal_clients = false;
+static jack_nframes_t sample_rate = 48000;
+static int seconds = 5;
+static int work_usecs = 0;
+static int max_clients = 256;
+static const char* jackd_path = "jackd";
+static bool json = false;
+
+static char server_name[64];
+static pid_t server_pid = -1;
+static jack_client_t* control = NULL;
+static volatile int xruns = 0;
+static volatile bool recording = false;
+
+struct bench_client {
+    jack_client_t* client;
+    jack_port_t* input;
+    jack_port_t* output;
+    std::string name;
+    bool internal;
+    jack_intclient_t intclient;
+    // Ring of cycles, indexed by the cycle frame time
+    std::vector<jack_nframes_t> frames;
+    std::vector<jack_time_t> cycle_usecs;
+    std::vector<jack_time_t> start_usecs;
+    std::vector<jack_time_t> end_usecs;
+};
+
+static jack_nframes_t period = 0;
+static size_t ring_size = 0;
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    bench_client* client = (bench_client*)arg;
+    jack_time_t start = jack_get_time();
+
+    jack_default_audio_sample_t* in = (jack_default_audio_sample_t*)jack_port_get_buffer(client->input, nframes);
+    jack_default_audio_sample_t* out = (jack_default_audio_sample_t*)jack_port_get_buffer(client->output, nframes);
+    memcpy(out, in, sizeof(jack_default_audio_sample_t) * nframes);
+
+    // Simulated DSP load
+    while (work_usecs > 0 && jack_get_time() - start < jack_time_t(work_usecs)) {}
+
+    if (recording) {
+        jack_nframes_t current_frames;
+        jack_time_t current_usecs;
+        jack_time_t next_usecs;
+        float period_usecs;
+        if (jack_get_cycle_times(client->client, &current_frames, &current_usecs, &next_usecs, &period_usecs) == 0) {
+            size_t slot = (current_frames / period) % ring_size;
+            client->frames[slot] = current_frames;
+            client->cycle_usecs[slot] = current_usecs;
+            client->start_usecs[slot] = start;
+            client->end_usecs[slot] = jack_get_time();
+        }
+    }
+    return 0;
+}
+
+static int xrun(void* arg)
+{
+    if (recording) {
+        xruns++;
+    }
+    return 0;
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_graph_bench \n"
+            "              [ --topology OR -t chain|fanout|fanin (default chain) ]\n"
+            "              [ --clients OR -c number_of_clients (default 8) ]\n"
+            "              [ --internal OR -i (interleave internal 'inprocess' clients) ]\n"
+            "              [ --periods OR -p comma_separated_period_sizes (default 64,128,256) ]\n"
+            "              [ --rate OR -r sample_rate (default 48000) ]\n"
+            "              [ --seconds OR -s seconds_per_measure (default 5) ]\n"
+            "              [ --work OR -w usecs_of_work_per_client_and_cycle (default 0) ]\n"
+            "              [ --max-clients OR -m sustainable_clients_search_limit, 0 to skip (default 256) ]\n"
+            "              [ --jackd OR -j jackd_path (default jackd) ]\n"
+            "              [ --json OR -J (one JSON object per line) ]\n"
+    );
+}
+
+static int start_server(jack_nframes_t period_size)
+{
+    char period_arg[16];
+    char rate_arg[16];
+    snprintf(period_arg, sizeof(period_arg), "%u", period_size);
+    snprintf(rate_arg, sizeof(rate_arg), "%u", sample_rate);
+
+    server_pid = fork();
+    if (server_pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (server_pid == 0) {
+        int null_fd = open("/dev/null", O_WRONLY);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+        }
+        execlp(jackd_path, jackd_path, "-n", server_name, "-d", "dummy", "-p", period_arg, "-r", rate_arg, (char*)NULL);
+        _exit(127);
+    }
+
+    // Wait for the server, at most 10 seconds
+    for (int tries = 0; tries < 100; tries++) {
+        jack_status_t status;
+        control = jack_client_open("graph_bench", (jack_options_t)(JackNoStartServer | JackServerName), &status, server_name);
+        if (control) {
+            jack_set_xrun_callback(control, xrun, NULL);
+            if (jack_activate(control) == 0) {
+                return 0;
+            }
+            jack_client_close(control);
+            control = NULL;
+            break;
+        }
+        if (waitpid(server_pid, NULL, WNOHANG) == server_pid) {
+            server_pid = -1;
+            break;
+        }
+        usleep(100000);
+    }
+    fprintf(stderr, "cannot start '%s -d dummy' with a period of %u frames\n", jackd_path, period_size);
+    return -1;
+}
+
+static void stop_server()
+{
+    if (control) {
+        jack_deactivate(control);
+        jack_client_close(control);
+        control = NULL;
+    }
+    if (server_pid > 0) {
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, NULL, 0);
+        server_pid = -1;
+    }
+}
+
+static int open_external(bench_client* client, int index)
+{
+    char name[64];
+    jack_status_t status;
+    snprintf(name, sizeof(name), "bench_%d", index);
+
+    client->client = jack_client_open(name, (jack_options_t)(JackNoStartServer | JackServerName), &status, server_name);
+    if (client->client == NULL) {
+        fprintf(stderr, "jack_client_open() failed, status = 0x%2.0x\n", status);
+        return -1;
+    }
+    client->name = jack_get_client_name(client->client);
+    client->frames.assign(ring_size, 0);
+    client->cycle_usecs.assign(ring_size, 0);
+    client->start_usecs.assign(ring_size, 0);
+    client->end_usecs.assign(ring_size, 0);
+
+    jack_set_process_callback(client->client, process, client);
+    client->input = jack_port_register(client->client, "input", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    client->output = jack_port_register(client->client, "output", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+    if (client->input == NULL || client->output == NULL) {
+        fprintf(stderr, "no more JACK ports available\n");
+        return -1;
+    }
+    if (jack_activate(client->client)) {
+        fprintf(stderr, "cannot activate client\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void disconnect_all(const std::string& port_name)
+{
+    jack_port_t* port = jack_port_by_name(control, port_name.c_str());
+    const char** connections = (port) ? jack_port_get_all_connections(control, port) : NULL;
+    if (connections) {
+        for (int i = 0; connections[i]; i++) {
+            if (jack_port_flags(port) & JackPortIsInput) {
+                jack_disconnect(control, connections[i], port_name.c_str());
+            } else {
+                jack_disconnect(control, port_name.c_str(), connections[i]);
+            }
+        }
+        jack_free(connections);
+    }
+}
+
+static int open_internal(bench_client* client, int index)
+{
+    char name[64];
+    jack_status_t status;
+    snprintf(name, sizeof(name), "bench_int_%d", index);
+
+    client->intclient = jack_internal_client_load(control, name, JackLoadName, &status, "inprocess");
+    if (status & JackFailure) {
+        fprintf(stderr, "cannot load the 'inprocess' internal client, status = 0x%2.0x\n", status);
+        return -1;
+    }
+    char* real_name = jack_get_internal_client_name(control, client->intclient);
+    client->name = real_name;
+    jack_free(real_name);
+
+    // 'inprocess' connects itself to the physical ports
+    disconnect_all(client->name + ":input");
+    disconnect_all(client->name + ":output");
+    return 0;
+}
+
+static void close_clients(std::vector<bench_client>& table)
+{
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table[i].internal) {
+            jack_internal_client_unload(control, table[i].intclient);
+        } else if (table[i].client) {
+            jack_deactivate(table[i].client);
+            jack_client_close(table[i].client);
+        }
+    }
+    table.clear();
+}
+
+static int connect_clients(const bench_client& src, const bench_client& dst)
+{
+    std::string src_port = src.name + ":output";
+    std::string dst_port = dst.name + ":input";
+    if (jack_connect(control, src_port.c_str(), dst_port.c_str())) {
+        fprintf(stderr, "cannot connect %s to %s\n", src_port.c_str(), dst_port.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+// In fan topologies, the source or sink is always an external client
+static bool is_internal(topology_t topo, int index, int count)
+{
+    if (!internal_clients) {
+        return false;
+    }
+    switch (topo) {
+        case kFanOut:
+            return index > 0 && (index % 2) == 0;
+        case kFanIn:
+            return index < count - 1 && (index % 2) == 1;
+        default:
+            return (index % 2) == 1;
+    }
+}
+
+static int build_graph(std::vector<bench_client>& table, topology_t topo, int count)
+{
+    table.resize(count);
+    for (int i = 0; i < count; i++) {
+        bench_client* client = &table[i];
+        client->client = NULL;
+        client->internal = is_internal(topo, i, count);
+        if ((client->internal) ? open_internal(client, i) : open_external(client, i)) {
+            return -1;
+        }
+    }
+
+    for (int i = 1; i < count; i++) {
+        int res;
+        switch (topo) {
+            case kFanOut:
+                res = connect_clients(table[0], table[i]);
+                break;
+            case kFanIn:
+                res = connect_clients(table[i - 1], table[count - 1]);
+                break;
+            default:
+                res = connect_clients(table[i - 1], table[i]);
+                break;
+        }
+        if (res < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+struct bench_result {
+    std::vector<jack_time_t> wake;
+    std::vector<jack_time_t> graph;
+    std::vector<jack_time_t> overhead;
+    std::vector<jack_time_t> hop;
+    int xruns;
+    float cpu_load;
+};
+
+static jack_time_t elapsed(jack_time_t from, jack_time_t to)
+{
+    return (to > from) ? to - from : 0;
+}
+
+// Only cycles recorded by all external clients are used
+static void collect(std::vector<bench_client>& table, topology_t topo, bench_result* result)
+{
+    std::vector<int> external;
+    for (size_t i = 0; i < table.size(); i++) {
+        if (!table[i].internal) {
+            external.push_back(i);
+        }
+    }
+
+    for (size_t slot = 0; slot < ring_size; slot++) {
+        bench_client& first = table[external[0]];
+        if (first.frames[slot] == 0) {
+            continue;
+        }
+        bool complete = true;
+        for (size_t i = 1; i < external.size() && complete; i++) {
+            complete = (table[external[i]].frames[slot] == first.frames[slot]);
+        }
+        if (!complete) {
+            continue;
+        }
+
+        jack_time_t cycle = first.cycle_usecs[slot];
+        jack_time_t first_start = first.start_usecs[slot];
+        jack_time_t last_end = first.end_usecs[slot];
+        jack_time_t busy = 0;
+        for (size_t i = 0; i < external.size(); i++) {
+            bench_client& client = table[external[i]];
+            first_start = std::min(first_start, client.start_usecs[slot]);
+            last_end = std::max(last_end, client.end_usecs[slot]);
+            busy += client.end_usecs[slot] - client.start_usecs[slot];
+        }
+        if (first_start < cycle) {
+            continue;
+        }
+        result->wake.push_back(first_start - cycle);
+        result->graph.push_back(last_end - cycle);
+        result->overhead.push_back(elapsed(busy, last_end - cycle));
+
+        switch (topo) {
+            case kFanOut:
+                for (size_t i = 1; i < external.size(); i++) {
+                    result->hop.push_back(elapsed(first.end_usecs[slot], table[external[i]].start_usecs[slot]));
+                }
+                break;
+            case kFanIn: {
+                jack_time_t sources_end = 0;
+                for (size_t i = 0; i + 1 < external.size(); i++) {
+                    sources_end = std::max(sources_end, table[external[i]].end_usecs[slot]);
+                }
+                if (external.size() > 1) {
+                    result->hop.push_back(elapsed(sources_end, table[external.back()].start_usecs[slot]));
+                }
+                break;
+            }
+            default:
+                for (size_t i = 1; i < external.size(); i++) {
+                    result->hop.push_back(elapsed(table[external[i - 1]].end_usecs[slot], table[external[i]].start_usecs[slot]));
+                }
+                break;
+        }
+    }
+}
+
+static int run(topology_t topo, int count, int duration, bench_result* result)
+{
+    std::vector<bench_client> table;
+    int res = build_graph(table, topo, count);
+
+    if (res == 0) {
+        // Let the graph settle before recording
+        sleep(1);
+        xruns = 0;
+        recording = true;
+        sleep(duration);
+        recording = false;
+        result->xruns = xruns;
+        result->cpu_load = jack_cpu_load(control);
+        // Wait for the last recording cycle
+        usleep(100000);
+        collect(table, topo, result);
+    }
+
+    close_clients(table);
+    return res;
+}
+
+static void print_stats(const char* metric, std::vector<jack_time_t>& values)
+{
+    if (values.empty()) {
+        return;
+    }
+
+    double sum = 0;
+    std::sort(values.begin(), values.end());
+    for (size_t i = 0; i < values.size(); i++) {
+        sum += values[i];
+    }
+
+    if (json) {
+        printf("{\"period\": %u, \"topology\": \"%s\", \"clients\": %d, \"internal\": %s, \"metric\": \"%s\", "
+               "\"samples\": %lu, \"min\": %lld, \"mean\": %.2f, \"median\": %lld, \"p99\": %lld, \"max\": %lld}\n",
+               period, topology_names[topology], clients, (internal_clients) ? "true" : "false", metric,
+               (unsigned long)values.size(), (long long)values.front(), sum / values.size(),
+               (long long)values[values.size() / 2], (long long)values[(values.size() * 99) / 100],
+               (long long)values.back());
+    } else {
+        printf("  %-10s min = %5lld  mean = %8.2f  median = %5lld  p99 = %5lld  max = %6lld usec (%lu samples)\n",
+               metric, (long long)values.front(), sum / values.size(),
+               (long long)values[values.size() / 2], (long long)values[(values.size() * 99) / 100],
+               (long long)values.back(), (unsigned long)values.size());
+    }
+}
+
+// A client count is sustainable when no xrun happens and every graph ends within the period
+static bool sustainable(int count, jack_time_t period_usecs)
+{
+    bench_result result;
+    if (run(kChain, count, 2, &result) < 0 || result.graph.empty()) {
+        return false;
+    }
+    return result.xruns == 0 && result.graph.back() < period_usecs;
+}
+
+static int max_sustainable(jack_time_t period_usecs)
+{
+    int low = 0;
+    int high = 1;
+
+    // Double the chain until it fails, then bisect
+    while (high <= max_clients && sustainable(high, period_usecs)) {
+        low = high;
+        high *= 2;
+    }
+    high = std::min(high, max_clients + 1);
+    while (high - low > 1) {
+        int middle = (low + high) / 2;
+        if (sustainable(middle, period_usecs)) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static int bench(jack_nframes_t period_size)
+{
+    period = period_size;
+    ring_size = std::min(size_t(sample_rate / period_size + 1) * (seconds + 2), size_t(1 << 16));
+
+    if (start_server(period_size) < 0) {
+        stop_server();
+        return -1;
+    }
+
+    bench_result result;
+    if (run(topology, clients, seconds, &result) < 0) {
+        stop_server();
+        return -1;
+    }
+
+    if (!json) {
+        printf("period = %u frames, %s of %d clients%s, xruns = %d, DSP load = %.2f%%\n",
+               period, topology_names[topology], clients, (internal_clients) ? " (with internal clients)" : "",
+               result.xruns, result.cpu_load);
+    }
+    print_stats("wake", result.wake);
+    print_stats("graph", result.graph);
+    print_stats("overhead", result.overhead);
+    print_stats("hop", result.hop);
+    if (json) {
+        printf("{\"period\": %u, \"topology\": \"%s\", \"clients\": %d, \"internal\": %s, \"metric\": \"xruns\", \"value\": %d}\n",
+               period, topology_names[topology], clients, (internal_clients) ? "true" : "false", result.xruns);
+    }
+
+    if (max_clients > 0) {
+        jack_time_t period_usecs = (jack_time_t(period_size) * 1000000) / sample_rate;
+        int count = max_sustainable(period_usecs);
+        if (json) {
+            printf("{\"period\": %u, \"topology\": \"chain\", \"work\": %d, \"metric\": \"max_clients\", \"value\": %d}\n",
+                   period, work_usecs, count);
+        } else {
+            printf("  max sustainable chained clients = %d%s\n", count, (count >= max_clients) ? " (search limit)" : "");
+        }
+    }
+
+    fflush(stdout);
+    stop_server();
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "t:c:ip:r:s:w:m:j:Jh";
+    struct option long_options[] = {
+        {"topology", 1, 0, 't'},
+        {"clients", 1, 0, 'c'},
+        {"internal", 0, 0, 'i'},
+        {"periods", 1, 0, 'p'},
+        {"rate", 1, 0, 'r'},
+        {"seconds", 1, 0, 's'},
+        {"work", 1, 0, 'w'},
+        {"max-clients", 1, 0, 'm'},
+        {"jackd", 1, 0, 'j'},
+        {"json", 0, 0, 'J'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+    std::vector<jack_nframes_t> periods;
+    int res = 0;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 't':
+                if (strcmp(optarg, "chain") == 0) {
+                    topology = kChain;
+                } else if (strcmp(optarg, "fanout") == 0) {
+                    topology = kFanOut;
+                } else if (strcmp(optarg, "fanin") == 0) {
+                    topology = kFanIn;
+                } else {
+                    usage();
+                    return 1;
+                }
+                break;
+            case 'c':
+                clients = atoi(optarg);
+                break;
+            case 'i':
+                internal_clients = true;
+                break;
+            case 'p':
+                for (char* token = strtok(optarg, ","); token; token = strtok(NULL, ",")) {
+                    periods.push_back(atoi(token));
+                }
+                break;
+            case 'r':
+                sample_rate = atoi(optarg);
+                break;
+            case 's':
+                seconds = atoi(optarg);
+                break;
+            case 'w':
+                work_usecs = atoi(optarg);
+                break;
+            case 'm':
+                max_clients = atoi(optarg);
+                break;
+            case 'j':
+                jackd_path = optarg;
+                break;
+            case 'J':
+                json = true;
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (periods.empty()) {
+        periods.push_back(64);
+        periods.push_back(128);
+        periods.push_back(256);
+    }
+
+    if (clients < 2 || seconds < 1 || sample_rate == 0 || max_clients < 0) {
+        fprintf(stderr, "at least two clients and one second are needed\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < periods.size(); i++) {
+        if (periods[i] == 0) {
+            fprintf(stderr, "invalid period size\n");
+            return 1;
+        }
+    }
+
+    snprintf(server_name, sizeof(server_name), "graph_bench_%d", (int)getpid());
+    signal(SIGPIPE, SIG_IGN);
+
+    for (size_t i = 0; i < periods.size(); i++) {
+        if (bench(periods[i]) < 0) {
+            res = 1;
+            break;
+        }
+    }
+
+    return res;
+}
@@ -0,0 +1,236 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file graphstate.cpp
+ *
+ * @brief Measures graph changes in the double buffered connection state, and their effect on a concurrent RT reader.
+ *
+ * No server is needed : the connection state is used directly, the way the engine and the RT thread do.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <algorithm>
+#include <vector>
+#include "JackConnectionManager.h"
+#include "JackAtomicState.h"
+
+using namespace Jack;
+
+#define CLIENTS     16
+#define PORTS       8      // input and output ports per client
+
+class TestGraph : public JackAtomicState<JackConnectionManager>
+{};
+
+static TestGraph* graph;
+static int iterations = 2000;
+static volatile bool changing = false;
+static volatile bool running = true;
+static std::vector<double> idle_cycles;
+static std::vector<double> busy_cycles;
+
+static double now_usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static jack_port_id_t input_port(int client, int port)
+{
+    return FIRST_AVAILABLE_PORT + (client * PORTS + port) * 2;
+}
+
+static jack_port_id_t output_port(int client, int port)
+{
+    return input_port(client, port) + 1;
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_graph_state \n"
+            "              [ --iterations OR -i number_of_graph_changes (default 2000) ]\n"
+    );
+}
+
+static void print_stats(const char* what, std::vector<double>& times)
+{
+    if (times.empty()) {
+        return;
+    }
+
+    double sum = 0;
+    std::sort(times.begin(), times.end());
+    for (size_t i = 0; i < times.size(); i++) {
+        sum += times[i];
+    }
+
+    printf("%-36s min = %8.2f  mean = %8.2f  median = %8.2f  99%% = %8.2f  max = %8.2f usec\n",
+           what, times.front(), sum / times.size(),
+           times[times.size() / 2],
+           times[(times.size() * 99) / 100],
+           times.back());
+}
+
+// Same work as the RT thread at the beginning of a cycle : switch to the next state, then read the connections
+static void* reader(void* arg)
+{
+    while (running) {
+        double start = now_usec();
+        JackConnectionManager* manager = graph->TrySwitchState();
+        int count = 0;
+        for (int client = 0; client < CLIENTS; client++) {
+            for (int port = 0; port < PORTS; port++) {
+                const jack_int_t* connections = manager->GetConnections(input_port(client, port));
+                for (int i = 0; (i < CONNECTION_NUM_FOR_PORT) && (connections[i] != EMPTY); i++) {
+                    count++;
+                }
+            }
+        }
+        double duration = now_usec() - start;
+        (changing ? busy_cycles : idle_cycles).push_back(duration);
+        usleep(500);
+    }
+    return NULL;
+}
+
+static void change(bool connect, int src_client, int src_port, int dst_client, int dst_port)
+{
+    jack_port_id_t src = output_port(src_client, src_port);
+    jack_port_id_t dst = input_port(dst_client, dst_port);
+    JackConnectionManager* manager = graph->WriteNextStateStart();
+
+    if (connect) {
+        manager->Connect(src, dst);
+        manager->Connect(dst, src);
+        manager->DirectConnect(src_client + 2, dst_client + 2);
+    } else {
+        manager->Disconnect(src, dst);
+        manager->Disconnect(dst, src);
+        manager->DirectDisconnect(src_client + 2, dst_client + 2);
+    }
+
+    graph->WriteNextStateStop();
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "i:h";
+    struct option long_options[] = {
+        {"iterations", 1, 0, 'i'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    std::vector<double> changes;
+    std::vector<double> copies;
+    int option_index;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (iterations < 10) {
+        fprintf(stderr, "iterations must be at least 10\n");
+        return 1;
+    }
+
+    graph = new TestGraph();
+    printf("connection state size = %ld bytes\n", (long)sizeof(JackConnectionManager));
+
+    // Clients 2 to CLIENTS + 1 with their ports, and a chain of connections between them
+    JackConnectionManager* manager = graph->WriteNextStateStart();
+    for (int client = 0; client < CLIENTS; client++) {
+        for (int port = 0; port < PORTS; port++) {
+            manager->AddInputPort(client + 2, input_port(client, port));
+            manager->AddOutputPort(client + 2, output_port(client, port));
+        }
+    }
+    graph->WriteNextStateStop();
+    for (int client = 0; client < CLIENTS - 1; client++) {
+        for (int port = 0; port < PORTS; port++) {
+            change(true, client, port, client + 1, port);
+        }
+    }
+
+    // Reference : what each state switch used to copy
+    JackConnectionManager* copy = new JackConnectionManager();
+    for (int i = 0; i < iterations; i++) {
+        double start = now_usec();
+        *copy = *graph->ReadCurrentState();
+        copies.push_back(now_usec() - start);
+    }
+    delete copy;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, reader, NULL);
+    usleep(200000);
+
+    changing = true;
+    for (int i = 0; i < iterations; i++) {
+        int src_client = rand() % CLIENTS;
+        int dst_client = (src_client + 1 + rand() % (CLIENTS - 1)) % CLIENTS;
+        int src_port = rand() % PORTS;
+        int dst_port = rand() % PORTS;
+
+        double start = now_usec();
+        change(true, src_client, src_port, dst_client, dst_port);
+        changes.push_back(now_usec() - start);
+
+        // Let the reader switch so that the next change starts from a copy
+        while (graph->IsPendingChange()) {
+            usleep(100);
+        }
+
+        start = now_usec();
+        change(false, src_client, src_port, dst_client, dst_port);
+        changes.push_back(now_usec() - start);
+
+        while (graph->IsPendingChange()) {
+            usleep(100);
+        }
+    }
+    changing = false;
+
+    usleep(200000);
+    running = false;
+    pthread_join(thread, NULL);
+
+    print_stats("full state copy", copies);
+    print_stats("graph change (copy + connect)", changes);
+    print_stats("RT cycle start, graph unchanged", idle_cycles);
+    print_stats("RT cycle start, graph changing", busy_cycles);
+
+    delete graph;
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file netcodecs.cpp
+ *
+ * @brief Measures the netone payload sample conversions for several channel counts, and checks them against the per sample reference.
+ *
+ * No server is needed : each cycle encodes the channels into a payload, then decodes the payload back, like a netone slave does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <arpa/inet.h>
+#include <vector>
+#include "netjack_packet.h"
+
+static int period = 128;
+static int iterations = 10000;
+
+static double now_usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// The per sample conversions, as they were done before the kernels
+static void reference_16bit(float* dst, const float* src, int nsamples)
+{
+    for (int i = 0; i < nsamples; i++) {
+        float sample = (src[i] > -1.0f) ? ((src[i] < 1.0f) ? src[i] : 1.0f) : -1.0f;
+        uint16_t net = htons((uint16_t)((sample + 1.0f) * 32767.0f));
+        dst[i] = ((float)ntohs(net)) / 32768.0f - 1.0f;
+    }
+}
+
+static void reference_8bit(float* dst, const float* src, int nsamples)
+{
+    for (int i = 0; i < nsamples; i++) {
+        float sample = (src[i] > -1.0f) ? ((src[i] < 1.0f) ? src[i] : 1.0f) : -1.0f;
+        dst[i] = ((float)(int8_t)(sample * 127.0f)) / 127.0f;
+    }
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_net_codecs \n"
+            "              [ --period OR -p frames_per_cycle (default 128) ]\n"
+            "              [ --iterations OR -i number_of_cycles (default 10000) ]\n"
+    );
+}
+
+static int measure(int channels)
+{
+    int nsamples = channels * period;
+    std::vector<float> input(nsamples);
+    std::vector<float> output(nsamples);
+    std::vector<float> expected(nsamples);
+    std::vector<uint32_t> payload(nsamples);
+    int res = 0;
+
+    // Includes out of range samples, to check the saturation
+    for (int i = 0; i < nsamples; i++) {
+        input[i] = 1.2f * sinf(i * 0.05f);
+    }
+
+    printf("%3d channels :", channels);
+
+    double start = now_usec();
+    for (int i = 0; i < iterations; i++) {
+        netjack_float_to_net(&payload[0], &input[0], nsamples);
+        netjack_net_to_float(&output[0], &payload[0], nsamples);
+    }
+    printf("  float %7.3f", (now_usec() - start) / iterations);
+    if (memcmp(&output[0], &input[0], nsamples * sizeof(float)) != 0) {
+        printf(" (mismatch)");
+        res = -1;
+    }
+
+    start = now_usec();
+    for (int i = 0; i < iterations; i++) {
+        netjack_float_to_net_16bit((uint16_t*)&payload[0], &input[0], nsamples);
+        netjack_net_16bit_to_float(&output[0], (uint16_t*)&payload[0], nsamples);
+    }
+    printf("  16bit %7.3f", (now_usec() - start) / iterations);
+    reference_16bit(&expected[0], &input[0], nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        // The vector and scalar products may truncate to different sides
+        if (fabsf(output[i] - expected[i]) > 1.5f / 32768.f) {
+            printf(" (mismatch at %d)", i);
+            res = -1;
+            break;
+        }
+    }
+
+    start = now_usec();
+    for (int i = 0; i < iterations; i++) {
+        netjack_float_to_net_8bit((int8_t*)&payload[0], &input[0], nsamples);
+        netjack_net_8bit_to_float(&output[0], (int8_t*)&payload[0], nsamples);
+    }
+    printf("  8bit %7.3f usec per cycle", (now_usec() - start) / iterations);
+    reference_8bit(&expected[0], &input[0], nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        if (fabsf(output[i] - expected[i]) > 1.5f / 127.f) {
+            printf(" (mismatch at %d)", i);
+            res = -1;
+            break;
+        }
+    }
+
+    printf("\n");
+    return res;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "p:i:h";
+    struct option long_options[] = {
+        {"period", 1, 0, 'p'},
+        {"iterations", 1, 0, 'i'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+    int channels[] = { 1, 2, 8, 32, 64 };
+    int res = 0;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'p':
+                period = atoi(optarg);
+                break;
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (period < 1 || iterations < 1) {
+        fprintf(stderr, "period and iterations must be at least 1\n");
+        return 1;
+    }
+
+    printf("%d frames per cycle, encoding then decoding each channel\n", period);
+    for (size_t i = 0; i < sizeof(channels) / sizeof(channels[0]); i++) {
+        if (measure(channels[i]) < 0) {
+            res = 1;
+        }
+    }
+
+    return res;
+}
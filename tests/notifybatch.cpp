@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file notifybatch.cpp
+ *
+ * @brief Checks the batched client notifications : coalescing rules, and decoding of a batch one notification at a time.
+ *
+ * No server is needed : notifications are queued with the engine rules, sent to a memory channel the way
+ * the server writes them to a client socket, and read back with JackClientNotification::Read like the client does.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "JackRequest.h"
+
+using namespace Jack;
+
+// Keeps the written bytes, and counts the writes that reach the channel
+class MemoryChannel : public detail::JackChannelTransactionInterface
+{
+
+    public:
+
+        std::vector<char> fData;
+        size_t fReadPos;
+        int fWrites;
+
+        MemoryChannel(): fReadPos(0), fWrites(0)
+        {}
+
+        int Read(void* data, int len)
+        {
+            if (fReadPos + len > fData.size()) {
+                return -1;
+            }
+            memcpy(data, &fData[fReadPos], len);
+            fReadPos += len;
+            return 0;
+        }
+
+        int Write(void* data, int len)
+        {
+            fData.insert(fData.end(), (char*)data, (char*)data + len);
+            fWrites++;
+            return 0;
+        }
+
+};
+
+static int errors = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("%s !\n", what);
+        errors++;
+    }
+}
+
+static void queue(std::vector<JackClientNotification>& pending, int notify, int value1, int* coalesced)
+{
+    char name[JACK_CLIENT_NAME_SIZE + 1];
+    snprintf(name, sizeof(name), "client%d", value1);
+    if (JackClientNotificationBatch::Queue(pending, JackClientNotification(name, 2, notify, false, "", value1, 0))) {
+        (*coalesced)++;
+    }
+}
+
+// Decodes the whole channel, and checks that every notification is read back as sent
+static void decode(MemoryChannel* channel, const std::vector<JackClientNotification>& sent)
+{
+    size_t count = 0;
+    while (channel->fReadPos < channel->fData.size()) {
+        JackClientNotification event;
+        if (event.Read(channel) < 0) {
+            check(false, "a notification of the batch cannot be decoded");
+            return;
+        }
+        if (count < sent.size()) {
+            const JackClientNotification& expected = sent[count];
+            check(event.fNotify == expected.fNotify && event.fValue1 == expected.fValue1 && event.fRefNum == expected.fRefNum
+                  && event.fSync == 0 && strcmp(event.fName, expected.fName) == 0, "a decoded notification differs from the sent one");
+        }
+        count++;
+    }
+    check(count == sent.size(), "the batch does not decode to the sent notification count");
+}
+
+static void test_coalescing()
+{
+    std::vector<JackClientNotification> pending;
+    int coalesced = 0;
+
+    // What a port registration, a connection and an activation in a row queue for a client
+    queue(pending, kPortRegistrationOnCallback, 1, &coalesced);
+    queue(pending, kGraphOrderCallback, 1, &coalesced);
+    queue(pending, kPortRegistrationOnCallback, 2, &coalesced);
+    queue(pending, kPortConnectCallback, 3, &coalesced);
+    queue(pending, kGraphOrderCallback, 2, &coalesced);
+    queue(pending, kPortRegistrationOnCallback, 4, &coalesced);
+    queue(pending, kGraphOrderCallback, 3, &coalesced);
+
+    printf("coalescing : 7 queued, %d coalesced, %d to send\n", coalesced, (int)pending.size());
+    check(coalesced == 2, "earlier graph order notifications are not coalesced");
+    check(pending.size() == 5, "the queue does not keep one notification per port change and one graph order");
+
+    MemoryChannel channel;
+    JackClientNotificationBatch batch;
+    check(batch.Send(&channel, &pending[0], pending.size()) == 0, "the batch cannot be sent");
+    check(channel.fWrites == 1, "a small batch is not sent in a single write");
+
+    // Port notifications keep their order, the last graph order comes after them
+    int expected_notify[] = { kPortRegistrationOnCallback, kPortRegistrationOnCallback, kPortConnectCallback, kPortRegistrationOnCallback, kGraphOrderCallback };
+    int expected_value[] = { 1, 2, 3, 4, 3 };
+    for (size_t i = 0; i < pending.size(); i++) {
+        check(pending[i].fNotify == expected_notify[i] && pending[i].fValue1 == expected_value[i], "the queue order is wrong");
+    }
+    decode(&channel, pending);
+}
+
+static void test_large_batch()
+{
+    std::vector<JackClientNotification> pending;
+    int coalesced = 0;
+    int count = NOTIFICATION_BATCH_MAX * 3 + 5;
+
+    for (int i = 0; i < count; i++) {
+        queue(pending, kPortRegistrationOnCallback, i, &coalesced);
+    }
+    queue(pending, kGraphOrderCallback, count, &coalesced);
+
+    MemoryChannel channel;
+    JackClientNotificationBatch batch;
+    check(batch.Send(&channel, &pending[0], pending.size()) == 0, "the large batch cannot be sent");
+
+    int writes_max = (int)(pending.size() + NOTIFICATION_BATCH_MAX - 1) / NOTIFICATION_BATCH_MAX;
+    printf("large batch : %d notifications in %d write(s), at most %d expected\n", (int)pending.size(), channel.fWrites, writes_max);
+    check(coalesced == 0, "port notifications are coalesced");
+    check(channel.fWrites <= writes_max, "the large batch takes too many writes");
+    decode(&channel, pending);
+}
+
+static void test_single()
+{
+    // A batch decodes like notifications written one by one
+    MemoryChannel single;
+    MemoryChannel batched;
+    std::vector<JackClientNotification> pending;
+    int coalesced = 0;
+
+    queue(pending, kPortRegistrationOnCallback, 1, &coalesced);
+    queue(pending, kGraphOrderCallback, 2, &coalesced);
+    for (size_t i = 0; i < pending.size(); i++) {
+        pending[i].Write(&single);
+    }
+
+    JackClientNotificationBatch batch;
+    batch.Send(&batched, &pending[0], pending.size());
+    check(single.fData == batched.fData, "a batch is not the same bytes as the notifications written one by one");
+}
+
+int main(int argc, char* argv[])
+{
+    test_coalescing();
+    test_large_batch();
+    test_single();
+
+    printf("%s\n", errors ? "FAILED" : "OK");
+    return errors ? 1 : 0;
+}
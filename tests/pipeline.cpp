@@ -0,0 +1,258 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file pipeline.cpp
+ *
+ * @brief Runs a chain of clients in freewheel mode and checks that every client keeps being activated by the freewheel driver.
+ *
+ * Start the server with a freewheel pipeline (jackd -W depth) to check pipelined rendering : the chain is then split in stages,
+ * and the data received at the end of the chain is delayed by one cycle per stage boundary. The head of the chain is also
+ * directly connected to the end of the chain, this connection must be delayed as much as the whole chain, and the transport
+ * position seen at the end of the chain must be the one the head of the chain saw for the same data.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <jack/jack.h>
+
+#define CLIENTS_MAX 16
+
+struct PipelineClient {
+    jack_client_t* client;
+    jack_port_t* input;
+    jack_port_t* bypass;
+    jack_port_t* output;
+    volatile bool freewheel;
+    volatile int freewheel_cycles;
+    volatile int lag;
+    volatile int lag_changes;
+    volatile int bypass_lag;
+    volatile int transport_cycles;
+    volatile int transport_errors;
+};
+
+static PipelineClient clients[CLIENTS_MAX];
+static int client_count = 4;
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_pipeline \n"
+            "              [ --clients OR -c number_of_chained_clients (default 4) ]\n"
+            "              [ --delay OR -d expected_delay_in_cycles ]\n"
+            "              [ --time OR -t freewheel_seconds (default 2) ]\n"
+    );
+}
+
+// Cycle number of the current cycle, exactly representable in a float sample
+static float cycle_number(jack_client_t* client, jack_nframes_t nframes)
+{
+    return float((jack_last_frame_time(client) / nframes) % (1 << 24));
+}
+
+// Transport cycle number of the current cycle, 0 when the transport is not rolling
+static float transport_number(jack_client_t* client, jack_nframes_t nframes)
+{
+    jack_position_t pos;
+    if (jack_transport_query(client, &pos) != JackTransportRolling) {
+        return 0.f;
+    }
+    return float((pos.frame / nframes + 1) % (1 << 24));
+}
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    PipelineClient* pc = (PipelineClient*)arg;
+    float* out = (float*)jack_port_get_buffer(pc->output, nframes);
+    float cycle = cycle_number(pc->client, nframes);
+
+    if (pc == &clients[0]) {
+        // Head of the chain : stamp the cycle, and the transport cycle in the second frame
+        for (jack_nframes_t i = 0; i < nframes; i++) {
+            out[i] = cycle;
+        }
+        out[1] = transport_number(pc->client, nframes);
+    } else {
+        float* in = (float*)jack_port_get_buffer(pc->input, nframes);
+        memcpy(out, in, nframes * sizeof(float));
+        if (pc->freewheel && in[0] > 0) {
+            int lag = int(cycle - in[0]);
+            // Delay is only stable once the pipeline is filled, at most one cycle per client
+            if (pc->freewheel_cycles > client_count && lag != pc->lag) {
+                pc->lag_changes++;
+            }
+            pc->lag = lag;
+        }
+        if (pc->bypass && pc->freewheel && pc->freewheel_cycles > client_count) {
+            float* bypass = (float*)jack_port_get_buffer(pc->bypass, nframes);
+            float transport = transport_number(pc->client, nframes);
+            if (bypass[0] > 0) {
+                pc->bypass_lag = int(cycle - bypass[0]);
+            }
+            if (in[1] > 0 && transport > 0) {
+                pc->transport_cycles++;
+                if (in[1] != transport) {
+                    pc->transport_errors++;
+                }
+            }
+        }
+    }
+
+    if (pc->freewheel) {
+        pc->freewheel_cycles++;
+    }
+    return 0;
+}
+
+static void freewheel(int starting, void* arg)
+{
+    PipelineClient* pc = (PipelineClient*)arg;
+    pc->freewheel = starting;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "c:d:t:h";
+    struct option long_options[] = {
+        {"clients", 1, 0, 'c'},
+        {"delay", 1, 0, 'd'},
+        {"time", 1, 0, 't'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int expected_delay = -1;
+    int seconds = 2;
+    int option_index;
+    int opt;
+    int res = 0;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'c':
+                client_count = atoi(optarg);
+                break;
+            case 'd':
+                expected_delay = atoi(optarg);
+                break;
+            case 't':
+                seconds = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (client_count < 2 || client_count > CLIENTS_MAX) {
+        fprintf(stderr, "clients must be between 2 and %d\n", CLIENTS_MAX);
+        return 1;
+    }
+
+    for (int i = 0; i < client_count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "pipeline%d", i);
+        PipelineClient* pc = &clients[i];
+        if ((pc->client = jack_client_open(name, JackNoStartServer, NULL)) == NULL) {
+            fprintf(stderr, "cannot open client %s, is the server running ?\n", name);
+            return 1;
+        }
+        pc->input = jack_port_register(pc->client, "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        pc->output = jack_port_register(pc->client, "out", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (i == client_count - 1) {
+            pc->bypass = jack_port_register(pc->client, "bypass", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+        }
+        jack_set_process_callback(pc->client, process, pc);
+        jack_set_freewheel_callback(pc->client, freewheel, pc);
+        if (jack_activate(pc->client) != 0) {
+            fprintf(stderr, "cannot activate client %s\n", name);
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < client_count - 1; i++) {
+        if (jack_connect(clients[i].client, jack_port_name(clients[i].output), jack_port_name(clients[i + 1].input)) != 0) {
+            fprintf(stderr, "cannot connect client %d to client %d\n", i, i + 1);
+            return 1;
+        }
+    }
+    if (jack_connect(clients[0].client, jack_port_name(clients[0].output), jack_port_name(clients[client_count - 1].bypass)) != 0) {
+        fprintf(stderr, "cannot connect client 0 to the end of the chain\n");
+        return 1;
+    }
+
+    jack_transport_locate(clients[0].client, 0);
+    jack_transport_start(clients[0].client);
+    usleep(100000);
+
+    if (jack_set_freewheel(clients[0].client, 1) != 0) {
+        fprintf(stderr, "cannot start freewheel mode\n");
+        return 1;
+    }
+    sleep(seconds);
+    jack_set_freewheel(clients[0].client, 0);
+    jack_transport_stop(clients[0].client);
+    usleep(100000);
+
+    PipelineClient* last = &clients[client_count - 1];
+    jack_latency_range_t range;
+    jack_port_get_latency_range(last->input, JackCaptureLatency, &range);
+
+    for (int i = 0; i < client_count; i++) {
+        printf("client %2d : %8d freewheel cycles\n", i, clients[i].freewheel_cycles);
+        // With 2 seconds of freewheel, even a slow machine runs thousands of cycles
+        if (clients[i].freewheel_cycles < 100 * seconds) {
+            printf("client %d was not activated in freewheel mode !\n", i);
+            res = 1;
+        }
+    }
+
+    printf("delay at the end of the chain = %d cycle(s), changed %d time(s), capture latency = %u frames\n",
+           last->lag, last->lag_changes, range.max);
+    if (last->lag_changes > 0) {
+        printf("delay is not constant !\n");
+        res = 1;
+    }
+    if (expected_delay >= 0 && last->lag != expected_delay) {
+        printf("delay should be %d cycle(s) !\n", expected_delay);
+        res = 1;
+    }
+
+    printf("delay of the direct connection = %d cycle(s)\n", last->bypass_lag);
+    if (last->bypass_lag != last->lag) {
+        printf("direct connection is not delayed as much as the chain !\n");
+        res = 1;
+    }
+
+    printf("transport checked on %d cycle(s), %d error(s)\n", last->transport_cycles, last->transport_errors);
+    if (last->transport_cycles == 0 || last->transport_errors > 0) {
+        printf("transport position does not follow the data !\n");
+        res = 1;
+    }
+
+    for (int i = 0; i < client_count; i++) {
+        jack_deactivate(clients[i].client);
+        jack_client_close(clients[i].client);
+    }
+
+    printf("%s\n", res ? "FAILED" : "OK");
+    return res;
+}
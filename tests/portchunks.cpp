@@ -0,0 +1,210 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file portchunks.cpp
+ *
+ * @brief Registers more ports than the server started with, so that the port table grows by chunks.
+ *
+ * A client in another process, without any callback but the process one, receives a signal from a port of the last chunk :
+ * it has to map the chunk without any port registration callback. The graph snapshot has to show the new ports and their connection.
+ * Start the server with a small port table, for instance jackd -p 128, and register more ports than that (-n).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/wait.h>
+#include <jack/jack.h>
+#include <jack/graph.h>
+
+#define SIGNAL_VALUE 0.5f
+
+static jack_port_t* input_port;
+static volatile int received_cycles = 0;
+static jack_port_t* output_port;
+
+static int reader_process(jack_nframes_t nframes, void* arg)
+{
+    float* in = (float*)jack_port_get_buffer(input_port, nframes);
+    if (in[0] == SIGNAL_VALUE && in[nframes - 1] == SIGNAL_VALUE) {
+        received_cycles++;
+    }
+    return 0;
+}
+
+static int writer_process(jack_nframes_t nframes, void* arg)
+{
+    float* out = (float*)jack_port_get_buffer(output_port, nframes);
+    for (jack_nframes_t i = 0; i < nframes; i++) {
+        out[i] = SIGNAL_VALUE;
+    }
+    return 0;
+}
+
+// Child process : only a process callback
+static int run_reader(int seconds)
+{
+    jack_client_t* client = jack_client_open("chunk_reader", JackNoStartServer, NULL);
+    if (!client) {
+        fprintf(stderr, "cannot open the reader client, is the server running ?\n");
+        return 1;
+    }
+    input_port = jack_port_register(client, "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    jack_set_process_callback(client, reader_process, NULL);
+    if (jack_activate(client) != 0) {
+        fprintf(stderr, "cannot activate the reader client\n");
+        return 1;
+    }
+
+    for (int i = 0; i < seconds * 10 && received_cycles < 100; i++) {
+        usleep(100000);
+    }
+
+    printf("reader : %d cycle(s) received the signal\n", received_cycles);
+    jack_deactivate(client);
+    jack_client_close(client);
+    return (received_cycles >= 100) ? 0 : 1;
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_port_chunks \n"
+            "              [ --ports OR -n number_of_ports_to_register (default 600) ]\n"
+            "              [ --time OR -t seconds_to_wait_for_the_signal (default 5) ]\n"
+    );
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "n:t:h";
+    struct option long_options[] = {
+        {"ports", 1, 0, 'n'},
+        {"time", 1, 0, 't'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int port_count = 600;
+    int seconds = 5;
+    int option_index;
+    int opt;
+    int res = 0;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'n':
+                port_count = atoi(optarg);
+                break;
+            case 't':
+                seconds = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (port_count < 1) {
+        fprintf(stderr, "at least one port has to be registered\n");
+        return 1;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        return run_reader(seconds);
+    }
+
+    jack_client_t* client = jack_client_open("chunk_writer", JackNoStartServer, NULL);
+    if (!client) {
+        fprintf(stderr, "cannot open the writer client, is the server running ?\n");
+        waitpid(pid, NULL, 0);
+        return 1;
+    }
+
+    // Wait for the reader to be active
+    for (int i = 0; i < 50 && !jack_port_by_name(client, "chunk_reader:in"); i++) {
+        usleep(100000);
+    }
+
+    uint32_t first_port_count = 0;
+    jack_graph_snapshot_t* snapshot = jack_graph_snapshot_new(client);
+    if (snapshot) {
+        first_port_count = jack_graph_snapshot_get_port_count(snapshot);
+    }
+
+    for (int i = 0; i < port_count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "out%d", i);
+        jack_port_t* port = jack_port_register(client, name, JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+        if (!port) {
+            fprintf(stderr, "cannot register port %d\n", i);
+            res = 1;
+            break;
+        }
+        output_port = port;
+    }
+
+    jack_set_process_callback(client, writer_process, NULL);
+    if (res == 0 && jack_activate(client) != 0) {
+        fprintf(stderr, "cannot activate the writer client\n");
+        res = 1;
+    }
+    if (res == 0 && jack_connect(client, jack_port_name(output_port), "chunk_reader:in") != 0) {
+        fprintf(stderr, "cannot connect %s to the reader\n", jack_port_name(output_port));
+        res = 1;
+    }
+
+    // The last port is in a chunk when the table grew, and the snapshot of the last chunk has to be used
+    jack_port_id_t output_id = (jack_port_id_t)(uintptr_t)output_port;
+    if (res == 0 && snapshot) {
+        const jack_port_id_t* peers;
+        jack_graph_snapshot_update(client, snapshot);
+        uint32_t last_port_count = jack_graph_snapshot_get_port_count(snapshot);
+        int peer_count = jack_graph_snapshot_get_peers(snapshot, output_id, &peers);
+        printf("writer : last port id = %u, snapshot port count %u -> %u, peers of the last port = %d\n",
+               output_id, first_port_count, last_port_count, peer_count);
+        if (last_port_count <= first_port_count) {
+            printf("the port table did not grow, register more ports than the server port max !\n");
+            res = 1;
+        }
+        if (peer_count != 1 || peers[0] != (jack_port_id_t)(uintptr_t)jack_port_by_name(client, "chunk_reader:in")) {
+            printf("the connection of the last port is not in the snapshot !\n");
+            res = 1;
+        }
+    } else if (!snapshot) {
+        printf("cannot read the graph snapshot !\n");
+        res = 1;
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("the reader did not receive the signal !\n");
+        res = 1;
+    }
+
+    jack_graph_snapshot_free(snapshot);
+    jack_deactivate(client);
+    jack_client_close(client);
+
+    printf("%s\n", res ? "FAILED" : "OK");
+    return res;
+}
@@ -0,0 +1,181 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file reqlatency.cpp
+ *
+ * @brief Measures client to server request round trips, using the socket and the shared memory request channel.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <algorithm>
+#include <vector>
+#include <jack/jack.h>
+
+static int iterations = 10000;
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_request_latency \n"
+            "              [ --iterations OR -i number_of_requests (default 10000) ]\n"
+            "              [ --server OR -s server_name ]\n"
+    );
+}
+
+static void print_stats(const char* channel, const char* request, std::vector<jack_time_t>& times)
+{
+    if (times.empty()) {
+        return;
+    }
+
+    double sum = 0;
+    std::sort(times.begin(), times.end());
+    for (size_t i = 0; i < times.size(); i++) {
+        sum += times[i];
+    }
+
+    printf("%-8s %-28s min = %5lld  mean = %8.2f  median = %5lld  99%% = %5lld  max = %6lld usec\n",
+           channel, request,
+           (long long)times.front(), sum / times.size(),
+           (long long)times[times.size() / 2],
+           (long long)times[(times.size() * 99) / 100],
+           (long long)times.back());
+}
+
+static int bench(const char* channel, const char* server_name)
+{
+    char name[64];
+    jack_status_t status;
+    std::vector<jack_time_t> times;
+    int i;
+
+    snprintf(name, sizeof(name), "reqlatency_%s", channel);
+    jack_options_t options = (server_name) ? (jack_options_t)(JackNoStartServer | JackServerName) : JackNoStartServer;
+    jack_client_t* client = jack_client_open(name, options, &status, server_name);
+    if (client == NULL) {
+        fprintf(stderr, "jack_client_open() failed, status = 0x%2.0x\n", status);
+        return -1;
+    }
+
+    jack_port_t* output_port = jack_port_register(client, "out", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0);
+    jack_port_t* input_port = jack_port_register(client, "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+    if (output_port == NULL || input_port == NULL) {
+        fprintf(stderr, "no more JACK ports available\n");
+        jack_client_close(client);
+        return -1;
+    }
+
+    if (jack_activate(client)) {
+        fprintf(stderr, "cannot activate client\n");
+        jack_client_close(client);
+        return -1;
+    }
+
+    times.reserve(iterations);
+
+    // Lightweight query
+    for (i = 0; i < iterations; i++) {
+        jack_time_t start = jack_get_time();
+        char* uuid = jack_get_uuid_for_client_name(client, name);
+        times.push_back(jack_get_time() - start);
+        jack_free(uuid);
+    }
+    print_stats(channel, "get_uuid_for_client_name", times);
+    times.clear();
+
+    for (i = 0; i < iterations; i++) {
+        jack_time_t start = jack_get_time();
+        jack_recompute_total_latencies(client);
+        times.push_back(jack_get_time() - start);
+    }
+    print_stats(channel, "recompute_total_latencies", times);
+    times.clear();
+
+    for (i = 0; i < iterations; i++) {
+        jack_time_t start = jack_get_time();
+        jack_port_rename(client, output_port, (i & 1) ? "out" : "out_renamed");
+        times.push_back(jack_get_time() - start);
+    }
+    print_stats(channel, "port_rename", times);
+    times.clear();
+
+    // Graph changes, with notifications to all clients
+    for (i = 0; i < iterations / 10; i++) {
+        jack_time_t start = jack_get_time();
+        jack_connect(client, jack_port_name(output_port), jack_port_name(input_port));
+        jack_disconnect(client, jack_port_name(output_port), jack_port_name(input_port));
+        times.push_back(jack_get_time() - start);
+    }
+    print_stats(channel, "connect + disconnect", times);
+    times.clear();
+
+    jack_deactivate(client);
+    jack_client_close(client);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* server_name = NULL;
+    const char* options = "i:s:h";
+    struct option long_options[] = {
+        {"iterations", 1, 0, 'i'},
+        {"server", 1, 0, 's'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 's':
+                server_name = optarg;
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (iterations < 10) {
+        fprintf(stderr, "iterations must be at least 10\n");
+        return 1;
+    }
+
+    // The channel is chosen when the client is opened
+    setenv("JACK_NO_SHM_REQUEST", "1", 1);
+    if (bench("socket", server_name) < 0) {
+        return 1;
+    }
+
+    unsetenv("JACK_NO_SHM_REQUEST");
+    if (bench("shm", server_name) < 0) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file shmtlb.cpp
+ *
+ * @brief Measures the data TLB misses of cycles touching shared memory segments backed by normal pages, then by huge pages.
+ *
+ * No server is needed : segments are allocated with the shm layer of the server, under a server name of their own.
+ * Each cycle touches every 4 KB page of the segments once in a shuffled order, the way port buffers and control
+ * structures of clients spread over the segments are touched by the RT threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <algorithm>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+#include "shm.h"
+
+#define SEGMENT_SIZE    (1024 * 1024)
+#define TOUCH_STRIDE    4096
+
+static int segments = 16;
+static int iterations = 1000;
+
+static double now_usec()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int open_dtlb_counter()
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB
+                  | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                  | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_shm_tlb \n"
+            "              [ --segments OR -s number_of_1MB_segments (default 16) ]\n"
+            "              [ --iterations OR -i number_of_cycles (default 1000) ]\n"
+    );
+}
+
+static void measure(const char* what, int hugepages)
+{
+    std::vector<jack_shm_info_t> infos;
+    std::vector<float*> pages;
+    int counter = open_dtlb_counter();
+    int counter_error = errno;
+    long long misses = 0;
+    float sum = 0.f;
+
+    jack_set_shm_hugepages(hugepages);
+
+    for (int i = 0; i < segments; i++) {
+        jack_shm_info_t info;
+        if (jack_shmalloc("/jack_shm_tlb", SEGMENT_SIZE, &info)) {
+            fprintf(stderr, "cannot allocate segment %d\n", i);
+            break;
+        }
+        if (jack_attach_shm(&info)) {
+            fprintf(stderr, "cannot attach segment %d\n", i);
+            jack_destroy_shm(&info);
+            break;
+        }
+        infos.push_back(info);
+        char* addr = jack_shm_addr(&info);
+        for (int offset = 0; offset < SEGMENT_SIZE; offset += TOUCH_STRIDE) {
+            pages.push_back((float*)(addr + offset));
+        }
+    }
+
+    std::random_shuffle(pages.begin(), pages.end());
+
+    double start = now_usec();
+#ifdef __linux__
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    for (int i = 0; i < iterations; i++) {
+        for (size_t page = 0; page < pages.size(); page++) {
+            sum += *pages[page];
+            *pages[page] = (float)i;
+        }
+    }
+#ifdef __linux__
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &misses, sizeof(misses)) != sizeof(misses)) {
+            misses = -1;
+        }
+        close(counter);
+    }
+#endif
+    double cycle = (now_usec() - start) / iterations;
+
+    if (counter >= 0) {
+        printf("%-12s %4d pages per cycle : %8.2f usec per cycle, %10.1f dTLB load misses per cycle\n",
+               what, (int)pages.size(), cycle, (double)misses / iterations);
+    } else {
+        printf("%-12s %4d pages per cycle : %8.2f usec per cycle, dTLB counter not available (%s)\n",
+               what, (int)pages.size(), cycle, strerror(counter_error));
+    }
+
+    for (size_t i = 0; i < infos.size(); i++) {
+        jack_release_shm(&infos[i]);
+        jack_destroy_shm(&infos[i]);
+    }
+
+    // Keeps the loop from being optimized out
+    if (sum < 0.f) {
+        printf("%f\n", sum);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* options = "s:i:h";
+    struct option long_options[] = {
+        {"segments", 1, 0, 's'},
+        {"iterations", 1, 0, 'i'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+    char server_name[64];
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 's':
+                segments = atoi(optarg);
+                break;
+            case 'i':
+                iterations = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (segments < 1 || segments > MAX_SHM_ID / 2 || iterations < 1) {
+        fprintf(stderr, "segments must be between 1 and %d, iterations at least 1\n", MAX_SHM_ID / 2);
+        return 1;
+    }
+
+    snprintf(server_name, sizeof(server_name), "jack_shm_tlb_%d", (int)getpid());
+    if (jack_register_server(server_name, 0) != 0) {
+        fprintf(stderr, "cannot access the shm registry\n");
+        return 1;
+    }
+
+    measure("normal pages", 0);
+    measure("huge pages", 1);
+
+    jack_cleanup_shm();
+    jack_unregister_server(server_name);
+    return 0;
+}
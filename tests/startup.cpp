@@ -0,0 +1,236 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file startup.cpp
+ *
+ * @brief Measures the time from jack_client_open to the first process callback, when starting many clients like a session load does.
+ *
+ * Clients are started one after the other, either with jack_port_register and jack_activate calls,
+ * or with a single jack_activate_with_ports call.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <jack/jack.h>
+#include <jack/startup.h>
+
+static int clients = 40;
+static int ports = 4;
+
+struct startup_client {
+    jack_client_t* client;
+    jack_time_t open_usecs;
+    volatile jack_time_t first_process_usecs;
+};
+
+static int process(jack_nframes_t nframes, void* arg)
+{
+    startup_client* client = (startup_client*)arg;
+    if (client->first_process_usecs == 0) {
+        client->first_process_usecs = jack_get_time();
+    }
+    return 0;
+}
+
+static void usage()
+{
+    fprintf(stderr, "\n"
+            "usage: jack_startup_time \n"
+            "              [ --clients OR -c number_of_clients (default 40) ]\n"
+            "              [ --ports OR -p ports_per_client (default 4) ]\n"
+            "              [ --server OR -s server_name ]\n"
+    );
+}
+
+static void print_stats(const char* sequence, std::vector<jack_time_t>& times, jack_time_t total)
+{
+    if (times.empty()) {
+        return;
+    }
+
+    double sum = 0;
+    std::sort(times.begin(), times.end());
+    for (size_t i = 0; i < times.size(); i++) {
+        sum += times[i];
+    }
+
+    printf("%-24s min = %6lld  mean = %9.2f  median = %6lld  max = %7lld usec, all clients = %8.2f msec\n",
+           sequence,
+           (long long)times.front(), sum / times.size(),
+           (long long)times[times.size() / 2],
+           (long long)times.back(),
+           total / 1000.);
+}
+
+static int start_client(startup_client* client, int index, bool combined, const char* server_name)
+{
+    char name[64];
+    jack_status_t status;
+    std::vector<jack_port_spec_t> specs(ports + 1);
+    std::vector<jack_port_t*> registered(ports + 1);
+    std::vector<std::string> port_names(ports);
+
+    snprintf(name, sizeof(name), "startup_%d", index);
+    jack_options_t options = (server_name) ? (jack_options_t)(JackNoStartServer | JackServerName) : JackNoStartServer;
+
+    client->first_process_usecs = 0;
+    client->open_usecs = jack_get_time();
+    client->client = jack_client_open(name, options, &status, server_name);
+    if (client->client == NULL) {
+        fprintf(stderr, "jack_client_open() failed, status = 0x%2.0x\n", status);
+        return -1;
+    }
+
+    jack_set_process_callback(client->client, process, client);
+
+    for (int i = 0; i < ports; i++) {
+        char port_name[64];
+        snprintf(port_name, sizeof(port_name), "%s%d", (i & 1) ? "in" : "out", i / 2 + 1);
+        port_names[i] = port_name;
+        specs[i].name = port_names[i].c_str();
+        specs[i].type = JACK_DEFAULT_AUDIO_TYPE;
+        specs[i].flags = (i & 1) ? JackPortIsInput : JackPortIsOutput;
+    }
+
+    if (combined) {
+        if (jack_activate_with_ports(client->client, &specs[0], ports, &registered[0])) {
+            fprintf(stderr, "cannot register ports and activate client\n");
+            return -1;
+        }
+    } else {
+        for (int i = 0; i < ports; i++) {
+            if (jack_port_register(client->client, specs[i].name, specs[i].type, specs[i].flags, 0) == NULL) {
+                fprintf(stderr, "no more JACK ports available\n");
+                return -1;
+            }
+        }
+        if (jack_activate(client->client)) {
+            fprintf(stderr, "cannot activate client\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int bench(const char* sequence, bool combined, const char* server_name)
+{
+    std::vector<startup_client> table(clients);
+    std::vector<jack_time_t> times;
+    int started;
+    int res = 0;
+
+    jack_time_t start = jack_get_time();
+    for (started = 0; started < clients; started++) {
+        if (start_client(&table[started], started, combined, server_name) < 0) {
+            if (table[started].client) {
+                jack_client_close(table[started].client);
+            }
+            res = -1;
+            break;
+        }
+    }
+
+    // Wait for the first cycle of each client, at most 10 seconds
+    jack_time_t last = 0;
+    for (int i = 0; i < started; i++) {
+        for (int tries = 0; table[i].first_process_usecs == 0 && tries < 10000; tries++) {
+            usleep(1000);
+        }
+        if (table[i].first_process_usecs == 0) {
+            fprintf(stderr, "client %d was never called\n", i);
+            res = -1;
+        } else {
+            times.push_back(table[i].first_process_usecs - table[i].open_usecs);
+            last = std::max(last, (jack_time_t)table[i].first_process_usecs);
+        }
+    }
+
+    if (res == 0) {
+        print_stats(sequence, times, last - start);
+    }
+
+    for (int i = 0; i < started; i++) {
+        jack_deactivate(table[i].client);
+        jack_client_close(table[i].client);
+    }
+    return res;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* server_name = NULL;
+    const char* options = "c:p:s:h";
+    struct option long_options[] = {
+        {"clients", 1, 0, 'c'},
+        {"ports", 1, 0, 'p'},
+        {"server", 1, 0, 's'},
+        {"help", 0, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+    int option_index;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, options, long_options, &option_index)) != -1) {
+        switch (opt) {
+            case 'c':
+                clients = atoi(optarg);
+                break;
+            case 'p':
+                ports = atoi(optarg);
+                break;
+            case 's':
+                server_name = optarg;
+                break;
+            case 'h':
+            default:
+                usage();
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    if (clients < 1 || ports < 0) {
+        fprintf(stderr, "at least one client is needed\n");
+        return 1;
+    }
+
+    // jack_get_time needs the library clock, only set up while a client is open : keep one open for the whole run
+    jack_options_t open_options = (server_name) ? (jack_options_t)(JackNoStartServer | JackServerName) : JackNoStartServer;
+    jack_client_t* clock_client = jack_client_open("startup_clock", open_options, NULL, server_name);
+    if (clock_client == NULL) {
+        fprintf(stderr, "cannot open the clock client, is the server running ?\n");
+        return 1;
+    }
+
+    printf("%d clients with %d ports, time from open to the first process callback\n", clients, ports);
+
+    int res = 0;
+    if (bench("register + activate", false, server_name) < 0
+        || bench("activate_with_ports", true, server_name) < 0) {
+        res = 1;
+    }
+
+    jack_client_close(clock_client);
+    return res;
+}
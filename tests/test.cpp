@@ -37,6 +37,9 @@
 #include <jack/jack.h>
 #include <jack/intclient.h>
 #include <jack/transport.h>
+#include <jack/graph.h>
+#include <jack/startup.h>
+#include <jack/budget.h>
 
 #define TEST_EXCLUDE_DEPRECATED 1
 
@@ -1554,6 +1557,125 @@ int main (int argc, char *argv[])
         printf("!!! ERROR !!! while checking jack_port_get_connections() Vs jack_port_get_all_connections() on PHY port...\n");
     }
 
+    /**
+     * Test the graph snapshot functions...
+     *
+     */
+    Log("Testing jack_graph_get_port_peers and jack_graph_snapshot...\n");
+    t_error = 0;
+    connexions2 = jack_port_get_all_connections(client1, output_port1);
+    {
+        jack_port_id_t peers[8];
+        const jack_port_id_t* snapshot_peers;
+        uint32_t version1, version2;
+        int count = jack_graph_get_port_peers(client1, output_port1, peers, 8, &version1);
+        jack_graph_snapshot_t* snapshot = jack_graph_snapshot_new(client1);
+
+        for (a = 0; connexions2 && connexions2[a] != NULL; a++) {}
+        if (count != a || snapshot == NULL) {
+            t_error = 1;
+        } else {
+            jack_port_id_t port_id;
+            for (port_id = 0; port_id < jack_graph_snapshot_get_port_count(snapshot); port_id++) {
+                if (jack_port_by_id(client1, port_id) == output_port1) {
+                    break;
+                }
+            }
+            if (jack_graph_snapshot_get_peers(snapshot, port_id, &snapshot_peers) != count) {
+                t_error = 1;
+            }
+            for (a = 0; a < count && t_error == 0; a++) {
+                t_error = strcmp(jack_port_name(jack_port_by_id(client1, peers[a])), connexions2[a])
+                    || (snapshot_peers[a] != peers[a]);
+            }
+        }
+
+        // Version must change with the graph, and only then
+        jack_graph_get_version(client1, &version2);
+        if (version1 != version2 || (snapshot && jack_graph_snapshot_update(client1, snapshot) != 0)) {
+            t_error = 1;
+        }
+        jack_connect(client1, jack_port_name(output_port2), jack_port_name(input_port2));
+        jack_graph_get_version(client1, &version2);
+        if (version1 == version2 || (snapshot && jack_graph_snapshot_update(client1, snapshot) != 1)) {
+            t_error = 1;
+        }
+        jack_disconnect(client1, jack_port_name(output_port2), jack_port_name(input_port2));
+        jack_graph_snapshot_free(snapshot);
+    }
+    jack_free(connexions2);
+
+    if (t_error == 0) {
+        Log("Checking jack_graph_get_port_peers() and jack_graph_snapshot Vs jack_port_get_all_connections... ok\n");
+    } else {
+        printf("!!! ERROR !!! while checking jack_graph_get_port_peers() and jack_graph_snapshot Vs jack_port_get_all_connections...\n");
+    }
+
+    /**
+     * Test registering ports and activating in one request...
+     *
+     */
+    Log("Testing jack_activate_with_ports...\n");
+    t_error = 0;
+    {
+        jack_client_t* client_startup = jack_client_open("test_startup", jack_options, &status, server_name);
+        jack_port_spec_t specs[3] = {
+            { "out", JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput },
+            { "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput },
+            { "in", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput }
+        };
+        jack_port_t* ports[3];
+        if (client_startup == NULL) {
+            t_error = 1;
+        } else {
+            // A duplicated name : no port is registered and the client stays inactive
+            if (jack_activate_with_ports(client_startup, specs, 3, ports) == 0
+                    || jack_port_by_name(client1, "test_startup:out") != NULL) {
+                t_error = 1;
+            }
+            if (jack_activate_with_ports(client_startup, specs, 2, ports) != 0
+                    || ports[0] == NULL || ports[1] == NULL
+                    || !jack_port_is_mine(client_startup, ports[0])
+                    || jack_port_by_name(client1, "test_startup:in") != ports[1]) {
+                t_error = 1;
+            }
+            jack_client_close(client_startup);
+        }
+    }
+
+    if (t_error == 0) {
+        Log("Checking jack_activate_with_ports()... ok\n");
+    } else {
+        printf("!!! ERROR !!! while checking jack_activate_with_ports()...\n");
+    }
+
+    /**
+     * Test the client budget API...
+     *
+     */
+    Log("Testing jack_set_budget_callback and jack_get_budget_stats...\n");
+    t_error = 0;
+    {
+        jack_budget_stats_t stats;
+        // client1 is active : callbacks cannot be set anymore
+        if (jack_set_budget_callback(client1, NULL, NULL) == 0) {
+            t_error = 1;
+        }
+        // A well behaved client is never bypassed
+        if (jack_get_budget_stats(client1, &stats) != 0 || stats.bypassed || stats.bypass_count != 0) {
+            t_error = 1;
+        }
+        if (jack_get_budget_stats(client1, NULL) == 0) {
+            t_error = 1;
+        }
+    }
+
+    if (t_error == 0) {
+        Log("Checking jack_set_budget_callback() and jack_get_budget_stats()... ok\n");
+    } else {
+        printf("!!! ERROR !!! while checking jack_set_budget_callback() and jack_get_budget_stats()...\n");
+    }
+
     if (jack_disconnect(client1, jack_port_name(output_port1), jack_port_name(input_port1)) != 0) {
         printf("!!! ERROR !!! while client1 intenting to disconnect ports...\n");
     }
@@ -0,0 +1,133 @@
+/*
+    Copyright (C) 2026 JACK developers
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/** @file transportinterpolate.cpp
+ *
+ * @brief Checks how a rolling transport position is moved later in the cycle, as jack_transport_query_offset does.
+ *
+ * No server is needed : JackTransportEngine::InterpolatePosition is called on hand-made positions, at 120 BPM,
+ * 48 kHz and 1920 ticks per beat, so that a beat lasts 24000 frames and a frame 0.08 tick.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "JackTransportEngine.h"
+
+using namespace Jack;
+
+#define SAMPLE_RATE     48000
+#define TICKS_PER_BEAT  1920.
+#define BPM             120.
+#define TICKS_PER_FRAME (TICKS_PER_BEAT * BPM / 60. / SAMPLE_RATE)
+
+static int errors = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("%s !\n", what);
+        errors++;
+    }
+}
+
+static void make_position(jack_position_t* pos, int32_t bar, int32_t beat, int32_t tick)
+{
+    memset(pos, 0, sizeof(jack_position_t));
+    pos->valid = JackPositionBBT;
+    pos->frame_rate = SAMPLE_RATE;
+    pos->frame = 100000;
+    pos->bar = bar;
+    pos->beat = beat;
+    pos->tick = tick;
+    pos->beats_per_bar = 4.f;
+    pos->beat_type = 4.f;
+    pos->ticks_per_beat = TICKS_PER_BEAT;
+    pos->beats_per_minute = BPM;
+    pos->bar_start_tick = (bar - 1) * 4 * TICKS_PER_BEAT;
+}
+
+static void check_bbt(const char* name, const jack_position_t& pos, jack_nframes_t frame, int32_t bar, int32_t beat, int32_t tick, double bar_start_tick)
+{
+    printf("%-24s : frame = %u bar = %d beat = %d tick = %d bar_start_tick = %.0f\n", name, pos.frame, pos.bar, pos.beat, pos.tick, pos.bar_start_tick);
+    check(pos.frame == frame, "the frame is not moved by the offset");
+    check(pos.bar == bar && pos.beat == beat && pos.tick == tick, "the BBT position is wrong");
+    check(pos.bar_start_tick == bar_start_tick, "the bar start tick does not follow the bar");
+}
+
+static void test_tick_to_beat()
+{
+    // 1900 + 1000 * 0.08 = 1980 ticks : second beat, tick 60
+    jack_position_t pos;
+    make_position(&pos, 1, 1, 1900);
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 1000);
+    check_bbt("tick to beat", pos, 101000, 1, 2, 60, 0.);
+}
+
+static void test_beat_to_bar()
+{
+    // Last beat of bar 3, 1800 + 3000 * 0.08 = 2040 ticks : first beat of bar 4, tick 120
+    jack_position_t pos;
+    make_position(&pos, 3, 4, 1800);
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 3000);
+    check_bbt("beat to bar", pos, 103000, 4, 1, 120, 3 * 4 * TICKS_PER_BEAT);
+
+    // 9 beats and 40 ticks later : two bars and one beat
+    make_position(&pos, 1, 1, 0);
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 9 * 24000 + 500);
+    check_bbt("several bars", pos, 100000 + 9 * 24000 + 500, 3, 2, 40, 2 * 4 * TICKS_PER_BEAT);
+}
+
+static void test_bbt_offset()
+{
+    // BBT refers to 500 frames before the cycle start : 1880 + (500 + 100) * 0.08 = 1928 ticks
+    jack_position_t pos;
+    make_position(&pos, 2, 1, 1880);
+    pos.valid = (jack_position_bits_t)(JackPositionBBT | JackBBTFrameOffset);
+    pos.bbt_offset = 500;
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 100);
+    check_bbt("bbt offset", pos, 100100, 2, 2, 8, 4 * TICKS_PER_BEAT);
+    check(pos.bbt_offset == 0, "the BBT offset is not consumed");
+
+    // Without JackBBTFrameOffset, the field is ignored : 1880 + 100 * 0.08 = 1888 ticks
+    make_position(&pos, 2, 1, 1880);
+    pos.bbt_offset = 500;
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 100);
+    check_bbt("bbt offset not valid", pos, 100100, 2, 1, 1888, 4 * TICKS_PER_BEAT);
+    check(pos.bbt_offset == 500, "an invalid BBT offset is changed");
+}
+
+static void test_no_bbt()
+{
+    // Only the frame moves
+    jack_position_t pos;
+    make_position(&pos, 1, 1, 1900);
+    pos.valid = (jack_position_bits_t)0;
+    JackTransportEngine::InterpolatePosition(&pos, TICKS_PER_FRAME, 1000);
+    check_bbt("no bbt", pos, 101000, 1, 1, 1900, 0.);
+}
+
+int main(int argc, char* argv[])
+{
+    test_tick_to_beat();
+    test_beat_to_bar();
+    test_bbt_offset();
+    test_no_bbt();
+
+    printf("%s\n", errors ? "FAILED" : "OK");
+    return errors ? 1 : 0;
+}
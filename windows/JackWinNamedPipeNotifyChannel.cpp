@@ -73,6 +73,19 @@ void JackWinNamedPipeNotifyChannel::ClientNotify(int refnum, const char* name, i
     }
 }
 
+void JackWinNamedPipeNotifyChannel::ClientNotify(JackClientNotification* events, int count, int* result)
+{
+    JackClientNotificationBatch batch;
+
+    // Asynchronous notifications only, no result to read
+    if (batch.Send(&fNotifyPipe, events, count) < 0) {
+        jack_error("Could not write notifications");
+        *result = -1;
+    } else {
+        *result = 0;
+    }
+}
+
 } // end of namespace
 
 
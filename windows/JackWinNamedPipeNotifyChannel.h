@@ -26,6 +26,8 @@
 namespace Jack
 {
 
+struct JackClientNotification;
+
 /*!
 \brief JackNotifyChannel using named pipe.
 */
@@ -46,6 +48,7 @@ class JackWinNamedPipeNotifyChannel
         void Close();					// Close the Server/Client connection
 
         void ClientNotify(int refnum, const char* name, int notify, int sync, const char* message, int value1, int value2, int* result);
+        void ClientNotify(JackClientNotification* events, int count, int* result);
 };
 
 } // end of namespace
@@ -29,7 +29,7 @@ namespace Jack
 \brief A synchronization primitive built using a condition variable.
 */
 
-class JackWinProcessSync : public JackWinMutex
+class SERVER_EXPORT JackWinProcessSync : public JackWinMutex
 {
 
     private:
@@ -239,6 +239,28 @@ int JackWinThread::DropRealTimeImp(jack_native_thread_t thread)
     }
 }
 
+int JackWinThread::SetSelfAffinity(int cpu)
+{
+    return SetAffinityImp(GetCurrentThread(), cpu);
+}
+
+int JackWinThread::SetAffinityImp(jack_native_thread_t thread, int cpu)
+{
+    if (cpu < 0 || cpu >= (int)(sizeof(DWORD_PTR) * 8)) {
+        return -1;
+    } else if (SetThreadAffinityMask(thread, (DWORD_PTR)1 << cpu) != 0) {
+        return 0;
+    } else {
+        jack_error("Cannot set thread affinity to CPU %d = %d", cpu, GetLastError());
+        return -1;
+    }
+}
+
+void JackWinThread::SetRealTimeCpus(const int* cpus, int count)
+{
+    // Non RT threads keep the default affinity here
+}
+
 jack_native_thread_t JackWinThread::GetThreadID()
 {
     return fThread;
@@ -68,6 +68,8 @@ class SERVER_EXPORT JackWinThread : public JackMMCSS, public detail::JackThreadI
         int DropRealTime();                     // Used when called from another thread
         int DropSelfRealTime();                 // Used when called from thread itself
 
+        int SetSelfAffinity(int cpu);           // Used when called from thread itself
+
         jack_native_thread_t GetThreadID();
         bool IsThread();
 
@@ -77,6 +79,8 @@ class SERVER_EXPORT JackWinThread : public JackMMCSS, public detail::JackThreadI
             return JackWinThread::AcquireRealTimeImp(thread, priority);
         }
         static int DropRealTimeImp(jack_native_thread_t thread);
+        static int SetAffinityImp(jack_native_thread_t thread, int cpu);
+        static void SetRealTimeCpus(const int* cpus, int count);
         static int StartImp(jack_native_thread_t* thread, int priority, int realtime, void*(*start_routine)(void*), void* arg)
         {
             return JackWinThread::StartImp(thread, priority, realtime, (ThreadCallback) start_routine, arg);